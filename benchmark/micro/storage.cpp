@@ -2,6 +2,8 @@
 #include "duckdb_benchmark_macro.hpp"
 #include "duckdb/main/appender.hpp"
 
+#include <fstream>
+
 using namespace duckdb;
 using namespace std;
 
@@ -39,3 +41,113 @@ string BenchmarkInfo() override {
 	return "Run the query \"SELECT 1\" 50K times in in-memory mode";
 }
 FINISH_BENCHMARK(SELECT1Disk)
+
+#define COLD_SCAN_BENCHMARK(THREADS)                                                                                   \
+	unique_ptr<DuckDBBenchmarkState> CreateBenchmarkState() override {                                                 \
+		auto path = GetDatabasePath();                                                                                 \
+		{                                                                                                              \
+			DuckDB db(path);                                                                                           \
+			Connection con(db);                                                                                        \
+			con.Query("CREATE TABLE integers AS SELECT (i * 7919) % 1000003 AS i, (i * 104729) % 999983 AS j "         \
+			          "FROM range(0, 10000000) tbl(i)");                                                               \
+		}                                                                                                              \
+		/* reopening the database checkpoints the table, after which it is stored in persistent segments */            \
+		return make_unique<DuckDBBenchmarkState>(path);                                                                \
+	}                                                                                                                  \
+	void Load(DuckDBBenchmarkState *state) override {                                                                  \
+		state->conn.Query("PRAGMA threads=" #THREADS);                                                                 \
+	}                                                                                                                  \
+	void RunBenchmark(DuckDBBenchmarkState *state) override {                                                          \
+		/* evict all blocks from the buffer manager so the scan has to read them from disk again */                    \
+		state->conn.Query("PRAGMA memory_limit='0MB'");                                                                \
+		state->conn.Query("PRAGMA memory_limit=-1");                                                                   \
+		state->result = state->conn.Query("SELECT SUM(i), SUM(j) FROM integers");                                      \
+	}                                                                                                                  \
+	string VerifyResult(QueryResult *result) override {                                                                \
+		if (!result->success) {                                                                                        \
+			return result->error;                                                                                      \
+		}                                                                                                              \
+		return string();                                                                                               \
+	}                                                                                                                  \
+	bool InMemory() override {                                                                                         \
+		return false;                                                                                                  \
+	}                                                                                                                  \
+	string BenchmarkInfo() override {                                                                                  \
+		return "Scan a persistent table with " #THREADS " thread(s) after evicting it from the buffer manager";        \
+	}
+
+DUCKDB_BENCHMARK(ColdScanSingleThread, "[storage]")
+COLD_SCAN_BENCHMARK(1)
+FINISH_BENCHMARK(ColdScanSingleThread)
+
+DUCKDB_BENCHMARK(ColdScanFourThreads, "[storage]")
+COLD_SCAN_BENCHMARK(4)
+FINISH_BENCHMARK(ColdScanFourThreads)
+
+#define WAL_REPLAY_BENCHMARK(THREADS)                                                                                  \
+	string GetTemplatePath() {                                                                                         \
+		return "duckdb_benchmark_wal_template.db";                                                                     \
+	}                                                                                                                  \
+	static void CopyDatabaseFile(const string &source, const string &target) {                                         \
+		ifstream input(source, ios::binary);                                                                           \
+		ofstream output(target, ios::binary | ios::trunc);                                                             \
+		output << input.rdbuf();                                                                                       \
+	}                                                                                                                  \
+	unique_ptr<DuckDBBenchmarkState> CreateBenchmarkState() override {                                                 \
+		auto path = GetTemplatePath();                                                                                 \
+		DeleteDatabase(path);                                                                                          \
+		DBConfig config;                                                                                               \
+		config.checkpoint_wal_size = (idx_t)1 << 40;                                                                   \
+		{                                                                                                              \
+			DuckDB db(path, &config);                                                                                  \
+			Connection con(db);                                                                                        \
+			for (idx_t t = 0; t < 4; t++) {                                                                            \
+				con.Query("CREATE TABLE t" + to_string(t) + "(i INTEGER, j BIGINT, s VARCHAR)");                       \
+			}                                                                                                          \
+			/* many small transactions that insert into the tables in turn, which are all stored in the WAL */         \
+			for (idx_t i = 0; i < 20000; i++) {                                                                        \
+				con.Query("INSERT INTO t" + to_string(i % 4) + " SELECT range, range * " + to_string(i) +              \
+				          ", 'string' || range FROM range(0, 100)");                                                   \
+			}                                                                                                          \
+		}                                                                                                              \
+		return make_unique<DuckDBBenchmarkState>(string());                                                            \
+	}                                                                                                                  \
+	void Load(DuckDBBenchmarkState *state) override {                                                                  \
+	}                                                                                                                  \
+	void RunBenchmark(DuckDBBenchmarkState *state) override {                                                          \
+		/* start from a copy of the database and its WAL, so every run replays the entire WAL */                       \
+		auto path = GetDatabasePath();                                                                                 \
+		CopyDatabaseFile(GetTemplatePath(), path);                                                                     \
+		CopyDatabaseFile(GetTemplatePath() + ".wal", path + ".wal");                                                   \
+		DBConfig config;                                                                                               \
+		config.checkpoint_wal_size = (idx_t)1 << 40;                                                                   \
+		config.maximum_threads = THREADS;                                                                              \
+		DuckDB db(path, &config);                                                                                      \
+		Connection con(db);                                                                                            \
+		state->result = con.Query("SELECT (SELECT COUNT(*) FROM t0) + (SELECT COUNT(*) FROM t1) + "                    \
+		                          "(SELECT COUNT(*) FROM t2) + (SELECT COUNT(*) FROM t3)");                            \
+	}                                                                                                                  \
+	string VerifyResult(QueryResult *result) override {                                                                \
+		if (!result->success) {                                                                                        \
+			return result->error;                                                                                      \
+		}                                                                                                              \
+		auto &materialized = (MaterializedQueryResult &)*result;                                                       \
+		if (materialized.GetValue(0, 0) != Value::BIGINT(2000000)) {                                                   \
+			return "Incorrect row count " + materialized.GetValue(0, 0).ToString();                                    \
+		}                                                                                                              \
+		return string();                                                                                               \
+	}                                                                                                                  \
+	bool InMemory() override {                                                                                         \
+		return false;                                                                                                  \
+	}                                                                                                                  \
+	string BenchmarkInfo() override {                                                                                  \
+		return "Replay a WAL of 20K small inserts into 4 tables with " #THREADS " thread(s)";                          \
+	}
+
+DUCKDB_BENCHMARK(WALReplaySingleThread, "[storage]")
+WAL_REPLAY_BENCHMARK(1)
+FINISH_BENCHMARK(WALReplaySingleThread)
+
+DUCKDB_BENCHMARK(WALReplayFourThreads, "[storage]")
+WAL_REPLAY_BENCHMARK(4)
+FINISH_BENCHMARK(WALReplayFourThreads)
@@ -214,7 +214,7 @@ idx_t CatalogSet::GetEntryIndex(CatalogEntry *entry) {
 bool CatalogSet::HasConflict(ClientContext &context, transaction_t timestamp) {
 	auto &transaction = Transaction::GetTransaction(context);
 	return (timestamp >= TRANSACTION_ID_START && timestamp != transaction.transaction_id) ||
-	       (timestamp < TRANSACTION_ID_START && timestamp > transaction.start_time);
+	       (timestamp < TRANSACTION_ID_START && timestamp >= transaction.start_time);
 }
 
 MappingValue *CatalogSet::GetMapping(ClientContext &context, const string &name, bool get_latest) {
@@ -171,6 +171,55 @@ int64_t FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes) {
 	return bytes_written;
 }
 
+void FileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	// positional reads do not use the file pointer: multiple threads can read from the same handle concurrently
+	int fd = ((UnixFileHandle &)handle).fd;
+	auto read_buffer = (char *)buffer;
+	while (nr_bytes > 0) {
+		int64_t bytes_read = pread(fd, read_buffer, nr_bytes, location);
+		if (bytes_read == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw IOException("Could not read from file \"%s\": %s", handle.path, strerror(errno));
+		}
+		if (bytes_read == 0) {
+			throw IOException("Could not read sufficient bytes from file \"%s\"", handle.path);
+		}
+		read_buffer += bytes_read;
+		nr_bytes -= bytes_read;
+		location += bytes_read;
+	}
+}
+
+void FileSystem::Prefetch(FileHandle &handle, int64_t nr_bytes, idx_t location) {
+#ifdef POSIX_FADV_WILLNEED
+	int fd = ((UnixFileHandle &)handle).fd;
+	// this is only a hint: errors are ignored
+	posix_fadvise(fd, location, nr_bytes, POSIX_FADV_WILLNEED);
+#endif
+}
+
+void FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	int fd = ((UnixFileHandle &)handle).fd;
+	auto write_buffer = (char *)buffer;
+	while (nr_bytes > 0) {
+		int64_t bytes_written = pwrite(fd, write_buffer, nr_bytes, location);
+		if (bytes_written == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw IOException("Could not write file \"%s\": %s", handle.path, strerror(errno));
+		}
+		if (bytes_written == 0) {
+			throw IOException("Could not write sufficient bytes from file \"%s\"", handle.path);
+		}
+		write_buffer += bytes_written;
+		nr_bytes -= bytes_written;
+		location += bytes_written;
+	}
+}
+
 int64_t FileSystem::GetFileSize(FileHandle &handle) {
 	int fd = ((UnixFileHandle &)handle).fd;
 	struct stat s;
@@ -472,6 +521,43 @@ int64_t FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes) {
 	return bytes_read;
 }
 
+void FileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	// pass the location in an OVERLAPPED structure: this does not depend on the current file pointer
+	HANDLE hFile = ((WindowsFileHandle &)handle).fd;
+	OVERLAPPED ov = {};
+	ov.Offset = location & 0xFFFFFFFF;
+	ov.OffsetHigh = location >> 32;
+	DWORD bytes_read;
+	auto rc = ReadFile(hFile, buffer, (DWORD)nr_bytes, &bytes_read, &ov);
+	if (rc == 0) {
+		auto error = GetLastErrorAsString();
+		throw IOException("Could not read from file \"%s\": %s", handle.path, error);
+	}
+	if ((int64_t)bytes_read != nr_bytes) {
+		throw IOException("Could not read sufficient bytes from file \"%s\"", handle.path);
+	}
+}
+
+void FileSystem::Prefetch(FileHandle &handle, int64_t nr_bytes, idx_t location) {
+	// not supported: the data is read when it is requested
+}
+
+void FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
+	HANDLE hFile = ((WindowsFileHandle &)handle).fd;
+	OVERLAPPED ov = {};
+	ov.Offset = location & 0xFFFFFFFF;
+	ov.OffsetHigh = location >> 32;
+	DWORD bytes_written;
+	auto rc = WriteFile(hFile, buffer, (DWORD)nr_bytes, &bytes_written, &ov);
+	if (rc == 0) {
+		auto error = GetLastErrorAsString();
+		throw IOException("Could not write file \"%s\": %s", handle.path, error);
+	}
+	if ((int64_t)bytes_written != nr_bytes) {
+		throw IOException("Could not write sufficient bytes from file \"%s\"", handle.path);
+	}
+}
+
 int64_t FileSystem::GetFileSize(FileHandle &handle) {
 	HANDLE hFile = ((WindowsFileHandle &)handle).fd;
 	LARGE_INTEGER result;
@@ -671,26 +757,6 @@ string FileSystem::GetHomeDirectory() {
 	return homedir;
 }
 
-void FileSystem::Read(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	// seek to the location
-	SetFilePointer(handle, location);
-	// now read from the location
-	int64_t bytes_read = Read(handle, buffer, nr_bytes);
-	if (bytes_read != nr_bytes) {
-		throw IOException("Could not read sufficient bytes from file \"%s\"", handle.path);
-	}
-}
-
-void FileSystem::Write(FileHandle &handle, void *buffer, int64_t nr_bytes, idx_t location) {
-	// seek to the location
-	SetFilePointer(handle, location);
-	// now write to the location
-	int64_t bytes_written = Write(handle, buffer, nr_bytes);
-	if (bytes_written != nr_bytes) {
-		throw IOException("Could not write sufficient bytes from file \"%s\"", handle.path);
-	}
-}
-
 string FileSystem::JoinPath(const string &a, const string &b) {
 	// FIXME: sanitize paths
 	return a + PathSeparator() + b;
@@ -704,6 +770,10 @@ void FileHandle::Write(void *buffer, idx_t nr_bytes, idx_t location) {
 	file_system.Write(*this, buffer, nr_bytes, location);
 }
 
+void FileHandle::Prefetch(idx_t nr_bytes, idx_t location) {
+	file_system.Prefetch(*this, nr_bytes, location);
+}
+
 void FileHandle::Sync() {
 	file_system.FileSync(*this);
 }
@@ -5,6 +5,7 @@
 #include "duckdb/common/value_operations/value_operations.hpp"
 #include "duckdb/common/operator/comparison_operators.hpp"
 #include "duckdb/common/assert.hpp"
+#include "duckdb/common/types/sort_key.hpp"
 
 #include <algorithm>
 #include <cstring>
@@ -312,11 +313,65 @@ static void _quicksort_inplace(ChunkCollection *sort_by, vector<OrderType> &desc
 	stack.Enqueue(part + 1, right);
 }
 
+//! Returns true if all sort columns can be encoded in a normalized sort key
+static bool SupportsSortKeys(vector<LogicalType> &types, idx_t column_count) {
+	for (idx_t col_idx = 0; col_idx < column_count; col_idx++) {
+		if (!SortKeyLayout::IsSupported(types[col_idx])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Encodes the sort columns of the collection into entries of (sort key, row index)
+static unique_ptr<data_t[]> EncodeSortKeys(ChunkCollection &collection, SortKeyLayout &layout, idx_t entry_width) {
+	auto entries = unique_ptr<data_t[]>(new data_t[collection.Count() * entry_width]);
+	idx_t row_idx = 0;
+	for (auto &chunk : collection.Chunks()) {
+		auto chunk_entries = entries.get() + row_idx * entry_width;
+		layout.Encode(*chunk, chunk_entries, entry_width);
+		for (idx_t i = 0; i < chunk->size(); i++) {
+			Store<idx_t>(row_idx + i, chunk_entries + i * entry_width + layout.key_width);
+		}
+		row_idx += chunk->size();
+	}
+	return entries;
+}
+
 void ChunkCollection::Sort(vector<OrderType> &desc, vector<OrderByNullType> &null_order, idx_t result[]) {
 	D_ASSERT(result);
 	if (count == 0) {
 		return;
 	}
+	if (SupportsSortKeys(types, desc.size())) {
+		// encode the sort columns into normalized keys and radix sort them
+		vector<LogicalType> key_types(types.begin(), types.begin() + desc.size());
+		SortKeyLayout layout(key_types, desc, null_order);
+		idx_t entry_width = layout.key_width + sizeof(idx_t);
+		auto entries = EncodeSortKeys(*this, layout, entry_width);
+		SortKeyLayout::RadixSort(entries.get(), count, layout.key_width, entry_width);
+		for (idx_t i = 0; i < count; i++) {
+			result[i] = Load<idx_t>(entries.get() + i * entry_width + layout.key_width);
+		}
+		if (!layout.exact) {
+			// the sort keys only contain string prefixes: sort any rows with an equal exact prefix by comparing the
+			// full values
+			idx_t run_start = 0;
+			for (idx_t i = 1; i <= count; i++) {
+				if (i < count && memcmp(entries.get() + run_start * entry_width, entries.get() + i * entry_width,
+				                        layout.exact_width) == 0) {
+					continue;
+				}
+				if (i - run_start > 1) {
+					std::sort(result + run_start, result + i, [&](const idx_t &left, const idx_t &right) {
+						return compare_tuple(this, desc, null_order, left, right) < 0;
+					});
+				}
+				run_start = i;
+			}
+		}
+		return;
+	}
 	// start off with an initial quicksort
 	int64_t part = _quicksort_initial(this, desc, null_order, result);
 
@@ -544,6 +599,29 @@ void ChunkCollection::Heap(vector<OrderType> &desc, vector<OrderByNullType> &nul
 	if (count == 0)
 		return;
 
+	if (SupportsSortKeys(types, desc.size())) {
+		// encode the sort columns into normalized keys, and select the smallest heap_size keys
+		vector<LogicalType> key_types(types.begin(), types.begin() + desc.size());
+		SortKeyLayout layout(key_types, desc, null_order);
+		idx_t entry_width = layout.key_width + sizeof(idx_t);
+		auto keys = EncodeSortKeys(*this, layout, entry_width);
+		auto indices = unique_ptr<idx_t[]>(new idx_t[count]);
+		for (idx_t i = 0; i < count; i++) {
+			indices[i] = i;
+		}
+		std::partial_sort(indices.get(), indices.get() + heap_size, indices.get() + count,
+		                  [&](const idx_t &left, const idx_t &right) {
+			                  auto cmp = memcmp(keys.get() + left * entry_width, keys.get() + right * entry_width,
+			                                    layout.exact_width);
+			                  if (cmp == 0 && !layout.exact) {
+				                  cmp = compare_tuple(this, desc, null_order, left, right);
+			                  }
+			                  return cmp < 0;
+		                  });
+		memcpy(heap, indices.get(), heap_size * sizeof(idx_t));
+		return;
+	}
+
 	_heap_create(this, desc, null_order, heap, heap_size);
 
 	// Heap is ready. Now do a heapsort
@@ -0,0 +1,52 @@
+#include "duckdb/common/types/hyperloglog.hpp"
+#include "duckdb/common/serializer.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace duckdb {
+
+HyperLogLog::HyperLogLog() {
+	memset(registers, 0, sizeof(registers));
+}
+
+void HyperLogLog::Merge(const HyperLogLog &other) {
+	for (idx_t i = 0; i < REGISTER_COUNT; i++) {
+		registers[i] = MaxValue<uint8_t>(registers[i], other.registers[i]);
+	}
+}
+
+idx_t HyperLogLog::Count() const {
+	double sum = 0;
+	idx_t zero_registers = 0;
+	for (idx_t i = 0; i < REGISTER_COUNT; i++) {
+		sum += 1.0 / double(uint64_t(1) << registers[i]);
+		zero_registers += registers[i] == 0;
+	}
+	double m = double(REGISTER_COUNT);
+	double alpha = 0.7213 / (1.0 + 1.079 / m);
+	double estimate = alpha * m * m / sum;
+	if (estimate <= 2.5 * m && zero_registers > 0) {
+		// small range correction: count the empty registers instead (linear counting)
+		estimate = m * std::log(m / double(zero_registers));
+	}
+	return idx_t(estimate + 0.5);
+}
+
+unique_ptr<HyperLogLog> HyperLogLog::Copy() const {
+	auto result = make_unique<HyperLogLog>();
+	memcpy(result->registers, registers, sizeof(registers));
+	return result;
+}
+
+void HyperLogLog::Serialize(Serializer &serializer) const {
+	serializer.WriteData((const_data_ptr_t)registers, sizeof(registers));
+}
+
+unique_ptr<HyperLogLog> HyperLogLog::Deserialize(Deserializer &source) {
+	auto result = make_unique<HyperLogLog>();
+	source.ReadData((data_ptr_t)result->registers, sizeof(result->registers));
+	return result;
+}
+
+} // namespace duckdb
@@ -384,7 +384,7 @@ interval_t Interval::GetDifference(timestamp_t timestamp_1, timestamp_t timestam
 	return interval;
 }
 
-static void normalize_interval_entries(interval_t input, int64_t &months, int64_t &days, int64_t &msecs) {
+void Interval::Normalize(interval_t input, int64_t &months, int64_t &days, int64_t &msecs) {
 	int64_t extra_months_d = input.days / Interval::DAYS_PER_MONTH;
 	int64_t extra_months_ms = input.msecs / Interval::MSECS_PER_MONTH;
 	input.days -= extra_months_d * Interval::DAYS_PER_MONTH;
@@ -405,8 +405,8 @@ bool Interval::Equals(interval_t left, interval_t right) {
 bool Interval::GreaterThan(interval_t left, interval_t right) {
 	int64_t lmonths, ldays, lmsecs;
 	int64_t rmonths, rdays, rmsecs;
-	normalize_interval_entries(left, lmonths, ldays, lmsecs);
-	normalize_interval_entries(right, rmonths, rdays, rmsecs);
+	Normalize(left, lmonths, ldays, lmsecs);
+	Normalize(right, rmonths, rdays, rmsecs);
 
 	if (lmonths > rmonths) {
 		return true;
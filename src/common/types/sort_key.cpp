@@ -0,0 +1,338 @@
+#include "duckdb/common/types/sort_key.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/interval.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace duckdb {
+using namespace std;
+
+SortKeyLayout::SortKeyLayout(vector<LogicalType> types_p, vector<OrderType> order_types_p,
+                             vector<OrderByNullType> null_orders_p)
+    : types(move(types_p)), order_types(move(order_types_p)), null_orders(move(null_orders_p)), key_width(0),
+      exact(true), exact_width(0) {
+	D_ASSERT(types.size() == order_types.size());
+	D_ASSERT(types.size() == null_orders.size());
+	for (auto &type : types) {
+		bool prefix_exact = exact;
+		idx_t value_width;
+		switch (type.InternalType()) {
+		case PhysicalType::VARCHAR:
+			value_width = STRING_PREFIX_SIZE;
+			exact = false;
+			break;
+		case PhysicalType::INTERVAL:
+			// intervals are stored as their normalized (months, days, msecs)
+			value_width = 3 * sizeof(int64_t);
+			break;
+		default:
+			if (!IsSupported(type)) {
+				throw NotImplementedException("Type %s is not supported in a sort key", type.ToString());
+			}
+			value_width = GetTypeIdSize(type.InternalType());
+			break;
+		}
+		offsets.push_back(key_width);
+		// every column is prefixed by a byte indicating whether or not the value is NULL
+		key_width += 1 + value_width;
+		if (prefix_exact) {
+			// all preceding columns are exact: this column still orders rows exactly
+			exact_width = key_width;
+		}
+	}
+}
+
+bool SortKeyLayout::IsSupported(const LogicalType &type) {
+	switch (type.InternalType()) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+	case PhysicalType::INT16:
+	case PhysicalType::INT32:
+	case PhysicalType::INT64:
+	case PhysicalType::INT128:
+	case PhysicalType::FLOAT:
+	case PhysicalType::DOUBLE:
+	case PhysicalType::INTERVAL:
+	case PhysicalType::VARCHAR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Encoding
+//===--------------------------------------------------------------------===//
+//! Stores an unsigned integer in big-endian byte order, so that memcmp order equals numeric order
+template <class T> static inline void StoreBigEndian(T value, data_ptr_t ptr) {
+	for (idx_t i = 0; i < sizeof(T); i++) {
+		ptr[i] = (value >> ((sizeof(T) - 1 - i) * 8)) & 0xFF;
+	}
+}
+
+template <class T> static inline void EncodeSigned(T value, data_ptr_t ptr) {
+	typedef typename std::make_unsigned<T>::type UNSIGNED;
+	// flip the sign bit so negative numbers are ordered before positive numbers
+	StoreBigEndian<UNSIGNED>(UNSIGNED(value) ^ (UNSIGNED(1) << (sizeof(T) * 8 - 1)), ptr);
+}
+
+template <class T> static inline void EncodeValue(T value, data_ptr_t ptr);
+
+template <> inline void EncodeValue(bool value, data_ptr_t ptr) {
+	ptr[0] = value ? 1 : 0;
+}
+
+template <> inline void EncodeValue(int8_t value, data_ptr_t ptr) {
+	EncodeSigned<int8_t>(value, ptr);
+}
+
+template <> inline void EncodeValue(int16_t value, data_ptr_t ptr) {
+	EncodeSigned<int16_t>(value, ptr);
+}
+
+template <> inline void EncodeValue(int32_t value, data_ptr_t ptr) {
+	EncodeSigned<int32_t>(value, ptr);
+}
+
+template <> inline void EncodeValue(int64_t value, data_ptr_t ptr) {
+	EncodeSigned<int64_t>(value, ptr);
+}
+
+template <> inline void EncodeValue(hugeint_t value, data_ptr_t ptr) {
+	EncodeSigned<int64_t>(value.upper, ptr);
+	StoreBigEndian<uint64_t>(value.lower, ptr + sizeof(int64_t));
+}
+
+template <> inline void EncodeValue(float value, data_ptr_t ptr) {
+	uint32_t bits;
+	if (value == 0) {
+		// +0 and -0 are equal
+		value = 0;
+	}
+	memcpy(&bits, &value, sizeof(bits));
+	// positive numbers: flip the sign bit, negative numbers: flip all bits
+	bits = (bits & (1u << 31)) ? ~bits : bits | (1u << 31);
+	StoreBigEndian<uint32_t>(bits, ptr);
+}
+
+template <> inline void EncodeValue(double value, data_ptr_t ptr) {
+	uint64_t bits;
+	if (value == 0) {
+		value = 0;
+	}
+	memcpy(&bits, &value, sizeof(bits));
+	bits = (bits & (1ull << 63)) ? ~bits : bits | (1ull << 63);
+	StoreBigEndian<uint64_t>(bits, ptr);
+}
+
+template <> inline void EncodeValue(interval_t value, data_ptr_t ptr) {
+	int64_t months, days, msecs;
+	Interval::Normalize(value, months, days, msecs);
+	EncodeSigned<int64_t>(months, ptr);
+	EncodeSigned<int64_t>(days, ptr + sizeof(int64_t));
+	EncodeSigned<int64_t>(msecs, ptr + 2 * sizeof(int64_t));
+}
+
+template <> inline void EncodeValue(string_t value, data_ptr_t ptr) {
+	// store the prefix of the string, padded with zeros
+	auto len = MinValue<idx_t>(value.GetSize(), SortKeyLayout::STRING_PREFIX_SIZE);
+	memcpy(ptr, value.GetDataUnsafe(), len);
+	memset(ptr + len, 0, SortKeyLayout::STRING_PREFIX_SIZE - len);
+}
+
+template <class T>
+static void TemplatedEncodeColumn(VectorData &vdata, idx_t count, data_ptr_t key_data, idx_t entry_width,
+                                  idx_t value_width, data_t valid_byte, data_t null_byte) {
+	auto data = (T *)vdata.data;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		auto key_ptr = key_data + i * entry_width;
+		if ((*vdata.nullmask)[idx]) {
+			key_ptr[0] = null_byte;
+			memset(key_ptr + 1, 0, value_width);
+		} else {
+			key_ptr[0] = valid_byte;
+			EncodeValue<T>(data[idx], key_ptr + 1);
+		}
+	}
+}
+
+void SortKeyLayout::EncodeColumn(idx_t col_idx, Vector &input, idx_t count, data_ptr_t key_data, idx_t entry_width) {
+	VectorData vdata;
+	input.Orrify(count, vdata);
+
+	auto column_data = key_data + offsets[col_idx];
+	idx_t column_width = (col_idx + 1 < offsets.size() ? offsets[col_idx + 1] : key_width) - offsets[col_idx];
+	idx_t value_width = column_width - 1;
+	data_t valid_byte = null_orders[col_idx] == OrderByNullType::NULLS_FIRST ? 1 : 0;
+	data_t null_byte = 1 - valid_byte;
+
+	switch (input.type.InternalType()) {
+	case PhysicalType::BOOL:
+		TemplatedEncodeColumn<bool>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	case PhysicalType::INT8:
+		TemplatedEncodeColumn<int8_t>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	case PhysicalType::INT16:
+		TemplatedEncodeColumn<int16_t>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	case PhysicalType::INT32:
+		TemplatedEncodeColumn<int32_t>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	case PhysicalType::INT64:
+		TemplatedEncodeColumn<int64_t>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	case PhysicalType::INT128:
+		TemplatedEncodeColumn<hugeint_t>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	case PhysicalType::FLOAT:
+		TemplatedEncodeColumn<float>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	case PhysicalType::DOUBLE:
+		TemplatedEncodeColumn<double>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	case PhysicalType::INTERVAL:
+		TemplatedEncodeColumn<interval_t>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	case PhysicalType::VARCHAR:
+		TemplatedEncodeColumn<string_t>(vdata, count, column_data, entry_width, value_width, valid_byte, null_byte);
+		break;
+	default:
+		throw NotImplementedException("Unimplemented type for sort key encoding");
+	}
+
+	if (order_types[col_idx] == OrderType::DESCENDING) {
+		// descending order: invert all bytes of the column, including the validity byte
+		for (idx_t i = 0; i < count; i++) {
+			auto key_ptr = column_data + i * entry_width;
+			for (idx_t byte_idx = 0; byte_idx < column_width; byte_idx++) {
+				key_ptr[byte_idx] = ~key_ptr[byte_idx];
+			}
+		}
+	}
+}
+
+void SortKeyLayout::Encode(DataChunk &chunk, data_ptr_t key_data, idx_t entry_width) {
+	D_ASSERT(chunk.ColumnCount() >= types.size());
+	for (idx_t col_idx = 0; col_idx < types.size(); col_idx++) {
+		EncodeColumn(col_idx, chunk.data[col_idx], chunk.size(), key_data, entry_width);
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Radix Sort
+//===--------------------------------------------------------------------===//
+//! Buckets with at most this many entries are sorted using insertion sort
+static constexpr idx_t INSERTION_SORT_THRESHOLD = 24;
+//! Keys of at most this width are sorted using LSD radix sort, wider keys use MSD radix sort
+static constexpr idx_t LSD_MAX_KEY_WIDTH = 4;
+
+static void InsertionSort(data_ptr_t data, idx_t count, idx_t offset, idx_t key_width, idx_t entry_width,
+                          data_ptr_t swap_entry) {
+	idx_t compare_width = key_width - offset;
+	for (idx_t i = 1; i < count; i++) {
+		memcpy(swap_entry, data + i * entry_width, entry_width);
+		idx_t j = i;
+		while (j > 0 && memcmp(data + (j - 1) * entry_width + offset, swap_entry + offset, compare_width) > 0) {
+			memcpy(data + j * entry_width, data + (j - 1) * entry_width, entry_width);
+			j--;
+		}
+		memcpy(data + j * entry_width, swap_entry, entry_width);
+	}
+}
+
+static void RadixSortLSD(data_ptr_t data, data_ptr_t temp, idx_t count, idx_t key_width, idx_t entry_width) {
+	idx_t counts[256];
+	data_ptr_t source = data;
+	data_ptr_t target = temp;
+	for (idx_t r = 1; r <= key_width; r++) {
+		idx_t offset = key_width - r;
+		memset(counts, 0, sizeof(counts));
+		for (idx_t i = 0; i < count; i++) {
+			counts[source[i * entry_width + offset]]++;
+		}
+		if (counts[source[offset]] == count) {
+			// all entries have the same byte at this offset: nothing to do
+			continue;
+		}
+		// compute the start location of each bucket
+		idx_t location = 0;
+		for (idx_t bucket = 0; bucket < 256; bucket++) {
+			auto bucket_count = counts[bucket];
+			counts[bucket] = location;
+			location += bucket_count;
+		}
+		for (idx_t i = 0; i < count; i++) {
+			auto entry = source + i * entry_width;
+			memcpy(target + counts[entry[offset]]++ * entry_width, entry, entry_width);
+		}
+		std::swap(source, target);
+	}
+	if (source != data) {
+		memcpy(data, source, count * entry_width);
+	}
+}
+
+static void RadixSortMSD(data_ptr_t data, data_ptr_t temp, idx_t count, idx_t offset, idx_t key_width,
+                         idx_t entry_width, data_ptr_t swap_entry) {
+	idx_t counts[256];
+	while (true) {
+		if (count <= INSERTION_SORT_THRESHOLD) {
+			InsertionSort(data, count, offset, key_width, entry_width, swap_entry);
+			return;
+		}
+		if (offset == key_width) {
+			// all keys in this bucket are equal
+			return;
+		}
+		memset(counts, 0, sizeof(counts));
+		for (idx_t i = 0; i < count; i++) {
+			counts[data[i * entry_width + offset]]++;
+		}
+		if (counts[data[offset]] != count) {
+			break;
+		}
+		// all entries have the same byte at this offset: continue with the next byte without moving any data
+		offset++;
+	}
+	// scatter the entries into their buckets
+	idx_t locations[256];
+	idx_t location = 0;
+	for (idx_t bucket = 0; bucket < 256; bucket++) {
+		locations[bucket] = location;
+		location += counts[bucket];
+	}
+	for (idx_t i = 0; i < count; i++) {
+		auto entry = data + i * entry_width;
+		memcpy(temp + locations[entry[offset]]++ * entry_width, entry, entry_width);
+	}
+	memcpy(data, temp, count * entry_width);
+	// recurse into the buckets
+	idx_t bucket_start = 0;
+	for (idx_t bucket = 0; bucket < 256; bucket++) {
+		if (counts[bucket] > 1) {
+			RadixSortMSD(data + bucket_start * entry_width, temp + bucket_start * entry_width, counts[bucket],
+			             offset + 1, key_width, entry_width, swap_entry);
+		}
+		bucket_start += counts[bucket];
+	}
+}
+
+void SortKeyLayout::RadixSort(data_ptr_t data, idx_t count, idx_t key_width, idx_t entry_width) {
+	auto swap_entry = unique_ptr<data_t[]>(new data_t[entry_width]);
+	if (count <= INSERTION_SORT_THRESHOLD) {
+		InsertionSort(data, count, 0, key_width, entry_width, swap_entry.get());
+		return;
+	}
+	auto temp = unique_ptr<data_t[]>(new data_t[count * entry_width]);
+	if (key_width <= LSD_MAX_KEY_WIDTH) {
+		RadixSortLSD(data, temp.get(), count, key_width, entry_width);
+	} else {
+		RadixSortMSD(data, temp.get(), count, 0, key_width, entry_width, swap_entry.get());
+	}
+}
+
+} // namespace duckdb
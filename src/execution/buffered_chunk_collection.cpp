@@ -0,0 +1,190 @@
+#include "duckdb/execution/buffered_chunk_collection.hpp"
+
+#include "duckdb/common/serializer/buffered_deserializer.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+using namespace std;
+
+BufferedChunkCollection::BufferedChunkCollection(BufferManager &buffer_manager, vector<LogicalType> types_p)
+    : buffer_manager(buffer_manager), types(move(types_p)), count(0), block_bytes(0) {
+	spillable = IsSpillable(types);
+	if (spillable) {
+		append_chunk.Initialize(types);
+	}
+}
+
+bool BufferedChunkCollection::IsSpillable(vector<LogicalType> &types) {
+	for (auto &type : types) {
+		auto physical_type = type.InternalType();
+		if (!TypeIsConstantSize(physical_type) && physical_type != PhysicalType::VARCHAR) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void BufferedChunkCollection::Append(DataChunk &chunk) {
+	if (chunk.size() == 0) {
+		return;
+	}
+	count += chunk.size();
+	if (!spillable) {
+		data.Append(chunk);
+		return;
+	}
+	// gather the rows in the append chunk, so that every chunk but the last one is full
+	idx_t offset = 0;
+	while (offset < chunk.size()) {
+		idx_t append_count = MinValue<idx_t>(chunk.size() - offset, STANDARD_VECTOR_SIZE - append_chunk.size());
+		for (idx_t col_idx = 0; col_idx < chunk.ColumnCount(); col_idx++) {
+			VectorOperations::Copy(chunk.data[col_idx], append_chunk.data[col_idx], offset + append_count, offset,
+			                       append_chunk.size());
+		}
+		append_chunk.SetCardinality(append_chunk.size() + append_count);
+		offset += append_count;
+		if (append_chunk.size() == STANDARD_VECTOR_SIZE) {
+			FlushChunk();
+		}
+	}
+}
+
+void BufferedChunkCollection::FlushChunk() {
+	if (append_chunk.size() == 0) {
+		return;
+	}
+	if (!serializer) {
+		serializer = make_unique<BufferedSerializer>(Storage::BLOCK_SIZE);
+	}
+	chunk_locations.push_back(make_pair(blocks.size(), serializer->blob.size));
+	append_chunk.Serialize(*serializer);
+	append_chunk.Reset();
+	if (serializer->blob.size >= Storage::BLOCK_SIZE) {
+		FlushBlock();
+	}
+}
+
+void BufferedChunkCollection::FlushBlock() {
+	if (!serializer || serializer->blob.size == 0) {
+		return;
+	}
+	// write the serialized chunks into a new buffer-managed block; the block is unpinned as soon as the handle goes
+	// out of scope, after which the buffer manager is free to offload it to disk
+	idx_t size = serializer->blob.size;
+	auto alloc_size = MaxValue<idx_t>(size + Storage::BLOCK_HEADER_SIZE, Storage::BLOCK_ALLOC_SIZE);
+	auto block = buffer_manager.RegisterMemory(alloc_size, false);
+	{
+		auto handle = buffer_manager.Pin(block);
+		memcpy(handle->Ptr(), serializer->data, size);
+	}
+	blocks.push_back(move(block));
+	block_bytes += size;
+	serializer->Reset();
+}
+
+void BufferedChunkCollection::Finalize() {
+	if (!spillable) {
+		return;
+	}
+	FlushChunk();
+	FlushBlock();
+	serializer.reset();
+}
+
+void BufferedChunkCollection::FetchChunk(idx_t chunk_idx, DataChunk &result) {
+	D_ASSERT(chunk_idx < ChunkCount());
+	if (!spillable) {
+		if (result.ColumnCount() == 0) {
+			result.InitializeEmpty(types);
+		}
+		result.Reference(data.GetChunk(chunk_idx));
+		return;
+	}
+	auto &location = chunk_locations[chunk_idx];
+	D_ASSERT(location.first < blocks.size());
+	// the block is only pinned while the chunk is copied out of it
+	auto handle = buffer_manager.Pin(blocks[location.first]);
+	BufferedDeserializer source(handle->Ptr() + location.second, handle->node->size - location.second);
+	result.Destroy();
+	result.Deserialize(source);
+}
+
+void BufferedChunkCollection::FetchRows(idx_t rows[], idx_t row_count, ChunkCollection &result) {
+	// fill the result with NULL values, which are overwritten by the gathered rows
+	for (idx_t offset = 0; offset < row_count; offset += STANDARD_VECTOR_SIZE) {
+		DataChunk result_chunk;
+		result_chunk.Initialize(types);
+		result_chunk.SetCardinality(MinValue<idx_t>(row_count - offset, STANDARD_VECTOR_SIZE));
+		for (idx_t col_idx = 0; col_idx < result_chunk.ColumnCount(); col_idx++) {
+			result_chunk.data[col_idx].vector_type = VectorType::CONSTANT_VECTOR;
+			ConstantVector::SetNull(result_chunk.data[col_idx], true);
+		}
+		result.Append(result_chunk);
+	}
+	if (!spillable) {
+		for (idx_t i = 0; i < row_count; i++) {
+			for (idx_t col_idx = 0; col_idx < types.size(); col_idx++) {
+				result.SetValue(col_idx, i, data.GetValue(col_idx, rows[i]));
+			}
+		}
+		return;
+	}
+	// visit the rows in the order in which they are stored, so that every chunk is fetched only once
+	vector<std::pair<idx_t, idx_t>> row_positions;
+	row_positions.reserve(row_count);
+	for (idx_t i = 0; i < row_count; i++) {
+		D_ASSERT(rows[i] < count);
+		row_positions.push_back(make_pair(rows[i], i));
+	}
+	std::sort(row_positions.begin(), row_positions.end());
+	DataChunk chunk;
+	idx_t fetched_chunk = INVALID_INDEX;
+	for (auto &position : row_positions) {
+		idx_t chunk_idx = position.first / STANDARD_VECTOR_SIZE;
+		if (chunk_idx != fetched_chunk) {
+			FetchChunk(chunk_idx, chunk);
+			fetched_chunk = chunk_idx;
+		}
+		for (idx_t col_idx = 0; col_idx < types.size(); col_idx++) {
+			result.SetValue(col_idx, position.second,
+			                chunk.GetValue(col_idx, position.first - chunk_idx * STANDARD_VECTOR_SIZE));
+		}
+	}
+}
+
+void BufferedChunkCollection::Reset() {
+	count = 0;
+	block_bytes = 0;
+	data.Reset();
+	blocks.clear();
+	chunk_locations.clear();
+	if (spillable) {
+		append_chunk.Reset();
+	}
+	serializer.reset();
+}
+
+void BufferedChunkCollection::Merge(BufferedChunkCollection &other) {
+	D_ASSERT(types == other.types);
+	other.Finalize();
+	if (count == 0) {
+		// this collection is empty: take over the chunks of the other collection
+		count = other.count;
+		block_bytes = other.block_bytes;
+		data.Merge(other.data);
+		blocks = move(other.blocks);
+		chunk_locations = move(other.chunk_locations);
+	} else {
+		DataChunk chunk;
+		for (idx_t chunk_idx = 0; chunk_idx < other.ChunkCount(); chunk_idx++) {
+			other.FetchChunk(chunk_idx, chunk);
+			Append(chunk);
+		}
+	}
+	other.Reset();
+}
+
+} // namespace duckdb
@@ -8,6 +8,8 @@
 #include "duckdb/common/vector_operations/unary_executor.hpp"
 #include "duckdb/common/operator/comparison_operators.hpp"
 
+#include <atomic>
+
 using namespace std;
 
 namespace duckdb {
@@ -17,7 +19,7 @@ using ScanStructure = JoinHashTable::ScanStructure;
 JoinHashTable::JoinHashTable(BufferManager &buffer_manager, vector<JoinCondition> &conditions,
                              vector<LogicalType> btypes, JoinType type)
     : buffer_manager(buffer_manager), build_types(move(btypes)), equality_size(0), condition_size(0), build_size(0),
-      entry_size(0), tuple_size(0), join_type(type), finalized(false), has_null(false), count(0) {
+      entry_size(0), tuple_size(0), join_type(type), finalized(false), has_null(false), count(0), bloom_mask(0) {
 	for (auto &condition : conditions) {
 		D_ASSERT(condition.left->return_type == condition.right->return_type);
 		auto type = condition.left->return_type;
@@ -354,7 +356,23 @@ void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
 	SerializeVector(hash_values, payload.size(), *current_sel, added_count, key_locations);
 }
 
-void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[]) {
+void JoinHashTable::Merge(JoinHashTable &other) {
+	D_ASSERT(!finalized && !other.finalized);
+	D_ASSERT(entry_size == other.entry_size);
+	lock_guard<mutex> merge_lock(ht_lock);
+	// the data blocks are moved as-is: the last block of the other HT might not be full, but that only wastes space
+	for (auto &block : other.blocks) {
+		blocks.push_back(move(block));
+	}
+	other.blocks.clear();
+	count += other.count;
+	other.count = 0;
+	has_null = has_null || other.has_null;
+	// the strings in the data blocks point into the string heap of the other HT
+	string_heap.MergeHeap(other.string_heap);
+}
+
+void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[], bool parallel) {
 	D_ASSERT(hashes.type.id() == LogicalTypeId::HASH);
 
 	// use bitmask to get position in array
@@ -363,8 +381,23 @@ void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_loc
 	hashes.Normalify(count);
 
 	D_ASSERT(hashes.vector_type == VectorType::FLAT_VECTOR);
-	auto pointers = (data_ptr_t *)hash_map->node->buffer;
 	auto indices = FlatVector::GetData<hash_t>(hashes);
+	if (parallel) {
+		// other threads are inserting into the pointer table concurrently: use compare-and-swap to update the heads
+		static_assert(sizeof(std::atomic<data_ptr_t>) == sizeof(data_ptr_t), "atomic pointers must be lock-free");
+		auto pointers = (std::atomic<data_ptr_t> *)hash_map->node->buffer;
+		for (idx_t i = 0; i < count; i++) {
+			auto index = indices[i];
+			auto prev_pointer = (data_ptr_t *)(key_locations[i] + pointer_offset);
+			data_ptr_t head = pointers[index].load();
+			do {
+				// set prev in current key to the current head of the chain
+				Store<data_ptr_t>(head, (data_ptr_t)prev_pointer);
+			} while (!pointers[index].compare_exchange_weak(head, key_locations[i]));
+		}
+		return;
+	}
+	auto pointers = (data_ptr_t *)hash_map->node->buffer;
 	for (idx_t i = 0; i < count; i++) {
 		auto index = indices[i];
 		// set prev in current key to the value (NOTE: this will be nullptr if
@@ -377,7 +410,57 @@ void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_loc
 	}
 }
 
+//! Every key sets three bits in a single 64-bit word of the Bloom filter. The bits are taken from the middle of the hash,
+//! as the lower bits select the word (and the pointer table entry) and the upper bits select the partition.
+static inline uint64_t BloomFilterBits(hash_t hash) {
+	return (uint64_t(1) << ((hash >> 26) & 63)) | (uint64_t(1) << ((hash >> 32) & 63)) |
+	       (uint64_t(1) << ((hash >> 38) & 63));
+}
+
+void JoinHashTable::InsertBloomFilter(hash_t hashes[], idx_t count, bool parallel) {
+	if (parallel) {
+		static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "atomic words must be lock-free");
+		auto words = (std::atomic<uint64_t> *)bloom_filter->node->buffer;
+		for (idx_t i = 0; i < count; i++) {
+			auto bits = BloomFilterBits(hashes[i]);
+			auto &word = words[hashes[i] & bloom_mask];
+			if ((word.load(std::memory_order_relaxed) & bits) != bits) {
+				word.fetch_or(bits, std::memory_order_relaxed);
+			}
+		}
+		return;
+	}
+	auto words = (uint64_t *)bloom_filter->node->buffer;
+	for (idx_t i = 0; i < count; i++) {
+		words[hashes[i] & bloom_mask] |= BloomFilterBits(hashes[i]);
+	}
+}
+
+idx_t JoinHashTable::ProbeBloomFilter(Vector &hashes, const SelectionVector &sel, idx_t count,
+                                      SelectionVector &result) {
+	VectorData hdata;
+	hashes.Orrify(count, hdata);
+
+	auto hash_data = (hash_t *)hdata.data;
+	auto words = (uint64_t *)bloom_filter->node->buffer;
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto rindex = sel.get_index(i);
+		auto hash = hash_data[hdata.sel->get_index(rindex)];
+		auto bits = BloomFilterBits(hash);
+		if ((words[hash & bloom_mask] & bits) == bits) {
+			result.set_index(result_count++, rindex);
+		}
+	}
+	return result_count;
+}
+
 void JoinHashTable::Finalize() {
+	InitializePointerTable();
+	FinalizeBlocks(0, blocks.size(), false);
+}
+
+void JoinHashTable::InitializePointerTable() {
 	// the build has finished, now iterate over all the nodes and construct the final hash table
 	// select a HT that has at least 50% empty space
 	idx_t capacity = NextPowerOfTwo(MaxValue<idx_t>(count * 2, (Storage::BLOCK_ALLOC_SIZE / sizeof(data_ptr_t)) + 1));
@@ -389,16 +472,35 @@ void JoinHashTable::Finalize() {
 	hash_map = buffer_manager.Allocate(capacity * sizeof(data_ptr_t));
 	memset(hash_map->node->buffer, 0, capacity * sizeof(data_ptr_t));
 
+	if (count >= BLOOM_FILTER_THRESHOLD) {
+		// allocate the Bloom filter with (at least) 16 bits per entry
+		idx_t word_count = NextPowerOfTwo(MaxValue<idx_t>(count / 4, Storage::BLOCK_ALLOC_SIZE / sizeof(uint64_t)));
+		bloom_mask = word_count - 1;
+		bloom_filter = buffer_manager.Allocate(word_count * sizeof(uint64_t));
+		memset(bloom_filter->node->buffer, 0, word_count * sizeof(uint64_t));
+	}
+
+	// we pin all the blocks of the HT and keep them pinned until the HT is destroyed
+	// this is so that we can keep pointers around to the blocks
+	// if the HT does not fit in memory, the hash join partitions the HT and pins one partition at a time instead
+	D_ASSERT(pinned_handles.empty());
+	for (auto &block : blocks) {
+		pinned_handles.push_back(buffer_manager.Pin(block.block));
+	}
+	finalized = true;
+}
+
+void JoinHashTable::FinalizeBlocks(idx_t block_start, idx_t block_end, bool parallel) {
+	D_ASSERT(finalized);
+	D_ASSERT(block_end <= pinned_handles.size());
+
 	Vector hashes(LogicalType::HASH);
 	auto hash_data = FlatVector::GetData<hash_t>(hashes);
 	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
 	// now construct the actual hash table; scan the nodes
-	// as we can the nodes we pin all the blocks of the HT and keep them pinned until the HT is destroyed
-	// this is so that we can keep pointers around to the blocks
-	// FIXME: if we cannot keep everything pinned in memory, we could switch to an out-of-memory merge join or so
-	for (auto &block : blocks) {
-		auto handle = buffer_manager.Pin(block.block);
-		data_ptr_t dataptr = handle->node->buffer;
+	for (idx_t block_idx = block_start; block_idx < block_end; block_idx++) {
+		auto &block = blocks[block_idx];
+		data_ptr_t dataptr = pinned_handles[block_idx]->node->buffer;
 		idx_t entry = 0;
 		while (entry < block.count) {
 			// fetch the next vector of entries from the blocks
@@ -408,19 +510,83 @@ void JoinHashTable::Finalize() {
 				key_locations[i] = dataptr;
 				dataptr += entry_size;
 			}
+			if (bloom_filter) {
+				InsertBloomFilter(hash_data, next, parallel);
+			}
 			// now insert into the hash table
-			InsertHashes(hashes, next, key_locations);
+			InsertHashes(hashes, next, key_locations, parallel);
 
 			entry += next;
 		}
-		pinned_handles.push_back(move(handle));
 	}
+}
 
-	finalized = true;
+idx_t JoinHashTable::SizeInBytes() {
+	idx_t capacity = NextPowerOfTwo(MaxValue<idx_t>(count * 2, (Storage::BLOCK_ALLOC_SIZE / sizeof(data_ptr_t)) + 1));
+	idx_t bloom_filter_size = 0;
+	if (count >= BLOOM_FILTER_THRESHOLD) {
+		bloom_filter_size =
+		    NextPowerOfTwo(MaxValue<idx_t>(count / 4, Storage::BLOCK_ALLOC_SIZE / sizeof(uint64_t))) * sizeof(uint64_t);
+	}
+	return blocks.size() * block_capacity * entry_size + capacity * sizeof(data_ptr_t) + bloom_filter_size;
+}
+
+void JoinHashTable::Partition(vector<unique_ptr<JoinHashTable>> &partitions) {
+	D_ASSERT(!finalized);
+	idx_t partition_count = partitions.size();
+	D_ASSERT(partition_count > 0 && (partition_count & (partition_count - 1)) == 0);
+	for (auto &partition : partitions) {
+		D_ASSERT(partition->count == 0 && partition->entry_size == entry_size);
+		partition->has_null = has_null;
+	}
+	// scatter the entries of the blocks into the partitions one block at a time, so only a few blocks are pinned at once
+	vector<vector<data_ptr_t>> partition_entries(partition_count);
+	for (auto &block : blocks) {
+		auto handle = buffer_manager.Pin(block.block);
+		data_ptr_t dataptr = handle->node->buffer;
+		for (idx_t i = 0; i < block.count; i++) {
+			// before finalization the hash of the entry is stored in place of the next pointer
+			auto hash = Load<hash_t>(dataptr + pointer_offset);
+			partition_entries[PartitionIndex(hash, partition_count)].push_back(dataptr);
+			dataptr += entry_size;
+		}
+		for (idx_t partition_idx = 0; partition_idx < partition_count; partition_idx++) {
+			partitions[partition_idx]->AppendEntries(partition_entries[partition_idx]);
+			partition_entries[partition_idx].clear();
+		}
+		// the entries have been copied: release the block
+		handle.reset();
+		block.block.reset();
+	}
+	blocks.clear();
+}
+
+void JoinHashTable::AppendEntries(vector<data_ptr_t> &entries) {
+	idx_t offset = 0;
+	while (offset < entries.size()) {
+		if (blocks.empty() || blocks.back().count == blocks.back().capacity) {
+			// the last block is full: allocate a new block
+			HTDataBlock new_block;
+			new_block.count = 0;
+			new_block.capacity = block_capacity;
+			new_block.block = buffer_manager.RegisterMemory(block_capacity * entry_size, false);
+			blocks.push_back(move(new_block));
+		}
+		auto &block = blocks.back();
+		auto handle = buffer_manager.Pin(block.block);
+		idx_t append_count = MinValue<idx_t>(entries.size() - offset, block.capacity - block.count);
+		auto dataptr = handle->node->buffer + block.count * entry_size;
+		for (idx_t i = 0; i < append_count; i++) {
+			memcpy(dataptr, entries[offset + i], entry_size);
+			dataptr += entry_size;
+		}
+		block.count += append_count;
+		count += append_count;
+		offset += append_count;
+	}
 }
 
 unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
-	D_ASSERT(count > 0); // should be handled before
 	D_ASSERT(finalized);
 
 	// set up the scan structure
@@ -442,6 +608,15 @@ unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
 	Vector hashes(LogicalType::HASH);
 	Hash(keys, *current_sel, ss->count, hashes);
 
+	if (bloom_filter) {
+		// discard the keys that are not contained in the Bloom filter before probing the pointer table
+		ss->count = ProbeBloomFilter(hashes, *current_sel, ss->count, ss->sel_vector);
+		current_sel = &ss->sel_vector;
+		if (ss->count == 0) {
+			return ss;
+		}
+	}
+
 	// now initialize the pointers of the scan structure based on the hashes
 	ApplyBitmask(hashes, *current_sel, ss->count, ss->pointers);
 
@@ -1064,4 +1239,45 @@ void JoinHashTable::ScanFullOuter(DataChunk &result, JoinHTScanState &state) {
 	}
 }
 
+void JoinHashTable::Unpin() {
+	D_ASSERT(finalized);
+	// the construction of the pointer table replaced the hashes in the entries by the next pointers: recompute the
+	// hashes from the keys, so the pointer table can be constructed again when the HT is finalized again
+	DataChunk keys;
+	keys.Initialize(equality_types);
+	Vector hashes(LogicalType::HASH);
+	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
+	for (idx_t block_idx = 0; block_idx < blocks.size(); block_idx++) {
+		auto &block = blocks[block_idx];
+		data_ptr_t dataptr = pinned_handles[block_idx]->node->buffer;
+		idx_t entry = 0;
+		while (entry < block.count) {
+			idx_t next = MinValue<idx_t>(STANDARD_VECTOR_SIZE, block.count - entry);
+			for (idx_t i = 0; i < next; i++) {
+				key_locations[i] = dataptr;
+				dataptr += entry_size;
+			}
+			// gather the equality keys (which are stored at the start of the entries) and hash them
+			keys.Reset();
+			keys.SetCardinality(next);
+			idx_t offset = 0;
+			for (idx_t i = 0; i < equality_types.size(); i++) {
+				GatherResultVector(keys.data[i], FlatVector::IncrementalSelectionVector, (uintptr_t *)key_locations,
+				                   FlatVector::IncrementalSelectionVector, next, offset);
+			}
+			Hash(keys, FlatVector::IncrementalSelectionVector, next, hashes);
+			hashes.Normalify(next);
+			auto hash_data = FlatVector::GetData<hash_t>(hashes);
+			for (idx_t i = 0; i < next; i++) {
+				Store<hash_t>(hash_data[i], key_locations[i] + pointer_offset);
+			}
+			entry += next;
+		}
+	}
+	pinned_handles.clear();
+	hash_map.reset();
+	bloom_filter.reset();
+	finalized = false;
+}
+
 } // namespace duckdb
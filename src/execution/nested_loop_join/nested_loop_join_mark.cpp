@@ -78,12 +78,13 @@ static void mark_join(Vector &left, Vector &right, idx_t lcount, idx_t rcount, b
 	}
 }
 
-void NestedLoopJoinMark::Perform(DataChunk &left, ChunkCollection &right, bool found_match[],
+void NestedLoopJoinMark::Perform(DataChunk &left, BufferedChunkCollection &right, bool found_match[],
                                  vector<JoinCondition> &conditions) {
 	// initialize a new temporary selection vector for the left chunk
 	// loop over all chunks in the RHS
+	DataChunk right_chunk;
 	for (idx_t chunk_idx = 0; chunk_idx < right.ChunkCount(); chunk_idx++) {
-		DataChunk &right_chunk = right.GetChunk(chunk_idx);
+		right.FetchChunk(chunk_idx, right_chunk);
 		for (idx_t i = 0; i < conditions.size(); i++) {
 			mark_join(left.data[i], right_chunk.data[i], left.size(), right_chunk.size(), found_match,
 			          conditions[i].comparison);
@@ -5,6 +5,7 @@
 
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/parallel/task_context.hpp"
 #include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/planner/expression/bound_aggregate_expression.hpp"
 #include "duckdb/planner/expression/bound_constant_expression.hpp"
@@ -179,11 +180,22 @@ void PhysicalHashAggregate::Sink(ExecutionContext &context, GlobalOperatorState
 	                         gstate.lossy_total_groups > radix_limit && gstate.partition_info.n_partitions > 1);
 }
 
+//! The parallel state used to scan the finalized hash tables in parallel: every thread scans entire hash tables
+class HashAggregateParallelState : public ParallelState {
+public:
+	HashAggregateParallelState() : next_ht(0) {
+	}
+
+	//! The index of the next hash table to scan
+	std::atomic<idx_t> next_ht;
+};
+
 class PhysicalHashAggregateState : public PhysicalOperatorState {
 public:
 	PhysicalHashAggregateState(PhysicalOperator &op, vector<LogicalType> &group_types,
 	                           vector<LogicalType> &aggregate_types, PhysicalOperator *child)
-	    : PhysicalOperatorState(op, child), ht_index(0), ht_scan_position(0) {
+	    : PhysicalOperatorState(op, child), ht_index(0), ht_scan_position(0), initialized(false),
+	      parallel_state(nullptr) {
 		auto scan_chunk_types = group_types;
 		for (auto &aggr_type : aggregate_types) {
 			scan_chunk_types.push_back(aggr_type);
@@ -197,6 +209,10 @@ public:
 	//! The current position to scan the HT for output tuples
 	idx_t ht_index;
 	idx_t ht_scan_position;
+	//! Whether or not the scan has been initialized
+	bool initialized;
+	//! The parallel scan state (if any)
+	HashAggregateParallelState *parallel_state;
 };
 
 void PhysicalHashAggregate::Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate) {
@@ -239,8 +255,7 @@ void PhysicalHashAggregate::Combine(ExecutionContext &context, GlobalOperatorSta
 // folds them into the global ht finally.
 class PhysicalHashAggregateFinalizeTask : public Task {
 public:
-	PhysicalHashAggregateFinalizeTask(Pipeline &parent_, HashAggregateGlobalState &state_, idx_t radix_)
-	    : parent(parent_), state(state_), radix(radix_) {
+	PhysicalHashAggregateFinalizeTask(HashAggregateGlobalState &state_, idx_t radix_) : state(state_), radix(radix_) {
 	}
 	static void FinalizeHT(HashAggregateGlobalState &gstate, idx_t radix) {
 		D_ASSERT(gstate.finalized_hts[radix]);
@@ -253,18 +268,11 @@ public:
 		gstate.finalized_hts[radix]->Finalize();
 	}
 
-	void Execute() {
+	void Execute() override {
 		FinalizeHT(state, radix);
-		lock_guard<mutex> glock(state.lock);
-		parent.finished_tasks++;
-		// finish the whole pipeline
-		if (parent.total_tasks == parent.finished_tasks) {
-			parent.Finish();
-		}
 	}
 
 private:
-	Pipeline &parent;
 	HashAggregateGlobalState &state;
 	idx_t radix;
 };
@@ -309,23 +317,24 @@ void PhysicalHashAggregate::FinalizeInternal(ClientContext &context, unique_ptr<
 				pht->Partition();
 			}
 		}
-		// schedule additional tasks to combine the partial HTs
-		if (!immediate) {
-			D_ASSERT(pipeline);
-			pipeline->total_tasks += gstate.partition_info.n_partitions;
-		}
 		gstate.finalized_hts.resize(gstate.partition_info.n_partitions);
 		for (idx_t r = 0; r < gstate.partition_info.n_partitions; r++) {
 			gstate.finalized_hts[r] =
 			    make_unique<GroupedAggregateHashTable>(BufferManager::GetBufferManager(context), group_types,
 			                                           payload_types, bindings, HtEntryType::HT_WIDTH_64);
-			if (immediate) {
+		}
+		if (immediate) {
+			for (idx_t r = 0; r < gstate.partition_info.n_partitions; r++) {
 				PhysicalHashAggregateFinalizeTask::FinalizeHT(gstate, r);
-			} else {
-				D_ASSERT(pipeline);
-				auto new_task = make_unique<PhysicalHashAggregateFinalizeTask>(*pipeline, gstate, r);
-				TaskScheduler::GetScheduler(context).ScheduleTask(pipeline->token, move(new_task));
 			}
+		} else {
+			// schedule additional tasks to combine the partial HTs
+			D_ASSERT(pipeline);
+			vector<unique_ptr<Task>> tasks;
+			for (idx_t r = 0; r < gstate.partition_info.n_partitions; r++) {
+				tasks.push_back(make_unique<PhysicalHashAggregateFinalizeTask>(gstate, r));
+			}
+			pipeline->ScheduleFinalizeTasks(move(tasks));
 		}
 	} else { // in the non-partitioned case we immediately combine all the unpartitioned hts created by the threads.
 		     // TODO possible optimization, if total count < limit for 32 bit ht, use that one
@@ -378,10 +387,19 @@ void PhysicalHashAggregate::GetChunkInternal(ExecutionContext &context, DataChun
 		state.finished = true;
 		return;
 	}
+	if (!state.initialized) {
+		// check if we are scanning the hash tables as part of a parallel scan
+		auto task_info = context.task.task_info.find(this);
+		if (task_info != context.task.task_info.end()) {
+			state.parallel_state = (HashAggregateParallelState *)task_info->second;
+			state.ht_index = state.parallel_state->next_ht++;
+		}
+		state.initialized = true;
+	}
 	idx_t elements_found = 0;
 
 	while (true) {
-		if (state.ht_index == gstate.finalized_hts.size()) {
+		if (state.ht_index >= gstate.finalized_hts.size()) {
 			state.finished = true;
 			return;
 		}
@@ -391,7 +409,12 @@ void PhysicalHashAggregate::GetChunkInternal(ExecutionContext &context, DataChun
 			break;
 		}
 		gstate.finalized_hts[state.ht_index].reset();
-		state.ht_index++;
+		if (state.parallel_state) {
+			// parallel scan: fetch the next hash table that has not been claimed by another thread
+			state.ht_index = state.parallel_state->next_ht++;
+		} else {
+			state.ht_index++;
+		}
 		state.ht_scan_position = 0;
 	}
 
@@ -416,6 +439,22 @@ unique_ptr<PhysicalOperatorState> PhysicalHashAggregate::GetOperatorState() {
 	                                               children.size() == 0 ? nullptr : children[0].get());
 }
 
+idx_t PhysicalHashAggregate::MaxThreads(ClientContext &context) {
+	if (!sink_state) {
+		return 0;
+	}
+	auto &gstate = (HashAggregateGlobalState &)*sink_state;
+	if (gstate.is_empty) {
+		return 0;
+	}
+	// every thread scans one of the (radix-partitioned) finalized hash tables at a time
+	return gstate.finalized_hts.size();
+}
+
+unique_ptr<ParallelState> PhysicalHashAggregate::GetParallelState() {
+	return make_unique<HashAggregateParallelState>();
+}
+
 bool PhysicalHashAggregate::ForceSingleHT(GlobalOperatorState &state) {
 	auto &gstate = (HashAggregateGlobalState &)state;
 
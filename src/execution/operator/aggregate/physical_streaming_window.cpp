@@ -0,0 +1,462 @@
+#include "duckdb/execution/operator/aggregate/physical_streaming_window.hpp"
+
+#include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/window_segment_tree.hpp"
+#include "duckdb/planner/expression/bound_window_expression.hpp"
+
+#include <deque>
+
+using namespace std;
+
+namespace duckdb {
+
+PhysicalStreamingWindow::PhysicalStreamingWindow(vector<LogicalType> types, vector<unique_ptr<Expression>> select_list,
+                                                 PhysicalOperatorType type)
+    : PhysicalOperator(type, move(types)), select_list(move(select_list)) {
+}
+
+//! Evaluates the constant offset of a LAG or of a ROWS frame, returns false if it is not a non-negative constant
+static bool GetConstantOffset(Expression &expr, idx_t &result) {
+	if (!expr.IsFoldable()) {
+		return false;
+	}
+	auto value = ExpressionExecutor::EvaluateScalar(expr);
+	if (value.is_null) {
+		return false;
+	}
+	auto offset = value.GetValue<int64_t>();
+	if (offset < 0) {
+		return false;
+	}
+	result = offset;
+	return true;
+}
+
+//! Computes the offsets of the ROWS frame of a window aggregate relative to the current row, the frame of row r is
+//! [r - start_offset, r - end_offset]. Returns false if the frame is not a ROWS frame that ends at or before the
+//! current row, in which case the aggregate cannot be computed while streaming.
+static bool GetFrameOffsets(BoundWindowExpression &wexpr, idx_t &start_offset, idx_t &end_offset) {
+	switch (wexpr.end) {
+	case WindowBoundary::CURRENT_ROW_ROWS:
+		end_offset = 0;
+		break;
+	case WindowBoundary::EXPR_PRECEDING:
+		if (!GetConstantOffset(*wexpr.end_expr, end_offset)) {
+			return false;
+		}
+		break;
+	default:
+		return false;
+	}
+	switch (wexpr.start) {
+	case WindowBoundary::UNBOUNDED_PRECEDING:
+		// the running state of an unbounded frame can only be kept if the frame ends at the current row
+		start_offset = INVALID_INDEX;
+		return end_offset == 0;
+	case WindowBoundary::CURRENT_ROW_ROWS:
+		start_offset = 0;
+		break;
+	case WindowBoundary::EXPR_PRECEDING:
+		if (!GetConstantOffset(*wexpr.start_expr, start_offset)) {
+			return false;
+		}
+		break;
+	default:
+		return false;
+	}
+	return end_offset <= start_offset;
+}
+
+bool PhysicalStreamingWindow::IsStreamingFunction(BoundWindowExpression &wexpr) {
+	switch (wexpr.type) {
+	case ExpressionType::WINDOW_ROW_NUMBER:
+	case ExpressionType::WINDOW_RANK:
+	case ExpressionType::WINDOW_RANK_DENSE:
+		return true;
+	case ExpressionType::WINDOW_LAG: {
+		idx_t offset;
+		if (wexpr.offset_expr && !GetConstantOffset(*wexpr.offset_expr, offset)) {
+			return false;
+		}
+		return !wexpr.default_expr || wexpr.default_expr->IsFoldable();
+	}
+	case ExpressionType::WINDOW_FIRST_VALUE:
+		// the frame starts at the start of the partition and always contains the current row
+		return wexpr.start == WindowBoundary::UNBOUNDED_PRECEDING &&
+		       (wexpr.end == WindowBoundary::CURRENT_ROW_ROWS || wexpr.end == WindowBoundary::CURRENT_ROW_RANGE ||
+		        wexpr.end == WindowBoundary::UNBOUNDED_FOLLOWING);
+	case ExpressionType::WINDOW_LAST_VALUE:
+		// the frame ends at the current row and always contains it
+		return wexpr.end == WindowBoundary::CURRENT_ROW_ROWS && wexpr.start != WindowBoundary::EXPR_FOLLOWING;
+	case ExpressionType::WINDOW_AGGREGATE: {
+		idx_t start_offset, end_offset;
+		return wexpr.aggregate->combine && GetFrameOffsets(wexpr, start_offset, end_offset);
+	}
+	default:
+		return false;
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// GetChunkInternal
+//===--------------------------------------------------------------------===//
+static bool KeysAreEqual(vector<Value> &a, vector<Value> &b, idx_t start, idx_t end) {
+	for (idx_t i = start; i < end; i++) {
+		if (a[i] != b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Copies the rows [start, end) of the source collection into the target collection
+static void CopyRows(ChunkCollection &source, idx_t start, idx_t end, ChunkCollection &target) {
+	auto types = source.Types();
+	while (start < end) {
+		auto &chunk = source.GetChunkForRow(start);
+		idx_t offset = start % STANDARD_VECTOR_SIZE;
+		idx_t count = MinValue<idx_t>(chunk.size() - offset, end - start);
+		DataChunk rows;
+		rows.InitializeEmpty(types);
+		for (idx_t col_idx = 0; col_idx < chunk.ColumnCount(); col_idx++) {
+			rows.data[col_idx].Slice(chunk.data[col_idx], offset);
+		}
+		rows.SetCardinality(count);
+		target.Append(rows);
+		start += count;
+	}
+}
+
+//! The state of a single window expression, holds everything that is carried over from one input chunk to the next
+class StreamingWindowExpressionState {
+public:
+	explicit StreamingWindowExpressionState(BoundWindowExpression &wexpr)
+	    : wexpr(wexpr), key_count(wexpr.partitions.size() + wexpr.orders.size()), has_previous_row(false),
+	      row_number(0), dense_rank(1), rank(1), rank_equal(0), offset(1), start_offset(0), end_offset(0),
+	      running_state_initialized(false), running_state_pointers(LogicalType::POINTER),
+	      row_state_pointers(LogicalType::POINTER) {
+		if (key_count > 0) {
+			vector<LogicalType> key_types;
+			for (auto &pexpr : wexpr.partitions) {
+				key_types.push_back(pexpr->return_type);
+				key_executor.AddExpression(*pexpr);
+			}
+			for (auto &order : wexpr.orders) {
+				key_types.push_back(order.expression->return_type);
+				key_executor.AddExpression(*order.expression);
+			}
+			keys.Initialize(key_types);
+		}
+		if (!wexpr.children.empty()) {
+			vector<LogicalType> payload_types;
+			for (auto &child : wexpr.children) {
+				payload_types.push_back(child->return_type);
+				payload_executor.AddExpression(*child);
+			}
+			payload.Initialize(payload_types);
+			row_payload.InitializeEmpty(payload_types);
+		}
+		switch (wexpr.type) {
+		case ExpressionType::WINDOW_LAG:
+			if (wexpr.offset_expr) {
+				GetConstantOffset(*wexpr.offset_expr, offset);
+			}
+			default_value = Value(wexpr.return_type);
+			if (wexpr.default_expr) {
+				default_value = ExpressionExecutor::EvaluateScalar(*wexpr.default_expr).CastAs(wexpr.return_type);
+			}
+			break;
+		case ExpressionType::WINDOW_AGGREGATE:
+			GetFrameOffsets(wexpr, start_offset, end_offset);
+			if (start_offset == INVALID_INDEX) {
+				running_state = unique_ptr<data_t[]>(new data_t[wexpr.aggregate->state_size()]);
+				row_states = unique_ptr<data_t[]>(new data_t[wexpr.aggregate->state_size() * STANDARD_VECTOR_SIZE]);
+				FlatVector::GetData<data_ptr_t>(running_state_pointers)[0] = running_state.get();
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	~StreamingWindowExpressionState() {
+		if (running_state_initialized) {
+			DestroyRunningState();
+		}
+	}
+
+	void Compute(DataChunk &input, Vector &result);
+
+private:
+	void ComputeRunningAggregate(idx_t count, Vector &result);
+	void ComputeFrameAggregate(idx_t count, Vector &result);
+	void DestroyRunningState() {
+		if (wexpr.aggregate->destructor) {
+			wexpr.aggregate->destructor(running_state_pointers, 1);
+		}
+	}
+
+	BoundWindowExpression &wexpr;
+	//! The amount of PARTITION BY and ORDER BY expressions
+	idx_t key_count;
+	//! Computes the PARTITION BY and ORDER BY keys of the input
+	ExpressionExecutor key_executor;
+	DataChunk keys;
+	//! Computes the arguments of the window function
+	ExpressionExecutor payload_executor;
+	DataChunk payload;
+	DataChunk row_payload;
+	//! The keys of the previous row
+	vector<Value> row_prev;
+	bool has_previous_row;
+	//! For every row of the current chunk, whether or not it starts a new partition, and its index within the partition
+	bool new_partition[STANDARD_VECTOR_SIZE];
+	idx_t partition_row[STANDARD_VECTOR_SIZE];
+
+	//! The amount of rows of the current partition that have been seen
+	idx_t row_number;
+	uint64_t dense_rank, rank, rank_equal;
+	//! FIRST_VALUE: the first value of the current partition
+	Value first_value;
+	//! LAG: the offset and the default value, and the last [offset] values of the current partition
+	idx_t offset;
+	Value default_value;
+	std::deque<Value> previous_values;
+	//! Aggregates: the frame offsets of the ROWS frame, start_offset is INVALID_INDEX for UNBOUNDED PRECEDING
+	idx_t start_offset;
+	idx_t end_offset;
+	//! UNBOUNDED PRECEDING: the state of the aggregate over the current partition so far, and the states of the rows of
+	//! the current chunk
+	unique_ptr<data_t[]> running_state;
+	bool running_state_initialized;
+	unique_ptr<data_t[]> row_states;
+	Vector running_state_pointers;
+	Vector row_state_pointers;
+	//! N PRECEDING: the arguments of the last rows of the current partition that can still be in the frame of the next
+	//! rows
+	ChunkCollection frame_rows;
+};
+
+void StreamingWindowExpressionState::Compute(DataChunk &input, Vector &result) {
+	idx_t count = input.size();
+	if (key_count > 0) {
+		keys.Reset();
+		key_executor.Execute(input, keys);
+	}
+	if (payload.ColumnCount() > 0) {
+		payload.Reset();
+		payload_executor.Execute(input, payload);
+		payload.Normalify();
+	}
+	// figure out where the partitions start and compute the ranking functions
+	bool needs_rank = wexpr.type == ExpressionType::WINDOW_RANK || wexpr.type == ExpressionType::WINDOW_RANK_DENSE;
+	for (idx_t i = 0; i < count; i++) {
+		bool is_same_partition = has_previous_row;
+		bool is_peer = has_previous_row;
+		if (key_count > 0) {
+			vector<Value> row_cur;
+			for (idx_t col_idx = 0; col_idx < key_count; col_idx++) {
+				row_cur.push_back(keys.GetValue(col_idx, i));
+			}
+			if (has_previous_row) {
+				is_same_partition = KeysAreEqual(row_prev, row_cur, 0, wexpr.partitions.size());
+				is_peer = is_same_partition && KeysAreEqual(row_prev, row_cur, wexpr.partitions.size(), key_count);
+			}
+			row_prev = move(row_cur);
+		}
+		has_previous_row = true;
+		new_partition[i] = !is_same_partition;
+		if (!is_same_partition) {
+			row_number = 0;
+			dense_rank = 1;
+			rank = 1;
+			rank_equal = 0;
+		} else if (!is_peer) {
+			dense_rank++;
+			rank += rank_equal;
+			rank_equal = 0;
+		}
+		rank_equal++;
+		partition_row[i] = row_number++;
+		if (needs_rank || wexpr.type == ExpressionType::WINDOW_ROW_NUMBER) {
+			auto value = wexpr.type == ExpressionType::WINDOW_ROW_NUMBER
+			                 ? row_number
+			                 : (wexpr.type == ExpressionType::WINDOW_RANK ? rank : dense_rank);
+			result.SetValue(i, Value::Numeric(wexpr.return_type, value));
+		}
+	}
+
+	switch (wexpr.type) {
+	case ExpressionType::WINDOW_LAG: {
+		for (idx_t i = 0; i < count; i++) {
+			if (new_partition[i]) {
+				previous_values.clear();
+			}
+			auto current = payload.GetValue(0, i);
+			if (offset == 0) {
+				result.SetValue(i, current);
+				continue;
+			}
+			result.SetValue(i, previous_values.size() == offset ? previous_values.front() : default_value);
+			previous_values.push_back(move(current));
+			if (previous_values.size() > offset) {
+				previous_values.pop_front();
+			}
+		}
+		break;
+	}
+	case ExpressionType::WINDOW_FIRST_VALUE:
+		for (idx_t i = 0; i < count; i++) {
+			if (new_partition[i]) {
+				first_value = payload.GetValue(0, i);
+			}
+			result.SetValue(i, first_value);
+		}
+		break;
+	case ExpressionType::WINDOW_LAST_VALUE:
+		for (idx_t i = 0; i < count; i++) {
+			result.SetValue(i, payload.GetValue(0, i));
+		}
+		break;
+	case ExpressionType::WINDOW_AGGREGATE:
+		if (start_offset == INVALID_INDEX) {
+			ComputeRunningAggregate(count, result);
+		} else {
+			ComputeFrameAggregate(count, result);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void StreamingWindowExpressionState::ComputeRunningAggregate(idx_t count, Vector &result) {
+	auto &aggregate = *wexpr.aggregate;
+	if (payload.ColumnCount() == 0) {
+		// no arguments: the aggregate counts the rows of the partition so far
+		for (idx_t i = 0; i < count; i++) {
+			result.SetValue(i, Value::Numeric(wexpr.return_type, partition_row[i] + 1));
+		}
+		return;
+	}
+	auto state_size = aggregate.state_size();
+	Vector row_states_vector(LogicalType::POINTER);
+	auto row_state_data = FlatVector::GetData<data_ptr_t>(row_states_vector);
+	for (idx_t i = 0; i < count; i++) {
+		if (new_partition[i]) {
+			// a new partition starts: reset the running state
+			if (running_state_initialized) {
+				DestroyRunningState();
+			}
+			aggregate.initialize(running_state.get());
+			running_state_initialized = true;
+		}
+		// add the row to the running state
+		for (idx_t col_idx = 0; col_idx < payload.ColumnCount(); col_idx++) {
+			row_payload.data[col_idx].Slice(payload.data[col_idx], i);
+		}
+		row_payload.SetCardinality(1);
+		aggregate.update(&row_payload.data[0], row_payload.ColumnCount(), running_state_pointers, 1);
+		// the result of the row is computed from a copy of the running state
+		row_state_data[i] = row_states.get() + i * state_size;
+		aggregate.initialize(row_state_data[i]);
+		FlatVector::GetData<data_ptr_t>(row_state_pointers)[0] = row_state_data[i];
+		aggregate.combine(running_state_pointers, row_state_pointers, 1);
+	}
+	aggregate.finalize(row_states_vector, wexpr.bind_info.get(), result, count);
+	if (aggregate.destructor) {
+		aggregate.destructor(row_states_vector, count);
+	}
+}
+
+void StreamingWindowExpressionState::ComputeFrameAggregate(idx_t count, Vector &result) {
+	if (payload.ColumnCount() == 0) {
+		// no arguments: the aggregate counts the rows in the frame
+		for (idx_t i = 0; i < count; i++) {
+			idx_t row_idx = partition_row[i];
+			idx_t frame_start = row_idx > start_offset ? row_idx - start_offset : 0;
+			idx_t frame_end = row_idx + 1 > end_offset ? row_idx + 1 - end_offset : 0;
+			if (frame_start >= frame_end) {
+				result.SetValue(i, Value());
+			} else {
+				result.SetValue(i, Value::Numeric(wexpr.return_type, frame_end - frame_start));
+			}
+		}
+		return;
+	}
+	// the frames of the rows of this chunk are computed over the rows kept from the previous chunks followed by the
+	// rows of this chunk
+	ChunkCollection frame;
+	frame.Append(frame_rows);
+	frame.Append(payload);
+	WindowSegmentTree segment_tree(*wexpr.aggregate, wexpr.bind_info.get(), wexpr.return_type, &frame);
+	idx_t previous_rows = frame_rows.Count();
+	idx_t partition_start = 0;
+	for (idx_t i = 0; i < count; i++) {
+		idx_t row_idx = previous_rows + i;
+		if (new_partition[i]) {
+			partition_start = row_idx;
+		}
+		idx_t frame_start = MaxValue<idx_t>(partition_start, row_idx > start_offset ? row_idx - start_offset : 0);
+		idx_t frame_end = row_idx + 1 > end_offset ? row_idx + 1 - end_offset : 0;
+		if (frame_start >= frame_end) {
+			result.SetValue(i, Value());
+		} else {
+			result.SetValue(i, segment_tree.Compute(frame_start, frame_end));
+		}
+	}
+	// keep the rows of the current partition that can be in the frame of the next rows
+	frame_rows.Reset();
+	idx_t total_rows = frame.Count();
+	idx_t keep_start = MaxValue<idx_t>(partition_start, total_rows > start_offset ? total_rows - start_offset : 0);
+	CopyRows(frame, keep_start, total_rows, frame_rows);
+}
+
+class PhysicalStreamingWindowOperatorState : public PhysicalOperatorState {
+public:
+	PhysicalStreamingWindowOperatorState(PhysicalStreamingWindow &op, PhysicalOperator *child)
+	    : PhysicalOperatorState(op, child) {
+		for (auto &expr : op.select_list) {
+			D_ASSERT(expr->GetExpressionClass() == ExpressionClass::BOUND_WINDOW);
+			expressions.push_back(make_unique<StreamingWindowExpressionState>((BoundWindowExpression &)*expr));
+		}
+	}
+
+	vector<unique_ptr<StreamingWindowExpressionState>> expressions;
+};
+
+void PhysicalStreamingWindow::GetChunkInternal(ExecutionContext &context, DataChunk &chunk,
+                                               PhysicalOperatorState *state_p) {
+	auto &state = (PhysicalStreamingWindowOperatorState &)*state_p;
+	children[0]->GetChunk(context, state.child_chunk, state.child_state.get());
+	auto &input = state.child_chunk;
+	if (input.size() == 0) {
+		return;
+	}
+	// the window results are appended to the columns of the input
+	idx_t column_count = input.ColumnCount();
+	for (idx_t col_idx = 0; col_idx < column_count; col_idx++) {
+		chunk.data[col_idx].Reference(input.data[col_idx]);
+	}
+	for (idx_t expr_idx = 0; expr_idx < state.expressions.size(); expr_idx++) {
+		state.expressions[expr_idx]->Compute(input, chunk.data[column_count + expr_idx]);
+	}
+	chunk.SetCardinality(input);
+}
+
+unique_ptr<PhysicalOperatorState> PhysicalStreamingWindow::GetOperatorState() {
+	return make_unique<PhysicalStreamingWindowOperatorState>(*this, children[0].get());
+}
+
+string PhysicalStreamingWindow::ParamsToString() const {
+	string result;
+	for (idx_t i = 0; i < select_list.size(); i++) {
+		if (i > 0) {
+			result += "\n";
+		}
+		result += select_list[i]->GetName();
+	}
+	return result;
+}
+
+} // namespace duckdb
@@ -2,8 +2,11 @@
 
 #include "duckdb/common/types/chunk_collection.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/execution/buffered_chunk_collection.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/execution/window_segment_tree.hpp"
+#include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/planner/expression/bound_reference_expression.hpp"
 #include "duckdb/planner/expression/bound_window_expression.hpp"
 
@@ -13,40 +16,140 @@ using namespace std;
 
 namespace duckdb {
 
+//! A hash partition of the input of the window. All rows with the same PARTITION BY keys are in the same hash partition,
+//! so the window expressions can be computed for every hash partition independently. The rows of a partition are kept
+//! in buffer-managed collections, which are read one chunk at a time. Only the expressions that the windows are
+//! computed over and the window results are materialized in memory.
+class WindowHashPartition {
+public:
+	WindowHashPartition(BufferManager &buffer_manager, vector<LogicalType> input_types,
+	                    vector<LogicalType> output_types)
+	    : rows(buffer_manager, move(input_types)), output(buffer_manager, move(output_types)) {
+	}
+
+	//! The input rows of the partition
+	BufferedChunkCollection rows;
+	//! The input rows followed by the results of the window expressions, in their final order
+	BufferedChunkCollection output;
+	//! The results of the window expressions while they are computed
+	ChunkCollection window_results;
+	std::mutex lock;
+	//! The amount of sort groups that are being computed
+	idx_t active_groups = 0;
+	//! The amount of sort groups that have been computed
+	idx_t computed_groups = 0;
+	//! The highest index of the window expressions that sorted the rows of this partition (if any)
+	idx_t final_order_idx = INVALID_INDEX;
+	//! The row order of the window expressions with the highest index that sorted the rows; the rows of the partition
+	//! are emitted in this order
+	unique_ptr<idx_t[]> final_order;
+};
+
 class WindowGlobalState : public GlobalOperatorState {
 public:
-	WindowGlobalState(PhysicalWindow &_op, ClientContext &context) : op(_op) {
+	WindowGlobalState(PhysicalWindow &_op, BufferManager &buffer_manager, idx_t partition_count, idx_t thread_count)
+	    : op(_op) {
+		// the partitions that are finished at the same time share a quarter of the memory limit for reordering rows
+		reorder_memory = buffer_manager.GetMaxMemory() / 4 / thread_count;
+		for (idx_t i = 0; i < partition_count; i++) {
+			auto partition = make_unique<WindowHashPartition>(buffer_manager, op.children[0]->GetTypes(), op.types);
+			partitions.push_back(move(partition));
+		}
 	}
 
 	PhysicalWindow &op;
 	std::mutex lock;
-	ChunkCollection chunks;
-	ChunkCollection window_results;
+	//! The hash partitions of the input, there is a single partition if the input is not hash-partitioned
+	vector<unique_ptr<WindowHashPartition>> partitions;
+	//! The amount of memory that may be used to bring the rows of a partition in their final order
+	idx_t reorder_memory;
 };
 
 class WindowLocalState : public LocalSinkState {
 public:
-	WindowLocalState(PhysicalWindow &_op) : op(_op) {
+	WindowLocalState(PhysicalWindow &_op, idx_t partition_count) : op(_op) {
+		for (idx_t i = 0; i < partition_count; i++) {
+			partitions.push_back(make_unique<ChunkCollection>());
+		}
 	}
 
 	PhysicalWindow &op;
-	ChunkCollection chunks;
+	//! The rows of every hash partition that were sunk by this thread
+	vector<unique_ptr<ChunkCollection>> partitions;
+	//! Only used when hash-partitioning: computes the partition keys of the input
+	ExpressionExecutor partition_executor;
+	DataChunk partition_keys;
+	//! Only used when hash-partitioning: the input rows of a single hash partition
+	DataChunk partition_chunk;
 };
 
 //! The operator state of the window
 class PhysicalWindowOperatorState : public PhysicalOperatorState {
 public:
 	PhysicalWindowOperatorState(PhysicalOperator &op, PhysicalOperator *child)
-	    : PhysicalOperatorState(op, child), position(0) {
+	    : PhysicalOperatorState(op, child), partition_idx(0), position(0) {
 	}
 
+	//! The hash partition that is currently emitted
+	idx_t partition_idx;
+	//! The chunk within the hash partition that is emitted next
 	idx_t position;
+	//! The chunk fetched from the hash partition
+	DataChunk output_chunk;
 };
 
+//! Returns whether or not two window expressions are computed over the same sort of the input, i.e. whether they have
+//! the same PARTITION BY and ORDER BY clauses
+static bool HasSameSort(BoundWindowExpression &a, BoundWindowExpression &b) {
+	if (a.partitions.size() != b.partitions.size() || a.orders.size() != b.orders.size()) {
+		return false;
+	}
+	for (idx_t i = 0; i < a.partitions.size(); i++) {
+		if (!Expression::Equals(a.partitions[i].get(), b.partitions[i].get())) {
+			return false;
+		}
+	}
+	for (idx_t i = 0; i < a.orders.size(); i++) {
+		if (a.orders[i].type != b.orders[i].type || a.orders[i].null_order != b.orders[i].null_order ||
+		    !Expression::Equals(a.orders[i].expression.get(), b.orders[i].expression.get())) {
+			return false;
+		}
+	}
+	return true;
+}
+
 // this implements a sorted window functions variant
 PhysicalWindow::PhysicalWindow(vector<LogicalType> types, vector<unique_ptr<Expression>> select_list,
                                PhysicalOperatorType type)
-    : PhysicalSink(type, move(types)), select_list(move(select_list)) {
+    : PhysicalSink(type, move(types)), select_list(move(select_list)), is_partitioned(true) {
+	// group the window expressions that share the same sort
+	for (idx_t expr_idx = 0; expr_idx < this->select_list.size(); expr_idx++) {
+		D_ASSERT(this->select_list[expr_idx]->GetExpressionClass() == ExpressionClass::BOUND_WINDOW);
+		auto wexpr = reinterpret_cast<BoundWindowExpression *>(this->select_list[expr_idx].get());
+		bool found_group = false;
+		for (auto &sort_group : sort_groups) {
+			auto &group_expr = (BoundWindowExpression &)*this->select_list[sort_group[0]];
+			if (HasSameSort(*wexpr, group_expr)) {
+				sort_group.push_back(expr_idx);
+				found_group = true;
+				break;
+			}
+		}
+		if (!found_group) {
+			sort_groups.push_back(vector<idx_t>({expr_idx}));
+		}
+		// the input can only be hash-partitioned if all window expressions have the same PARTITION BY clause
+		auto &first_expr = (BoundWindowExpression &)*this->select_list[0];
+		if (wexpr->partitions.empty() || wexpr->partitions.size() != first_expr.partitions.size()) {
+			is_partitioned = false;
+			continue;
+		}
+		for (idx_t i = 0; i < wexpr->partitions.size(); i++) {
+			if (!Expression::Equals(wexpr->partitions[i].get(), first_expr.partitions[i].get())) {
+				is_partitioned = false;
+			}
+		}
+	}
 }
 
 static bool EqualsSubset(vector<Value> &a, vector<Value> &b, idx_t start, idx_t end) {
@@ -81,8 +184,8 @@ static idx_t BinarySearchRightmost(ChunkCollection &input, vector<Value> row, id
 	return l - 1;
 }
 
-static void MaterializeExpressions(Expression **exprs, idx_t expr_count, ChunkCollection &input,
-                                   ChunkCollection &output, bool scalar = false) {
+static void MaterializeExpressions(Expression **exprs, idx_t expr_count, BufferedChunkCollection &input,
+                                   ChunkCollection &output, idx_t sorted_vector[], bool scalar = false) {
 	if (expr_count == 0) {
 		return;
 	}
@@ -94,11 +197,13 @@ static void MaterializeExpressions(Expression **exprs, idx_t expr_count, ChunkCo
 		executor.AddExpression(*exprs[expr_idx]);
 	}
 
+	DataChunk input_chunk;
 	for (idx_t i = 0; i < input.ChunkCount(); i++) {
 		DataChunk chunk;
 		chunk.Initialize(types);
 
-		executor.Execute(input.GetChunk(i), chunk);
+		input.FetchChunk(i, input_chunk);
+		executor.Execute(input_chunk, chunk);
 
 		chunk.Verify();
 		output.Append(chunk);
@@ -107,15 +212,21 @@ static void MaterializeExpressions(Expression **exprs, idx_t expr_count, ChunkCo
 			break;
 		}
 	}
+	if (sorted_vector && !scalar) {
+		// bring the materialized expressions in the sort order of the window
+		output.Reorder(sorted_vector);
+	}
 }
 
-static void MaterializeExpression(Expression *expr, ChunkCollection &input, ChunkCollection &output,
-                                  bool scalar = false) {
-	MaterializeExpressions(&expr, 1, input, output, scalar);
+static void MaterializeExpression(Expression *expr, BufferedChunkCollection &input, ChunkCollection &output,
+                                  idx_t sorted_vector[], bool scalar = false) {
+	MaterializeExpressions(&expr, 1, input, output, sorted_vector, scalar);
 }
 
-static void SortCollectionForWindow(BoundWindowExpression *wexpr, ChunkCollection &input, ChunkCollection &output,
-                                    ChunkCollection &sort_collection) {
+//! Computes the sort order of the window, and the sorted partition and order expressions. The input itself is not
+//! reordered, so that multiple window expressions can be computed over the same input concurrently.
+static void SortCollectionForWindow(BoundWindowExpression *wexpr, BufferedChunkCollection &input,
+                                    ChunkCollection &sort_collection, idx_t sorted_vector[]) {
 	vector<LogicalType> sort_types;
 	vector<OrderType> orders;
 	vector<OrderByNullType> null_order_types;
@@ -141,11 +252,13 @@ static void SortCollectionForWindow(BoundWindowExpression *wexpr, ChunkCollectio
 	D_ASSERT(sort_types.size() > 0);
 
 	// create a chunkcollection for the results of the expressions in the window definitions
+	DataChunk input_chunk;
 	for (idx_t i = 0; i < input.ChunkCount(); i++) {
 		DataChunk sort_chunk;
 		sort_chunk.Initialize(sort_types);
 
-		executor.Execute(input.GetChunk(i), sort_chunk);
+		input.FetchChunk(i, input_chunk);
+		executor.Execute(input_chunk, sort_chunk);
 
 		sort_chunk.Verify();
 		sort_collection.Append(sort_chunk);
@@ -153,12 +266,8 @@ static void SortCollectionForWindow(BoundWindowExpression *wexpr, ChunkCollectio
 
 	D_ASSERT(input.Count() == sort_collection.Count());
 
-	auto sorted_vector = unique_ptr<idx_t[]>(new idx_t[input.Count()]);
-	sort_collection.Sort(orders, null_order_types, sorted_vector.get());
-
-	input.Reorder(sorted_vector.get());
-	output.Reorder(sorted_vector.get());
-	sort_collection.Reorder(sorted_vector.get());
+	sort_collection.Sort(orders, null_order_types, sorted_vector);
+	sort_collection.Reorder(sorted_vector);
 }
 
 struct WindowBoundariesState {
@@ -286,6 +395,9 @@ static void UpdateWindowBoundaries(BoundWindowExpression *wexpr, ChunkCollection
 	if (bounds.window_start < (int64_t)bounds.partition_start) {
 		bounds.window_start = bounds.partition_start;
 	}
+	if (bounds.window_end < (int64_t)bounds.partition_start) {
+		bounds.window_end = bounds.partition_start;
+	}
 	if ((idx_t)bounds.window_end > bounds.partition_end) {
 		bounds.window_end = bounds.partition_end;
 	}
@@ -295,16 +407,15 @@ static void UpdateWindowBoundaries(BoundWindowExpression *wexpr, ChunkCollection
 	}
 }
 
-static void ComputeWindowExpression(BoundWindowExpression *wexpr, ChunkCollection &input, ChunkCollection &output,
+//! Computes the window expression over the input and writes the results into the output_idx column of the output.
+//! The results are written in the original row order of the input. If the window requires sorting, sort_collection
+//! holds the sorted partition and order expressions and order the sort order of the input (as computed by
+//! SortCollectionForWindow), which can be shared by all window expressions with the same sort.
+static void ComputeWindowExpression(BoundWindowExpression *wexpr, BufferedChunkCollection &input,
+                                    ChunkCollection &sort_collection, idx_t order[], ChunkCollection &output,
                                     idx_t output_idx) {
-
-	ChunkCollection sort_collection;
 	bool needs_sorting = wexpr->partitions.size() + wexpr->orders.size() > 0;
-	if (needs_sorting) {
-		SortCollectionForWindow(wexpr, input, output, sort_collection);
-	}
-
-	// TODO we could evaluate those expressions in parallel
+	D_ASSERT(needs_sorting == (order != nullptr));
 
 	// evaluate inner expressions of window functions, could be more complex
 	ChunkCollection payload_collection;
@@ -313,17 +424,17 @@ static void ComputeWindowExpression(BoundWindowExpression *wexpr, ChunkCollectio
 		exprs.push_back(child.get());
 	}
 	// TODO: child may be a scalar, don't need to materialize the whole collection then
-	MaterializeExpressions(exprs.data(), exprs.size(), input, payload_collection);
+	MaterializeExpressions(exprs.data(), exprs.size(), input, payload_collection, order);
 
 	ChunkCollection leadlag_offset_collection;
 	ChunkCollection leadlag_default_collection;
 	if (wexpr->type == ExpressionType::WINDOW_LEAD || wexpr->type == ExpressionType::WINDOW_LAG) {
 		if (wexpr->offset_expr) {
-			MaterializeExpression(wexpr->offset_expr.get(), input, leadlag_offset_collection,
+			MaterializeExpression(wexpr->offset_expr.get(), input, leadlag_offset_collection, order,
 			                      wexpr->offset_expr->IsScalar());
 		}
 		if (wexpr->default_expr) {
-			MaterializeExpression(wexpr->default_expr.get(), input, leadlag_default_collection,
+			MaterializeExpression(wexpr->default_expr.get(), input, leadlag_default_collection, order,
 			                      wexpr->default_expr->IsScalar());
 		}
 	}
@@ -332,12 +443,14 @@ static void ComputeWindowExpression(BoundWindowExpression *wexpr, ChunkCollectio
 	ChunkCollection boundary_start_collection;
 	if (wexpr->start_expr &&
 	    (wexpr->start == WindowBoundary::EXPR_PRECEDING || wexpr->start == WindowBoundary::EXPR_FOLLOWING)) {
-		MaterializeExpression(wexpr->start_expr.get(), input, boundary_start_collection, wexpr->start_expr->IsScalar());
+		MaterializeExpression(wexpr->start_expr.get(), input, boundary_start_collection, order,
+		                      wexpr->start_expr->IsScalar());
 	}
 	ChunkCollection boundary_end_collection;
 	if (wexpr->end_expr &&
 	    (wexpr->end == WindowBoundary::EXPR_PRECEDING || wexpr->end == WindowBoundary::EXPR_FOLLOWING)) {
-		MaterializeExpression(wexpr->end_expr.get(), input, boundary_end_collection, wexpr->end_expr->IsScalar());
+		MaterializeExpression(wexpr->end_expr.get(), input, boundary_end_collection, order,
+		                      wexpr->end_expr->IsScalar());
 	}
 
 	// build a segment tree for frame-adhering aggregates
@@ -378,7 +491,7 @@ static void ComputeWindowExpression(BoundWindowExpression *wexpr, ChunkCollectio
 
 		// if no values are read for window, result is NULL
 		if (bounds.window_start >= bounds.window_end) {
-			output.SetValue(output_idx, row_idx, res);
+			output.SetValue(output_idx, order ? order[row_idx] : row_idx, res);
 			continue;
 		}
 
@@ -485,7 +598,7 @@ static void ComputeWindowExpression(BoundWindowExpression *wexpr, ChunkCollectio
 			throw NotImplementedException("Window aggregate type %s", ExpressionTypeToString(wexpr->type));
 		}
 
-		output.SetValue(output_idx, row_idx, res);
+		output.SetValue(output_idx, order ? order[row_idx] : row_idx, res);
 	}
 }
 
@@ -494,96 +607,285 @@ void PhysicalWindow::GetChunkInternal(ExecutionContext &context, DataChunk &chun
 
 	auto &gstate = (WindowGlobalState &)*sink_state;
 
-	ChunkCollection &big_data = gstate.chunks;
-	ChunkCollection &window_results = gstate.window_results;
-
-	if (big_data.Count() == 0) {
-		return;
+	// find the next hash partition that has rows left
+	while (state->partition_idx < gstate.partitions.size() &&
+	       state->position >= gstate.partitions[state->partition_idx]->output.ChunkCount()) {
+		state->partition_idx++;
+		state->position = 0;
 	}
-
-	if (state->position >= big_data.Count()) {
+	if (state->partition_idx >= gstate.partitions.size()) {
 		return;
 	}
+	auto &partition = *gstate.partitions[state->partition_idx];
 
-	// just return what was computed before, appending the result cols of the window expressions at the end
-	auto &proj_ch = big_data.GetChunkForRow(state->position);
-	auto &wind_ch = window_results.GetChunkForRow(state->position);
-
-	idx_t out_idx = 0;
-	D_ASSERT(proj_ch.size() == wind_ch.size());
-	chunk.SetCardinality(proj_ch);
-	for (idx_t col_idx = 0; col_idx < proj_ch.ColumnCount(); col_idx++) {
-		chunk.data[out_idx++].Reference(proj_ch.data[col_idx]);
-	}
-	for (idx_t col_idx = 0; col_idx < wind_ch.ColumnCount(); col_idx++) {
-		chunk.data[out_idx++].Reference(wind_ch.data[col_idx]);
-	}
-	state->position += STANDARD_VECTOR_SIZE;
+	// just return what was computed before: the input columns followed by the results of the window expressions
+	partition.output.FetchChunk(state->position, state->output_chunk);
+	chunk.Reference(state->output_chunk);
+	state->position++;
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalWindow::GetOperatorState() {
 	return make_unique<PhysicalWindowOperatorState>(*this, children[0].get());
 }
 
+//! Moves the rows of a thread-local partition into the global partition
+static void FlushLocalPartition(WindowHashPartition &partition, ChunkCollection &local) {
+	lock_guard<mutex> plock(partition.lock);
+	for (idx_t chunk_idx = 0; chunk_idx < local.ChunkCount(); chunk_idx++) {
+		partition.rows.Append(local.GetChunk(chunk_idx));
+	}
+	local.Reset();
+}
+
 void PhysicalWindow::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_,
                           DataChunk &input) {
+	auto &gstate = (WindowGlobalState &)state;
 	auto &lstate = (WindowLocalState &)lstate_;
-	lstate.chunks.Append(input);
+	idx_t partition_count = lstate.partitions.size();
+	if (partition_count == 1) {
+		lstate.partitions[0]->Append(input);
+		if (lstate.partitions[0]->Count() >= LOCAL_PARTITION_THRESHOLD) {
+			FlushLocalPartition(*gstate.partitions[0], *lstate.partitions[0]);
+		}
+		return;
+	}
+	// hash the PARTITION BY keys to figure out the hash partition of every row
+	lstate.partition_keys.Reset();
+	lstate.partition_executor.Execute(input, lstate.partition_keys);
+	idx_t count = input.size();
+	Vector hashes(LogicalType::HASH);
+	VectorOperations::Hash(lstate.partition_keys.data[0], hashes, count);
+	for (idx_t i = 1; i < lstate.partition_keys.ColumnCount(); i++) {
+		VectorOperations::CombineHash(hashes, lstate.partition_keys.data[i], count);
+	}
+	hashes.Normalify(count);
+	auto hash_data = FlatVector::GetData<hash_t>(hashes);
+
+	// order the rows by hash partition
+	idx_t partition_indices[STANDARD_VECTOR_SIZE];
+	vector<idx_t> partition_offsets(partition_count + 1, 0);
+	for (idx_t i = 0; i < count; i++) {
+		partition_indices[i] = hash_data[i] & (partition_count - 1);
+		partition_offsets[partition_indices[i] + 1]++;
+	}
+	for (idx_t partition_idx = 0; partition_idx < partition_count; partition_idx++) {
+		partition_offsets[partition_idx + 1] += partition_offsets[partition_idx];
+	}
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	vector<idx_t> positions(partition_offsets.begin(), partition_offsets.end() - 1);
+	for (idx_t i = 0; i < count; i++) {
+		sel.set_index(positions[partition_indices[i]]++, i);
+	}
+	// append the rows of every hash partition to the local collection of that partition
+	for (idx_t partition_idx = 0; partition_idx < partition_count; partition_idx++) {
+		idx_t partition_start = partition_offsets[partition_idx];
+		idx_t partition_size = partition_offsets[partition_idx + 1] - partition_start;
+		if (partition_size == 0) {
+			continue;
+		}
+		SelectionVector partition_sel(sel.data() + partition_start);
+		lstate.partition_chunk.Slice(input, partition_sel, partition_size);
+		auto &local = *lstate.partitions[partition_idx];
+		local.Append(lstate.partition_chunk);
+		if (local.Count() >= LOCAL_PARTITION_THRESHOLD) {
+			FlushLocalPartition(*gstate.partitions[partition_idx], local);
+		}
+	}
 }
 
 void PhysicalWindow::Combine(ExecutionContext &context, GlobalOperatorState &gstate_, LocalSinkState &lstate_) {
 	auto &gstate = (WindowGlobalState &)gstate_;
 	auto &lstate = (WindowLocalState &)lstate_;
-	lock_guard<mutex> glock(gstate.lock);
-	gstate.chunks.Merge(lstate.chunks);
+	for (idx_t partition_idx = 0; partition_idx < gstate.partitions.size(); partition_idx++) {
+		FlushLocalPartition(*gstate.partitions[partition_idx], *lstate.partitions[partition_idx]);
+	}
 }
 
-void PhysicalWindow::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> gstate_) {
-	this->sink_state = move(gstate_);
-	auto &gstate = (WindowGlobalState &)*this->sink_state;
-
-	ChunkCollection &big_data = gstate.chunks;
-	ChunkCollection &window_results = gstate.window_results;
-
-	if (big_data.Count() == 0) {
+//! Starts the computation of a sort group over a partition. The first sort group to start initializes the window
+//! results of the partition.
+static void StartSortGroup(PhysicalWindow &op, WindowHashPartition &partition) {
+	lock_guard<mutex> plock(partition.lock);
+	if (partition.active_groups++ > 0 || partition.computed_groups > 0) {
 		return;
 	}
-
 	vector<LogicalType> window_types;
-	for (idx_t expr_idx = 0; expr_idx < select_list.size(); expr_idx++) {
-		window_types.push_back(select_list[expr_idx]->return_type);
+	for (idx_t expr_idx = 0; expr_idx < op.select_list.size(); expr_idx++) {
+		window_types.push_back(op.select_list[expr_idx]->return_type);
 	}
-
-	for (idx_t i = 0; i < big_data.ChunkCount(); i++) {
+	idx_t count = partition.rows.Count();
+	for (idx_t offset = 0; offset < count; offset += STANDARD_VECTOR_SIZE) {
 		DataChunk window_chunk;
 		window_chunk.Initialize(window_types);
-		window_chunk.SetCardinality(big_data.GetChunk(i).size());
+		window_chunk.SetCardinality(MinValue<idx_t>(count - offset, STANDARD_VECTOR_SIZE));
 		for (idx_t col_idx = 0; col_idx < window_chunk.ColumnCount(); col_idx++) {
 			window_chunk.data[col_idx].vector_type = VectorType::CONSTANT_VECTOR;
 			ConstantVector::SetNull(window_chunk.data[col_idx], true);
 		}
 
 		window_chunk.Verify();
-		window_results.Append(window_chunk);
+		partition.window_results.Append(window_chunk);
+	}
+	D_ASSERT(partition.window_results.ColumnCount() == op.select_list.size());
+}
+
+//! Appends the input columns of a row chunk followed by the window results of the rows to the output of the partition
+static void AppendOutputChunk(WindowHashPartition &partition, DataChunk &proj_ch, DataChunk &wind_ch,
+                              DataChunk &output_chunk) {
+	D_ASSERT(proj_ch.size() == wind_ch.size());
+	idx_t out_idx = 0;
+	for (idx_t col_idx = 0; col_idx < proj_ch.ColumnCount(); col_idx++) {
+		output_chunk.data[out_idx++].Reference(proj_ch.data[col_idx]);
+	}
+	for (idx_t col_idx = 0; col_idx < wind_ch.ColumnCount(); col_idx++) {
+		output_chunk.data[out_idx++].Reference(wind_ch.data[col_idx]);
+	}
+	output_chunk.SetCardinality(proj_ch);
+	partition.output.Append(output_chunk);
+}
+
+//! Writes the rows of a partition together with their window results to the output of the partition. If the rows have
+//! to be reordered, they are gathered in passes over the rows that each materialize at most reorder_memory bytes.
+static void FinishPartition(WindowHashPartition &partition, idx_t reorder_memory) {
+	auto &rows = partition.rows;
+	idx_t count = rows.Count();
+	DataChunk output_chunk;
+	output_chunk.InitializeEmpty(partition.output.types);
+	if (!partition.final_order) {
+		DataChunk row_chunk;
+		for (idx_t chunk_idx = 0; chunk_idx < rows.ChunkCount(); chunk_idx++) {
+			rows.FetchChunk(chunk_idx, row_chunk);
+			AppendOutputChunk(partition, row_chunk, partition.window_results.GetChunk(chunk_idx), output_chunk);
+		}
+	} else {
+		partition.window_results.Reorder(partition.final_order.get());
+		// every pass gathers a whole number of chunks, so that they line up with the chunks of the window results
+		idx_t row_width = MaxValue<idx_t>(rows.SizeInBytes() / count, 1);
+		idx_t pass_chunks = MaxValue<idx_t>(reorder_memory / row_width / STANDARD_VECTOR_SIZE, 1);
+		idx_t pass_rows = pass_chunks * STANDARD_VECTOR_SIZE;
+		for (idx_t pass_start = 0; pass_start < count; pass_start += pass_rows) {
+			ChunkCollection gathered;
+			rows.FetchRows(partition.final_order.get() + pass_start, MinValue<idx_t>(count - pass_start, pass_rows),
+			               gathered);
+			for (idx_t chunk_idx = 0; chunk_idx < gathered.ChunkCount(); chunk_idx++) {
+				auto &wind_ch = partition.window_results.GetChunk(pass_start / STANDARD_VECTOR_SIZE + chunk_idx);
+				AppendOutputChunk(partition, gathered.GetChunk(chunk_idx), wind_ch, output_chunk);
+			}
+		}
+		partition.final_order.reset();
+	}
+	partition.output.Finalize();
+	partition.window_results.Reset();
+	partition.rows.Reset();
+}
+
+//! Computes the window expressions of a sort group over a hash partition. The window expressions of the group share a
+//! single sort of the input. The last sort group to finish writes the rows of the partition in their final order.
+static void ComputeWindowResults(PhysicalWindow &op, WindowGlobalState &gstate, WindowHashPartition &partition,
+                                 vector<idx_t> &sort_group) {
+	StartSortGroup(op, partition);
+	auto &input = partition.rows;
+	// sort by partition and order clause in window def
+	auto first_expr = reinterpret_cast<BoundWindowExpression *>(op.select_list[sort_group[0]].get());
+	ChunkCollection sort_collection;
+	unique_ptr<idx_t[]> sorted_vector;
+	if (first_expr->partitions.size() + first_expr->orders.size() > 0) {
+		sorted_vector = unique_ptr<idx_t[]>(new idx_t[input.Count()]);
+		SortCollectionForWindow(first_expr, input, sort_collection, sorted_vector.get());
+	}
+	for (auto expr_idx : sort_group) {
+		auto wexpr = reinterpret_cast<BoundWindowExpression *>(op.select_list[expr_idx].get());
+		ComputeWindowExpression(wexpr, input, sort_collection, sorted_vector.get(), partition.window_results,
+		                        expr_idx);
+	}
+
+	lock_guard<mutex> glock(partition.lock);
+	// the expressions of the group are ordered by index: the last one has the highest index
+	idx_t last_expr_idx = sort_group.back();
+	if (sorted_vector && (partition.final_order_idx == INVALID_INDEX || last_expr_idx > partition.final_order_idx)) {
+		partition.final_order_idx = last_expr_idx;
+		partition.final_order = move(sorted_vector);
+	}
+	partition.active_groups--;
+	if (++partition.computed_groups < op.sort_groups.size()) {
+		return;
+	}
+	// all window expressions have been computed: emit the rows in the order of the last sorted window
+	FinishPartition(partition, gstate.reorder_memory);
+}
+
+class WindowExpressionTask : public Task {
+public:
+	WindowExpressionTask(PhysicalWindow &op_, WindowGlobalState &gstate_, WindowHashPartition &partition_,
+	                     vector<idx_t> &sort_group_)
+	    : op(op_), gstate(gstate_), partition(partition_), sort_group(sort_group_) {
 	}
 
-	D_ASSERT(window_results.ColumnCount() == select_list.size());
-	idx_t window_output_idx = 0;
-	// we can have multiple window functions
-	for (idx_t expr_idx = 0; expr_idx < select_list.size(); expr_idx++) {
-		D_ASSERT(select_list[expr_idx]->GetExpressionClass() == ExpressionClass::BOUND_WINDOW);
-		// sort by partition and order clause in window def
-		auto wexpr = reinterpret_cast<BoundWindowExpression *>(select_list[expr_idx].get());
-		ComputeWindowExpression(wexpr, big_data, window_results, window_output_idx++);
+	void Execute() override {
+		ComputeWindowResults(op, gstate, partition, sort_group);
 	}
+
+private:
+	PhysicalWindow &op;
+	WindowGlobalState &gstate;
+	WindowHashPartition &partition;
+	vector<idx_t> &sort_group;
+};
+
+void PhysicalWindow::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> gstate_) {
+	this->sink_state = move(gstate_);
+	auto &gstate = (WindowGlobalState &)*this->sink_state;
+
+	vector<unique_ptr<Task>> tasks;
+	for (auto &partition : gstate.partitions) {
+		partition->rows.Finalize();
+		if (partition->rows.Count() == 0) {
+			continue;
+		}
+		// the hash partitions and the sort groups within a partition are independent: compute every combination in
+		// a separate task
+		for (auto &sort_group : sort_groups) {
+			tasks.push_back(make_unique<WindowExpressionTask>(*this, gstate, *partition, sort_group));
+		}
+	}
+	if (tasks.size() > 1 && TaskScheduler::GetScheduler(context).NumberOfThreads() > 1) {
+		pipeline.ScheduleFinalizeTasks(move(tasks));
+		return;
+	}
+	for (auto &task : tasks) {
+		task->Execute();
+	}
+}
+
+//! Returns the amount of hash partitions of the input of the window
+static idx_t GetPartitionCount(PhysicalWindow &op, ClientContext &context) {
+	idx_t thread_count = TaskScheduler::GetScheduler(context).NumberOfThreads();
+	if (!op.is_partitioned || thread_count <= 1) {
+		return 1;
+	}
+	// use a few hash partitions per thread, so the work is still balanced if the partitions differ in size
+	return NextPowerOfTwo(thread_count) * 4;
 }
 
 unique_ptr<LocalSinkState> PhysicalWindow::GetLocalSinkState(ExecutionContext &context) {
-	return make_unique<WindowLocalState>(*this);
+	idx_t partition_count = GetPartitionCount(*this, context.client);
+	auto state = make_unique<WindowLocalState>(*this, partition_count);
+	if (partition_count > 1) {
+		auto wexpr = reinterpret_cast<BoundWindowExpression *>(select_list[0].get());
+		vector<LogicalType> partition_types;
+		for (auto &pexpr : wexpr->partitions) {
+			partition_types.push_back(pexpr->return_type);
+			state->partition_executor.AddExpression(*pexpr);
+		}
+		state->partition_keys.Initialize(partition_types);
+		state->partition_chunk.InitializeEmpty(children[0]->GetTypes());
+	}
+	return move(state);
 }
 
 unique_ptr<GlobalOperatorState> PhysicalWindow::GetGlobalState(ClientContext &context) {
-	return make_unique<WindowGlobalState>(*this, context);
+	return make_unique<WindowGlobalState>(*this, BufferManager::GetBufferManager(context),
+	                                      GetPartitionCount(*this, context),
+	                                      TaskScheduler::GetScheduler(context).NumberOfThreads());
 }
 
 string PhysicalWindow::ParamsToString() const {
@@ -1,11 +1,104 @@
 #include "duckdb/execution/operator/helper/physical_vacuum.hpp"
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/execution/reservoir_sample.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/transaction/transaction.hpp"
 
 using namespace std;
 
 namespace duckdb {
 
+//! Build the histograms of the columns of a table from a sample of its rows
+static void AnalyzeTable(ClientContext &context, TableCatalogEntry &table, const vector<string> &column_names) {
+	// figure out which columns to analyze
+	vector<column_t> column_ids;
+	if (column_names.empty()) {
+		for (idx_t i = 0; i < table.columns.size(); i++) {
+			if (Histogram::IsSupported(table.columns[i].type)) {
+				column_ids.push_back(i);
+			}
+		}
+	} else {
+		for (auto &name : column_names) {
+			auto &column = table.GetColumn(name);
+			if (Histogram::IsSupported(column.type)) {
+				column_ids.push_back(column.oid);
+			}
+		}
+	}
+	if (column_ids.empty()) {
+		return;
+	}
+	vector<LogicalType> types;
+	for (auto &column_id : column_ids) {
+		types.push_back(table.columns[column_id].type);
+	}
+
+	// scan the table into a reservoir sample
+	auto &transaction = Transaction::GetTransaction(context);
+	TableScanState scan_state;
+	table.storage->InitializeScan(transaction, scan_state, column_ids);
+	DataChunk chunk;
+	chunk.Initialize(types);
+	ReservoirSample sample(Histogram::SAMPLE_SIZE, -1);
+	while (true) {
+		chunk.Reset();
+		table.storage->Scan(transaction, chunk, scan_state, column_ids);
+		if (chunk.size() == 0) {
+			break;
+		}
+		sample.AddToReservoir(chunk);
+	}
+
+	// build the histograms from the sampled values of each column
+	vector<vector<Value>> values(column_ids.size());
+	while (true) {
+		auto sample_chunk = sample.GetChunk();
+		if (!sample_chunk || sample_chunk->size() == 0) {
+			break;
+		}
+		for (idx_t col_idx = 0; col_idx < column_ids.size(); col_idx++) {
+			for (idx_t row_idx = 0; row_idx < sample_chunk->size(); row_idx++) {
+				values[col_idx].push_back(sample_chunk->GetValue(col_idx, row_idx));
+			}
+		}
+	}
+	// the histograms are only used once the transaction commits, so a rolled back ANALYZE has no effect
+	for (idx_t col_idx = 0; col_idx < column_ids.size(); col_idx++) {
+		auto histogram = Histogram::Build(types[col_idx], values[col_idx]);
+		transaction.PushHistogram(table.storage, column_ids[col_idx], move(histogram));
+	}
+}
+
 void PhysicalVacuum::GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) {
-	// NOP
+	if (info->analyze) {
+		auto &client = context.client;
+		auto &catalog = Catalog::GetCatalog(client);
+		vector<TableCatalogEntry *> tables;
+		if (!info->table.empty()) {
+			tables.push_back(catalog.GetEntry<TableCatalogEntry>(client, info->schema, info->table));
+		} else {
+			// analyze all tables, including the temporary tables of the connection
+			vector<SchemaCatalogEntry *> schemas;
+			catalog.ScanSchemas(client, [&](CatalogEntry *entry) { schemas.push_back((SchemaCatalogEntry *)entry); });
+			schemas.push_back(client.temporary_objects.get());
+			for (auto &schema : schemas) {
+				schema->tables.Scan(client, [&](CatalogEntry *entry) {
+					if (entry->type == CatalogType::TABLE_ENTRY) {
+						tables.push_back((TableCatalogEntry *)entry);
+					}
+				});
+			}
+		}
+		for (auto &table : tables) {
+			AnalyzeTable(client, *table, info->columns);
+		}
+		// the histograms are not written to the WAL: they are persisted by a checkpoint when the transaction commits
+		Transaction::GetTransaction(client).requires_checkpoint = true;
+	}
 	state->finished = true;
 }
 
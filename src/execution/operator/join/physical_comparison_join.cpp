@@ -1,5 +1,6 @@
 #include "duckdb/execution/operator/join/physical_comparison_join.hpp"
 #include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/execution/buffered_chunk_collection.hpp"
 
 using namespace std;
 
@@ -78,31 +79,50 @@ void PhysicalComparisonJoin::ConstructEmptyJoinResult(JoinType join_type, bool h
 	}
 }
 
-void PhysicalComparisonJoin::ConstructFullOuterJoinResult(bool *found_match, ChunkCollection &input, DataChunk &result,
-                                                          idx_t &scan_position) {
+static bool ConstructFullOuterJoinChunk(bool *found_match, DataChunk &rhs_chunk, DataChunk &result,
+                                       idx_t &scan_position) {
 	// fill in NULL values for the LHS
 	SelectionVector rsel(STANDARD_VECTOR_SIZE);
+	idx_t result_count = 0;
+	// figure out which tuples didn't find a match in the RHS
+	for (idx_t i = 0; i < rhs_chunk.size(); i++) {
+		if (!found_match[scan_position + i]) {
+			rsel.set_index(result_count++, i);
+		}
+	}
+	scan_position += STANDARD_VECTOR_SIZE;
+	if (result_count == 0) {
+		return false;
+	}
+	// if there were any tuples that didn't find a match, output them
+	idx_t left_column_count = result.ColumnCount() - rhs_chunk.ColumnCount();
+	for (idx_t i = 0; i < left_column_count; i++) {
+		result.data[i].vector_type = VectorType::CONSTANT_VECTOR;
+		ConstantVector::SetNull(result.data[i], true);
+	}
+	for (idx_t col_idx = 0; col_idx < rhs_chunk.ColumnCount(); col_idx++) {
+		result.data[left_column_count + col_idx].Slice(rhs_chunk.data[col_idx], rsel, result_count);
+	}
+	result.SetCardinality(result_count);
+	return true;
+}
+
+void PhysicalComparisonJoin::ConstructFullOuterJoinResult(bool *found_match, ChunkCollection &input, DataChunk &result,
+                                                          idx_t &scan_position) {
 	while (scan_position < input.Count()) {
 		auto &rhs_chunk = input.GetChunk(scan_position / STANDARD_VECTOR_SIZE);
-		idx_t result_count = 0;
-		// figure out which tuples didn't find a match in the RHS
-		for (idx_t i = 0; i < rhs_chunk.size(); i++) {
-			if (!found_match[scan_position + i]) {
-				rsel.set_index(result_count++, i);
-			}
+		if (ConstructFullOuterJoinChunk(found_match, rhs_chunk, result, scan_position)) {
+			return;
 		}
-		scan_position += STANDARD_VECTOR_SIZE;
-		if (result_count > 0) {
-			// if there were any tuples that didn't find a match, output them
-			idx_t left_column_count = result.ColumnCount() - input.ColumnCount();
-			for (idx_t i = 0; i < left_column_count; i++) {
-				result.data[i].vector_type = VectorType::CONSTANT_VECTOR;
-				ConstantVector::SetNull(result.data[i], true);
-			}
-			for (idx_t col_idx = 0; col_idx < rhs_chunk.ColumnCount(); col_idx++) {
-				result.data[left_column_count + col_idx].Slice(rhs_chunk.data[col_idx], rsel, result_count);
-			}
-			result.SetCardinality(result_count);
+	}
+}
+
+void PhysicalComparisonJoin::ConstructFullOuterJoinResult(bool *found_match, BufferedChunkCollection &input,
+                                                          DataChunk &scan_chunk, DataChunk &result,
+                                                          idx_t &scan_position) {
+	while (scan_position < input.Count()) {
+		input.FetchChunk(scan_position / STANDARD_VECTOR_SIZE, scan_chunk);
+		if (ConstructFullOuterJoinChunk(found_match, scan_chunk, result, scan_position)) {
 			return;
 		}
 	}
@@ -1,6 +1,7 @@
 #include "duckdb/execution/operator/join/physical_cross_product.hpp"
 
 #include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/execution/buffered_chunk_collection.hpp"
 
 namespace duckdb {
 using namespace std;
@@ -8,13 +9,18 @@ using namespace std;
 class PhysicalCrossProductOperatorState : public PhysicalOperatorState {
 public:
 	PhysicalCrossProductOperatorState(PhysicalOperator &op, PhysicalOperator *left, PhysicalOperator *right)
-	    : PhysicalOperatorState(op, left), left_position(0) {
+	    : PhysicalOperatorState(op, left), left_position(0), loaded_position(INVALID_INDEX) {
 		D_ASSERT(left && right);
 	}
 
 	idx_t left_position;
 	idx_t right_position;
-	ChunkCollection right_data;
+	//! The materialized right side, nullptr if it has not been materialized yet
+	unique_ptr<BufferedChunkCollection> right_data;
+	//! The chunk of the right side that is currently joined with the left side
+	DataChunk right_chunk;
+	//! The position of the chunk that is loaded into right_chunk
+	idx_t loaded_position;
 };
 
 PhysicalCrossProduct::PhysicalCrossProduct(vector<LogicalType> types, unique_ptr<PhysicalOperator> left,
@@ -28,9 +34,11 @@ void PhysicalCrossProduct::GetChunkInternal(ExecutionContext &context, DataChunk
                                             PhysicalOperatorState *state_) {
 	auto state = reinterpret_cast<PhysicalCrossProductOperatorState *>(state_);
 	// first we fully materialize the right child, if we haven't done that yet
-	if (state->right_data.ColumnCount() == 0) {
+	if (!state->right_data) {
 		auto right_state = children[1]->GetOperatorState();
 		auto types = children[1]->GetTypes();
+		state->right_data =
+		    make_unique<BufferedChunkCollection>(BufferManager::GetBufferManager(context.client), types);
 
 		DataChunk new_chunk;
 		new_chunk.Initialize(types);
@@ -39,10 +47,11 @@ void PhysicalCrossProduct::GetChunkInternal(ExecutionContext &context, DataChunk
 			if (new_chunk.size() == 0) {
 				break;
 			}
-			state->right_data.Append(new_chunk);
+			state->right_data->Append(new_chunk);
 		} while (new_chunk.size() > 0);
+		state->right_data->Finalize();
 
-		if (state->right_data.Count() == 0) {
+		if (state->right_data->Count() == 0) {
 			return;
 		}
 		state->left_position = 0;
@@ -56,7 +65,12 @@ void PhysicalCrossProduct::GetChunkInternal(ExecutionContext &context, DataChunk
 	}
 
 	auto &left_chunk = state->child_chunk;
-	auto &right_chunk = state->right_data.GetChunk(state->right_position);
+	auto &right_chunk = state->right_chunk;
+	if (state->loaded_position != state->right_position) {
+		// the right chunk is joined with all rows of the left chunk before moving on: load it once
+		state->right_data->FetchChunk(state->right_position, right_chunk);
+		state->loaded_position = state->right_position;
+	}
 	// now match the current row of the left relation with the current chunk
 	// from the right relation
 	chunk.SetCardinality(right_chunk.size());
@@ -77,7 +91,7 @@ void PhysicalCrossProduct::GetChunkInternal(ExecutionContext &context, DataChunk
 		// move to the next chunk on the right side
 		state->left_position = 0;
 		state->right_position++;
-		if (state->right_position >= state->right_data.ChunkCount()) {
+		if (state->right_position >= state->right_data->ChunkCount()) {
 			state->right_position = 0;
 			// move to the next chunk on the left side
 			children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
@@ -1,10 +1,17 @@
 #include "duckdb/execution/operator/join/physical_hash_join.hpp"
 
 #include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/common/serializer/buffered_deserializer.hpp"
+#include "duckdb/common/serializer/buffered_serializer.hpp"
+#include "duckdb/common/operator/comparison_operators.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/operator/scan/physical_table_scan.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/function/aggregate/distributive_functions.hpp"
+#include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
 
 using namespace std;
 
@@ -42,23 +49,192 @@ public:
 	DataChunk build_chunk;
 	DataChunk join_keys;
 	ExpressionExecutor build_executor;
+	//! The thread-local HT that the build side is added to, it is merged into the global HT in Combine. Not used for
+	//! the correlated MARK join, which builds the global HT directly.
+	unique_ptr<JoinHashTable> hash_table;
+	//! The range of the keys of the first condition that were added by this thread
+	Value key_min;
+	Value key_max;
+};
+
+//! A partition of a hash join that does not fit in memory. The partition is finalized (i.e. pinned) by the first thread
+//! that probes it, and unpinned again by the last thread that is done probing it.
+class HashJoinPartition {
+public:
+	explicit HashJoinPartition(unique_ptr<JoinHashTable> hash_table_p)
+	    : hash_table(move(hash_table_p)), active_threads(0) {
+	}
+
+	//! The HT holding the build-side entries of the partition
+	unique_ptr<JoinHashTable> hash_table;
+
+public:
+	JoinHashTable &Acquire() {
+		lock_guard<mutex> guard(lock);
+		if (active_threads++ == 0) {
+			hash_table->Finalize();
+		}
+		return *hash_table;
+	}
+
+	void Release() {
+		lock_guard<mutex> guard(lock);
+		D_ASSERT(active_threads > 0);
+		if (--active_threads == 0) {
+			hash_table->Unpin();
+		}
+	}
+
+private:
+	mutex lock;
+	//! The amount of threads that are currently probing the partition
+	idx_t active_threads;
 };
 
 class HashJoinGlobalState : public GlobalOperatorState {
 public:
-	HashJoinGlobalState() {
+	HashJoinGlobalState()
+	    : filter_scan(nullptr), active_probes(0), full_outer_claimed(false), full_outer_partition(0),
+	      full_outer_pinned(false) {
 	}
 
 	//! The HT used by the join
 	unique_ptr<JoinHashTable> hash_table;
+	//! The probe-side table scan that the key range of the build side is pushed into (if any)
+	PhysicalTableScan *filter_scan;
+	//! The range of the keys of the first condition, only tracked if there is a filter_scan
+	mutex key_range_lock;
+	Value key_min;
+	Value key_max;
+	//! The partitions of the HT, only used if the HT does not fit in memory
+	vector<unique_ptr<HashJoinPartition>> partitions;
+	//! Only used for RIGHT/FULL OUTER JOIN: the unmatched tuples of the build side can only be scanned after every
+	//! thread is done probing, the last thread that finishes probing scans them
+	mutex probe_lock;
+	//! Only used for RIGHT/FULL OUTER JOIN: the amount of threads that have started but not finished probing
+	idx_t active_probes;
+	//! Only used for RIGHT/FULL OUTER JOIN: whether or not a thread has claimed the scan of the unmatched tuples
+	bool full_outer_claimed;
 	//! Only used for FULL OUTER JOIN: scan state of the final scan to find unmatched tuples in the build-side
 	JoinHTScanState ht_scan_state;
+	//! Only used for a partitioned FULL OUTER JOIN: the partition that is scanned for unmatched tuples
+	idx_t full_outer_partition;
+	//! Only used for a partitioned FULL OUTER JOIN: whether or not the scanned partition is pinned
+	bool full_outer_pinned;
 };
 
+//! Returns the probe-side table scan that the key range of the build side can be pushed into as a filter, or nullptr
+//! if there is none. The probe side can only be filtered if probe-side rows without a match produce no output.
+static PhysicalTableScan *GetFilterScan(PhysicalHashJoin &join) {
+	if (join.join_type != JoinType::INNER && join.join_type != JoinType::SEMI && join.join_type != JoinType::RIGHT) {
+		return nullptr;
+	}
+	auto &condition = join.conditions[0];
+	if (condition.comparison != ExpressionType::COMPARE_EQUAL || condition.null_values_are_equal ||
+	    condition.left->type != ExpressionType::BOUND_REF) {
+		return nullptr;
+	}
+	switch (condition.left->return_type.InternalType()) {
+	case PhysicalType::INT8:
+	case PhysicalType::INT16:
+	case PhysicalType::INT32:
+	case PhysicalType::INT64:
+	case PhysicalType::INT128:
+	case PhysicalType::VARCHAR:
+		break;
+	default:
+		return nullptr;
+	}
+	// filters do not change the layout of their input, so we can look through them
+	auto op = join.children[0].get();
+	while (op->type == PhysicalOperatorType::FILTER) {
+		op = op->children[0].get();
+	}
+	if (op->type != PhysicalOperatorType::TABLE_SCAN) {
+		return nullptr;
+	}
+	auto &scan = (PhysicalTableScan &)*op;
+	auto column_index = ((BoundReferenceExpression &)*condition.left).index;
+	if (!scan.function.filter_pushdown || column_index >= scan.column_ids.size() ||
+	    scan.column_ids[column_index] == COLUMN_IDENTIFIER_ROW_ID) {
+		return nullptr;
+	}
+	return &scan;
+}
+
+//! Extends the range [min, max] with the range [source_min, source_max]
+static void MergeKeyRange(const Value &source_min, const Value &source_max, Value &min, Value &max) {
+	if (source_min.is_null) {
+		return;
+	}
+	if (min.is_null || source_min < min) {
+		min = source_min;
+	}
+	if (max.is_null || source_max > max) {
+		max = source_max;
+	}
+}
+
+template <class T> static void TemplatedUpdateKeyRange(Vector &keys, idx_t count, Value &min, Value &max) {
+	VectorData vdata;
+	keys.Orrify(count, vdata);
+
+	auto data = (T *)vdata.data;
+	idx_t min_row = INVALID_INDEX, max_row = INVALID_INDEX;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if ((*vdata.nullmask)[idx]) {
+			continue;
+		}
+		if (min_row == INVALID_INDEX || LessThan::Operation<T>(data[idx], data[vdata.sel->get_index(min_row)])) {
+			min_row = i;
+		}
+		if (max_row == INVALID_INDEX || GreaterThan::Operation<T>(data[idx], data[vdata.sel->get_index(max_row)])) {
+			max_row = i;
+		}
+	}
+	if (min_row == INVALID_INDEX) {
+		// only NULL values
+		return;
+	}
+	MergeKeyRange(keys.GetValue(min_row), keys.GetValue(max_row), min, max);
+}
+
+//! Extends the range [min, max] with the non-NULL keys in the vector
+static void UpdateKeyRange(Vector &keys, idx_t count, Value &min, Value &max) {
+	switch (keys.type.InternalType()) {
+	case PhysicalType::INT8:
+		TemplatedUpdateKeyRange<int8_t>(keys, count, min, max);
+		break;
+	case PhysicalType::INT16:
+		TemplatedUpdateKeyRange<int16_t>(keys, count, min, max);
+		break;
+	case PhysicalType::INT32:
+		TemplatedUpdateKeyRange<int32_t>(keys, count, min, max);
+		break;
+	case PhysicalType::INT64:
+		TemplatedUpdateKeyRange<int64_t>(keys, count, min, max);
+		break;
+	case PhysicalType::INT128:
+		TemplatedUpdateKeyRange<hugeint_t>(keys, count, min, max);
+		break;
+	case PhysicalType::VARCHAR:
+		TemplatedUpdateKeyRange<string_t>(keys, count, min, max);
+		break;
+	default:
+		throw InternalException("Unsupported type for the key range of a hash join");
+	}
+}
+
 unique_ptr<GlobalOperatorState> PhysicalHashJoin::GetGlobalState(ClientContext &context) {
 	auto state = make_unique<HashJoinGlobalState>();
 	state->hash_table =
 	    make_unique<JoinHashTable>(BufferManager::GetBufferManager(context), conditions, build_types, join_type);
+	state->filter_scan = GetFilterScan(*this);
+	if (state->filter_scan) {
+		// the plan can be executed more than once: remove the filters of a previous execution
+		state->filter_scan->ClearRuntimeFilters();
+	}
 	if (delim_types.size() > 0 && join_type == JoinType::MARK) {
 		// correlated MARK join
 		if (delim_types.size() + 1 == conditions.size()) {
@@ -113,6 +289,11 @@ unique_ptr<LocalSinkState> PhysicalHashJoin::GetLocalSinkState(ExecutionContext
 		state->build_executor.AddExpression(*cond.right);
 	}
 	state->join_keys.Initialize(condition_types);
+	if (delim_types.empty() || join_type != JoinType::MARK) {
+		// every thread builds its own HT, so the threads do not contend on the blocks of the global HT
+		state->hash_table = make_unique<JoinHashTable>(BufferManager::GetBufferManager(context.client), conditions,
+		                                               build_types, join_type);
+	}
 	return move(state);
 }
 
@@ -120,6 +301,7 @@ void PhysicalHashJoin::Sink(ExecutionContext &context, GlobalOperatorState &stat
                             DataChunk &input) {
 	auto &sink = (HashJoinGlobalState &)state;
 	auto &lstate = (HashJoinLocalState &)lstate_;
+	auto &hash_table = lstate.hash_table ? *lstate.hash_table : *sink.hash_table;
 	// resolve the join keys for the right chunk
 	lstate.build_executor.Execute(input, lstate.join_keys);
 	// build the HT
@@ -130,37 +312,239 @@ void PhysicalHashJoin::Sink(ExecutionContext &context, GlobalOperatorState &stat
 		for (idx_t i = 0; i < right_projection_map.size(); i++) {
 			lstate.build_chunk.data[i].Reference(input.data[right_projection_map[i]]);
 		}
-		sink.hash_table->Build(lstate.join_keys, lstate.build_chunk);
+		hash_table.Build(lstate.join_keys, lstate.build_chunk);
 	} else {
 		// there is not a projected map: place the entire right chunk in the HT
-		sink.hash_table->Build(lstate.join_keys, input);
+		hash_table.Build(lstate.join_keys, input);
+	}
+	if (sink.filter_scan) {
+		UpdateKeyRange(lstate.join_keys.data[0], lstate.join_keys.size(), lstate.key_min, lstate.key_max);
+	}
+}
+
+void PhysicalHashJoin::Combine(ExecutionContext &context, GlobalOperatorState &gstate, LocalSinkState &lstate_) {
+	auto &sink = (HashJoinGlobalState &)gstate;
+	auto &lstate = (HashJoinLocalState &)lstate_;
+	if (lstate.hash_table) {
+		sink.hash_table->Merge(*lstate.hash_table);
+	}
+	if (sink.filter_scan) {
+		lock_guard<mutex> guard(sink.key_range_lock);
+		MergeKeyRange(lstate.key_min, lstate.key_max, sink.key_min, sink.key_max);
 	}
 }
 
 //===--------------------------------------------------------------------===//
 // Finalize
 //===--------------------------------------------------------------------===//
-void PhysicalHashJoin::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
-	auto &sink = (HashJoinGlobalState &)*state;
-	sink.hash_table->Finalize();
+//! Inserts a range of the data blocks of the hash table into the pointer table, concurrently with other tasks
+class HashJoinFinalizeTask : public Task {
+public:
+	HashJoinFinalizeTask(JoinHashTable &hash_table_, idx_t block_start_, idx_t block_end_)
+	    : hash_table(hash_table_), block_start(block_start_), block_end(block_end_) {
+	}
+
+	void Execute() override {
+		hash_table.FinalizeBlocks(block_start, block_end, true);
+	}
+
+private:
+	JoinHashTable &hash_table;
+	idx_t block_start;
+	idx_t block_end;
+};
+
+//! Returns whether or not the hash join can be partitioned when the HT does not fit in memory
+static bool CanPartition(JoinHashTable &hash_table, const vector<LogicalType> &probe_types) {
+	if (!hash_table.correlated_mark_join_info.correlated_types.empty()) {
+		// the correlated MARK join keeps track of the group counts of the entire HT
+		return false;
+	}
+	// the probe-side rows of the partitions are serialized
+	for (auto &type : probe_types) {
+		if (!TypeIsConstantSize(type.InternalType()) && type.InternalType() != PhysicalType::VARCHAR) {
+			return false;
+		}
+	}
+	return true;
+}
 
+void PhysicalHashJoin::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
 	PhysicalSink::Finalize(pipeline, context, move(state));
+	auto &sink = (HashJoinGlobalState &)*sink_state;
+	auto &hash_table = *sink.hash_table;
+
+	if (sink.filter_scan && !sink.key_min.is_null) {
+		// probe-side rows with a key outside of the key range of the build side cannot find a match: push the range
+		// into the probe-side scan, which can then skip entire segments based on their statistics
+		auto column_index = ((BoundReferenceExpression &)*conditions[0].left).index;
+		sink.filter_scan->AddRuntimeRangeFilter(column_index, sink.key_min, sink.key_max);
+	}
+
+	idx_t block_count = hash_table.BlockCount();
+	idx_t thread_count = TaskScheduler::GetScheduler(context).NumberOfThreads();
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	idx_t ht_size = hash_table.SizeInBytes();
+	if (ht_size > buffer_manager.GetMaxMemory() / 2 && CanPartition(hash_table, children[0]->GetTypes())) {
+		// the HT does not fit in memory: radix-partition the HT, so the partitions can be pinned one at a time
+		// every probing thread pins one partition at a time, pick the partitions so one partition per thread fits in
+		// half of the memory limit
+		idx_t partition_size = MaxValue<idx_t>(buffer_manager.GetMaxMemory() / 2 / thread_count, 1);
+		idx_t partition_count = MinValue<idx_t>(NextPowerOfTwo(ht_size / partition_size + 1), MAX_PARTITIONS);
+		vector<unique_ptr<JoinHashTable>> partitions;
+		for (idx_t i = 0; i < partition_count; i++) {
+			partitions.push_back(make_unique<JoinHashTable>(buffer_manager, conditions, build_types, join_type));
+		}
+		hash_table.Partition(partitions);
+		for (auto &partition : partitions) {
+			sink.partitions.push_back(make_unique<HashJoinPartition>(move(partition)));
+		}
+		return;
+	}
+	if (block_count <= 1 || thread_count <= 1) {
+		// small hash table or single-threaded: build the pointer table here
+		hash_table.Finalize();
+		return;
+	}
+	// construct the pointer table in parallel: every task inserts a contiguous range of the data blocks
+	hash_table.InitializePointerTable();
+	idx_t task_count = MinValue<idx_t>(block_count, thread_count);
+	vector<unique_ptr<Task>> tasks;
+	for (idx_t task_idx = 0; task_idx < task_count; task_idx++) {
+		idx_t block_start = task_idx * block_count / task_count;
+		idx_t block_end = (task_idx + 1) * block_count / task_count;
+		tasks.push_back(make_unique<HashJoinFinalizeTask>(hash_table, block_start, block_end));
+	}
+	pipeline.ScheduleFinalizeTasks(move(tasks));
 }
 
 //===--------------------------------------------------------------------===//
 // GetChunkInternal
 //===--------------------------------------------------------------------===//
+//! The probe-side rows of a single partition of a partitioned hash join. The rows are collected in a chunk, and full
+//! chunks are serialized into blocks of the buffer manager, which are written to the temporary directory when they are
+//! evicted.
+class HashJoinSpill {
+public:
+	HashJoinSpill(BufferManager &buffer_manager, vector<LogicalType> types)
+	    : buffer_manager(buffer_manager), write_position(0), read_position(0) {
+		chunk.Initialize(types);
+	}
+
+public:
+	void Append(DataChunk &input) {
+		if (chunk.size() + input.size() > STANDARD_VECTOR_SIZE) {
+			Flush();
+		}
+		chunk.Append(input);
+	}
+
+	//! Serializes the collected rows into the blocks
+	void Flush() {
+		if (chunk.size() == 0) {
+			return;
+		}
+		BufferedSerializer serializer;
+		chunk.Serialize(serializer);
+		auto data = serializer.GetData();
+		WriteData((data_ptr_t)&data.size, sizeof(idx_t));
+		WriteData(data.data.get(), data.size);
+		chunk.Reset();
+	}
+
+	//! Deserializes the next chunk from the blocks, returns false if all chunks have been read
+	bool Scan(DataChunk &result) {
+		D_ASSERT(chunk.size() == 0);
+		if (read_position == write_position) {
+			return false;
+		}
+		idx_t size;
+		ReadData((data_ptr_t)&size, sizeof(idx_t));
+		auto data = unique_ptr<data_t[]>(new data_t[size]);
+		ReadData(data.get(), size);
+		BufferedDeserializer source(data.get(), size);
+		result.Destroy();
+		result.Deserialize(source);
+		return true;
+	}
+
+private:
+	void WriteData(data_ptr_t data, idx_t size) {
+		while (size > 0) {
+			idx_t block_offset = write_position % Storage::BLOCK_SIZE;
+			if (block_offset == 0) {
+				blocks.push_back(buffer_manager.RegisterMemory(Storage::BLOCK_ALLOC_SIZE, false));
+			}
+			auto handle = buffer_manager.Pin(blocks.back());
+			idx_t write_size = MinValue<idx_t>(size, Storage::BLOCK_SIZE - block_offset);
+			memcpy(handle->node->buffer + block_offset, data, write_size);
+			data += write_size;
+			size -= write_size;
+			write_position += write_size;
+		}
+	}
+
+	void ReadData(data_ptr_t data, idx_t size) {
+		while (size > 0) {
+			idx_t block_idx = read_position / Storage::BLOCK_SIZE;
+			idx_t block_offset = read_position % Storage::BLOCK_SIZE;
+			auto handle = buffer_manager.Pin(blocks[block_idx]);
+			idx_t read_size = MinValue<idx_t>(size, Storage::BLOCK_SIZE - block_offset);
+			memcpy(data, handle->node->buffer + block_offset, read_size);
+			data += read_size;
+			size -= read_size;
+			read_position += read_size;
+			if (block_offset + read_size == Storage::BLOCK_SIZE) {
+				// the block has been read entirely: release it
+				handle.reset();
+				blocks[block_idx].reset();
+			}
+		}
+	}
+
+private:
+	BufferManager &buffer_manager;
+	//! The rows that have not been serialized yet
+	DataChunk chunk;
+	//! The blocks holding the serialized chunks
+	vector<shared_ptr<BlockHandle>> blocks;
+	//! The amount of bytes written to the blocks
+	idx_t write_position;
+	//! The amount of bytes read from the blocks
+	idx_t read_position;
+};
+
 class PhysicalHashJoinState : public PhysicalOperatorState {
 public:
 	PhysicalHashJoinState(PhysicalOperator &op, PhysicalOperator *left, PhysicalOperator *right,
 	                      vector<JoinCondition> &conditions)
-	    : PhysicalOperatorState(op, left) {
+	    : PhysicalOperatorState(op, left), probe_registered(false), probe_finished(false), scan_full_outer(false),
+	      partition_idx(0), partition(nullptr) {
 	}
 
 	DataChunk cached_chunk;
 	DataChunk join_keys;
 	ExpressionExecutor probe_executor;
 	unique_ptr<JoinHashTable::ScanStructure> scan_structure;
+
+	//! Only used for RIGHT/FULL OUTER JOIN: whether or not this thread has been counted as an active probe
+	bool probe_registered;
+	//! Only used for RIGHT/FULL OUTER JOIN: whether or not this thread is done probing
+	bool probe_finished;
+	//! Only used for RIGHT/FULL OUTER JOIN: whether or not this thread scans the unmatched tuples of the build side
+	bool scan_full_outer;
+
+	//! Only used for a partitioned hash join: the partition that is probed. The first partition is probed while the
+	//! probe side is read, the other partitions are probed with the spilled rows afterwards.
+	idx_t partition_idx;
+	//! Only used for a partitioned hash join: the pinned partition that is probed
+	HashJoinPartition *partition;
+	//! Only used for a partitioned hash join: the spilled probe-side rows of every partition (but the first)
+	vector<unique_ptr<HashJoinSpill>> spills;
+	//! Only used for a partitioned hash join: the chunk that is used to append the rows of a partition to its spill
+	DataChunk partition_chunk;
+	//! Only used for a partitioned hash join: the chunk that holds the rows that are read from a spill
+	DataChunk spill_chunk;
 };
 
 unique_ptr<PhysicalOperatorState> PhysicalHashJoin::GetOperatorState() {
@@ -173,6 +557,49 @@ unique_ptr<PhysicalOperatorState> PhysicalHashJoin::GetOperatorState() {
 	return move(state);
 }
 
+//! Marks the thread as done probing, returns true if the thread has to scan the unmatched tuples of the build side.
+//! Since a thread only finishes probing when the probe side is exhausted, a thread that registers afterwards cannot
+//! find any more matches.
+static bool FinishProbe(HashJoinGlobalState &sink, PhysicalHashJoinState &state) {
+	if (state.probe_finished) {
+		return false;
+	}
+	state.probe_finished = true;
+	lock_guard<mutex> guard(sink.probe_lock);
+	D_ASSERT(sink.active_probes > 0);
+	sink.active_probes--;
+	if (sink.active_probes > 0 || sink.full_outer_claimed) {
+		return false;
+	}
+	sink.full_outer_claimed = true;
+	state.scan_full_outer = true;
+	return true;
+}
+
+//! Scans the next chunk of unmatched tuples from the build side, only called by the thread that claimed the scan
+static void ScanFullOuter(HashJoinGlobalState &sink, DataChunk &chunk) {
+	if (sink.partitions.empty()) {
+		sink.hash_table->ScanFullOuter(chunk, sink.ht_scan_state);
+		return;
+	}
+	// partitioned hash join: scan the partitions one at a time
+	while (sink.full_outer_partition < sink.partitions.size()) {
+		auto &partition = *sink.partitions[sink.full_outer_partition];
+		if (!sink.full_outer_pinned) {
+			partition.Acquire();
+			sink.full_outer_pinned = true;
+		}
+		partition.hash_table->ScanFullOuter(chunk, sink.ht_scan_state);
+		if (chunk.size() > 0) {
+			return;
+		}
+		partition.Release();
+		sink.full_outer_pinned = false;
+		sink.full_outer_partition++;
+		sink.ht_scan_state = JoinHTScanState();
+	}
+}
+
 void PhysicalHashJoin::GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
 	auto state = reinterpret_cast<PhysicalHashJoinState *>(state_);
 	auto &sink = (HashJoinGlobalState &)*sink_state;
@@ -181,7 +608,18 @@ void PhysicalHashJoin::GetChunkInternal(ExecutionContext &context, DataChunk &ch
 		// empty hash table with INNER or SEMI join means empty result set
 		return;
 	}
+	if (IsRightOuterJoin(join_type) && !state->probe_registered) {
+		// register the thread before it fetches its first probe chunk: the unmatched tuples are only scanned once
+		// every registered thread is done probing
+		lock_guard<mutex> guard(sink.probe_lock);
+		sink.active_probes++;
+		state->probe_registered = true;
+	}
 	do {
+		if (state->scan_full_outer) {
+			ScanFullOuter(sink, chunk);
+			return;
+		}
 		ProbeHashTable(context, chunk, state);
 		if (chunk.size() == 0) {
 #if STANDARD_VECTOR_SIZE >= 128
@@ -191,9 +629,9 @@ void PhysicalHashJoin::GetChunkInternal(ExecutionContext &context, DataChunk &ch
 				state->cached_chunk.Reset();
 			} else
 #endif
-			if (IsRightOuterJoin(join_type)) {
-				// check if we need to scan any unmatched tuples from the RHS for the full/right outer join
-				sink.hash_table->ScanFullOuter(chunk, sink.ht_scan_state);
+			if (IsRightOuterJoin(join_type) && FinishProbe(sink, *state)) {
+				// this is the last thread that finished probing: scan the unmatched tuples from the RHS
+				ScanFullOuter(sink, chunk);
 			}
 			return;
 		} else {
@@ -236,22 +674,127 @@ void PhysicalHashJoin::ProbeHashTable(ExecutionContext &context, DataChunk &chun
 
 	// probe the HT
 	do {
-		// fetch the chunk from the left side
-		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
-		if (state->child_chunk.size() == 0) {
+		// fetch the next chunk of the probe side
+		if (!FetchProbeChunk(context, state)) {
 			return;
 		}
 		if (sink.hash_table->size() == 0) {
 			ConstructEmptyJoinResult(sink.hash_table->join_type, sink.hash_table->has_null, state->child_chunk, chunk);
 			return;
 		}
-		// resolve the join keys for the left chunk
-		state->probe_executor.Execute(state->child_chunk, state->join_keys);
-
 		// perform the actual probe
-		state->scan_structure = sink.hash_table->Probe(state->join_keys);
+		auto &hash_table = state->partition ? *state->partition->hash_table : *sink.hash_table;
+		state->scan_structure = hash_table.Probe(state->join_keys);
 		state->scan_structure->Next(state->join_keys, state->child_chunk, chunk);
 	} while (chunk.size() == 0);
 }
 
+bool PhysicalHashJoin::FetchProbeChunk(ExecutionContext &context, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalHashJoinState *>(state_);
+	auto &sink = (HashJoinGlobalState &)*sink_state;
+	if (sink.partitions.empty()) {
+		// fetch the chunk from the left side
+		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+		if (state->child_chunk.size() == 0) {
+			return false;
+		}
+		// resolve the join keys for the left chunk
+		state->probe_executor.Execute(state->child_chunk, state->join_keys);
+		return true;
+	}
+	// partitioned hash join
+	while (state->partition_idx < sink.partitions.size()) {
+		if (!state->partition) {
+			state->partition = sink.partitions[state->partition_idx].get();
+			state->partition->Acquire();
+		}
+		if (state->partition_idx == 0) {
+			// the first partition is probed directly with the rows of the left side, the other rows are spilled
+			children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+			if (state->child_chunk.size() > 0) {
+				// the join keys are sliced below: reset them before resolving the keys of the next chunk
+				state->join_keys.Reset();
+				state->probe_executor.Execute(state->child_chunk, state->join_keys);
+				PartitionProbeChunk(context, state);
+				if (state->child_chunk.size() > 0) {
+					return true;
+				}
+				continue;
+			}
+			// the left side is exhausted
+			for (auto &spill : state->spills) {
+				if (spill) {
+					spill->Flush();
+				}
+			}
+		} else if (!state->spills.empty() && state->spills[state->partition_idx]->Scan(state->spill_chunk)) {
+			// probe the partition with the next chunk of spilled rows
+			state->child_chunk.Reference(state->spill_chunk);
+			state->join_keys.Reset();
+			state->probe_executor.Execute(state->child_chunk, state->join_keys);
+			return true;
+		} else if (!state->spills.empty()) {
+			state->spills[state->partition_idx].reset();
+		}
+		// done probing the partition: move on to the next partition
+		state->partition->Release();
+		state->partition = nullptr;
+		state->partition_idx++;
+	}
+	return false;
+}
+
+void PhysicalHashJoin::PartitionProbeChunk(ExecutionContext &context, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalHashJoinState *>(state_);
+	auto &sink = (HashJoinGlobalState &)*sink_state;
+	idx_t partition_count = sink.partitions.size();
+	if (state->spills.empty()) {
+		auto &buffer_manager = BufferManager::GetBufferManager(context.client);
+		auto types = children[0]->GetTypes();
+		state->spills.resize(partition_count);
+		for (idx_t partition_idx = 1; partition_idx < partition_count; partition_idx++) {
+			state->spills[partition_idx] = make_unique<HashJoinSpill>(buffer_manager, types);
+		}
+		state->partition_chunk.InitializeEmpty(types);
+	}
+	// hash the join keys to figure out the partition of every row
+	idx_t count = state->child_chunk.size();
+	Vector hashes(LogicalType::HASH);
+	sink.hash_table->Hash(state->join_keys, FlatVector::IncrementalSelectionVector, count, hashes);
+	hashes.Normalify(count);
+	auto hash_data = FlatVector::GetData<hash_t>(hashes);
+
+	// order the rows by partition
+	idx_t partition_indices[STANDARD_VECTOR_SIZE];
+	vector<idx_t> partition_offsets(partition_count + 1, 0);
+	for (idx_t i = 0; i < count; i++) {
+		partition_indices[i] = JoinHashTable::PartitionIndex(hash_data[i], partition_count);
+		partition_offsets[partition_indices[i] + 1]++;
+	}
+	for (idx_t partition_idx = 0; partition_idx < partition_count; partition_idx++) {
+		partition_offsets[partition_idx + 1] += partition_offsets[partition_idx];
+	}
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	vector<idx_t> positions(partition_offsets.begin(), partition_offsets.end() - 1);
+	for (idx_t i = 0; i < count; i++) {
+		sel.set_index(positions[partition_indices[i]]++, i);
+	}
+	// spill the rows of the other partitions
+	bool empty_partitions_match_nothing = join_type == JoinType::INNER || join_type == JoinType::SEMI;
+	for (idx_t partition_idx = 1; partition_idx < partition_count; partition_idx++) {
+		idx_t partition_start = partition_offsets[partition_idx];
+		idx_t partition_size = partition_offsets[partition_idx + 1] - partition_start;
+		if (partition_size == 0 ||
+		    (empty_partitions_match_nothing && sink.partitions[partition_idx]->hash_table->size() == 0)) {
+			continue;
+		}
+		SelectionVector partition_sel(sel.data() + partition_start);
+		state->partition_chunk.Slice(state->child_chunk, partition_sel, partition_size);
+		state->spills[partition_idx]->Append(state->partition_chunk);
+	}
+	// keep the rows of the first partition (which are at the start of the selection vector)
+	state->child_chunk.Slice(sel, partition_offsets[1]);
+	state->join_keys.Slice(sel, partition_offsets[1]);
+}
+
 } // namespace duckdb
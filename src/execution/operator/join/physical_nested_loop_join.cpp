@@ -4,6 +4,7 @@
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/execution/nested_loop_join.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 
 using namespace std;
 
@@ -128,13 +129,16 @@ public:
 
 class NestedLoopJoinGlobalState : public GlobalOperatorState {
 public:
-	NestedLoopJoinGlobalState() : has_null(false), right_outer_position(0) {
+	NestedLoopJoinGlobalState(BufferManager &buffer_manager, vector<LogicalType> data_types,
+	                          vector<LogicalType> condition_types)
+	    : right_data(buffer_manager, move(data_types)), right_chunks(buffer_manager, move(condition_types)),
+	      has_null(false), right_outer_position(0) {
 	}
 
 	//! Materialized data of the RHS
-	ChunkCollection right_data;
+	BufferedChunkCollection right_data;
 	//! Materialized join condition of the RHS
-	ChunkCollection right_chunks;
+	BufferedChunkCollection right_chunks;
 	//! Whether or not the RHS of the nested loop join has NULL values
 	bool has_null;
 	//! A bool indicating for each tuple in the RHS if they found a match (only used in FULL OUTER JOIN)
@@ -167,6 +171,8 @@ void PhysicalNestedLoopJoin::Sink(ExecutionContext &context, GlobalOperatorState
 void PhysicalNestedLoopJoin::Finalize(Pipeline &pipeline, ClientContext &context,
                                       unique_ptr<GlobalOperatorState> state) {
 	auto &gstate = (NestedLoopJoinGlobalState &)*state;
+	gstate.right_data.Finalize();
+	gstate.right_chunks.Finalize();
 	if (join_type == JoinType::OUTER || join_type == JoinType::RIGHT) {
 		// for FULL/RIGHT OUTER JOIN, initialize found_match to false for every tuple
 		gstate.right_found_match = unique_ptr<bool[]>(new bool[gstate.right_data.Count()]);
@@ -176,7 +182,12 @@ void PhysicalNestedLoopJoin::Finalize(Pipeline &pipeline, ClientContext &context
 }
 
 unique_ptr<GlobalOperatorState> PhysicalNestedLoopJoin::GetGlobalState(ClientContext &context) {
-	return make_unique<NestedLoopJoinGlobalState>();
+	vector<LogicalType> condition_types;
+	for (auto &cond : conditions) {
+		condition_types.push_back(cond.right->return_type);
+	}
+	return make_unique<NestedLoopJoinGlobalState>(BufferManager::GetBufferManager(context), children[1]->types,
+	                                              move(condition_types));
 }
 
 unique_ptr<LocalSinkState> PhysicalNestedLoopJoin::GetLocalSinkState(ExecutionContext &context) {
@@ -190,7 +201,7 @@ class PhysicalNestedLoopJoinState : public PhysicalOperatorState {
 public:
 	PhysicalNestedLoopJoinState(PhysicalOperator &op, PhysicalOperator *left, vector<JoinCondition> &conditions)
 	    : PhysicalOperatorState(op, left), fetch_next_left(true), fetch_next_right(false), right_chunk(0),
-	      left_tuple(0), right_tuple(0) {
+	      loaded_chunk(INVALID_INDEX), left_tuple(0), right_tuple(0) {
 		vector<LogicalType> condition_types;
 		for (auto &cond : conditions) {
 			lhs_executor.AddExpression(*cond.left);
@@ -202,6 +213,11 @@ public:
 	bool fetch_next_left;
 	bool fetch_next_right;
 	idx_t right_chunk;
+	//! The index of the RHS chunk that is loaded into right_condition and right_data
+	idx_t loaded_chunk;
+	//! The join condition and data of the RHS chunk that is currently joined
+	DataChunk right_condition;
+	DataChunk right_data;
 	DataChunk left_condition;
 	//! The executor of the LHS condition
 	ExpressionExecutor lhs_executor;
@@ -299,8 +315,9 @@ void PhysicalNestedLoopJoin::ResolveComplexJoin(ExecutionContext &context, DataC
 				if (join_type == JoinType::OUTER || join_type == JoinType::RIGHT) {
 					// if the LHS is exhausted in a FULL/RIGHT OUTER JOIN, we scan the found_match for any chunks we
 					// still need to output
-					ConstructFullOuterJoinResult(gstate.right_found_match.get(), gstate.right_data, chunk,
-					                             gstate.right_outer_position);
+					ConstructFullOuterJoinResult(gstate.right_found_match.get(), gstate.right_data,
+					                             state->right_data, chunk, gstate.right_outer_position);
+					state->loaded_chunk = INVALID_INDEX;
 				}
 				return;
 			}
@@ -315,8 +332,13 @@ void PhysicalNestedLoopJoin::ResolveComplexJoin(ExecutionContext &context, DataC
 		// now we have a left and a right chunk that we can join together
 		// note that we only get here in the case of a LEFT, INNER or FULL join
 		auto &left_chunk = state->child_chunk;
-		auto &right_chunk = gstate.right_chunks.GetChunk(state->right_chunk);
-		auto &right_data = gstate.right_data.GetChunk(state->right_chunk);
+		if (state->loaded_chunk != state->right_chunk) {
+			gstate.right_chunks.FetchChunk(state->right_chunk, state->right_condition);
+			gstate.right_data.FetchChunk(state->right_chunk, state->right_data);
+			state->loaded_chunk = state->right_chunk;
+		}
+		auto &right_chunk = state->right_condition;
+		auto &right_data = state->right_data;
 
 		// sanity check
 		left_chunk.Verify();
@@ -3,7 +3,12 @@
 #include "duckdb/common/assert.hpp"
 #include "duckdb/common/value_operations/value_operations.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/execution/executor.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/execution/sorted_run.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/storage/data_table.hpp"
 
 using namespace std;
@@ -12,11 +17,15 @@ namespace duckdb {
 
 class PhysicalOrderOperatorState : public PhysicalOperatorState {
 public:
-	PhysicalOrderOperatorState(PhysicalOperator &op, PhysicalOperator *child)
-	    : PhysicalOperatorState(op, child), position(0) {
+	PhysicalOrderOperatorState(PhysicalOperator &op, PhysicalOperator *child) : PhysicalOperatorState(op, child) {
 	}
 
-	idx_t position;
+	//! The partition of the sorted data that is being scanned
+	idx_t partition_idx = 0;
+	//! The scanner over the current partition
+	unique_ptr<SortedRunScanner> scanner;
+	//! The chunk holding the payload and sort key columns of the scanned run
+	DataChunk scan_chunk;
 };
 
 //===--------------------------------------------------------------------===//
@@ -24,63 +33,175 @@ public:
 //===--------------------------------------------------------------------===//
 class OrderByGlobalOperatorState : public GlobalOperatorState {
 public:
-	//! The lock for updating the global aggregate state
+	//! The lock for updating the global order state
 	mutex lock;
-	//! The sorted data
-	ChunkCollection sorted_data;
-	//! The sorted vector
-	unique_ptr<idx_t[]> sorted_vector;
+	//! The types of the sorted runs: the payload columns followed by the sort key columns
+	vector<LogicalType> run_types;
+	//! The sort key columns of the sorted runs
+	SortKeyInfo key_info;
+	//! The sorted runs that have yet to be merged
+	vector<unique_ptr<SortedRun>> sorted_runs;
+	//! The splitters dividing the sorted runs into partitions that are merged in parallel
+	unique_ptr<SortedRunSplitters> splitters;
+	//! The amount of merge tasks that have finished
+	idx_t finished_merges = 0;
+	//! The final sorted data: the concatenation of these runs is sorted
+	vector<unique_ptr<SortedRun>> sorted_data;
+};
+
+class OrderByLocalState : public LocalSinkState {
+public:
+	OrderByLocalState(PhysicalOrder &op, idx_t run_threshold) : run_threshold(run_threshold) {
+		vector<LogicalType> key_types;
+		for (auto &order : op.orders) {
+			key_types.push_back(order.expression->return_type);
+			executor.AddExpression(*order.expression);
+		}
+		key_chunk.Initialize(key_types);
+	}
+
+	//! The executor used to compute the sort keys
+	ExpressionExecutor executor;
+	//! Holds the sort keys of the current input chunk
+	DataChunk key_chunk;
+	//! The payload of the thread-local run that is being gathered
+	ChunkCollection payload;
+	//! The sort keys of the thread-local run that is being gathered
+	ChunkCollection keys;
+	//! The amount of rows after which the thread-local data is sorted and flushed as a sorted run
+	idx_t run_threshold;
 };
 
 unique_ptr<GlobalOperatorState> PhysicalOrder::GetGlobalState(ClientContext &context) {
-	return make_unique<OrderByGlobalOperatorState>();
+	auto state = make_unique<OrderByGlobalOperatorState>();
+	state->run_types = types;
+	state->key_info.key_offset = types.size();
+	vector<LogicalType> key_types;
+	for (auto &order : orders) {
+		key_types.push_back(order.expression->return_type);
+		state->key_info.order_types.push_back(order.type);
+		state->key_info.null_orders.push_back(order.null_order);
+	}
+	state->run_types.insert(state->run_types.end(), key_types.begin(), key_types.end());
+	state->key_info.InitializeLayout(move(key_types));
+	return move(state);
+}
+
+unique_ptr<LocalSinkState> PhysicalOrder::GetLocalSinkState(ExecutionContext &context) {
+	// flush a sorted run every ~1M rows per thread, or for every vector when parallelism is forced so that the merge
+	// phase is exercised even for small inputs
+	idx_t run_threshold = context.client.force_parallelism ? STANDARD_VECTOR_SIZE : SORTED_RUN_THRESHOLD;
+	return make_unique<OrderByLocalState>(*this, run_threshold);
+}
+
+//! Sorts the thread-local data and moves it into a new sorted run in the global state
+static void FlushSortedRun(ClientContext &context, OrderByGlobalOperatorState &gstate, OrderByLocalState &lstate) {
+	idx_t count = lstate.keys.Count();
+	if (count == 0) {
+		return;
+	}
+	auto order = unique_ptr<idx_t[]>(new idx_t[count]);
+	lstate.keys.Sort(gstate.key_info.order_types, gstate.key_info.null_orders, order.get());
+
+	auto run = make_unique<SortedRun>(BufferManager::GetBufferManager(context), gstate.run_types);
+	DataChunk payload_chunk, key_chunk, run_chunk;
+	payload_chunk.Initialize(lstate.payload.Types());
+	key_chunk.Initialize(lstate.keys.Types());
+	run_chunk.InitializeEmpty(gstate.run_types);
+	for (idx_t position = 0; position < count; position += STANDARD_VECTOR_SIZE) {
+		payload_chunk.Reset();
+		key_chunk.Reset();
+		lstate.payload.MaterializeSortedChunk(payload_chunk, order.get(), position);
+		lstate.keys.MaterializeSortedChunk(key_chunk, order.get(), position);
+		for (idx_t col_idx = 0; col_idx < payload_chunk.ColumnCount(); col_idx++) {
+			run_chunk.data[col_idx].Reference(payload_chunk.data[col_idx]);
+		}
+		for (idx_t col_idx = 0; col_idx < key_chunk.ColumnCount(); col_idx++) {
+			run_chunk.data[gstate.key_info.key_offset + col_idx].Reference(key_chunk.data[col_idx]);
+		}
+		run_chunk.SetCardinality(payload_chunk);
+		run->Append(run_chunk);
+	}
+	run->Finalize();
+	lstate.payload.Reset();
+	lstate.keys.Reset();
+
+	lock_guard<mutex> glock(gstate.lock);
+	gstate.sorted_runs.push_back(move(run));
 }
 
-void PhysicalOrder::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate,
+void PhysicalOrder::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_p,
                          DataChunk &input) {
-	// concatenate all the data of the child chunks
 	auto &gstate = (OrderByGlobalOperatorState &)state;
-	lock_guard<mutex> glock(gstate.lock);
-	gstate.sorted_data.Append(input);
+	auto &lstate = (OrderByLocalState &)lstate_p;
+
+	// compute the sort keys and append them together with the payload to the thread-local collections
+	lstate.key_chunk.Reset();
+	lstate.executor.Execute(input, lstate.key_chunk);
+	lstate.payload.Append(input);
+	lstate.keys.Append(lstate.key_chunk);
+	D_ASSERT(lstate.payload.Count() == lstate.keys.Count());
+
+	if (lstate.keys.Count() >= lstate.run_threshold) {
+		FlushSortedRun(context.client, gstate, lstate);
+	}
+}
+
+void PhysicalOrder::Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate) {
+	FlushSortedRun(context.client, (OrderByGlobalOperatorState &)state, (OrderByLocalState &)lstate);
 }
 
 //===--------------------------------------------------------------------===//
 // Finalize
 //===--------------------------------------------------------------------===//
-void PhysicalOrder::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
-	// finalize: perform the actual sorting
-	auto &sink = (OrderByGlobalOperatorState &)*state;
-	ChunkCollection &big_data = sink.sorted_data;
-
-	// compute the sorting columns from the input data
-	ExpressionExecutor executor;
-	vector<LogicalType> sort_types;
-	vector<OrderType> order_types;
-	vector<OrderByNullType> null_order_types;
-	for (idx_t i = 0; i < orders.size(); i++) {
-		auto &expr = orders[i].expression;
-		sort_types.push_back(expr->return_type);
-		order_types.push_back(orders[i].type);
-		null_order_types.push_back(orders[i].null_order);
-		executor.AddExpression(*expr);
+//! The merge task merges one partition of the sorted runs, i.e. the rows of every run that fall between two splitters
+class PhysicalOrderMergeTask : public Task {
+public:
+	PhysicalOrderMergeTask(OrderByGlobalOperatorState &state_, idx_t partition_idx_)
+	    : state(state_), partition_idx(partition_idx_) {
 	}
 
-	ChunkCollection sort_collection;
-	for (idx_t i = 0; i < big_data.ChunkCount(); i++) {
-		DataChunk sort_chunk;
-		sort_chunk.Initialize(sort_types);
+	void Execute() override {
+		auto ranges = state.splitters->GetPartition(partition_idx);
+		auto merged_run = SortedRun::Merge(ranges, state.key_info);
 
-		executor.Execute(big_data.GetChunk(i), sort_chunk);
-		sort_collection.Append(sort_chunk);
+		lock_guard<mutex> glock(state.lock);
+		state.sorted_data[partition_idx] = move(merged_run);
+		if (++state.finished_merges == state.sorted_data.size()) {
+			// this was the last merge task: the sorted runs are no longer needed
+			state.splitters.reset();
+			state.sorted_runs.clear();
+		}
 	}
 
-	D_ASSERT(sort_collection.Count() == big_data.Count());
-
-	// now perform the actual sort
-	sink.sorted_vector = unique_ptr<idx_t[]>(new idx_t[sort_collection.Count()]);
-	sort_collection.Sort(order_types, null_order_types, sink.sorted_vector.get());
+private:
+	OrderByGlobalOperatorState &state;
+	idx_t partition_idx;
+};
 
-	PhysicalSink::Finalize(pipeline, context, move(state));
+void PhysicalOrder::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
+	this->sink_state = move(state);
+	auto &gstate = (OrderByGlobalOperatorState &)*this->sink_state;
+	if (gstate.sorted_runs.size() <= 1) {
+		// zero or one run: no merging required
+		gstate.sorted_data = move(gstate.sorted_runs);
+		return;
+	}
+	// multiple runs: split them into one key range per thread, and merge the key ranges in parallel
+	vector<SortedRun *> runs;
+	for (auto &run : gstate.sorted_runs) {
+		runs.push_back(run.get());
+	}
+	auto &scheduler = TaskScheduler::GetScheduler(context);
+	gstate.splitters = make_unique<SortedRunSplitters>(move(runs), scheduler.NumberOfThreads(), gstate.key_info);
+
+	idx_t partition_count = gstate.splitters->PartitionCount();
+	gstate.sorted_data.resize(partition_count);
+	vector<unique_ptr<Task>> tasks;
+	for (idx_t partition_idx = 0; partition_idx < partition_count; partition_idx++) {
+		tasks.push_back(make_unique<PhysicalOrderMergeTask>(gstate, partition_idx));
+	}
+	pipeline.ScheduleFinalizeTasks(move(tasks));
 }
 
 //===--------------------------------------------------------------------===//
@@ -89,13 +210,26 @@ void PhysicalOrder::Finalize(Pipeline &pipeline, ClientContext &context, unique_
 void PhysicalOrder::GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
 	auto state = reinterpret_cast<PhysicalOrderOperatorState *>(state_);
 	auto &sink = (OrderByGlobalOperatorState &)*this->sink_state;
-	ChunkCollection &big_data = sink.sorted_data;
-	if (state->position >= big_data.Count()) {
-		return;
+	while (true) {
+		if (state->partition_idx >= sink.sorted_data.size()) {
+			return;
+		}
+		if (!state->scanner) {
+			state->scanner = make_unique<SortedRunScanner>(*sink.sorted_data[state->partition_idx]);
+		}
+		state->scanner->Scan(state->scan_chunk);
+		if (state->scan_chunk.size() > 0) {
+			break;
+		}
+		// this partition is exhausted: move on to the next one
+		state->partition_idx++;
+		state->scanner.reset();
 	}
-
-	big_data.MaterializeSortedChunk(chunk, sink.sorted_vector.get(), state->position);
-	state->position += STANDARD_VECTOR_SIZE;
+	// output only the payload columns of the run
+	for (idx_t col_idx = 0; col_idx < chunk.ColumnCount(); col_idx++) {
+		chunk.data[col_idx].Reference(state->scan_chunk.data[col_idx]);
+	}
+	chunk.SetCardinality(state->scan_chunk);
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalOrder::GetOperatorState() {
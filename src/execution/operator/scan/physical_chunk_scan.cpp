@@ -11,10 +11,21 @@ public:
 
 	//! The current position in the scan
 	idx_t chunk_index;
+	//! The chunk fetched from a buffered chunk collection
+	DataChunk fetch_chunk;
 };
 
 void PhysicalChunkScan::GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
 	auto state = (PhysicalChunkScanState *)state_;
+	if (buffered_collection) {
+		if (state->chunk_index >= buffered_collection->ChunkCount()) {
+			return;
+		}
+		buffered_collection->FetchChunk(state->chunk_index, state->fetch_chunk);
+		chunk.Reference(state->fetch_chunk);
+		state->chunk_index++;
+		return;
+	}
 	D_ASSERT(collection);
 	if (collection->Count() == 0) {
 		return;
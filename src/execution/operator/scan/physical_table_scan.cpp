@@ -32,6 +32,47 @@ PhysicalTableScan::PhysicalTableScan(vector<LogicalType> types, TableFunction fu
       table_filters(move(table_filters_p)) {
 }
 
+void PhysicalTableScan::AddRuntimeRangeFilter(idx_t column_index, const Value &min, const Value &max) {
+	D_ASSERT(function.filter_pushdown);
+	if (!runtime_filters) {
+		runtime_filters = make_unique<TableFilterSet>();
+		if (table_filters) {
+			*runtime_filters = *table_filters;
+		}
+	}
+	// the segments evaluate either a single comparison or a (lower bound, upper bound) pair of comparisons per column:
+	// combine the range with the bounds that are already there
+	auto &filters = runtime_filters->filters[column_index];
+	TableFilter lower(min, ExpressionType::COMPARE_GREATERTHANOREQUALTO, column_index);
+	TableFilter upper(max, ExpressionType::COMPARE_LESSTHANOREQUALTO, column_index);
+	for (auto &filter : filters) {
+		switch (filter.comparison_type) {
+		case ExpressionType::COMPARE_GREATERTHAN:
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			if (filter.constant >= lower.constant) {
+				lower = filter;
+			}
+			break;
+		case ExpressionType::COMPARE_LESSTHAN:
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			if (filter.constant <= upper.constant) {
+				upper = filter;
+			}
+			break;
+		default:
+			// an equality filter is at least as selective as the range
+			return;
+		}
+	}
+	filters.clear();
+	filters.push_back(move(lower));
+	filters.push_back(move(upper));
+}
+
+void PhysicalTableScan::ClearRuntimeFilters() {
+	runtime_filters.reset();
+}
+
 void PhysicalTableScan::GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
 	auto &state = (PhysicalTableScanOperatorState &)*state_;
 	if (column_ids.empty()) {
@@ -40,6 +81,7 @@ void PhysicalTableScan::GetChunkInternal(ExecutionContext &context, DataChunk &c
 	if (!state.initialized) {
 		state.parallel_state = nullptr;
 		if (function.init) {
+			auto filters = runtime_filters ? runtime_filters.get() : table_filters.get();
 			auto &task = context.task;
 			// check if there is any parallel state to fetch
 			state.parallel_state = nullptr;
@@ -48,10 +90,10 @@ void PhysicalTableScan::GetChunkInternal(ExecutionContext &context, DataChunk &c
 				// parallel scan init
 				state.parallel_state = task_info->second;
 				state.operator_data = function.parallel_init(context.client, bind_data.get(), state.parallel_state,
-				                                             column_ids, table_filters.get());
+				                                             column_ids, filters);
 			} else {
 				// sequential scan init
-				state.operator_data = function.init(context.client, bind_data.get(), column_ids, table_filters.get());
+				state.operator_data = function.init(context.client, bind_data.get(), column_ids, filters);
 			}
 			if (!state.operator_data) {
 				// no operator data returned: nothing to scan
@@ -2,7 +2,6 @@
 
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 
-#include "duckdb/common/types/chunk_collection.hpp"
 #include "duckdb/execution/aggregate_hashtable.hpp"
 #include "duckdb/parallel/pipeline.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
@@ -62,6 +61,7 @@ void PhysicalRecursiveCTE::GetChunkInternal(ExecutionContext &context, DataChunk
 				return;
 			}
 		} while (chunk.size() != 0);
+		working_table->Finalize();
 		ExecuteRecursivePipelines(context);
 		state->recursing = true;
 	}
@@ -77,8 +77,7 @@ void PhysicalRecursiveCTE::GetChunkInternal(ExecutionContext &context, DataChunk
 			}
 
 			working_table->Reset();
-			working_table->Merge(intermediate_table);
-			intermediate_table.Reset();
+			working_table->Merge(*intermediate_table);
 
 			ExecuteRecursivePipelines(context);
 			state->bottom_state = children[1]->GetOperatorState();
@@ -92,11 +91,11 @@ void PhysicalRecursiveCTE::GetChunkInternal(ExecutionContext &context, DataChunk
 			// intermediate tables.
 			idx_t match_count = ProbeHT(chunk, state);
 			if (match_count > 0) {
-				intermediate_table.Append(chunk);
+				intermediate_table->Append(chunk);
 				state->intermediate_empty = false;
 			}
 		} else {
-			intermediate_table.Append(chunk);
+			intermediate_table->Append(chunk);
 			state->intermediate_empty = false;
 		}
 
@@ -1,6 +1,7 @@
 #include "duckdb/execution/operator/set/physical_recursive_cte.hpp"
 #include "duckdb/execution/operator/scan/physical_chunk_scan.hpp"
 #include "duckdb/execution/physical_plan_generator.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/planner/expression/bound_reference_expression.hpp"
 #include "duckdb/planner/operator/logical_recursive_cte.hpp"
 #include "duckdb/planner/operator/logical_cteref.hpp"
@@ -12,9 +13,10 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalRecursiveC
 	D_ASSERT(op.children.size() == 2);
 
 	// Create the working_table that the PhysicalRecursiveCTE will use for evaluation.
-	auto working_table = std::make_shared<ChunkCollection>();
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	auto working_table = std::make_shared<BufferedChunkCollection>(buffer_manager, op.types);
 
-	// Add the ChunkCollection to the context of this PhysicalPlanGenerator
+	// Add the BufferedChunkCollection to the context of this PhysicalPlanGenerator
 	rec_ctes[op.table_index] = working_table;
 
 	auto left = CreatePlan(*op.children[0]);
@@ -22,6 +24,7 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalRecursiveC
 
 	auto cte = make_unique<PhysicalRecursiveCTE>(op.types, op.union_all, move(left), move(right));
 	cte->working_table = working_table;
+	cte->intermediate_table = make_unique<BufferedChunkCollection>(buffer_manager, op.types);
 
 	return move(cte);
 }
@@ -36,7 +39,7 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalCTERef &op
 	if (cte == rec_ctes.end()) {
 		throw Exception("Referenced recursive CTE does not exist.");
 	}
-	chunk_scan->collection = cte->second.get();
+	chunk_scan->buffered_collection = cte->second.get();
 	return move(chunk_scan);
 }
 
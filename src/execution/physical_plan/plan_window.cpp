@@ -1,23 +1,139 @@
+#include "duckdb/execution/operator/aggregate/physical_streaming_window.hpp"
 #include "duckdb/execution/operator/aggregate/physical_window.hpp"
 #include "duckdb/execution/physical_plan_generator.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/expression/bound_window_expression.hpp"
+#include "duckdb/planner/operator/logical_filter.hpp"
+#include "duckdb/planner/operator/logical_order.hpp"
+#include "duckdb/planner/operator/logical_top_n.hpp"
 #include "duckdb/planner/operator/logical_window.hpp"
 
 namespace duckdb {
 using namespace std;
 
+struct SortedColumn {
+	SortedColumn(idx_t column_index, OrderType type, OrderByNullType null_order)
+	    : column_index(column_index), type(type), null_order(null_order) {
+	}
+
+	idx_t column_index;
+	OrderType type;
+	OrderByNullType null_order;
+};
+
+static bool ReferencesColumn(Expression &expr, idx_t column_index) {
+	return expr.type == ExpressionType::BOUND_REF && ((BoundReferenceExpression &)expr).index == column_index;
+}
+
+//! Returns the columns that the output of the operator is sorted on, in the order of the sort
+static vector<SortedColumn> GetSortedColumns(LogicalOperator &op) {
+	vector<SortedColumn> result;
+	switch (op.type) {
+	case LogicalOperatorType::LOGICAL_ORDER_BY:
+	case LogicalOperatorType::LOGICAL_TOP_N: {
+		auto &orders = op.type == LogicalOperatorType::LOGICAL_ORDER_BY ? ((LogicalOrder &)op).orders
+		                                                                : ((LogicalTopN &)op).orders;
+		for (auto &order : orders) {
+			if (order.expression->type != ExpressionType::BOUND_REF) {
+				break;
+			}
+			auto &colref = (BoundReferenceExpression &)*order.expression;
+			result.push_back(SortedColumn(colref.index, order.type, order.null_order));
+		}
+		break;
+	}
+	case LogicalOperatorType::LOGICAL_PROJECTION: {
+		// a projection keeps the order of its input, as long as the sorted columns are projected
+		for (auto &column : GetSortedColumns(*op.children[0])) {
+			idx_t projected_index = INVALID_INDEX;
+			for (idx_t expr_idx = 0; expr_idx < op.expressions.size(); expr_idx++) {
+				if (ReferencesColumn(*op.expressions[expr_idx], column.column_index)) {
+					projected_index = expr_idx;
+					break;
+				}
+			}
+			if (projected_index == INVALID_INDEX) {
+				break;
+			}
+			result.push_back(SortedColumn(projected_index, column.type, column.null_order));
+		}
+		break;
+	}
+	case LogicalOperatorType::LOGICAL_FILTER:
+		if (((LogicalFilter &)op).projection_map.empty()) {
+			result = GetSortedColumns(*op.children[0]);
+		}
+		break;
+	default:
+		break;
+	}
+	return result;
+}
+
+//! Returns whether or not the input of the window is sorted on the PARTITION BY and ORDER BY clauses of the window
+//! expression, i.e. whether the window expression can be computed without sorting the input
+static bool InputIsSorted(BoundWindowExpression &wexpr, vector<SortedColumn> &sorted_columns) {
+	idx_t partition_count = wexpr.partitions.size();
+	if (partition_count + wexpr.orders.size() > sorted_columns.size()) {
+		return false;
+	}
+	// the rows of a partition only have to be adjacent: the first sorted columns have to be the partition columns, in
+	// any order or direction
+	for (idx_t i = 0; i < partition_count; i++) {
+		bool found = false;
+		for (auto &pexpr : wexpr.partitions) {
+			found = found || ReferencesColumn(*pexpr, sorted_columns[i].column_index);
+		}
+		if (!found) {
+			return false;
+		}
+	}
+	for (auto &pexpr : wexpr.partitions) {
+		bool found = false;
+		for (idx_t i = 0; i < partition_count; i++) {
+			found = found || ReferencesColumn(*pexpr, sorted_columns[i].column_index);
+		}
+		if (!found) {
+			return false;
+		}
+	}
+	// the ORDER BY clause has to match the next sorted columns exactly
+	for (idx_t i = 0; i < wexpr.orders.size(); i++) {
+		auto &order = wexpr.orders[i];
+		auto &column = sorted_columns[partition_count + i];
+		if (!ReferencesColumn(*order.expression, column.column_index) || order.type != column.type ||
+		    order.null_order != column.null_order) {
+			return false;
+		}
+	}
+	return true;
+}
+
 unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalWindow &op) {
 	D_ASSERT(op.children.size() == 1);
 
-	auto plan = CreatePlan(*op.children[0]);
-#ifdef DEBUG
+	// check if the window expressions can be computed while streaming through the input, which is the case if the
+	// input is already sorted on their PARTITION BY and ORDER BY clauses
+	auto sorted_columns = GetSortedColumns(*op.children[0]);
+	bool is_streaming = true;
 	for (auto &expr : op.expressions) {
 		D_ASSERT(expr->IsWindow());
+		auto &wexpr = (BoundWindowExpression &)*expr;
+		if (!PhysicalStreamingWindow::IsStreamingFunction(wexpr) || !InputIsSorted(wexpr, sorted_columns)) {
+			is_streaming = false;
+			break;
+		}
 	}
-#endif
 
-	auto window = make_unique<PhysicalWindow>(op.types, move(op.expressions));
+	auto plan = CreatePlan(*op.children[0]);
+	unique_ptr<PhysicalOperator> window;
+	if (is_streaming) {
+		window = make_unique<PhysicalStreamingWindow>(op.types, move(op.expressions));
+	} else {
+		window = make_unique<PhysicalWindow>(op.types, move(op.expressions));
+	}
 	window->children.push_back(move(plan));
-	return move(window);
+	return window;
 }
 
 } // namespace duckdb
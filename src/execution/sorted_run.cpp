@@ -0,0 +1,429 @@
+#include "duckdb/execution/sorted_run.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/operator/comparison_operators.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+using namespace std;
+
+//===--------------------------------------------------------------------===//
+// Comparison
+//===--------------------------------------------------------------------===//
+template <class T>
+static int TemplatedCompareValue(Vector &left_vec, idx_t left_idx, Vector &right_vec, idx_t right_idx) {
+	auto left_val = FlatVector::GetData<T>(left_vec)[left_idx];
+	auto right_val = FlatVector::GetData<T>(right_vec)[right_idx];
+	if (Equals::Operation<T>(left_val, right_val)) {
+		return 0;
+	}
+	return LessThan::Operation<T>(left_val, right_val) ? -1 : 1;
+}
+
+static int CompareValue(Vector &left_vec, idx_t left_idx, Vector &right_vec, idx_t right_idx,
+                        OrderByNullType null_order) {
+	D_ASSERT(left_vec.vector_type == VectorType::FLAT_VECTOR);
+	D_ASSERT(right_vec.vector_type == VectorType::FLAT_VECTOR);
+	bool left_null = FlatVector::IsNull(left_vec, left_idx);
+	bool right_null = FlatVector::IsNull(right_vec, right_idx);
+	if (left_null || right_null) {
+		if (left_null && right_null) {
+			return 0;
+		}
+		bool nulls_first = null_order == OrderByNullType::NULLS_FIRST;
+		return left_null == nulls_first ? -1 : 1;
+	}
+	switch (left_vec.type.InternalType()) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+		return TemplatedCompareValue<int8_t>(left_vec, left_idx, right_vec, right_idx);
+	case PhysicalType::INT16:
+		return TemplatedCompareValue<int16_t>(left_vec, left_idx, right_vec, right_idx);
+	case PhysicalType::INT32:
+		return TemplatedCompareValue<int32_t>(left_vec, left_idx, right_vec, right_idx);
+	case PhysicalType::INT64:
+		return TemplatedCompareValue<int64_t>(left_vec, left_idx, right_vec, right_idx);
+	case PhysicalType::INT128:
+		return TemplatedCompareValue<hugeint_t>(left_vec, left_idx, right_vec, right_idx);
+	case PhysicalType::FLOAT:
+		return TemplatedCompareValue<float>(left_vec, left_idx, right_vec, right_idx);
+	case PhysicalType::DOUBLE:
+		return TemplatedCompareValue<double>(left_vec, left_idx, right_vec, right_idx);
+	case PhysicalType::VARCHAR:
+		return TemplatedCompareValue<string_t>(left_vec, left_idx, right_vec, right_idx);
+	case PhysicalType::INTERVAL:
+		return TemplatedCompareValue<interval_t>(left_vec, left_idx, right_vec, right_idx);
+	default:
+		throw NotImplementedException("Unimplemented type for sort key comparison");
+	}
+}
+
+int SortKeyInfo::Compare(DataChunk &left, idx_t left_idx, DataChunk &right, idx_t right_idx) {
+	for (idx_t key_idx = 0; key_idx < order_types.size(); key_idx++) {
+		auto col_idx = key_offset + key_idx;
+		auto cmp = CompareValue(left.data[col_idx], left_idx, right.data[col_idx], right_idx, null_orders[key_idx]);
+		if (cmp != 0) {
+			return order_types[key_idx] == OrderType::ASCENDING ? cmp : -cmp;
+		}
+	}
+	return 0;
+}
+
+int SortKeyInfo::Compare(data_ptr_t left_key, DataChunk &left, idx_t left_idx, data_ptr_t right_key, DataChunk &right,
+                         idx_t right_idx) {
+	if (layout) {
+		auto cmp = memcmp(left_key, right_key, layout->exact_width);
+		if (cmp != 0 || layout->exact) {
+			return cmp;
+		}
+	}
+	// the normalized keys are equal but do not hold the full values: compare the original values
+	return Compare(left, left_idx, right, right_idx);
+}
+
+void SortKeyInfo::InitializeLayout(vector<LogicalType> key_types) {
+	for (auto &type : key_types) {
+		if (!SortKeyLayout::IsSupported(type)) {
+			// the sort keys cannot be normalized: rows are compared using their original values
+			return;
+		}
+	}
+	layout = make_unique<SortKeyLayout>(move(key_types), order_types, null_orders);
+}
+
+void SortKeyInfo::EncodeKeys(DataChunk &chunk, data_ptr_t key_data) {
+	D_ASSERT(layout);
+	for (idx_t key_idx = 0; key_idx < order_types.size(); key_idx++) {
+		layout->EncodeColumn(key_idx, chunk.data[key_offset + key_idx], chunk.size(), key_data, layout->key_width);
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Sorted Run
+//===--------------------------------------------------------------------===//
+SortedRun::SortedRun(BufferManager &buffer_manager, vector<LogicalType> types_p)
+    : buffer_manager(buffer_manager), types(move(types_p)), data(buffer_manager, types) {
+}
+
+void SortedRun::Append(DataChunk &chunk) {
+	data.Append(chunk);
+}
+
+void SortedRun::Finalize() {
+	data.Finalize();
+}
+
+template <class T>
+static void TemplatedCopyValue(Vector &source, idx_t source_idx, Vector &target, idx_t target_idx) {
+	FlatVector::GetData<T>(target)[target_idx] = FlatVector::GetData<T>(source)[source_idx];
+}
+
+//! Copies a single row from the source chunk into the target chunk; any strings are copied into the target chunk
+static void CopyRow(DataChunk &source, idx_t source_idx, DataChunk &target, idx_t target_idx) {
+	for (idx_t col_idx = 0; col_idx < source.ColumnCount(); col_idx++) {
+		auto &source_vec = source.data[col_idx];
+		auto &target_vec = target.data[col_idx];
+		D_ASSERT(source_vec.vector_type == VectorType::FLAT_VECTOR);
+		if (FlatVector::IsNull(source_vec, source_idx)) {
+			FlatVector::SetNull(target_vec, target_idx, true);
+			continue;
+		}
+		switch (source_vec.type.InternalType()) {
+		case PhysicalType::BOOL:
+		case PhysicalType::INT8:
+			TemplatedCopyValue<int8_t>(source_vec, source_idx, target_vec, target_idx);
+			break;
+		case PhysicalType::INT16:
+			TemplatedCopyValue<int16_t>(source_vec, source_idx, target_vec, target_idx);
+			break;
+		case PhysicalType::INT32:
+			TemplatedCopyValue<int32_t>(source_vec, source_idx, target_vec, target_idx);
+			break;
+		case PhysicalType::INT64:
+			TemplatedCopyValue<int64_t>(source_vec, source_idx, target_vec, target_idx);
+			break;
+		case PhysicalType::INT128:
+			TemplatedCopyValue<hugeint_t>(source_vec, source_idx, target_vec, target_idx);
+			break;
+		case PhysicalType::FLOAT:
+			TemplatedCopyValue<float>(source_vec, source_idx, target_vec, target_idx);
+			break;
+		case PhysicalType::DOUBLE:
+			TemplatedCopyValue<double>(source_vec, source_idx, target_vec, target_idx);
+			break;
+		case PhysicalType::INTERVAL:
+			TemplatedCopyValue<interval_t>(source_vec, source_idx, target_vec, target_idx);
+			break;
+		case PhysicalType::VARCHAR: {
+			auto source_str = FlatVector::GetData<string_t>(source_vec)[source_idx];
+			FlatVector::GetData<string_t>(target_vec)[target_idx] =
+			    StringVector::AddStringOrBlob(target_vec, source_str);
+			break;
+		}
+		default:
+			// nested types: fall back to the (slow) value API
+			target_vec.SetValue(target_idx, source_vec.GetValue(source_idx));
+			break;
+		}
+	}
+}
+
+//! Holds a chunk of a sorted run together with the normalized sort keys of its rows
+struct SortedRunChunk {
+	explicit SortedRunChunk(SortKeyInfo &info) : info(info), chunk_idx(INVALID_INDEX), key_width(info.KeyWidth()) {
+		if (key_width > 0) {
+			keys = unique_ptr<data_t[]>(new data_t[key_width * STANDARD_VECTOR_SIZE]);
+		}
+	}
+
+	SortKeyInfo &info;
+	DataChunk chunk;
+	//! The index of the chunk within its run
+	idx_t chunk_idx;
+	idx_t key_width;
+	unique_ptr<data_t[]> keys;
+
+	void Load(SortedRun &run, idx_t new_chunk_idx) {
+		if (chunk_idx == new_chunk_idx) {
+			return;
+		}
+		run.FetchChunk(new_chunk_idx, chunk);
+		chunk_idx = new_chunk_idx;
+		if (key_width > 0) {
+			info.EncodeKeys(chunk, keys.get());
+		}
+	}
+
+	data_ptr_t Key(idx_t row_idx) {
+		return key_width > 0 ? keys.get() + row_idx * key_width : nullptr;
+	}
+
+	//! Compares a row of the chunk with the given row
+	int Compare(idx_t row_idx, data_ptr_t key, DataChunk &other, idx_t other_idx) {
+		return info.Compare(Key(row_idx), chunk, row_idx, key, other, other_idx);
+	}
+};
+
+idx_t SortedRun::LowerBound(DataChunk &chunk, idx_t row_idx, data_ptr_t key, SortKeyInfo &info) {
+	SortedRunChunk run_chunk(info);
+	// find the first chunk of which the last row is not ordered before the row
+	idx_t lower = 0;
+	idx_t upper = ChunkCount();
+	while (lower < upper) {
+		idx_t middle = (lower + upper) / 2;
+		run_chunk.Load(*this, middle);
+		if (run_chunk.Compare(run_chunk.chunk.size() - 1, key, chunk, row_idx) < 0) {
+			lower = middle + 1;
+		} else {
+			upper = middle;
+		}
+	}
+	if (lower == ChunkCount()) {
+		// every row of the run is ordered before the row
+		return Count();
+	}
+	// now find the first row within that chunk
+	idx_t chunk_idx = lower;
+	run_chunk.Load(*this, chunk_idx);
+	lower = 0;
+	upper = run_chunk.chunk.size();
+	while (lower < upper) {
+		idx_t middle = (lower + upper) / 2;
+		if (run_chunk.Compare(middle, key, chunk, row_idx) < 0) {
+			lower = middle + 1;
+		} else {
+			upper = middle;
+		}
+	}
+	return chunk_idx * STANDARD_VECTOR_SIZE + lower;
+}
+
+//! Reads the rows of a range of a sorted run in order
+struct MergeSource {
+	MergeSource(SortedRunRange &range, SortKeyInfo &info)
+	    : run(range.run), position(range.begin), end(range.end), current(info) {
+		Load();
+	}
+
+	SortedRun &run;
+	//! The row of the run that is read next
+	idx_t position;
+	idx_t end;
+	//! The chunk holding the current row
+	SortedRunChunk current;
+
+	bool Exhausted() {
+		return position >= end;
+	}
+	idx_t RowIndex() {
+		return position % STANDARD_VECTOR_SIZE;
+	}
+	void Next() {
+		position++;
+		Load();
+	}
+
+private:
+	void Load() {
+		if (!Exhausted()) {
+			current.Load(run, position / STANDARD_VECTOR_SIZE);
+		}
+	}
+};
+
+unique_ptr<SortedRun> SortedRun::Merge(vector<SortedRunRange> &ranges, SortKeyInfo &info) {
+	D_ASSERT(ranges.size() > 0);
+	auto result = make_unique<SortedRun>(ranges[0].run.buffer_manager, ranges[0].run.types);
+
+	vector<unique_ptr<MergeSource>> sources;
+	vector<idx_t> heap;
+	for (auto &range : ranges) {
+		sources.push_back(make_unique<MergeSource>(range, info));
+		if (!sources.back()->Exhausted()) {
+			heap.push_back(sources.size() - 1);
+		}
+	}
+	// the sources are kept in a heap with the source of the smallest row on top; ties are resolved in favor of the
+	// earlier source to keep the merge stable
+	auto ordered_after = [&](idx_t left, idx_t right) {
+		auto &left_source = *sources[left];
+		auto &right_source = *sources[right];
+		auto right_idx = right_source.RowIndex();
+		auto cmp = left_source.current.Compare(left_source.RowIndex(), right_source.current.Key(right_idx),
+		                                       right_source.current.chunk, right_idx);
+		return cmp != 0 ? cmp > 0 : left > right;
+	};
+	std::make_heap(heap.begin(), heap.end(), ordered_after);
+
+	DataChunk output;
+	output.Initialize(result->types);
+	while (!heap.empty()) {
+		std::pop_heap(heap.begin(), heap.end(), ordered_after);
+		auto &source = *sources[heap.back()];
+		CopyRow(source.current.chunk, source.RowIndex(), output, output.size());
+		output.SetCardinality(output.size() + 1);
+		if (output.size() == STANDARD_VECTOR_SIZE) {
+			result->Append(output);
+			output.Reset();
+		}
+		source.Next();
+		if (source.Exhausted()) {
+			heap.pop_back();
+		} else {
+			std::push_heap(heap.begin(), heap.end(), ordered_after);
+		}
+	}
+	result->Append(output);
+	result->Finalize();
+	return result;
+}
+
+//===--------------------------------------------------------------------===//
+// Sorted Run Splitters
+//===--------------------------------------------------------------------===//
+SortedRunSplitters::SortedRunSplitters(vector<SortedRun *> runs_p, idx_t partition_count, SortKeyInfo &info)
+    : runs(move(runs_p)), info(info) {
+	D_ASSERT(runs.size() > 0);
+	auto &types = runs[0]->types;
+	partition_count = MinValue<idx_t>(partition_count, STANDARD_VECTOR_SIZE);
+
+	// sample evenly spaced rows of every run; every sample stands for the rows up to the next sample of its run
+	ChunkCollection samples;
+	vector<idx_t> weights;
+	DataChunk sample_chunk;
+	sample_chunk.Initialize(types);
+	idx_t total_weight = 0;
+	for (auto run : runs) {
+		SortedRunChunk run_chunk(info);
+		idx_t sample_count = MinValue<idx_t>(run->Count(), partition_count * SAMPLES_PER_PARTITION);
+		for (idx_t sample_idx = 0; sample_idx < sample_count; sample_idx++) {
+			idx_t row = sample_idx * run->Count() / sample_count;
+			run_chunk.Load(*run, row / STANDARD_VECTOR_SIZE);
+			CopyRow(run_chunk.chunk, row % STANDARD_VECTOR_SIZE, sample_chunk, sample_chunk.size());
+			sample_chunk.SetCardinality(sample_chunk.size() + 1);
+			if (sample_chunk.size() == STANDARD_VECTOR_SIZE) {
+				samples.Append(sample_chunk);
+				sample_chunk.Reset();
+			}
+			weights.push_back((sample_idx + 1) * run->Count() / sample_count - row);
+			total_weight += weights.back();
+		}
+	}
+	samples.Append(sample_chunk);
+
+	// sort the samples using their normalized sort keys
+	idx_t key_width = info.KeyWidth();
+	auto sample_keys = unique_ptr<data_t[]>(new data_t[MaxValue<idx_t>(samples.Count() * key_width, 1)]);
+	if (key_width > 0) {
+		for (idx_t chunk_idx = 0; chunk_idx < samples.ChunkCount(); chunk_idx++) {
+			auto chunk_keys = sample_keys.get() + chunk_idx * STANDARD_VECTOR_SIZE * key_width;
+			info.EncodeKeys(samples.GetChunk(chunk_idx), chunk_keys);
+		}
+	}
+	vector<idx_t> order;
+	for (idx_t i = 0; i < samples.Count(); i++) {
+		order.push_back(i);
+	}
+	std::sort(order.begin(), order.end(), [&](idx_t left, idx_t right) {
+		return info.Compare(key_width > 0 ? sample_keys.get() + left * key_width : nullptr,
+		                    samples.GetChunkForRow(left), left % STANDARD_VECTOR_SIZE,
+		                    key_width > 0 ? sample_keys.get() + right * key_width : nullptr,
+		                    samples.GetChunkForRow(right), right % STANDARD_VECTOR_SIZE) < 0;
+	});
+
+	// pick the splitters so that every partition holds about the same amount of rows
+	splitters.Initialize(types);
+	idx_t cumulative_weight = 0;
+	for (auto sample_idx : order) {
+		idx_t splitter_idx = splitters.size() + 1;
+		if (splitter_idx < partition_count && cumulative_weight >= splitter_idx * total_weight / partition_count) {
+			CopyRow(samples.GetChunkForRow(sample_idx), sample_idx % STANDARD_VECTOR_SIZE, splitters,
+			        splitters.size());
+			splitters.SetCardinality(splitters.size() + 1);
+		}
+		cumulative_weight += weights[sample_idx];
+	}
+	if (key_width > 0) {
+		splitter_keys = unique_ptr<data_t[]>(new data_t[STANDARD_VECTOR_SIZE * key_width]);
+		info.EncodeKeys(splitters, splitter_keys.get());
+	}
+}
+
+vector<SortedRunRange> SortedRunSplitters::GetPartition(idx_t partition_idx) {
+	D_ASSERT(partition_idx < PartitionCount());
+	vector<SortedRunRange> result;
+	for (auto run : runs) {
+		idx_t begin = 0;
+		idx_t end = run->Count();
+		if (partition_idx > 0) {
+			begin = run->LowerBound(splitters, partition_idx - 1, GetSplitterKey(partition_idx - 1), info);
+		}
+		if (partition_idx + 1 < PartitionCount()) {
+			end = run->LowerBound(splitters, partition_idx, GetSplitterKey(partition_idx), info);
+		}
+		result.push_back(SortedRunRange(*run, begin, end));
+	}
+	return result;
+}
+
+data_ptr_t SortedRunSplitters::GetSplitterKey(idx_t splitter_idx) {
+	return splitter_keys ? splitter_keys.get() + splitter_idx * info.KeyWidth() : nullptr;
+}
+
+//===--------------------------------------------------------------------===//
+// Sorted Run Scanner
+//===--------------------------------------------------------------------===//
+SortedRunScanner::SortedRunScanner(SortedRun &run) : run(run), chunk_index(0) {
+}
+
+void SortedRunScanner::Scan(DataChunk &result) {
+	if (chunk_index >= run.data.ChunkCount()) {
+		result.SetCardinality(0);
+		return;
+	}
+	run.data.FetchChunk(chunk_index++, result);
+}
+
+} // namespace duckdb
@@ -7,6 +7,7 @@
 #include "duckdb/planner/expression_binder.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/transaction/transaction_manager.hpp"
 #include "duckdb/common/enums/output_type.hpp"
 #include <cctype>
 
@@ -60,6 +61,23 @@ static void pragma_memory_limit(ClientContext &context, FunctionParameters param
 	context.db.storage->buffer_manager->SetLimit(new_limit);
 }
 
+static void pragma_checkpoint_threshold(ClientContext &context, FunctionParameters parameters) {
+	idx_t new_threshold = ParseMemoryLimit(parameters.values[0].ToString());
+	DBConfig::GetConfig(context).checkpoint_wal_size = new_threshold;
+}
+
+static void pragma_commit_delay(ClientContext &context, FunctionParameters parameters) {
+	auto delay = parameters.values[0].GetValue<int64_t>();
+	if (delay < 0) {
+		throw ParserException("Commit delay must be a positive number of microseconds (or 0 to disable the delay)");
+	}
+	DBConfig::GetConfig(context).commit_delay = delay;
+}
+
+static void pragma_force_checkpoint(ClientContext &context, FunctionParameters parameters) {
+	context.db.transaction_manager->Checkpoint();
+}
+
 static void pragma_collation(ClientContext &context, FunctionParameters parameters) {
 	auto collation_param = StringUtil::Lower(parameters.values[0].ToString());
 	// bind the collation to verify that it exists
@@ -150,6 +168,19 @@ static void pragma_explain_output(ClientContext &context, FunctionParameters par
 	}
 }
 
+static void pragma_task_priority(ClientContext &context, FunctionParameters parameters) {
+	string val = StringUtil::Lower(parameters.values[0].ToString());
+	if (val == "low") {
+		context.task_priority = TaskPriority::LOW;
+	} else if (val == "normal") {
+		context.task_priority = TaskPriority::NORMAL;
+	} else if (val == "high") {
+		context.task_priority = TaskPriority::HIGH;
+	} else {
+		throw ParserException("Unrecognized task priority '%s', expected either LOW, NORMAL or HIGH", val);
+	}
+}
+
 static void pragma_enable_optimizer(ClientContext &context, FunctionParameters parameters) {
 	context.enable_optimizer = true;
 }
@@ -167,6 +198,14 @@ static void pragma_perfect_ht_threshold(ClientContext &context, FunctionParamete
 	context.perfect_ht_threshold = bits;
 }
 
+static void pragma_read_ahead_depth(ClientContext &context, FunctionParameters parameters) {
+	auto depth = parameters.values[0].GetValue<int64_t>();
+	if (depth < 0) {
+		throw ParserException("Read-ahead depth must be a positive number (or 0 to disable read-ahead)");
+	}
+	context.read_ahead_depth = depth;
+}
+
 void PragmaFunctions::RegisterFunction(BuiltinFunctions &set) {
 	register_enable_profiling(set);
 
@@ -178,6 +217,13 @@ void PragmaFunctions::RegisterFunction(BuiltinFunctions &set) {
 
 	set.AddFunction(PragmaFunction::PragmaAssignment("memory_limit", pragma_memory_limit, LogicalType::VARCHAR));
 
+	set.AddFunction(
+	    PragmaFunction::PragmaAssignment("checkpoint_threshold", pragma_checkpoint_threshold, LogicalType::VARCHAR));
+	set.AddFunction(
+	    PragmaFunction::PragmaAssignment("wal_autocheckpoint", pragma_checkpoint_threshold, LogicalType::VARCHAR));
+	set.AddFunction(PragmaFunction::PragmaStatement("force_checkpoint", pragma_force_checkpoint));
+	set.AddFunction(PragmaFunction::PragmaAssignment("commit_delay", pragma_commit_delay, LogicalType::BIGINT));
+
 	set.AddFunction(PragmaFunction::PragmaAssignment("collation", pragma_collation, LogicalType::VARCHAR));
 	set.AddFunction(PragmaFunction::PragmaAssignment("default_collation", pragma_collation, LogicalType::VARCHAR));
 
@@ -205,10 +251,14 @@ void PragmaFunctions::RegisterFunction(BuiltinFunctions &set) {
 	set.AddFunction(PragmaFunction::PragmaAssignment("log_query_path", pragma_log_query_path, LogicalType::VARCHAR));
 	set.AddFunction(PragmaFunction::PragmaAssignment("explain_output", pragma_explain_output, LogicalType::VARCHAR));
 
+	set.AddFunction(PragmaFunction::PragmaAssignment("task_priority", pragma_task_priority, LogicalType::VARCHAR));
+
 	set.AddFunction(PragmaFunction::PragmaStatement("force_index_join", pragma_enable_force_index_join));
 
 	set.AddFunction(
 	    PragmaFunction::PragmaAssignment("perfect_ht_threshold", pragma_perfect_ht_threshold, LogicalType::INTEGER));
+
+	set.AddFunction(PragmaFunction::PragmaAssignment("read_ahead_depth", pragma_read_ahead_depth, LogicalType::BIGINT));
 }
 
 idx_t ParseMemoryLimit(string arg) {
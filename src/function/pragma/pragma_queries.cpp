@@ -32,6 +32,14 @@ string pragma_version(ClientContext &context, FunctionParameters parameters) {
 	return "SELECT * FROM pragma_version()";
 }
 
+string pragma_task_scheduler_info(ClientContext &context, FunctionParameters parameters) {
+	return "SELECT * FROM pragma_task_scheduler_info()";
+}
+
+string pragma_buffer_manager_info(ClientContext &context, FunctionParameters parameters) {
+	return "SELECT * FROM pragma_buffer_manager_info()";
+}
+
 string pragma_import_database(ClientContext &context, FunctionParameters parameters) {
 	auto &fs = FileSystem::GetFileSystem(context);
 	string query;
@@ -56,6 +64,8 @@ void PragmaQueries::RegisterFunction(BuiltinFunctions &set) {
 	set.AddFunction(PragmaFunction::PragmaStatement("collations", pragma_collations));
 	set.AddFunction(PragmaFunction::PragmaCall("show", pragma_show, {LogicalType::VARCHAR}));
 	set.AddFunction(PragmaFunction::PragmaStatement("version", pragma_version));
+	set.AddFunction(PragmaFunction::PragmaStatement("task_scheduler_info", pragma_task_scheduler_info));
+	set.AddFunction(PragmaFunction::PragmaStatement("buffer_manager_info", pragma_buffer_manager_info));
 	set.AddFunction(PragmaFunction::PragmaCall("import_database", pragma_import_database, {LogicalType::VARCHAR}));
 }
 
@@ -0,0 +1,77 @@
+#include "duckdb/function/table/sqlite_functions.hpp"
+
+#include "duckdb/storage/buffer_manager.hpp"
+
+using namespace std;
+
+namespace duckdb {
+
+struct PragmaBufferManagerInfoData : public FunctionOperatorData {
+	PragmaBufferManagerInfoData() : finished(false) {
+	}
+
+	bool finished;
+};
+
+static unique_ptr<FunctionData> pragma_buffer_manager_info_bind(ClientContext &context, vector<Value> &inputs,
+                                                                unordered_map<string, Value> &named_parameters,
+                                                                vector<LogicalType> &return_types,
+                                                                vector<string> &names) {
+	names.push_back("memory_usage");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("memory_limit");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("block_hits");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("block_misses");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("evictions");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("prefetch_requests");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("prefetch_hits");
+	return_types.push_back(LogicalType::BIGINT);
+
+	return nullptr;
+}
+
+unique_ptr<FunctionOperatorData> pragma_buffer_manager_info_init(ClientContext &context, const FunctionData *bind_data,
+                                                                 vector<column_t> &column_ids,
+                                                                 TableFilterSet *table_filters) {
+	return make_unique<PragmaBufferManagerInfoData>();
+}
+
+void pragma_buffer_manager_info(ClientContext &context, const FunctionData *bind_data,
+                                FunctionOperatorData *operator_state, DataChunk &output) {
+	auto &data = (PragmaBufferManagerInfoData &)*operator_state;
+	if (data.finished) {
+		return;
+	}
+	auto stats = BufferManager::GetBufferManager(context).GetStatistics();
+
+	output.SetCardinality(1);
+	output.data[0].SetValue(0, Value::BIGINT(stats.memory_usage));
+	// the memory limit is NULL if there is no limit
+	output.data[1].SetValue(0, stats.memory_limit == INVALID_INDEX ? Value(LogicalType::BIGINT)
+	                                                               : Value::BIGINT(stats.memory_limit));
+	output.data[2].SetValue(0, Value::BIGINT(stats.block_hits));
+	output.data[3].SetValue(0, Value::BIGINT(stats.block_misses));
+	output.data[4].SetValue(0, Value::BIGINT(stats.evictions));
+	output.data[5].SetValue(0, Value::BIGINT(stats.prefetch_requests));
+	output.data[6].SetValue(0, Value::BIGINT(stats.prefetch_hits));
+
+	data.finished = true;
+}
+
+void PragmaBufferManagerInfo::RegisterFunction(BuiltinFunctions &set) {
+	set.AddFunction(TableFunction("pragma_buffer_manager_info", {}, pragma_buffer_manager_info,
+	                              pragma_buffer_manager_info_bind, pragma_buffer_manager_info_init));
+}
+
+} // namespace duckdb
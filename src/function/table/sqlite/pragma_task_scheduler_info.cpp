@@ -0,0 +1,72 @@
+#include "duckdb/function/table/sqlite_functions.hpp"
+
+#include "duckdb/parallel/task_scheduler.hpp"
+
+using namespace std;
+
+namespace duckdb {
+
+struct PragmaTaskSchedulerInfoData : public FunctionOperatorData {
+	PragmaTaskSchedulerInfoData() : finished(false) {
+	}
+
+	bool finished;
+};
+
+static unique_ptr<FunctionData> pragma_task_scheduler_info_bind(ClientContext &context, vector<Value> &inputs,
+                                                                unordered_map<string, Value> &named_parameters,
+                                                                vector<LogicalType> &return_types,
+                                                                vector<string> &names) {
+	names.push_back("threads");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("active_producers");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("tasks_scheduled");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("tasks_executed");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("total_wait_usecs");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("max_wait_usecs");
+	return_types.push_back(LogicalType::BIGINT);
+
+	return nullptr;
+}
+
+unique_ptr<FunctionOperatorData> pragma_task_scheduler_info_init(ClientContext &context, const FunctionData *bind_data,
+                                                                 vector<column_t> &column_ids,
+                                                                 TableFilterSet *table_filters) {
+	return make_unique<PragmaTaskSchedulerInfoData>();
+}
+
+void pragma_task_scheduler_info(ClientContext &context, const FunctionData *bind_data,
+                                FunctionOperatorData *operator_state, DataChunk &output) {
+	auto &data = (PragmaTaskSchedulerInfoData &)*operator_state;
+	if (data.finished) {
+		return;
+	}
+	auto &scheduler = TaskScheduler::GetScheduler(context);
+	auto stats = scheduler.GetStatistics();
+
+	output.SetCardinality(1);
+	output.data[0].SetValue(0, Value::BIGINT(scheduler.NumberOfThreads()));
+	output.data[1].SetValue(0, Value::BIGINT(stats.active_producers));
+	output.data[2].SetValue(0, Value::BIGINT(stats.tasks_scheduled));
+	output.data[3].SetValue(0, Value::BIGINT(stats.tasks_executed));
+	output.data[4].SetValue(0, Value::BIGINT(stats.total_wait_usecs));
+	output.data[5].SetValue(0, Value::BIGINT(stats.max_wait_usecs));
+
+	data.finished = true;
+}
+
+void PragmaTaskSchedulerInfo::RegisterFunction(BuiltinFunctions &set) {
+	set.AddFunction(TableFunction("pragma_task_scheduler_info", {}, pragma_task_scheduler_info,
+	                              pragma_task_scheduler_info_bind, pragma_task_scheduler_info_init));
+}
+
+} // namespace duckdb
@@ -68,6 +68,10 @@ static void table_scan_function(ClientContext &context, const FunctionData *bind
 	auto &state = (TableScanOperatorData &)*operator_state;
 	auto &transaction = Transaction::GetTransaction(context);
 	bind_data.table->storage->Scan(transaction, output, state.scan_state, state.column_ids);
+	if (state.scan_state.pruned_rows > 0) {
+		context.profiler.AddPrunedRows(state.scan_state.pruned_rows);
+		state.scan_state.pruned_rows = 0;
+	}
 }
 
 struct ParallelTableFunctionScanState : public ParallelState {
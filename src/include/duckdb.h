@@ -101,20 +101,31 @@ typedef struct {
 	char *error_message;
 } duckdb_result;
 
-// typedef struct {
-// 	void *data;
-// 	bool *nullmask;
-// } duckdb_column_data;
+typedef struct {
+	const char *data;
+	idx_t size;
+} duckdb_string;
+
+typedef struct {
+	// the data of the column, in the same representation as in duckdb_result, except for VARCHAR columns which are
+	// stored as duckdb_string
+	void *data;
+	bool *nullmask;
+} duckdb_column_data;
 
-// typedef struct {
-// 	int column_count;
-// 	int count;
-// 	duckdb_column_data *columns;
-// } duckdb_chunk;
+typedef struct {
+	idx_t column_count;
+	idx_t row_count;
+	duckdb_column_data *columns;
+} duckdb_chunk;
 
 typedef void *duckdb_database;
 typedef void *duckdb_connection;
 typedef void *duckdb_prepared_statement;
+typedef void *duckdb_stream_result;
+
+struct ArrowSchema;
+struct ArrowArray;
 
 typedef enum { DuckDBSuccess = 0, DuckDBError = 1 } duckdb_state;
 
@@ -185,6 +196,38 @@ DUCKDBAPI duckdb_state duckdb_execute_prepared(duckdb_prepared_statement prepare
 //! Destroys the specified prepared statement descriptor
 DUCKDBAPI void duckdb_destroy_prepare(duckdb_prepared_statement *prepared_statement);
 
+// Streaming Results
+// A streaming result is fetched chunk by chunk, so results of any size can be read with bounded memory. A connection
+// can only have one open streaming result: running another query in the connection closes it.
+
+//! Executes the specified SQL query, the result is fetched chunk by chunk. On failure the error message can be obtained
+//! with duckdb_stream_error. The result must always be destroyed. [OUT: stream result]
+DUCKDBAPI duckdb_state duckdb_query_stream(duckdb_connection connection, const char *query,
+                                           duckdb_stream_result *out_result);
+//! Executes the prepared statement with the currently bound parameters, the result is fetched chunk by chunk
+DUCKDBAPI duckdb_state duckdb_execute_prepared_stream(duckdb_prepared_statement prepared_statement,
+                                                      duckdb_stream_result *out_result);
+//! Returns the error message of the streaming result, or NULL if there was no error
+DUCKDBAPI const char *duckdb_stream_error(duckdb_stream_result result);
+//! Returns the number of columns of the streaming result
+DUCKDBAPI idx_t duckdb_stream_column_count(duckdb_stream_result result);
+//! Returns the name of the specified column, which is destroyed with the result
+DUCKDBAPI const char *duckdb_stream_column_name(duckdb_stream_result result, idx_t col);
+//! Returns the type of the specified column
+DUCKDBAPI duckdb_type duckdb_stream_column_type(duckdb_stream_result result, idx_t col);
+//! Fetches the next chunk of the result, a chunk with zero rows marks the end of the result. The data of the chunk
+//! refers directly to the data of the result where possible, and is only valid until the next chunk is fetched or the
+//! result is destroyed. [OUT: chunk]
+DUCKDBAPI duckdb_state duckdb_stream_fetch_chunk(duckdb_stream_result result, duckdb_chunk *out_chunk);
+//! Writes the schema of the result in the Arrow C data interface. [OUT: schema]
+DUCKDBAPI duckdb_state duckdb_stream_arrow_schema(duckdb_stream_result result, struct ArrowSchema *out_schema);
+//! Fetches the next chunk of the result as an Arrow C data interface struct array, which has to be released by the
+//! caller. The array keeps the data it refers to alive. At the end of the result, the release callback of the array is
+//! set to NULL. [OUT: array]
+DUCKDBAPI duckdb_state duckdb_stream_fetch_arrow_array(duckdb_stream_result result, struct ArrowArray *out_array);
+//! Destroys the specified streaming result, closing it if it has not been fully fetched
+DUCKDBAPI void duckdb_destroy_stream_result(duckdb_stream_result *result);
+
 #ifdef __cplusplus
 }
 #endif
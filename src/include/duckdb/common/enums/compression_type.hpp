@@ -0,0 +1,26 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/enums/compression_type.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/constants.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Compression Types
+//===--------------------------------------------------------------------===//
+//! The compression that is used for a persistent column segment
+enum class CompressionType : uint8_t {
+	UNCOMPRESSED = 0, // the segment is stored as a NumericSegment/StringSegment
+	COMPRESSED = 1,   // the vectors of the segment are stored using lightweight compression (see CompressedSegment)
+	DICTIONARY = 2,   // the segment is a StringSegment in which duplicate strings are stored only once
+	EMPTY = 3         // every row of the segment has been deleted: no data is stored (see EmptySegment)
+};
+
+} // namespace duckdb
@@ -0,0 +1,19 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/enums/task_priority.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/constants.hpp"
+
+namespace duckdb {
+
+//! The priority of the tasks of a query. Background threads serve producers in a weighted round-robin fashion, where
+//! the weight of a producer is determined by its priority.
+enum class TaskPriority : uint8_t { LOW = 0, NORMAL = 1, HIGH = 2 };
+
+} // namespace duckdb
@@ -41,6 +41,7 @@ enum class WALType : uint8_t {
 	INSERT_TUPLE = 26,
 	DELETE_TUPLE = 27,
 	UPDATE_TUPLE = 28,
+	INSERT_BLOCKS = 29,
 	// -----------------------------
 	// Flush
 	// -----------------------------
@@ -13,4 +13,5 @@
 namespace duckdb {
 using std::lock_guard;
 using std::mutex;
+using std::unique_lock;
 } // namespace duckdb
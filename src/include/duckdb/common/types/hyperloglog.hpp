@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/types/hyperloglog.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+namespace duckdb {
+class Serializer;
+class Deserializer;
+
+//! HyperLogLog is a sketch that approximates the number of distinct values that were added to it, using a fixed
+//! amount of memory. Sketches of different sets of values can be merged into a sketch of their union.
+class HyperLogLog {
+public:
+	//! The amount of bits of the hash that are used to select a register
+	static constexpr const idx_t REGISTER_BITS = 8;
+	//! The amount of registers of the sketch; the standard error of the estimate is 1.04 / sqrt(REGISTER_COUNT)
+	static constexpr const idx_t REGISTER_COUNT = 1 << REGISTER_BITS;
+
+	HyperLogLog();
+
+public:
+	//! Add the hash of a value to the sketch
+	void Add(hash_t hash) {
+		// finalize the hash first: the hash functions of the values do not spread them over all bits of the hash
+		hash ^= hash >> 33;
+		hash *= UINT64_C(0xff51afd7ed558ccd);
+		hash ^= hash >> 33;
+		hash *= UINT64_C(0xc4ceb9fe1a85ec53);
+		hash ^= hash >> 33;
+		// the highest bits select the register, the register keeps the maximum position of the lowest set bit
+		auto index = hash >> (64 - REGISTER_BITS);
+		uint8_t rank = 1;
+		while (rank <= 64 - REGISTER_BITS && (hash & 1) == 0) {
+			hash >>= 1;
+			rank++;
+		}
+		if (rank > registers[index]) {
+			registers[index] = rank;
+		}
+	}
+	//! Merge the values of another sketch into this sketch
+	void Merge(const HyperLogLog &other);
+	//! Returns the approximate number of distinct values that were added to the sketch
+	idx_t Count() const;
+
+	unique_ptr<HyperLogLog> Copy() const;
+	void Serialize(Serializer &serializer) const;
+	static unique_ptr<HyperLogLog> Deserialize(Deserializer &source);
+
+private:
+	uint8_t registers[REGISTER_COUNT];
+};
+
+} // namespace duckdb
@@ -43,6 +43,10 @@ public:
 	//! Returns the difference between two timestamps
 	static interval_t GetDifference(timestamp_t timestamp_1, timestamp_t timestamp_2);
 
+	//! Normalizes an interval into (months, days, msecs), such that equal intervals have equal normalized entries and
+	//! the order of the normalized entries matches the order of the intervals
+	static void Normalize(interval_t input, int64_t &months, int64_t &days, int64_t &msecs);
+
 	//! Comparison operators
 	static bool Equals(interval_t left, interval_t right);
 	static bool GreaterThan(interval_t left, interval_t right);
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/types/sort_key.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/enums/order_type.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+
+namespace duckdb {
+
+//! The SortKeyLayout describes how a set of ORDER BY columns is encoded into a fixed-width, normalized sort key. Two
+//! sort keys can be compared with memcmp, which takes the order type (ASC/DESC) and null order of every column into
+//! account. Every column is encoded as a single validity byte followed by the big-endian, sign-flipped value. Strings
+//! are encoded by their first STRING_PREFIX_SIZE bytes; if a layout contains strings, rows with equal sort keys have
+//! to be compared using the original values.
+class SortKeyLayout {
+public:
+	//! The amount of bytes of a string that are stored in the sort key
+	static constexpr idx_t STRING_PREFIX_SIZE = 12;
+
+	SortKeyLayout(vector<LogicalType> types, vector<OrderType> order_types, vector<OrderByNullType> null_orders);
+
+	//! The types of the sort columns
+	vector<LogicalType> types;
+	vector<OrderType> order_types;
+	vector<OrderByNullType> null_orders;
+	//! The offset of each column within the sort key
+	vector<idx_t> offsets;
+	//! The total width of the sort key
+	idx_t key_width;
+	//! Whether or not comparing sort keys is exact, i.e. whether equal sort keys always imply equal rows
+	bool exact;
+	//! The width of the sort key up to and including the first string column. Only this part of the key can be used
+	//! to order rows exactly: rows with an equal prefix have to be compared using the original values.
+	idx_t exact_width;
+
+public:
+	//! Encodes the first types.size() columns of the chunk into sort keys. The key of row i is written to
+	//! key_data + i * entry_width.
+	void Encode(DataChunk &chunk, data_ptr_t key_data, idx_t entry_width);
+	//! Encodes a single column into the sort keys
+	void EncodeColumn(idx_t col_idx, Vector &input, idx_t count, data_ptr_t key_data, idx_t entry_width);
+
+	//! Returns whether or not the type can be encoded in a sort key
+	static bool IsSupported(const LogicalType &type);
+
+	//! Sorts count entries of entry_width bytes, by the memcmp order of their first key_width bytes. Uses an LSD radix
+	//! sort for short keys and an MSD radix sort for long keys, falling back to insertion sort for small buckets.
+	static void RadixSort(data_ptr_t data, idx_t count, idx_t key_width, idx_t entry_width);
+};
+
+} // namespace duckdb
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/execution/buffered_chunk_collection.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/serializer/buffered_serializer.hpp"
+#include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace duckdb {
+
+//! The BufferedChunkCollection is an append-only collection of DataChunks that is stored in blocks registered with the
+//! BufferManager instead of on the heap. The blocks are unpinned as soon as they are written, so the buffer manager
+//! can offload them to the temporary directory when the memory limit is reached. Chunks are read back by copying
+//! them out of their block, pinning a single block at a time. Like in a ChunkCollection, every chunk but the last one
+//! holds STANDARD_VECTOR_SIZE rows. Types that cannot be serialized are kept in a regular ChunkCollection
+//! instead.
+class BufferedChunkCollection {
+public:
+	BufferedChunkCollection(BufferManager &buffer_manager, vector<LogicalType> types);
+
+	BufferManager &buffer_manager;
+	//! The types of the chunks stored in the collection
+	vector<LogicalType> types;
+
+public:
+	//! Append a chunk to the collection
+	void Append(DataChunk &chunk);
+	//! Write any buffered data to the blocks of the collection. Has to be called after the last append and before
+	//! chunks are fetched; afterwards chunks can be fetched by multiple threads at the same time.
+	void Finalize();
+	//! Copy the chunk with the given index into the result. The result remains valid until the next fetch into it.
+	void FetchChunk(idx_t chunk_idx, DataChunk &result);
+
+	//! Gathers the rows with the given indices into the result, i.e. the i-th row of the result is the row rows[i] of
+	//! the collection. Every chunk that holds any of the rows is fetched once, so gathering few rows at a time from a
+	//! large collection is expensive.
+	void FetchRows(idx_t rows[], idx_t row_count, ChunkCollection &result);
+
+	//! Removes all chunks from the collection
+	void Reset();
+	//! Moves the chunks of the other collection to the end of this collection, leaving the other collection empty
+	void Merge(BufferedChunkCollection &other);
+
+	//! The total amount of rows in the collection
+	idx_t Count() {
+		return count;
+	}
+	//! The amount of chunks in the collection
+	idx_t ChunkCount() {
+		return spillable ? chunk_locations.size() : data.ChunkCount();
+	}
+	//! The amount of bytes that the blocks of the collection hold (zero if the collection is not spillable)
+	idx_t SizeInBytes() {
+		return block_bytes;
+	}
+
+	//! Whether or not chunks of the given types can be offloaded to disk
+	static bool IsSpillable(vector<LogicalType> &types);
+
+private:
+	//! Serialize the chunk that is being appended to
+	void FlushChunk();
+	//! Write the serialized chunks to a new block
+	void FlushBlock();
+
+private:
+	//! The total amount of rows in the collection
+	idx_t count;
+	//! Whether or not the collection is stored in buffer-managed blocks
+	bool spillable;
+	//! The in-memory data of the collection (only used if the collection is not spillable)
+	ChunkCollection data;
+	//! The blocks of the collection (only used if the collection is spillable)
+	vector<shared_ptr<BlockHandle>> blocks;
+	//! The amount of bytes written to the blocks of the collection
+	idx_t block_bytes;
+	//! The block index and the offset within the block of every chunk
+	vector<std::pair<idx_t, idx_t>> chunk_locations;
+	//! The chunk that appended rows are gathered in until it is full
+	DataChunk append_chunk;
+	//! The serializer holding chunks that have not been written to a block yet
+	unique_ptr<BufferedSerializer> serializer;
+};
+
+} // namespace duckdb
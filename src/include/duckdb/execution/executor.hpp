@@ -60,6 +60,9 @@ private:
 	vector<unique_ptr<Pipeline>> pipelines;
 	//! The producer of this query
 	unique_ptr<ProducerToken> producer;
+	//! Whether or not pipelines are still scheduled while the result is fetched (i.e. the pipelines of a recursive
+	//! CTE), in which case the producer is kept until the executor is reset
+	bool has_recursive_pipelines;
 	//! Exceptions that occurred during the execution of the current query
 	vector<string> exceptions;
 
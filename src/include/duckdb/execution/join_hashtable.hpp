@@ -117,8 +117,6 @@ private:
 	idx_t AppendToBlock(HTDataBlock &block, BufferHandle &handle, vector<BlockAppendEntry> &append_entries,
 	                    idx_t remaining);
 
-	void Hash(DataChunk &keys, const SelectionVector &sel, idx_t count, Vector &hashes);
-
 public:
 	JoinHashTable(BufferManager &buffer_manager, vector<JoinCondition> &conditions, vector<LogicalType> build_types,
 	              JoinType type);
@@ -126,9 +124,36 @@ public:
 
 	//! Add the given data to the HT
 	void Build(DataChunk &keys, DataChunk &input);
+	//! Moves the data of another HT with the same layout (e.g. a HT that was built by a different thread) into this HT.
+	//! Merge can be called concurrently with other calls to Merge.
+	void Merge(JoinHashTable &other);
 	//! Finalize the build of the HT, constructing the actual hash table and making the HT ready for probing. Finalize
 	//! must be called before any call to Probe, and after Finalize is called Build should no longer be ever called.
 	void Finalize();
+	//! Allocates the pointer table and pins all blocks of the HT. After this, FinalizeBlocks can be called (possibly
+	//! from multiple threads) to insert the entries of the blocks into the pointer table.
+	void InitializePointerTable();
+	//! Inserts the entries of the blocks in the range [block_start, block_end) into the pointer table. If parallel is
+	//! true, the pointer table is updated using atomic compare-and-swap, so different ranges can be inserted concurrently
+	void FinalizeBlocks(idx_t block_start, idx_t block_end, bool parallel);
+	//! The amount of data blocks in the HT
+	idx_t BlockCount() {
+		return blocks.size();
+	}
+	//! The amount of memory (in bytes) that is required to keep the finalized HT pinned
+	idx_t SizeInBytes();
+	//! Releases the pointer table and the pinned blocks of a finalized HT, after which the HT can be finalized again
+	void Unpin();
+	//! Radix-partitions the entries of the HT into the given (empty) partitions based on the hashes of the keys, and
+	//! releases the data blocks of this HT. The amount of partitions must be a power of two. The partitions refer to the
+	//! string heap of this HT, so they must be destroyed before this HT.
+	void Partition(vector<unique_ptr<JoinHashTable>> &partitions);
+	//! Returns the partition of a hash in a HT that is partitioned into partition_count partitions
+	static idx_t PartitionIndex(hash_t hash, idx_t partition_count) {
+		return (hash >> PARTITION_SHIFT) & (partition_count - 1);
+	}
+	//! Hash the equality keys of the rows in the selection vector
+	void Hash(DataChunk &keys, const SelectionVector &sel, idx_t count, Vector &hashes);
 	//! Probe the HT with the given input chunk, resulting in the given result
 	unique_ptr<ScanStructure> Probe(DataChunk &keys);
 	//! Scan the HT to construct the final full outer join result after
@@ -172,6 +197,11 @@ public:
 	uint64_t bitmask;
 	//! The amount of entries stored per block
 	idx_t block_capacity;
+	//! The partitions are determined by the upper bits of the hashes, as the lower bits are used by the pointer table
+	static constexpr idx_t PARTITION_SHIFT = 48;
+	//! The minimum amount of entries for which a Bloom filter is constructed. For smaller HTs the pointer table is
+	//! small enough that probing it directly is about as cheap as probing the Bloom filter.
+	static constexpr idx_t BLOOM_FILTER_THRESHOLD = 131072;
 
 	struct {
 		std::mutex mj_lock;
@@ -195,14 +225,21 @@ private:
 	void ApplyBitmask(Vector &hashes, idx_t count);
 	void ApplyBitmask(Vector &hashes, const SelectionVector &sel, idx_t count, Vector &pointers);
 	//! Insert the given set of locations into the HT with the given set of
-	//! hashes. Caller should hold lock in parallel HT.
-	void InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[]);
+	//! hashes. If parallel is false, the caller should hold lock in parallel HT.
+	void InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[], bool parallel = false);
+	//! Sets the bits of the given hashes in the Bloom filter
+	void InsertBloomFilter(hash_t hashes[], idx_t count, bool parallel);
+	//! Removes the rows of which the hash is not contained in the Bloom filter from the selection vector, and returns
+	//! the amount of remaining rows
+	idx_t ProbeBloomFilter(Vector &hashes, const SelectionVector &sel, idx_t count, SelectionVector &result);
 
 	idx_t PrepareKeys(DataChunk &keys, unique_ptr<VectorData[]> &key_data, const SelectionVector *&current_sel,
 	                  SelectionVector &sel, bool build_side);
 	void SerializeVectorData(VectorData &vdata, PhysicalType type, const SelectionVector &sel, idx_t count,
 	                         data_ptr_t key_locations[]);
 	void SerializeVector(Vector &v, idx_t vcount, const SelectionVector &sel, idx_t count, data_ptr_t key_locations[]);
+	//! Copies the given entries of another HT with the same layout into the data blocks of this HT
+	void AppendEntries(vector<data_ptr_t> &entries);
 
 	//! The amount of entries stored in the HT currently
 	idx_t count;
@@ -212,6 +249,11 @@ private:
 	vector<unique_ptr<BufferHandle>> pinned_handles;
 	//! The hash map of the HT, created after finalization
 	unique_ptr<BufferHandle> hash_map;
+	//! The (blocked) Bloom filter on the hashes of the keys, created after finalization of large HTs. Probe-side rows
+	//! that do not pass the Bloom filter are discarded before the (much larger) pointer table is accessed.
+	unique_ptr<BufferHandle> bloom_filter;
+	//! Bitmask for getting the word of the Bloom filter from the hashes
+	uint64_t bloom_mask;
 	//! Whether or not NULL values are considered equal in each of the comparisons
 	vector<bool> null_values_are_equal;
 
@@ -11,6 +11,7 @@
 #include "duckdb/common/common.hpp"
 #include "duckdb/common/types/chunk_collection.hpp"
 #include "duckdb/common/types/vector.hpp"
+#include "duckdb/execution/buffered_chunk_collection.hpp"
 #include "duckdb/planner/operator/logical_comparison_join.hpp"
 
 namespace duckdb {
@@ -21,7 +22,8 @@ struct NestedLoopJoinInner {
 };
 
 struct NestedLoopJoinMark {
-	static void Perform(DataChunk &left, ChunkCollection &right, bool found_match[], vector<JoinCondition> &conditions);
+	static void Perform(DataChunk &left, BufferedChunkCollection &right, bool found_match[],
+	                    vector<JoinCondition> &conditions);
 };
 
 } // namespace duckdb
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "duckdb/execution/physical_sink.hpp"
+#include "duckdb/parallel/parallel_state.hpp"
 #include "duckdb/storage/data_table.hpp"
 
 namespace duckdb {
@@ -63,6 +64,11 @@ public:
 
 	string ParamsToString() const override;
 
+	//! The maximum amount of threads that can be used to scan the finalized aggregate in parallel
+	idx_t MaxThreads(ClientContext &context);
+	//! Creates the state used to scan the finalized aggregate in parallel
+	unique_ptr<ParallelState> GetParallelState();
+
 private:
 	//! how many groups can we have in the operator before we switch to radix partitioning
 	idx_t radix_limit;
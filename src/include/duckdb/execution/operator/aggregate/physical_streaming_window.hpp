@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/execution/operator/aggregate/physical_streaming_window.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/execution/physical_operator.hpp"
+
+namespace duckdb {
+class BoundWindowExpression;
+
+//! PhysicalStreamingWindow computes window expressions over input that is already sorted on their PARTITION BY and
+//! ORDER BY clauses. The results are computed while the input streams through the operator, only the rows that can
+//! still be part of a frame are kept around.
+class PhysicalStreamingWindow : public PhysicalOperator {
+public:
+	PhysicalStreamingWindow(vector<LogicalType> types, vector<unique_ptr<Expression>> select_list,
+	                        PhysicalOperatorType type = PhysicalOperatorType::STREAMING_WINDOW);
+
+	//! The projection list of the WINDOW statement
+	vector<unique_ptr<Expression>> select_list;
+
+public:
+	void GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
+	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+	string ParamsToString() const override;
+
+	//! Returns whether or not the window expression can be computed while streaming through input that is sorted on
+	//! its PARTITION BY and ORDER BY clauses
+	static bool IsStreamingFunction(BoundWindowExpression &wexpr);
+};
+
+} // namespace duckdb
@@ -15,6 +15,10 @@ namespace duckdb {
 
 //! PhysicalWindow implements window functions
 class PhysicalWindow : public PhysicalSink {
+public:
+	//! The amount of rows a thread gathers for a hash partition before moving them to the global partition
+	static constexpr idx_t LOCAL_PARTITION_THRESHOLD = STANDARD_VECTOR_SIZE * 64;
+
 public:
 	PhysicalWindow(vector<LogicalType> types, vector<unique_ptr<Expression>> select_list,
 	               PhysicalOperatorType type = PhysicalOperatorType::WINDOW);
@@ -35,6 +39,12 @@ public:
 public:
 	//! The projection list of the WINDOW statement (may contain aggregates)
 	vector<unique_ptr<Expression>> select_list;
+	//! The window expressions grouped by their PARTITION BY and ORDER BY clauses, the window expressions of a group are
+	//! computed over a single sort of the input
+	vector<vector<idx_t>> sort_groups;
+	//! Whether or not all window expressions have the same (non-empty) PARTITION BY clause, in which case the input can
+	//! be hash-partitioned on the partition keys and the hash partitions can be computed independently
+	bool is_partitioned;
 };
 
 } // namespace duckdb
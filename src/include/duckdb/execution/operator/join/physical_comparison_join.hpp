@@ -13,6 +13,7 @@
 
 namespace duckdb {
 class ChunkCollection;
+class BufferedChunkCollection;
 
 //! PhysicalJoin represents the base class of the join operators
 class PhysicalComparisonJoin : public PhysicalJoin {
@@ -30,6 +31,10 @@ public:
 	//! Construct the remainder of a Full Outer Join based on which tuples in the RHS found no match
 	static void ConstructFullOuterJoinResult(bool *found_match, ChunkCollection &input, DataChunk &result,
 	                                         idx_t &scan_position);
+	//! Construct the remainder of a Full Outer Join from a BufferedChunkCollection. The RHS chunks are fetched into the
+	//! scan chunk, which the result references.
+	static void ConstructFullOuterJoinResult(bool *found_match, BufferedChunkCollection &input, DataChunk &scan_chunk,
+	                                         DataChunk &result, idx_t &scan_position);
 };
 
 } // namespace duckdb
@@ -32,12 +32,15 @@ public:
 	vector<LogicalType> build_types;
 	//! Duplicate eliminated types; only used for delim_joins (i.e. correlated subqueries)
 	vector<LogicalType> delim_types;
+	//! The maximum amount of partitions of a hash join that does not fit in memory
+	static constexpr idx_t MAX_PARTITIONS = 256;
 
 public:
 	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
 
 	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) override;
 	void Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Combine(ExecutionContext &context, GlobalOperatorState &gstate, LocalSinkState &lstate) override;
 	void Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> gstate) override;
 
 	void GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
@@ -45,6 +48,11 @@ public:
 
 private:
 	void ProbeHashTable(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_);
+	//! Fetches the next chunk of the probe side and resolves its join keys, returns false if the probe side is exhausted
+	bool FetchProbeChunk(ExecutionContext &context, PhysicalOperatorState *state_);
+	//! Spills the rows of the probe chunk that belong to the other partitions than the first partition of a
+	//! partitioned hash join, and leaves only the rows of the first partition in the probe chunk
+	void PartitionProbeChunk(ExecutionContext &context, PhysicalOperatorState *state_);
 };
 
 } // namespace duckdb
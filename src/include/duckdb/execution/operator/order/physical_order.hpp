@@ -14,9 +14,14 @@
 
 namespace duckdb {
 
-//! Represents a physical ordering of the data. Note that this will not change
-//! the data but only add a selection vector.
+//! Represents a physical ordering of the data. The data is sorted using a parallel external merge sort: every thread
+//! produces sorted runs of its input. In the finalize phase, splitters divide the runs into one key range per thread,
+//! and the key ranges are merged in parallel in a single pass.
 class PhysicalOrder : public PhysicalSink {
+public:
+	//! The amount of rows a thread gathers before sorting them into a sorted run
+	static constexpr idx_t SORTED_RUN_THRESHOLD = STANDARD_VECTOR_SIZE * 1024;
+
 public:
 	PhysicalOrder(vector<LogicalType> types, vector<BoundOrderByNode> orders)
 	    : PhysicalSink(PhysicalOperatorType::ORDER_BY, move(types)), orders(move(orders)) {
@@ -26,7 +31,9 @@ public:
 
 public:
 	void Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate) override;
 	void Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) override;
 	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
 
 	void GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
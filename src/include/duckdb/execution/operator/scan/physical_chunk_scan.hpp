@@ -9,6 +9,7 @@
 #pragma once
 
 #include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/execution/buffered_chunk_collection.hpp"
 #include "duckdb/execution/physical_operator.hpp"
 
 namespace duckdb {
@@ -17,7 +18,7 @@ namespace duckdb {
 class PhysicalChunkScan : public PhysicalOperator {
 public:
 	PhysicalChunkScan(vector<LogicalType> types, PhysicalOperatorType op_type)
-	    : PhysicalOperator(op_type, move(types)), collection(nullptr) {
+	    : PhysicalOperator(op_type, move(types)), collection(nullptr), buffered_collection(nullptr) {
 	}
 
 	void GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
@@ -28,6 +29,8 @@ public:
 	ChunkCollection *collection;
 	//! Owned chunk collection, if any
 	unique_ptr<ChunkCollection> owned_collection;
+	//! The buffered chunk collection to scan (instead of collection), if any
+	BufferedChunkCollection *buffered_collection;
 };
 
 } // namespace duckdb
@@ -31,8 +31,17 @@ public:
 	vector<string> names;
 	//! The table filters
 	unique_ptr<TableFilterSet> table_filters;
+	//! The table filters combined with the filters that are only known during execution (e.g. the key range of the
+	//! build side of a hash join that probes this scan). If set, these filters are used instead of the table filters.
+	unique_ptr<TableFilterSet> runtime_filters;
 
 public:
+	//! Restricts the given column to the range [min, max] (e.g. the key range of the build side of a hash join) on top
+	//! of the table filters, must be called before the scan is initialized
+	void AddRuntimeRangeFilter(idx_t column_index, const Value &min, const Value &max);
+	//! Removes the filters that were added during a previous execution of the plan
+	void ClearRuntimeFilters();
+
 	string GetName() const override;
 	string ParamsToString() const override;
 
@@ -9,7 +9,7 @@
 #pragma once
 
 #include "duckdb/execution/physical_operator.hpp"
-#include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/execution/buffered_chunk_collection.hpp"
 
 namespace duckdb {
 class Pipeline;
@@ -21,8 +21,10 @@ public:
 	~PhysicalRecursiveCTE();
 
 	bool union_all;
-	std::shared_ptr<ChunkCollection> working_table;
-	ChunkCollection intermediate_table;
+	//! The rows produced by the previous iteration, which are scanned by the recursive term
+	std::shared_ptr<BufferedChunkCollection> working_table;
+	//! The rows produced by the current iteration
+	unique_ptr<BufferedChunkCollection> intermediate_table;
 	vector<unique_ptr<Pipeline>> pipelines;
 
 public:
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/execution/sorted_run.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/enums/order_type.hpp"
+#include "duckdb/common/types/sort_key.hpp"
+#include "duckdb/execution/buffered_chunk_collection.hpp"
+
+namespace duckdb {
+
+//! Describes which columns of the chunks stored in a SortedRun make up the sort key, and how they are ordered
+struct SortKeyInfo {
+	//! The index of the first sort key column; all columns from this index onwards are sort keys
+	idx_t key_offset;
+	//! The order types of the sort key columns
+	vector<OrderType> order_types;
+	//! The null orders of the sort key columns
+	vector<OrderByNullType> null_orders;
+	//! The layout of the normalized sort keys, or nullptr if the sort key columns cannot be normalized
+	unique_ptr<SortKeyLayout> layout;
+
+	//! Initializes the layout of the normalized sort keys for the given sort key types
+	void InitializeLayout(vector<LogicalType> key_types);
+	//! The width of the normalized sort key of a row (0 if the sort keys are not normalized)
+	idx_t KeyWidth() {
+		return layout ? layout->key_width : 0;
+	}
+	//! Encodes the normalized sort keys of the rows of the chunk into key_data, KeyWidth() bytes per row
+	void EncodeKeys(DataChunk &chunk, data_ptr_t key_data);
+
+	//! Compares the sort keys of two rows, returns a negative number if left < right, 0 if equal and a positive number
+	//! otherwise
+	int Compare(DataChunk &left, idx_t left_idx, DataChunk &right, idx_t right_idx);
+	//! Compares two rows using their normalized sort keys, only comparing the original values if the normalized keys
+	//! cannot tell them apart
+	int Compare(data_ptr_t left_key, DataChunk &left, idx_t left_idx, data_ptr_t right_key, DataChunk &right,
+	            idx_t right_idx);
+};
+
+class SortedRun;
+
+//! A range of rows of a sorted run
+struct SortedRunRange {
+	SortedRunRange(SortedRun &run, idx_t begin, idx_t end) : run(run), begin(begin), end(end) {
+	}
+
+	SortedRun &run;
+	idx_t begin;
+	idx_t end;
+};
+
+//! A SortedRun is a sequence of sorted DataChunks, used as unit of work by the external merge sort. The chunks are
+//! stored in a BufferedChunkCollection, which allows them to be offloaded to the temporary directory when memory runs
+//! out.
+class SortedRun {
+	friend class SortedRunScanner;
+
+public:
+	SortedRun(BufferManager &buffer_manager, vector<LogicalType> types);
+
+	BufferManager &buffer_manager;
+	//! The types of the chunks stored in the run
+	vector<LogicalType> types;
+
+public:
+	//! Appends a chunk to the end of the run. The chunk must be ordered after any data already in the run.
+	void Append(DataChunk &chunk);
+	//! Flushes any buffered data of the run; no more data can be appended afterwards
+	void Finalize();
+
+	idx_t Count() {
+		return data.Count();
+	}
+	idx_t ChunkCount() {
+		return data.ChunkCount();
+	}
+	//! Copies the chunk with the given index into the result
+	void FetchChunk(idx_t chunk_idx, DataChunk &result) {
+		data.FetchChunk(chunk_idx, result);
+	}
+
+	//! Finds the first row of the run that is not ordered before the given row
+	idx_t LowerBound(DataChunk &chunk, idx_t row_idx, data_ptr_t key, SortKeyInfo &info);
+
+	//! Merges ranges of sorted runs into a single sorted run. Rows with equal sort keys are ordered by the index of
+	//! their range.
+	static unique_ptr<SortedRun> Merge(vector<SortedRunRange> &ranges, SortKeyInfo &info);
+
+private:
+	//! The chunks of the run
+	BufferedChunkCollection data;
+};
+
+//! The SortedRunSplitters divide the rows of a set of sorted runs into partitions of roughly equal size using splitter
+//! rows sampled from the runs. Every row of a partition is ordered before the rows of the next partition, so the
+//! partitions can be merged independently and in parallel, and concatenating them yields the sorted data.
+class SortedRunSplitters {
+	//! The amount of rows sampled from every run per partition to select the splitters
+	static constexpr idx_t SAMPLES_PER_PARTITION = 4;
+
+public:
+	SortedRunSplitters(vector<SortedRun *> runs, idx_t partition_count, SortKeyInfo &info);
+
+	//! The ranges of the runs that make up the partition with the given index
+	vector<SortedRunRange> GetPartition(idx_t partition_idx);
+
+	idx_t PartitionCount() {
+		return splitters.size() + 1;
+	}
+
+private:
+	data_ptr_t GetSplitterKey(idx_t splitter_idx);
+
+private:
+	vector<SortedRun *> runs;
+	SortKeyInfo &info;
+	//! The splitter rows; partition i holds the rows ordered before splitter i and not before splitter i - 1
+	DataChunk splitters;
+	//! The normalized sort keys of the splitters
+	unique_ptr<data_t[]> splitter_keys;
+};
+
+//! The SortedRunScanner reads the chunks of a SortedRun back in order
+class SortedRunScanner {
+public:
+	explicit SortedRunScanner(SortedRun &run);
+
+	//! Scans the next chunk of the run into the result; the result is empty if the run is exhausted. The result chunk
+	//! remains valid until the next call to Scan.
+	void Scan(DataChunk &result);
+
+private:
+	SortedRun &run;
+	//! The next chunk to scan
+	idx_t chunk_index;
+};
+
+} // namespace duckdb
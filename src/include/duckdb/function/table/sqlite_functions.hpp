@@ -32,4 +32,12 @@ struct PragmaDatabaseList {
 	static void RegisterFunction(BuiltinFunctions &set);
 };
 
+struct PragmaTaskSchedulerInfo {
+	static void RegisterFunction(BuiltinFunctions &set);
+};
+
+struct PragmaBufferManagerInfo {
+	static void RegisterFunction(BuiltinFunctions &set);
+};
+
 } // namespace duckdb
@@ -18,6 +18,7 @@
 #include "duckdb/main/table_description.hpp"
 #include "duckdb/transaction/transaction_context.hpp"
 #include "duckdb/common/enums/output_type.hpp"
+#include "duckdb/common/enums/task_priority.hpp"
 #include "duckdb/storage/object_cache.hpp"
 
 #include <random>
@@ -69,10 +70,14 @@ public:
 	//! Maximum bits allowed for using a perfect hash table (i.e. the perfect HT can hold up to 2^perfect_ht_threshold
 	//! elements)
 	idx_t perfect_ht_threshold = 12;
+	//! The amount of blocks per column that table scans read ahead of the current position (0 disables read-ahead)
+	idx_t read_ahead_depth = 8;
 	//! The writer used to log queries (if logging is enabled)
 	unique_ptr<BufferedFileWriter> log_query_writer;
 	//! The explain output type used when none is specified (default: PHYSICAL_ONLY)
 	ExplainOutputType explain_output_type = ExplainOutputType::PHYSICAL_ONLY;
+	//! The priority of the tasks of queries issued by this client (default: NORMAL)
+	TaskPriority task_priority = TaskPriority::NORMAL;
 	//! The random generator used by random(). Its seed value can be set by setseed().
 	std::mt19937 random_engine;
 
@@ -95,8 +100,10 @@ public:
 	unique_ptr<QueryResult> Query(unique_ptr<SQLStatement> statement, bool allow_stream_result);
 	//! Fetch a query from the current result set (if any)
 	unique_ptr<DataChunk> Fetch();
-	//! Cleanup the result set (if any).
+	//! Cleanup the context, invalidating its prepared statements and appenders (called when the connection is closed)
 	void Cleanup();
+	//! Close the open result set (if any), finishing its query
+	void CloseResult();
 	//! Invalidate the client context. The current query will be interrupted and the client context will be invalidated,
 	//! making it impossible for future queries to run.
 	void Invalidate();
@@ -29,6 +29,12 @@ public:
 	AccessMode access_mode = AccessMode::AUTOMATIC;
 	// Checkpoint when WAL reaches this size
 	idx_t checkpoint_wal_size = 1 << 20;
+	//! The maximum time (in microseconds) that a commit waits before syncing the WAL, so that the commits of other
+	//! transactions can be included in the same sync
+	idx_t commit_delay = 0;
+	//! The number of threads used by the database (including the thread of the client), e.g. while the WAL is replayed
+	//! at startup. Can be changed later on with PRAGMA threads
+	idx_t maximum_threads = 1;
 	//! Whether or not to use Direct IO, bypassing operating system buffers
 	bool use_direct_io = false;
 	//! The FileSystem to use, can be overwritten to allow for injecting custom file systems for testing purposes (e.g.
@@ -53,10 +59,6 @@ public:
 
 public:
 	static DBConfig &GetConfig(ClientContext &context);
-
-private:
-	// FIXME: don't set this as a user: used internally (only for now)
-	bool checkpoint_only = false;
 };
 
 } // namespace duckdb
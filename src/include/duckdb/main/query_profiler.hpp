@@ -16,6 +16,7 @@
 #include "duckdb/common/enums/profiler_format.hpp"
 #include "duckdb/execution/physical_operator.hpp"
 
+#include <atomic>
 #include <stack>
 #include <unordered_map>
 
@@ -71,7 +72,8 @@ private:
 	static void Render(TreeNode &node, std::ostream &str);
 
 public:
-	QueryProfiler() : automatic_print_format(ProfilerPrintFormat::NONE), enabled(false), running(false) {
+	QueryProfiler()
+	    : automatic_print_format(ProfilerPrintFormat::NONE), enabled(false), running(false), pruned_rows(0) {
 	}
 
 	void Enable() {
@@ -91,6 +93,8 @@ public:
 
 	//! Adds the timings gathered by an OperatorProfiler to this query profiler
 	void Flush(OperatorProfiler &profiler);
+	//! Adds rows that table scans skipped because the zonemaps of their segments showed that no row passes the filters
+	void AddPrunedRows(idx_t count);
 
 	void StartPhase(string phase);
 	void EndPhase();
@@ -127,6 +131,8 @@ private:
 	Profiler main_query;
 	//! A map of a Physical Operator pointer to a tree node
 	unordered_map<PhysicalOperator *, TreeNode *> tree_map;
+	//! The amount of rows that the table scans of the query skipped based on zonemaps
+	std::atomic<idx_t> pruned_rows;
 
 	//! The timer used to time the individual phases of the planning process
 	Profiler phase_profiler;
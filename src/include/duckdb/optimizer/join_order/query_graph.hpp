@@ -25,6 +25,12 @@ struct FilterInfo {
 	JoinRelationSet *left_set = nullptr;
 	JoinRelationSet *right_set = nullptr;
 	JoinRelationSet *set = nullptr;
+	//! The estimated fraction of the tuples of the relation that pass the filter (filters on a single relation only)
+	double selectivity = 1;
+	//! The estimated number of distinct values of the left and right side of an equality join condition, or
+	//! INVALID_INDEX if they are unknown
+	idx_t left_distinct_count = INVALID_INDEX;
+	idx_t right_distinct_count = INVALID_INDEX;
 };
 
 struct FilterNode {
@@ -15,6 +15,7 @@
 #include "duckdb/parser/expression_map.hpp"
 #include "duckdb/planner/logical_operator.hpp"
 #include "duckdb/planner/logical_operator_visitor.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
 
 #include <functional>
 
@@ -78,6 +79,14 @@ private:
 	//! rewritten into joins. Returns true if there are joins in the tree that can be reordered, false otherwise.
 	bool ExtractJoinRelations(LogicalOperator &input_op, vector<LogicalOperator *> &filter_operators,
 	                          LogicalOperator *parent = nullptr);
+	//! Returns the statistics of the base table column an expression refers to, or nullptr if there are none
+	unique_ptr<BaseStatistics> GetColumnStatistics(Expression &expression);
+	//! Estimate the selectivity of a filter on a single relation and the distinct counts of a join condition
+	void EstimateFilter(Expression &filter, FilterInfo &info);
+	//! Estimate the cardinality of a relation after applying the filters on it
+	idx_t EstimateRelationCardinality(idx_t relation_index);
+	//! Create a new join tree node by joining together two previous join tree nodes
+	unique_ptr<JoinNode> CreateJoinTree(JoinRelationSet *set, NeighborInfo *info, JoinNode *left, JoinNode *right);
 	//! Emit a pair as a potential join candidate. Returns the best plan found for the (left, right) connection (either
 	//! the newly created plan, or an existing plan)
 	JoinNode *EmitPair(JoinRelationSet *left, JoinRelationSet *right, NeighborInfo *info);
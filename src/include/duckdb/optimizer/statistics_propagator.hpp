@@ -58,7 +58,7 @@ private:
 	//! Run a comparison with two sets of statistics, returns if the comparison will always returns true/false or not
 	FilterPropagateResult PropagateComparison(BaseStatistics &left, BaseStatistics &right, ExpressionType comparison);
 
-	//! Update filter statistics from a filter with a constant
+	//! Update filter statistics from a filter with a constant, and the estimated cardinality of the current node
 	void UpdateFilterStatistics(BaseStatistics &input, ExpressionType comparison_type, Value constant);
 	//! Update statistics from a filter between two stats
 	void UpdateFilterStatistics(BaseStatistics &lstats, BaseStatistics &rstats, ExpressionType comparison_type);
@@ -22,6 +22,7 @@ class TaskContext;
 //! The Pipeline class represents an execution pipeline
 class Pipeline {
 	friend class Executor;
+	friend class PipelineFinalizeTask;
 
 public:
 	Pipeline(Executor &execution_context, ProducerToken &token);
@@ -47,6 +48,11 @@ public:
 	//! Finish executing this pipeline
 	void Finish();
 
+	//! Schedules a set of tasks that perform (part of) the Finalize of the sink in parallel. Can be called from
+	//! PhysicalSink::Finalize, or from within a previously scheduled finalize task. The pipeline is only finished after
+	//! all scheduled finalize tasks have completed.
+	void ScheduleFinalizeTasks(vector<unique_ptr<Task>> tasks);
+
 	string ToString() const;
 	void Print() const;
 
@@ -76,7 +82,7 @@ public:
 	//! The current threads working on the pipeline
 	std::atomic<idx_t> finished_tasks;
 	//! The maximum amount of threads that can work on the pipeline
-	idx_t total_tasks;
+	std::atomic<idx_t> total_tasks;
 
 private:
 	//! The child from which to pull chunks
@@ -105,6 +111,8 @@ private:
 
 private:
 	void ScheduleSequentialTask();
+	//! Finish a single finalize task of this pipeline
+	void FinishFinalizeTask();
 	bool ScheduleOperator(PhysicalOperator *op);
 };
 
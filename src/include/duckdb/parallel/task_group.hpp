@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/parallel/task_group.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+
+#include <condition_variable>
+#include <functional>
+
+namespace duckdb {
+
+//! A TaskGroup runs a set of tasks on the task scheduler for a thread that has to wait for all of them. The waiting
+//! thread executes the tasks of the group as well, and then blocks until the tasks that are still being executed by
+//! other threads have finished.
+class TaskGroup {
+	friend class TaskGroupTask;
+
+public:
+	explicit TaskGroup(TaskScheduler &scheduler);
+	//! Waits for the scheduled tasks if Finish was not called, without throwing their errors
+	~TaskGroup();
+
+	//! Schedules a task that executes the given function
+	void Schedule(std::function<void()> function);
+	//! Executes tasks of the group on this thread, and waits until every task has finished. Throws the error of the
+	//! first task that failed (if any).
+	void Finish();
+
+private:
+	void WaitForTasks();
+	void FinishTask(const string &task_error);
+
+	TaskScheduler &scheduler;
+	unique_ptr<ProducerToken> producer;
+	//! The lock for the task counts and the error
+	mutex lock;
+	//! Signaled when the last scheduled task has finished
+	std::condition_variable tasks_finished;
+	//! The amount of tasks that were scheduled
+	idx_t scheduled_tasks;
+	//! The amount of tasks that have finished
+	idx_t finished_tasks;
+	//! The error of the first task that failed (if any)
+	string error;
+};
+
+} // namespace duckdb
@@ -9,10 +9,13 @@
 #pragma once
 
 #include "duckdb/common/common.hpp"
+#include "duckdb/common/enums/task_priority.hpp"
 #include "duckdb/common/mutex.hpp"
 #include "duckdb/common/vector.hpp"
 #include "duckdb/parallel/task.hpp"
 
+#include <atomic>
+
 namespace duckdb {
 
 struct ConcurrentQueue;
@@ -23,16 +26,35 @@ class TaskScheduler;
 struct SchedulerThread;
 
 struct ProducerToken {
-	ProducerToken(TaskScheduler &scheduler, unique_ptr<QueueProducerToken> token);
+	ProducerToken(TaskScheduler &scheduler, shared_ptr<QueueProducerToken> token, TaskPriority priority);
 	~ProducerToken();
 
 	TaskScheduler &scheduler;
-	unique_ptr<QueueProducerToken> token;
+	//! The token is shared with the background threads, which may still fetch tasks from it after it is unregistered
+	shared_ptr<QueueProducerToken> token;
 	std::mutex producer_lock;
+	//! The priority of the tasks of this producer
+	TaskPriority priority;
+};
+
+//! Statistics on the tasks executed by the task scheduler
+struct TaskSchedulerStatistics {
+	//! The amount of tasks that were scheduled
+	idx_t tasks_scheduled;
+	//! The amount of tasks that were taken from the queue
+	idx_t tasks_executed;
+	//! The total time tasks spent waiting in the queue (in microseconds)
+	idx_t total_wait_usecs;
+	//! The longest time a single task spent waiting in the queue (in microseconds)
+	idx_t max_wait_usecs;
+	//! The amount of producers that are currently registered
+	idx_t active_producers;
 };
 
 //! The TaskScheduler is responsible for managing tasks and threads
 class TaskScheduler {
+	friend struct ProducerToken;
+
 	// timeout for semaphore wait, default 50ms
 	constexpr static int64_t TASK_TIMEOUT_USECS = 50000;
 
@@ -42,7 +64,7 @@ public:
 
 	static TaskScheduler &GetScheduler(ClientContext &context);
 
-	unique_ptr<ProducerToken> CreateProducer();
+	unique_ptr<ProducerToken> CreateProducer(TaskPriority priority = TaskPriority::NORMAL);
 	//! Schedule a task to be executed by the task scheduler
 	void ScheduleTask(ProducerToken &producer, unique_ptr<Task> task);
 	//! Fetches a task from a specific producer, returns true if successful or false if no tasks were available
@@ -56,6 +78,13 @@ public:
 	//! Returns the number of threads
 	int32_t NumberOfThreads();
 
+	//! Returns the task statistics of the scheduler
+	TaskSchedulerStatistics GetStatistics();
+
+private:
+	//! Records that a task waited the specified amount of microseconds in the queue before it was dequeued
+	void RecordWait(idx_t wait_usecs);
+
 private:
 	//! The task queue
 	unique_ptr<ConcurrentQueue> queue;
@@ -63,6 +92,11 @@ private:
 	vector<unique_ptr<SchedulerThread>> threads;
 	//! Markers used by the various threads, if the markers are set to "false" the thread execution is stopped
 	vector<unique_ptr<bool>> markers;
+
+	std::atomic<idx_t> tasks_scheduled;
+	std::atomic<idx_t> tasks_executed;
+	std::atomic<idx_t> total_wait_usecs;
+	std::atomic<idx_t> max_wait_usecs;
 };
 
 } // namespace duckdb
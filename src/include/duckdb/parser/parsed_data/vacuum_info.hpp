@@ -13,7 +13,17 @@
 namespace duckdb {
 
 struct VacuumInfo : public ParseInfo {
-	// nothing for now
+	VacuumInfo() : analyze(false), schema(INVALID_SCHEMA) {
+	}
+
+	//! Whether or not the statistics of the tables are collected (ANALYZE)
+	bool analyze;
+	//! The schema of the table to analyze
+	string schema;
+	//! The table to analyze, or empty to analyze all tables
+	string table;
+	//! The columns to analyze, or empty to analyze all columns
+	vector<string> columns;
 };
 
 } // namespace duckdb
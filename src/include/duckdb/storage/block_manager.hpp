@@ -24,16 +24,30 @@ public:
 	virtual unique_ptr<Block> CreateBlock() = 0;
 	//! Return the next free block id
 	virtual block_id_t GetFreeBlockId() = 0;
+	//! Mark a block that was written by a previous checkpoint as used by the current checkpoint, so it is not freed
+	virtual void MarkBlockAsUsed(block_id_t block_id) = 0;
+	//! Mark a block that is referred to by the WAL as used, so it is not handed out by GetFreeBlockId
+	virtual void ReserveBlock(block_id_t block_id) = 0;
+	//! Mark a block that holds rows of a transaction that has not committed yet as pending: checkpoints do not free it
+	//! until the transaction has finished
+	virtual void MarkBlockAsPending(block_id_t block_id) = 0;
+	//! Release a pending block once its transaction has finished. If the transaction rolled back, the block is free.
+	virtual void ReleasePendingBlock(block_id_t block_id, bool free) = 0;
 	//! Get the first meta block id
 	virtual block_id_t GetMetaBlock() = 0;
-	//! Read the content of the block from disk
+	//! Read the content of the block from disk. Can be called concurrently from multiple threads for different blocks.
 	virtual void Read(Block &block) = 0;
+	//! Hint that the block will be read soon, the block manager can start reading it asynchronously
+	virtual void Prefetch(block_id_t block_id) {
+	}
 	//! Writes the block to disk
 	virtual void Write(FileBuffer &block, block_id_t block_id) = 0;
 	//! Writes the block to disk
 	void Write(Block &block) {
 		Write(block, block.id);
 	}
+	//! Sync the blocks that have been written to disk
+	virtual void Sync() = 0;
 	//! Write the header; should be the final step of a checkpoint
 	virtual void WriteHeader(DatabaseHeader header) = 0;
 };
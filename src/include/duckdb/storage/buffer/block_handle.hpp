@@ -58,6 +58,12 @@ private:
 	bool can_destroy;
 	//! The memory usage of the block
 	idx_t memory_usage;
+	//! Whether or not the block was prefetched, and has not been loaded since
+	bool prefetched;
+	//! Whether or not the block belongs to the frequent queue, i.e. it was loaded again shortly after it was evicted
+	bool frequent;
+	//! The id of the sequential scan that last pinned the block (0 if it was not pinned by a sequential scan)
+	idx_t last_scan_id;
 };
 
 } // namespace duckdb
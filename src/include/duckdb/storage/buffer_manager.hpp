@@ -22,6 +22,24 @@
 namespace duckdb {
 struct EvictionQueue;
 
+//! Statistics on the blocks managed by the buffer manager
+struct BufferManagerStatistics {
+	//! The amount of memory currently in use (in bytes)
+	idx_t memory_usage;
+	//! The maximum amount of memory that can be used (in bytes)
+	idx_t memory_limit;
+	//! The amount of times an on-disk block was pinned while it was loaded
+	idx_t block_hits;
+	//! The amount of times an on-disk block had to be read when it was pinned
+	idx_t block_misses;
+	//! The amount of blocks that were evicted
+	idx_t evictions;
+	//! The amount of blocks for which a prefetch was issued
+	idx_t prefetch_requests;
+	//! The amount of prefetched blocks that were subsequently pinned
+	idx_t prefetch_hits;
+};
+
 //! The buffer manager is in charge of handling memory management for the database. It hands out memory buffers that can
 //! be used by the database internally.
 class BufferManager {
@@ -35,6 +53,8 @@ public:
 
 	//! Register a block with the given block id in the base file
 	shared_ptr<BlockHandle> RegisterBlock(block_id_t block_id);
+	//! Returns the ids of the on-disk blocks that are currently registered, i.e. that are still referred to in memory
+	vector<block_id_t> GetRegisteredBlocks();
 
 	//! Register an in-memory buffer of arbitrary size, as long as it is >= BLOCK_SIZE. can_destroy signifies whether or
 	//! not the buffer can be destroyed when unpinned, or whether or not it needs to be written to a temporary file so
@@ -45,8 +65,14 @@ public:
 	//! The allocated memory is released when the buffer handle is destroyed.
 	unique_ptr<BufferHandle> Allocate(idx_t alloc_size);
 
-	unique_ptr<BufferHandle> Pin(shared_ptr<BlockHandle> &handle);
+	//! Pin a block, loading it if necessary. scan_id identifies the sequential scan that pins the block (0 if the block
+	//! is not pinned by a sequential scan): a block that is loaded again by the scan that evicted it is not considered
+	//! to be re-referenced.
+	unique_ptr<BufferHandle> Pin(shared_ptr<BlockHandle> &handle, idx_t scan_id = 0);
 	void Unpin(shared_ptr<BlockHandle> &handle);
+	//! Hint that the block will be pinned soon, so that it can be read in asynchronously. Only on-disk blocks that
+	//! are not loaded yet are prefetched.
+	void Prefetch(shared_ptr<BlockHandle> &handle);
 
 	void UnregisterBlock(block_id_t block_id, bool can_destroy);
 
@@ -56,6 +82,16 @@ public:
 
 	static BufferManager &GetBufferManager(ClientContext &context);
 
+	//! Returns the maximum amount of memory that the buffer manager can keep (in bytes)
+	idx_t GetMaxMemory() {
+		return maximum_memory;
+	}
+
+	//! Returns a new identifier for a sequential scan, that can be passed to Pin
+	idx_t RegisterScan();
+	//! Returns the statistics of the buffer manager
+	BufferManagerStatistics GetStatistics();
+
 private:
 	//! Evict blocks until the currently used memory + extra_memory fit, returns false if this was not possible
 	//! (i.e. not enough blocks could be evicted)
@@ -88,5 +124,17 @@ private:
 	unique_ptr<EvictionQueue> queue;
 	//! The temporary id used for managed buffers
 	block_id_t temporary_id;
+	//! The last identifier handed out to a sequential scan
+	std::atomic<idx_t> scan_id;
+	//! The amount of times an on-disk block was pinned while it was loaded
+	std::atomic<idx_t> block_hits;
+	//! The amount of times an on-disk block had to be read when it was pinned
+	std::atomic<idx_t> block_misses;
+	//! The amount of blocks that were evicted
+	std::atomic<idx_t> evictions;
+	//! The amount of blocks for which a prefetch was issued
+	std::atomic<idx_t> prefetch_requests;
+	//! The amount of prefetched blocks that were subsequently pinned
+	std::atomic<idx_t> prefetch_hits;
 };
 } // namespace duckdb
@@ -14,33 +14,78 @@ namespace duckdb {
 class UncompressedSegment;
 class BaseStatistics;
 class SegmentStatistics;
+class ColumnSegment;
+class DataTable;
+struct AppendBlocks;
+
+//! A range of consecutive segments of a column. Every range is written to its own blocks, which allows the ranges of
+//! a table to be written in parallel. Within a range, the data of consecutive segments is packed into shared blocks.
+struct ColumnWriteRange {
+	//! The column that the segments belong to
+	idx_t col_idx;
+	//! The row at which the range starts
+	idx_t row_start;
+	//! The first segment of the range
+	ColumnSegment *start_segment;
+	//! The amount of segments in the range
+	idx_t segment_count;
+	//! The segment that the data of the range is currently appended to
+	unique_ptr<UncompressedSegment> segment;
+	//! The statistics of the segment that the data is appended to
+	unique_ptr<SegmentStatistics> stats;
+	//! The blocks that the range has been written to
+	vector<shared_ptr<CheckpointBlock>> blocks;
+};
 
 //! The table data writer is responsible for writing the data of a table to the block manager
 class TableDataWriter {
 public:
-	TableDataWriter(CheckpointManager &manager, TableCatalogEntry &table);
+	TableDataWriter(CheckpointManager &manager, DataTable &table);
 	~TableDataWriter();
 
-	void WriteTableData(ClientContext &context);
+	//! The (minimum) amount of vectors of a column that are written together by WriteRange
+	static constexpr idx_t VECTORS_PER_RANGE = 2048;
+
+	//! Divide the columns of the table into the ranges of segments that have to be written
+	void InitializeTableData(ClientContext &context);
+	//! The amount of ranges of the table
+	idx_t RangeCount();
+	//! Write the data of the specified range. Different ranges can be written in parallel.
+	void WriteRange(idx_t range_idx);
+	//! Write the data pointers of the table to the table data of the checkpoint, after all ranges have been written
+	void WriteDataPointers();
+
+	//! Write the rows [start_row, start_row + count), which have been appended to the table by a transaction that has
+	//! not committed yet, to new blocks. Returns the blocks of every column.
+	unique_ptr<AppendBlocks> WriteAppend(idx_t start_row, idx_t count);
+
+	//! Returns the amount of rows in [start, end) that are deleted according to the (sorted) delete ranges
+	static idx_t CountDeletedRows(const vector<std::pair<idx_t, idx_t>> &deletes, idx_t start, idx_t end);
 
 private:
-	void AppendData(Transaction &transaction, idx_t col_idx, Vector &data, idx_t count);
+	void AppendData(ColumnWriteRange &range, Vector &data, idx_t offset, idx_t count);
+	//! Write the rows [start, end) of the segment to the blocks of the range. The values of deleted rows are dropped.
+	void WriteRows(ColumnWriteRange &range, ColumnSegment &segment, idx_t start, idx_t end);
+	//! Write the rows [start, end), which have all been deleted, without storing any data for them
+	void WriteDeletedRows(ColumnWriteRange &range, idx_t start, idx_t end);
 
-	void CreateSegment(idx_t col_idx);
-	void FlushSegment(Transaction &transaction, idx_t col_idx);
+	void CreateSegment(ColumnWriteRange &range);
+	void FlushSegment(ColumnWriteRange &range);
+	//! Refer to an existing block of a previous checkpoint
+	void WriteExistingBlock(ColumnWriteRange &range, shared_ptr<CheckpointBlock> block);
 
-	void WriteDataPointers();
 	void VerifyDataPointers();
 
 private:
 	CheckpointManager &manager;
-	TableCatalogEntry &table;
-
-	vector<unique_ptr<UncompressedSegment>> segments;
-	vector<unique_ptr<SegmentStatistics>> stats;
-	vector<unique_ptr<BaseStatistics>> column_stats;
+	DataTable &table;
+	//! The transaction whose committed state is written
+	Transaction *transaction;
 
-	vector<vector<DataPointer>> data_pointers;
+	//! The ranges of the table, ordered by column and by row
+	vector<unique_ptr<ColumnWriteRange>> ranges;
+	//! The rows of the table that are deleted, as [start, end) ranges of row ids
+	vector<std::pair<idx_t, idx_t>> deletes;
 };
 
 } // namespace duckdb
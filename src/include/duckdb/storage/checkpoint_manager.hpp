@@ -10,6 +10,8 @@
 
 #include "duckdb/common/common.hpp"
 #include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/data_pointer.hpp"
 #include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/storage/meta_block_writer.hpp"
 #include "duckdb/storage/statistics/base_statistics.hpp"
@@ -20,27 +22,18 @@ class MetaBlockReader;
 class SchemaCatalogEntry;
 class SequenceCatalogEntry;
 class TableCatalogEntry;
+class TableDataWriter;
 class ViewCatalogEntry;
 
-class DataPointer {
-public:
-	DataPointer(){};
-
-	uint64_t row_start;
-	uint64_t tuple_count;
-	block_id_t block_id;
-	uint32_t offset;
-	//! Type-specific statistics of the segment
-	unique_ptr<BaseStatistics> statistics;
-};
-
 //! CheckpointManager is responsible for checkpointing the database
 class CheckpointManager {
 public:
 	CheckpointManager(StorageManager &manager);
+	~CheckpointManager();
 
-	//! Checkpoint the current state of the WAL and flush it to the main storage. This should be called BEFORE any
-	//! connction is available because right now the checkpointing cannot be done online. (TODO)
+	//! Write the committed state of the database to the main storage. Segments that have not been modified since the
+	//! previous checkpoint keep their blocks, only new and modified data is written. No transaction can commit while
+	//! the checkpoint is being written.
 	void CreateCheckpoint();
 	//! Load from a stored checkpoint
 	void LoadFromStorage();
@@ -57,6 +50,14 @@ public:
 	unique_ptr<MetaBlockWriter> tabledata_writer;
 
 private:
+	//! The writers of the data of the tables, the data of the tables is written before the metadata
+	unordered_map<TableCatalogEntry *, unique_ptr<TableDataWriter>> table_writers;
+
+private:
+	//! Write the data of all tables of the given schemas, the ranges of the tables are written in parallel by tasks of
+	//! the task scheduler
+	void WriteTableData(ClientContext &context, vector<SchemaCatalogEntry *> &schemas);
+
 	void WriteSchema(ClientContext &context, SchemaCatalogEntry &schema);
 	void WriteTable(ClientContext &context, TableCatalogEntry &table);
 	void WriteView(ViewCatalogEntry &table);
@@ -13,6 +13,7 @@
 #include "duckdb/storage/table/scan_state.hpp"
 #include "duckdb/storage/table/persistent_segment.hpp"
 #include "duckdb/storage/statistics/base_statistics.hpp"
+#include "duckdb/common/mutex.hpp"
 
 namespace duckdb {
 class PersistentSegment;
@@ -61,6 +62,13 @@ public:
 	void Append(ColumnAppendState &state, Vector &vector, idx_t count);
 	//! Revert a set of appends to the ColumnData
 	void RevertAppend(row_t start_row);
+	//! Hand the blocks that committed appended rows were written to to the segments that hold the rows
+	void AddCheckpointBlocks(vector<shared_ptr<CheckpointBlock>> &blocks);
+
+	//! Returns the histogram of the column collected by ANALYZE, or nullptr if the column has not been analyzed
+	shared_ptr<Histogram> GetHistogram();
+	//! Replace the histogram of the column
+	void SetHistogram(shared_ptr<Histogram> new_histogram);
 
 	//! Update the specified row identifiers
 	void Update(Transaction &transaction, Vector &updates, Vector &row_ids, idx_t count);
@@ -73,6 +81,12 @@ public:
 private:
 	//! Append a transient segment
 	void AppendTransientSegment(idx_t start_row);
+
+private:
+	//! Lock for the histogram, which can be replaced by ANALYZE while queries are using it
+	mutex histogram_lock;
+	//! The histogram of the column
+	shared_ptr<Histogram> histogram;
 };
 
 } // namespace duckdb
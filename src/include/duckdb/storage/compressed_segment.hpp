@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/compressed_segment.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/storage/numeric_segment.hpp"
+
+namespace duckdb {
+
+//! The encodings that can be used for a single vector of a compressed segment
+enum class VectorEncoding : uint8_t {
+	UNCOMPRESSED = 0, // the values are stored as-is
+	CONSTANT = 1,     // all values of the vector are equal: the value is stored once
+	RLE = 2,          // run-length encoding: the run values are stored followed by the run lengths
+	BITPACKING = 3    // frame-of-reference: the minimum is stored followed by the bit-packed offsets from the minimum
+};
+
+//! A compressed segment stores fixed-size values using lightweight compression. The encoding is chosen per vector,
+//! based on the amount of runs and the value range of the vector. The encoded vectors are stored back-to-back at the
+//! start of the block, and the offsets of the vectors are stored in reverse order at the end of the block.
+//!
+//! Compressed data is never modified in-place: the first update of a compressed segment decompresses the segment
+//! into an in-memory buffer in the NumericSegment format, after which the segment behaves as a NumericSegment.
+class CompressedSegment : public NumericSegment {
+public:
+	//! Creates an empty compressed segment that can be appended to (when block_id is INVALID_BLOCK), or a compressed
+	//! segment with the specified amount of tuples that refers to an on-disk block
+	CompressedSegment(BufferManager &manager, PhysicalType type, idx_t row_start, block_id_t block_id = INVALID_BLOCK,
+	                  idx_t count = 0);
+
+	//! The maximum amount of vectors stored in a single compressed segment
+	static constexpr idx_t MAX_VECTOR_COUNT = 512;
+
+public:
+	//! Returns whether or not values of the specified type can be stored in a compressed segment
+	static bool SupportsType(PhysicalType type);
+
+	void InitializeScan(ColumnScanState &state) override;
+
+	//! Fetch a single value and append it to the vector
+	void FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id, Vector &result,
+	              idx_t result_idx) override;
+
+	//! Append a part of a vector to the compressed segment, updating the provided stats in the process. Returns the
+	//! amount of tuples appended. If this is less than `count`, the compressed segment is full.
+	idx_t Append(SegmentStatistics &stats, Vector &data, idx_t offset, idx_t count) override;
+
+	//! Decompresses the segment into an in-memory buffer
+	void ToTemporary() override;
+
+protected:
+	void Select(ColumnScanState &state, Vector &result, SelectionVector &sel, idx_t &approved_tuple_count,
+	            vector<TableFilter> &tableFilter) override;
+	void FetchBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) override;
+	void FilterFetchBaseData(ColumnScanState &state, Vector &result, SelectionVector &sel,
+	                         idx_t &approved_tuple_count) override;
+
+private:
+	//! Decodes the vector at the specified index of the compressed block into the nullmask and data
+	void DecodeVector(data_ptr_t block_data, idx_t vector_index, nullmask_t &nullmask, data_ptr_t data);
+	//! Encodes the pending vector into the block
+	void EncodePendingVector();
+
+private:
+	//! The uncompressed segment holding the values of the vector that is currently being appended to
+	unique_ptr<NumericSegment> pending;
+	//! The offset in the block at which the next vector is written
+	idx_t data_size;
+};
+
+} // namespace duckdb
@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/data_pointer.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/enums/compression_type.hpp"
+#include "duckdb/storage/storage_info.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
+
+#include <atomic>
+
+namespace duckdb {
+class Serializer;
+class Deserializer;
+
+class DataPointer {
+public:
+	DataPointer(){};
+
+	uint64_t row_start;
+	uint64_t tuple_count;
+	block_id_t block_id;
+	uint32_t offset;
+	//! The compression that is used to store the segment
+	CompressionType compression = CompressionType::UNCOMPRESSED;
+	//! The blocks holding the overflow strings of the segment (if any)
+	vector<block_id_t> overflow_blocks;
+	//! Type-specific statistics of the segment
+	unique_ptr<BaseStatistics> statistics;
+
+public:
+	DataPointer Copy() const;
+
+	void Serialize(Serializer &serializer) const;
+	static DataPointer Deserialize(Deserializer &source, const LogicalType &type);
+};
+
+//! A block that has been written by a checkpoint. A block can hold the data of several consecutive segments of a
+//! column: the next checkpoint can refer to the block as-is as long as none of these segments has been modified, and
+//! no further rows of the block have been deleted.
+struct CheckpointBlock {
+	CheckpointBlock(DataPointer pointer_p, idx_t deleted_count)
+	    : pointer(move(pointer_p)), deleted_count(deleted_count), modified(false) {
+	}
+
+	//! The data pointer to the block
+	DataPointer pointer;
+	//! The amount of deleted rows of the block. The values of deleted rows are not stored in the block.
+	idx_t deleted_count;
+	//! Whether or not one of the segments whose data is stored in the block has been modified
+	std::atomic<bool> modified;
+};
+
+} // namespace duckdb
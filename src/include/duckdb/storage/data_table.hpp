@@ -30,6 +30,7 @@ class StorageManager;
 class TableCatalogEntry;
 class Transaction;
 class WriteAheadLog;
+struct AppendBlocks;
 
 struct DataTableInfo {
 	DataTableInfo(string schema, string table) : cardinality(0), schema(move(schema)), table(move(table)) {
@@ -53,6 +54,10 @@ struct DataTableInfo {
 struct ParallelTableScanState {
 	idx_t current_row;
 	bool transaction_local_data;
+	//! The id of the scan in the buffer manager
+	idx_t scan_id;
+	//! For each scanned column, the row up to which blocks have been read ahead
+	vector<idx_t> read_ahead_row;
 };
 
 //! DataTable represents a physical table on disk
@@ -116,6 +121,8 @@ public:
 	void CommitAppend(transaction_t commit_id, idx_t row_start, idx_t count);
 	//! Write a segment of the table to the WAL
 	void WriteToLog(WriteAheadLog &log, idx_t row_start, idx_t count);
+	//! Hand the blocks that committed appended rows were written to to the segments of the table
+	void AddCheckpointBlocks(AppendBlocks &blocks);
 	//! Revert a set of appends made by the given AppendState, used to revert appends in the event of an error during
 	//! commit (e.g. because of an I/O exception)
 	void RevertAppend(idx_t start_row, idx_t count);
@@ -139,6 +146,14 @@ public:
 
 	unique_ptr<BaseStatistics> GetStatistics(ClientContext &context, column_t column_id);
 
+	//! Returns the physical column data of the column with the given index
+	ColumnData &GetColumnData(idx_t column_idx) {
+		return *columns[column_idx];
+	}
+	//! Returns the rows of the table that are not visible to the given transaction, as [start, end) ranges of row ids
+	//! (see MorselInfo::GetCommittedDeletes)
+	vector<std::pair<idx_t, idx_t>> GetCommittedDeletes(Transaction &transaction);
+
 private:
 	//! Verify constraints with a chunk from the Append containing all columns of the table
 	void VerifyAppendConstraints(TableCatalogEntry &table, DataChunk &chunk);
@@ -146,8 +161,15 @@ private:
 	void VerifyUpdateConstraints(TableCatalogEntry &table, DataChunk &chunk, vector<column_t> &column_ids);
 
 	void InitializeScanWithOffset(TableScanState &state, const vector<column_t> &column_ids,
-	                              TableFilterSet *table_filters, idx_t start_row, idx_t end_row);
+	                              TableFilterSet *table_filters, idx_t start_row, idx_t end_row, idx_t scan_id);
+	//! Prefetch the blocks of the persistent segments of the scanned columns that follow the specified row
+	void ReadAhead(ClientContext &context, ParallelTableScanState &state, const vector<column_t> &column_ids,
+	               idx_t row);
 	bool CheckZonemap(TableScanState &state, TableFilterSet *table_filters, idx_t &current_row);
+	//! Check the zonemaps of the segments of the filtered columns that contain the given row. Returns false if the rows
+	//! up to segment_end can be skipped, otherwise segment_end is set to the first segment boundary after the row.
+	bool CheckSegmentZonemaps(TableFilterSet *table_filters, const vector<column_t> &column_ids, idx_t row,
+	                          idx_t &segment_end);
 	bool ScanBaseTable(Transaction &transaction, DataChunk &result, TableScanState &state,
 	                   const vector<column_t> &column_ids, idx_t &current_row, idx_t max_row);
 	bool ScanCreateIndex(CreateIndexScanState &state, const vector<column_t> &column_ids, DataChunk &result,
@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/empty_segment.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/storage/uncompressed_segment.hpp"
+
+namespace duckdb {
+
+//! An empty segment takes the place of a persistent segment of which every row has been deleted. The data of the rows
+//! is not stored: the rows only exist so the row ids of the table remain unchanged, and are never visible to a scan.
+class EmptySegment : public UncompressedSegment {
+public:
+	EmptySegment(BufferManager &manager, PhysicalType type, idx_t row_start, idx_t count);
+
+public:
+	//! Fetch a single value and append it to the vector
+	void FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id, Vector &result,
+	              idx_t result_idx) override;
+
+	//! An empty segment cannot be appended to
+	idx_t Append(SegmentStatistics &stats, Vector &data, idx_t offset, idx_t count) override;
+
+	//! Rollback a previous update
+	void RollbackUpdate(UpdateInfo *info) override;
+	//! An empty segment is never converted into an in-memory segment
+	void ToTemporary() override;
+
+protected:
+	void Update(ColumnData &data, SegmentStatistics &stats, Transaction &transaction, Vector &update, row_t *ids,
+	            idx_t count, idx_t vector_index, idx_t vector_offset, UpdateInfo *node) override;
+	void Select(ColumnScanState &state, Vector &result, SelectionVector &sel, idx_t &approved_tuple_count,
+	            vector<TableFilter> &tableFilter) override;
+	void FetchBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) override;
+	void FilterFetchBaseData(ColumnScanState &state, Vector &result, SelectionVector &sel,
+	                         idx_t &approved_tuple_count) override;
+	void FetchUpdateData(ColumnScanState &state, Transaction &transaction, UpdateInfo *versions,
+	                     Vector &result) override;
+};
+
+} // namespace duckdb
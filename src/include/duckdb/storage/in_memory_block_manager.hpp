@@ -26,6 +26,18 @@ public:
 	block_id_t GetFreeBlockId() override {
 		throw Exception("Cannot perform IO in in-memory database!");
 	}
+	void MarkBlockAsUsed(block_id_t block_id) override {
+		throw Exception("Cannot perform IO in in-memory database!");
+	}
+	void ReserveBlock(block_id_t block_id) override {
+		throw Exception("Cannot perform IO in in-memory database!");
+	}
+	void MarkBlockAsPending(block_id_t block_id) override {
+		throw Exception("Cannot perform IO in in-memory database!");
+	}
+	void ReleasePendingBlock(block_id_t block_id, bool free) override {
+		throw Exception("Cannot perform IO in in-memory database!");
+	}
 	block_id_t GetMetaBlock() override {
 		throw Exception("Cannot perform IO in in-memory database!");
 	}
@@ -35,6 +47,9 @@ public:
 	void Write(FileBuffer &block, block_id_t block_id) override {
 		throw Exception("Cannot perform IO in in-memory database!");
 	}
+	void Sync() override {
+		throw Exception("Cannot perform IO in in-memory database!");
+	}
 	void WriteHeader(DatabaseHeader header) override {
 		throw Exception("Cannot perform IO in in-memory database!");
 	}
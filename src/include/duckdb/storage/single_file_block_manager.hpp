@@ -12,6 +12,7 @@
 #include "duckdb/storage/block_manager.hpp"
 #include "duckdb/storage/block.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/common/unordered_set.hpp"
 #include "duckdb/common/vector.hpp"
 
@@ -32,12 +33,24 @@ public:
 	unique_ptr<Block> CreateBlock() override;
 	//! Return the next free block id
 	block_id_t GetFreeBlockId() override;
+	//! Mark a block of the previous checkpoint as used by the current checkpoint
+	void MarkBlockAsUsed(block_id_t block_id) override;
+	//! Remove a block that is referred to by the WAL from the free list
+	void ReserveBlock(block_id_t block_id) override;
+	//! Keep a block of an uncommitted transaction from being freed by checkpoints
+	void MarkBlockAsPending(block_id_t block_id) override;
+	//! Release a block of a transaction that has finished, and free it if the transaction rolled back
+	void ReleasePendingBlock(block_id_t block_id, bool free) override;
 	//! Return the meta block id
 	block_id_t GetMetaBlock() override;
 	//! Read the content of the block from disk
 	void Read(Block &block) override;
+	//! Ask the operating system to read the block into the page cache asynchronously
+	void Prefetch(block_id_t block_id) override;
 	//! Write the given block to disk
 	void Write(FileBuffer &block, block_id_t block_id) override;
+	//! Sync the blocks that have been written to disk
+	void Sync() override;
 	//! Write the header to disk, this is the final step of the checkpointing process
 	void WriteHeader(DatabaseHeader header) override;
 
@@ -56,10 +69,14 @@ private:
 	unique_ptr<FileHandle> handle;
 	//! The buffer used to read/write to the headers
 	FileBuffer header_buffer;
+	//! The lock for the free list and the used blocks, blocks are requested by multiple threads during a checkpoint
+	mutex block_lock;
 	//! The list of free blocks that can be written to currently
 	vector<block_id_t> free_list;
 	//! The list of blocks that are used by the current block manager
 	unordered_set<block_id_t> used_blocks;
+	//! The blocks that hold rows of transactions that have not committed yet, these are used by every checkpoint
+	unordered_set<block_id_t> pending_blocks;
 	//! The current meta block id
 	block_id_t meta_block;
 	//! The current maximum block id, this id will be given away first after the free_list runs out
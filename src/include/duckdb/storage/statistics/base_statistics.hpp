@@ -12,6 +12,8 @@
 #include "duckdb/common/types.hpp"
 #include "duckdb/common/operator/comparison_operators.hpp"
 #include "duckdb/common/enums/expression_type.hpp"
+#include "duckdb/common/types/hyperloglog.hpp"
+#include "duckdb/storage/statistics/histogram.hpp"
 
 namespace duckdb {
 class Serializer;
@@ -29,6 +31,12 @@ public:
 	LogicalType type;
 	//! Whether or not the segment can contain NULL values
 	bool has_null;
+	//! The sketch of the distinct values of the segment. Only maintained for the statistics of stored data, nullptr
+	//! if the distinct values are unknown.
+	unique_ptr<HyperLogLog> distinct_stats;
+	//! The histogram of the column collected by ANALYZE. Only set on the statistics of a base table column: it is not
+	//! copied, merged or serialized with the statistics.
+	shared_ptr<Histogram> histogram;
 
 public:
 	static unique_ptr<BaseStatistics> CreateEmpty(LogicalType type);
@@ -40,7 +48,14 @@ public:
 	//! Verify that a vector does not violate the statistics
 	virtual void Verify(Vector &vector, idx_t count);
 
+	//! Returns the approximate number of distinct non-NULL values, or INVALID_INDEX if it is unknown
+	idx_t GetDistinctCount();
+
 	virtual string ToString();
+
+protected:
+	//! Copy the members of the BaseStatistics to another set of statistics
+	void CopyBase(BaseStatistics &other);
 };
 
 } // namespace duckdb
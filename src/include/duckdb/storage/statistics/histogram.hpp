@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/statistics/histogram.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/common/enums/expression_type.hpp"
+
+namespace duckdb {
+class Serializer;
+class Deserializer;
+
+//! The Histogram describes the distribution of the values of a column, and is built by ANALYZE from a sample of the
+//! rows of the table. The most common values are stored together with the fraction of the rows that holds them. The
+//! remaining values are summarized by an equi-depth histogram, in which every bucket holds about the same amount of
+//! rows.
+class Histogram {
+public:
+	//! The amount of rows that are sampled from a table to build the histograms of its columns
+	static constexpr const idx_t SAMPLE_SIZE = 10000;
+	//! The maximum amount of most common values that are kept
+	static constexpr const idx_t MAX_COMMON_VALUES = 16;
+	//! The maximum amount of buckets of the equi-depth histogram
+	static constexpr const idx_t MAX_BUCKETS = 32;
+
+	explicit Histogram(LogicalType type);
+
+	//! The type of the column
+	LogicalType type;
+	//! The fraction of the rows that is NULL
+	double null_fraction;
+	//! The most common values of the column
+	vector<Value> common_values;
+	//! The fraction of the rows that holds each of the most common values
+	vector<double> common_frequencies;
+	//! The boundaries of the buckets: bucket i holds the values in between bounds[i] and bounds[i + 1]. Either empty
+	//! or at least two values.
+	vector<Value> bounds;
+	//! The fraction of the rows that is summarized by the buckets
+	double bucket_fraction;
+	//! The amount of distinct values in the buckets
+	idx_t bucket_distinct_count;
+
+public:
+	//! Whether or not histograms can be built for columns of the given type
+	static bool IsSupported(const LogicalType &type);
+	//! Build the histogram of a column from the values of the sampled rows, returns nullptr if no rows were sampled
+	static unique_ptr<Histogram> Build(LogicalType type, vector<Value> &sample);
+
+	//! Estimate the fraction of the rows for which "[column] [comparison_type] [constant]" holds. Returns a negative
+	//! number if the histogram cannot estimate the comparison.
+	double EstimateSelectivity(ExpressionType comparison_type, const Value &constant) const;
+
+	//! Convert a numeric value to a double, returns false if the value is not numeric
+	static bool TryGetNumericValue(const Value &value, double &result);
+
+	void Serialize(Serializer &serializer);
+	static unique_ptr<Histogram> Deserialize(Deserializer &source, LogicalType type);
+
+	string ToString() const;
+
+private:
+	//! Estimate the fraction of the rows in the buckets that is smaller than the constant
+	double BucketFractionSmallerThan(const Value &constant) const;
+};
+
+} // namespace duckdb
@@ -36,6 +36,12 @@ public:
 		return wal.initialized ? &wal : nullptr;
 	}
 
+	//! Returns whether or not the WAL has grown beyond the checkpoint threshold
+	bool CheckpointIsRequired();
+	//! Checkpoint the database while it is running, and empty the WAL afterwards. The caller has to ensure that no
+	//! transaction commits while the checkpoint is created (see TransactionManager::Checkpoint).
+	void CreateCheckpoint();
+
 	DuckDB &GetDatabase() {
 		return database;
 	}
@@ -53,8 +59,8 @@ public:
 private:
 	//! Load the database from a directory
 	void LoadDatabase();
-	//! Create a checkpoint of the database
-	void Checkpoint(string wal_path);
+	//! Returns whether or not the WAL file at the given path is large enough to checkpoint the database on load
+	bool WALIsLarge(string &wal_path);
 
 	//! The path of the database
 	string path;
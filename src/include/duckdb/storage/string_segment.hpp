@@ -62,6 +62,15 @@ public:
 	unique_ptr<OverflowStringWriter> overflow_writer;
 	//! Map of block id to string block
 	unordered_map<block_id_t, StringBlock *> overflow_blocks;
+	//! The on-disk blocks holding the overflow strings of a persistent segment. The blocks stay registered for as long
+	//! as the segment exists, which prevents a checkpoint from handing them out again while they can still be read.
+	vector<shared_ptr<BlockHandle>> persistent_overflow_blocks;
+	//! Map of string to the offset of the string in the dictionary (if any), if set strings that occur multiple times
+	//! within the segment are stored in the dictionary only once
+	unique_ptr<unordered_map<string, int32_t>> dictionary_offsets;
+	//! Whether or not the segment was written with a deduplicated dictionary, in which case filters are evaluated once
+	//! per distinct dictionary entry rather than once per row
+	bool shared_dictionary;
 
 public:
 	void InitializeScan(ColumnScanState &state) override;
@@ -74,6 +83,7 @@ public:
 	//! in the process. Returns the amount of tuples appended. If this is less than `count`, the uncompressed segment is
 	//! full.
 	idx_t Append(SegmentStatistics &stats, Vector &data, idx_t offset, idx_t count) override;
+	void RevertAppend(idx_t start_tuple) override;
 
 	//! Rollback a previous update
 	void RollbackUpdate(UpdateInfo *info) override;
@@ -134,6 +144,11 @@ private:
 	//! The amount of bytes remaining to store in the block
 	idx_t RemainingSpace(BufferHandle &handle);
 
+	//! Select the rows of a vector that pass the filters by evaluating the filters once per dictionary entry
+	void SelectDictionary(ColumnScanState &state, Vector &result, data_ptr_t baseptr, int32_t *dict_offset,
+	                      SelectionVector &sel, idx_t &approved_tuple_count, vector<TableFilter> &tableFilter,
+	                      nullmask_t &source_nullmask);
+
 	void read_string(string_t *result_data, Vector &result, data_ptr_t baseptr, int32_t *dict_offset, idx_t src_idx,
 	                 idx_t res_idx, idx_t &update_idx, size_t vector_index);
 	template <class OP>
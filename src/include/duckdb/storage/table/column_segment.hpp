@@ -12,7 +12,9 @@
 #include "duckdb/storage/table/segment_tree.hpp"
 #include "duckdb/common/types.hpp"
 #include "duckdb/common/types/vector.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/data_pointer.hpp"
 #include "duckdb/storage/statistics/segment_statistics.hpp"
 
 namespace duckdb {
@@ -46,6 +48,16 @@ public:
 	//! The statistics for the segment
 	SegmentStatistics stats;
 
+private:
+	//! The lock for the checkpoint state of the segment
+	mutex checkpoint_lock;
+	//! The blocks of the last checkpoint (or of committed appends) that hold the data of this segment. These are marked
+	//! as modified and cleared as soon as the segment is modified: as long as they are unmodified, a checkpoint can
+	//! refer to them instead of rewriting the data of the segment.
+	vector<shared_ptr<CheckpointBlock>> checkpoint_blocks;
+	//! Whether or not the segment has been modified since the current checkpoint of the segment started
+	bool modified = true;
+
 public:
 	virtual void InitializeScan(ColumnScanState &state) = 0;
 	//! Scan one vector from this segment
@@ -67,6 +79,22 @@ public:
 	//! Perform an update within the segment
 	virtual void Update(ColumnData &column_data, Transaction &transaction, Vector &updates, row_t *ids,
 	                    idx_t count) = 0;
+	//! Returns whether or not the segment has updates that are still kept in version chains
+	virtual bool HasUpdates() = 0;
+
+	//! Returns the blocks of the last checkpoint that hold the data of this segment, or an empty list if the segment
+	//! has been modified since the last checkpoint
+	vector<shared_ptr<CheckpointBlock>> GetCheckpointBlocks();
+	//! Mark the start of a checkpoint that writes the data of this segment
+	void BeginCheckpoint();
+	//! Set the blocks that the data of the segment has been written to. These are only kept if the segment has not
+	//! been modified since BeginCheckpoint was called and has no outstanding updates, otherwise they are marked as
+	//! modified.
+	void SetCheckpointBlocks(vector<shared_ptr<CheckpointBlock>> blocks);
+	//! Add a block that holds the committed data of some of the rows of the segment
+	void AddCheckpointBlock(shared_ptr<CheckpointBlock> block);
+	//! Mark the segment as modified, this should be called after the data of the segment has been changed
+	void MarkAsModified();
 };
 
 } // namespace duckdb
@@ -48,6 +48,14 @@ public:
 
 	void RevertAppend(idx_t start);
 
+	//! Appends the rows of the morsel that are not visible to the given transaction to the result, as [start, end)
+	//! ranges of row ids: the rows that were deleted by transactions that committed before it started, and the rows
+	//! that were inserted by transactions that did not commit before it started
+	void GetCommittedDeletes(Transaction &transaction, vector<std::pair<idx_t, idx_t>> &result);
+	//! Mark count rows of the morsel, starting at morsel_start, as deleted before any transaction started. Used to
+	//! restore the deletes stored in a checkpoint.
+	void MarkAsDeleted(idx_t morsel_start, idx_t count);
+
 private:
 	ChunkInfo *GetChunkInfo(idx_t vector_idx);
 
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "duckdb/storage/table/column_segment.hpp"
+#include "duckdb/common/enums/compression_type.hpp"
 #include "duckdb/storage/block.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/storage/uncompressed_segment.hpp"
@@ -18,11 +19,12 @@ namespace duckdb {
 class PersistentSegment : public ColumnSegment {
 public:
 	PersistentSegment(BufferManager &manager, block_id_t id, idx_t offset, LogicalType type, idx_t start, idx_t count,
-	                  unique_ptr<BaseStatistics> statistics);
+	                  unique_ptr<BaseStatistics> statistics, CompressionType compression,
+	                  vector<block_id_t> overflow_blocks = vector<block_id_t>(), idx_t deleted_count = 0);
 
 	//! The buffer manager
 	BufferManager &manager;
-	//! The block id that this segment relates to
+	//! The block id that this segment relates to (INVALID_BLOCK if every row of the segment has been deleted)
 	block_id_t block_id;
 	//! The offset into the block
 	idx_t offset;
@@ -49,6 +51,8 @@ public:
 
 	//! Perform an update within the segment
 	void Update(ColumnData &column_data, Transaction &transaction, Vector &updates, row_t *ids, idx_t count) override;
+	//! Returns whether or not the segment has updates that are still kept in version chains
+	bool HasUpdates() override;
 };
 
 } // namespace duckdb
@@ -13,6 +13,7 @@
 
 namespace duckdb {
 class BaseStatistics;
+class Histogram;
 class PersistentSegment;
 
 class PersistentTableData {
@@ -21,7 +22,11 @@ public:
 	~PersistentTableData();
 
 	vector<unique_ptr<BaseStatistics>> column_stats;
+	//! The histograms of the columns that were collected by ANALYZE (nullptr for columns that were not analyzed)
+	vector<shared_ptr<Histogram>> column_histograms;
 	vector<vector<unique_ptr<PersistentSegment>>> table_data;
+	//! The rows of the table that were deleted when the checkpoint was written, as [start, end) ranges of row ids
+	vector<std::pair<idx_t, idx_t>> deletes;
 };
 
 } // namespace duckdb
@@ -43,6 +43,10 @@ struct ColumnScanState {
 	bool initialized = false;
 	//! If this segment has already been checked for skipping puorposes
 	bool segment_checked = false;
+	//! The id of the sequential scan this column scan belongs to (0 if it is not part of a sequential scan)
+	idx_t scan_id = 0;
+	//! The filter results of the dictionary entries of the current segment, keyed by dictionary offset (if any)
+	unordered_map<int32_t, bool> dictionary_filter_results;
 
 public:
 	//! Move on to the next vector in the scan
@@ -82,6 +86,9 @@ public:
 	unique_ptr<AdaptiveFilter> adaptive_filter;
 	LocalScanState local_state;
 	MorselInfo *version_info;
+	//! The amount of rows that were skipped because the zonemaps of their segments showed that no row passes the
+	//! filters
+	idx_t pruned_rows = 0;
 
 	//! Move to the next vector
 	void NextVector();
@@ -47,6 +47,8 @@ public:
 
 	//! Perform an update within the transient segment
 	void Update(ColumnData &column_data, Transaction &transaction, Vector &updates, row_t *ids, idx_t count) override;
+	//! Returns whether or not the segment has updates that are still kept in version chains
+	bool HasUpdates() override;
 
 	//! Initialize an append of this transient segment
 	void InitializeAppend(ColumnAppendState &state);
@@ -74,6 +74,8 @@ public:
 	//! in the process. Returns the amount of tuples appended. If this is less than `count`, the uncompressed segment is
 	//! full.
 	virtual idx_t Append(SegmentStatistics &stats, Vector &data, idx_t offset, idx_t count) = 0;
+	//! Revert an append, removing all tuples from the given tuple index onwards from the segment
+	virtual void RevertAppend(idx_t start_tuple);
 
 	//! Update a set of row identifiers to the specified set of updated values
 	void Update(ColumnData &data, SegmentStatistics &stats, Transaction &transaction, Vector &update, row_t *ids,
@@ -85,6 +87,9 @@ public:
 	//! on the segment
 	void CleanupUpdate(UpdateInfo *info);
 
+	//! Returns whether or not there are any updates in the version chains of the segment
+	bool HasUpdates();
+
 	//! Convert a persistently backed uncompressed segment (i.e. one where block_id refers to an on-disk block) to a
 	//! temporary in-memory one
 	virtual void ToTemporary();
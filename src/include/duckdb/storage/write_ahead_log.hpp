@@ -9,11 +9,15 @@
 #pragma once
 
 #include "duckdb/common/helper.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/common/types/data_chunk.hpp"
 #include "duckdb/common/enums/wal_type.hpp"
 #include "duckdb/common/serializer/buffered_file_writer.hpp"
 #include "duckdb/catalog/catalog_entry/sequence_catalog_entry.hpp"
 
+#include <atomic>
+#include <condition_variable>
+
 namespace duckdb {
 
 struct AlterInfo;
@@ -28,6 +32,7 @@ class ViewCatalogEntry;
 class TableCatalogEntry;
 class Transaction;
 class TransactionManager;
+struct AppendBlocks;
 
 //! The WriteAheadLog (WAL) is a log that is used to provide durability. Prior
 //! to committing a transaction it writes the changes the transaction made to
@@ -71,6 +76,8 @@ public:
 	void WriteAlter(AlterInfo &info);
 
 	void WriteInsert(DataChunk &chunk);
+	//! Write an insert of rows that have already been written to the given blocks
+	void WriteInsertBlocks(AppendBlocks &blocks);
 	void WriteDelete(DataChunk &chunk);
 	void WriteUpdate(DataChunk &chunk, column_t col_idx);
 
@@ -78,9 +85,38 @@ public:
 	void Truncate(int64_t size);
 	void Flush();
 
+	//! Write the end of a commit to the WAL file without syncing the file. Returns the sequence number of the commit,
+	//! which is passed to SyncCommit.
+	idx_t WriteCommit();
+	//! Wait until the WAL has been synced to disk up to and including the commit with the given sequence number. One
+	//! of the waiting committers syncs the WAL for every commit that has been written up to that point, so concurrent
+	//! commits share a single sync (group commit). The syncing committer first waits for commit_delay microseconds,
+	//! giving other commits the chance to join the sync. Once a sync has failed, every later call fails as well: it is
+	//! unknown which of the written commits have reached the disk.
+	void SyncCommit(idx_t commit_sequence, idx_t commit_delay);
+	//! The amount of times SyncCommit has synced the WAL to disk
+	idx_t GetSyncCount() {
+		return sync_count;
+	}
+
 private:
 	DuckDB &database;
 	unique_ptr<BufferedFileWriter> writer;
+
+	//! The sequence number of the last commit that has been written to the WAL file
+	std::atomic<idx_t> written_sequence;
+	//! The lock for the sync state
+	mutex sync_lock;
+	//! Signals the committers that are waiting for a sync to finish
+	std::condition_variable sync_finished;
+	//! Whether or not a committer is currently syncing the WAL
+	bool sync_in_progress;
+	//! The sequence number up to which all commits have been synced to disk
+	idx_t synced_sequence;
+	//! The error of the sync that failed (if any)
+	string sync_error;
+	//! The amount of syncs performed by SyncCommit
+	std::atomic<idx_t> sync_count;
 };
 
 } // namespace duckdb
@@ -9,14 +9,28 @@
 #pragma once
 
 #include "duckdb/common/constants.hpp"
+#include "duckdb/common/vector.hpp"
 
 namespace duckdb {
 class DataTable;
+struct CheckpointBlock;
+
+//! The blocks that the rows of one or more consecutive appends have been written to before the transaction committed
+struct AppendBlocks {
+	//! The first row of the blocks
+	idx_t start_row;
+	//! The amount of rows of the blocks
+	idx_t count;
+	//! The blocks of every column of the table
+	vector<vector<shared_ptr<CheckpointBlock>>> columns;
+};
 
 struct AppendInfo {
 	DataTable *table;
 	idx_t start_row;
 	idx_t count;
+	//! The blocks that the appended rows have been written to, or nullptr if the rows are written to the WAL
+	AppendBlocks *blocks;
 };
 
 } // namespace duckdb
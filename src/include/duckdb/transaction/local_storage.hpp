@@ -62,6 +62,8 @@ public:
 	//! Update a set of rows in the local storage
 	void Update(DataTable *table, Vector &row_ids, vector<column_t> &column_ids, DataChunk &data);
 
+	//! Move the transaction-local rows of the table (if any) into the table
+	void Flush(DataTable *table);
 	//! Commits the local storage, writing it to the WAL and completing the commit
 	void Commit(LocalStorage::CommitState &commit_state, Transaction &transaction, WriteAheadLog *log,
 	            transaction_t commit_id);
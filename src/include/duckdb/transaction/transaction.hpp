@@ -11,6 +11,8 @@
 #include "duckdb/catalog/catalog_entry/sequence_catalog_entry.hpp"
 #include "duckdb/common/types/data_chunk.hpp"
 #include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/storage_info.hpp"
+#include "duckdb/transaction/append_info.hpp"
 #include "duckdb/transaction/undo_buffer.hpp"
 #include "duckdb/transaction/local_storage.hpp"
 
@@ -20,9 +22,12 @@ class SequenceCatalogEntry;
 class ClientContext;
 class CatalogEntry;
 class DataTable;
+class StorageManager;
 class WriteAheadLog;
 
+class BlockManager;
 class ChunkVectorInfo;
+class Histogram;
 
 struct DeleteInfo;
 struct UpdateInfo;
@@ -32,9 +37,14 @@ struct UpdateInfo;
 
 class Transaction {
 public:
+	//! The estimated size of the appended rows that are written to blocks at once before the transaction commits
+	const static idx_t APPEND_WRITE_SIZE = 64 * Storage::BLOCK_SIZE;
+
 	Transaction(transaction_t start_time, transaction_t transaction_id, timestamp_t start_timestamp)
 	    : start_time(start_time), transaction_id(transaction_id), commit_id(0), highest_active_query(0),
-	      active_query(MAXIMUM_QUERY_ID), start_timestamp(start_timestamp), storage(*this), is_invalidated(false) {
+	      active_query(MAXIMUM_QUERY_ID), start_timestamp(start_timestamp), wal_sequence(0), storage(*this),
+	      is_invalidated(false), requires_checkpoint(false), optimistic_append_size(0),
+	      unwritten_append_size(0) {
 	}
 
 	//! The start timestamp of this transaction
@@ -50,12 +60,22 @@ public:
 	transaction_t active_query;
 	//! The timestamp when the transaction started
 	timestamp_t start_timestamp;
+	//! The sequence number of the commit of the transaction in the WAL, or 0 if the commit did not write to the WAL
+	idx_t wal_sequence;
 	//! The set of uncommitted appends for the transaction
 	LocalStorage storage;
 	//! Map of all sequences that were used during the transaction and the value they had in this transaction
 	unordered_map<SequenceCatalogEntry *, SequenceValue> sequence_usage;
 	//! Whether or not the transaction has been invalidated
 	bool is_invalidated;
+	//! Whether or not the transaction changed state that is not written to the WAL (e.g. the histograms collected by
+	//! ANALYZE), and that has to be persisted by a checkpoint when the transaction commits
+	bool requires_checkpoint;
+	//! The estimated size of the rows that were appended to persistent tables before the transaction committed. Large
+	//! appends are written to new blocks before the transaction commits, instead of being written to the WAL.
+	idx_t optimistic_append_size;
+	//! The estimated size of the appended rows that have not been written to blocks yet
+	idx_t unwritten_append_size;
 
 public:
 	static Transaction &GetTransaction(ClientContext &context);
@@ -63,7 +83,8 @@ public:
 	void PushCatalogEntry(CatalogEntry *entry, data_ptr_t extra_data = nullptr, idx_t extra_data_size = 0);
 
 	//! Commit the current transaction with the given commit identifier. Returns an error message if the transaction
-	//! commit failed, or an empty string if the commit was sucessful
+	//! commit failed, or an empty string if the commit was sucessful. The changes are written to the WAL without
+	//! syncing it: the commit is only durable after WriteAheadLog::SyncCommit has been called for its wal_sequence.
 	string Commit(WriteAheadLog *log, transaction_t commit_id) noexcept;
 	//! Rollback
 	void Rollback() noexcept {
@@ -82,10 +103,38 @@ public:
 	void PushAppend(DataTable *table, idx_t row_start, idx_t row_count);
 	UpdateInfo *CreateUpdateInfo(idx_t type_size, idx_t entries);
 
+	//! Write the rows that the transaction appended to persistent tables to new blocks, and sync them to disk. When the
+	//! transaction commits, only references to these blocks are written to the WAL.
+	void WriteOptimisticAppends(StorageManager &storage_manager);
+	//! Write the appends that have not been written to blocks yet to new blocks, without syncing them. The caller has
+	//! to keep checkpoints from running while the blocks are handed out.
+	void WriteAppendBlocks(StorageManager &storage_manager);
+	//! Whether or not any appends have been written to blocks
+	bool HasAppendBlocks() {
+		return !append_blocks.empty();
+	}
+	//! Release the blocks that the appends have been written to after the transaction finished. If the transaction
+	//! rolled back, the blocks are freed.
+	void ReleaseAppendBlocks(BlockManager &block_manager, bool free);
+	//! Set the histogram of a column when the transaction commits. Histograms are not versioned: once installed, they
+	//! are used by every transaction.
+	void PushHistogram(shared_ptr<DataTable> table, column_t column, shared_ptr<Histogram> histogram);
+
 private:
 	//! The undo buffer is used to store old versions of rows that are updated
 	//! or deleted
 	UndoBuffer undo_buffer;
+	//! The appends to persistent tables that were made before the transaction committed
+	vector<AppendInfo *> optimistic_appends;
+	//! The blocks that the optimistic appends have been written to
+	vector<unique_ptr<AppendBlocks>> append_blocks;
+	//! The histograms that are set when the transaction commits
+	struct PendingHistogram {
+		shared_ptr<DataTable> table;
+		column_t column;
+		shared_ptr<Histogram> histogram;
+	};
+	vector<PendingHistogram> histograms;
 
 	Transaction(const Transaction &) = delete;
 };
@@ -12,12 +12,14 @@
 #include "duckdb/common/common.hpp"
 #include "duckdb/common/mutex.hpp"
 #include "duckdb/common/vector.hpp"
+#include "duckdb/storage/storage_lock.hpp"
 
 #include <atomic>
 
 namespace duckdb {
 
 class ClientContext;
+class DataTable;
 class StorageManager;
 class Transaction;
 
@@ -41,6 +43,14 @@ public:
 	string CommitTransaction(Transaction *transaction);
 	//! Rollback the given transaction
 	void RollbackTransaction(Transaction *transaction);
+	//! Append the transaction-local rows of the table to the table itself before the transaction commits. If the
+	//! transaction has appended too many rows to write them to the WAL, they are written to new blocks as well.
+	void FlushLocalStorage(Transaction &transaction, DataTable &table);
+	//! Checkpoint the database. Transactions can keep on running while the checkpoint is written, but they cannot
+	//! commit until it has finished. If force is false, the checkpoint is only written if the WAL has grown too large.
+	//! No checkpoint is written while active transactions have appended rows that they have not committed yet: if
+	//! force is true, an exception is thrown instead.
+	void Checkpoint(bool force = true);
 	//! Add the catalog set
 	void AddCatalogSet(ClientContext &context, unique_ptr<CatalogSet> catalog_set);
 
@@ -51,6 +61,10 @@ public:
 private:
 	//! Remove the given transaction from the list of active transactions
 	void RemoveTransaction(Transaction *transaction) noexcept;
+	//! Clean up the committed transactions that are no longer needed by any running or future transaction
+	void GarbageCollect() noexcept;
+	//! Whether or not any active transaction has appended rows to persistent tables that it has not committed yet
+	bool HasOptimisticAppends();
 
 	//! The current query number
 	std::atomic<transaction_t> current_query_number;
@@ -58,6 +72,12 @@ private:
 	transaction_t current_start_timestamp;
 	//! The current transaction ID used by transactions
 	transaction_t current_transaction_id;
+	//! The commit ids of the committed transactions of which the WAL entries have not been synced yet, in order. New
+	//! transactions start before the first of these commits, so a commit only becomes visible once it is durable.
+	vector<transaction_t> unsynced_commits;
+	//! The error of a WAL sync that failed (if any). The commits that were not synced remain invisible, and no further
+	//! transactions can commit.
+	string sync_error;
 	//! Set of currently running transactions
 	vector<unique_ptr<Transaction>> active_transactions;
 	//! Set of recently committed transactions
@@ -68,6 +88,9 @@ private:
 	vector<StoredCatalogSet> old_catalog_sets;
 	//! The lock used for transaction operations
 	mutex transaction_lock;
+	//! The lock held while committing (shared) or checkpointing (exclusive): the WAL is emptied after a checkpoint, so
+	//! no transaction can commit while a checkpoint is being written
+	StorageLock checkpoint_lock;
 	//! The storage manager
 	StorageManager &storage;
 };
@@ -43,7 +43,7 @@ struct UpdateInfo {
 	//! transaction in-order of newest to oldest
 	template <class T> static void UpdatesForTransaction(UpdateInfo *current, Transaction &transaction, T &&callback) {
 		while (current) {
-			if (current->version_number > transaction.start_time &&
+			if (current->version_number >= transaction.start_time &&
 			    current->version_number != transaction.transaction_id) {
 				// these tuples were either committed AFTER this transaction started or are not committed yet, use
 				// tuples stored in this version
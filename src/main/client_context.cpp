@@ -65,6 +65,14 @@ void ClientContext::Cleanup() {
 	CleanupInternal();
 }
 
+void ClientContext::CloseResult() {
+	lock_guard<mutex> client_guard(context_lock);
+	if (is_invalidated) {
+		return;
+	}
+	CleanupInternal();
+}
+
 void ClientContext::RegisterAppender(Appender *appender) {
 	lock_guard<mutex> client_guard(context_lock);
 	if (is_invalidated) {
@@ -46,6 +46,7 @@ DuckDB::DuckDB(const char *path, DBConfig *new_config) {
 	scheduler = make_unique<TaskScheduler>();
 	connection_manager = make_unique<ConnectionManager>();
 	object_cache = make_unique<ObjectCache>();
+	scheduler->SetThreads(config.maximum_threads);
 
 	// initialize the database
 	storage->Initialize();
@@ -77,8 +78,9 @@ void DuckDB::Configure(DBConfig &new_config) {
 	} else {
 		config.maximum_memory = new_config.maximum_memory;
 	}
-	config.checkpoint_only = new_config.checkpoint_only;
 	config.checkpoint_wal_size = new_config.checkpoint_wal_size;
+	config.commit_delay = new_config.commit_delay;
+	config.maximum_threads = new_config.maximum_threads;
 	config.use_direct_io = new_config.use_direct_io;
 	config.maximum_memory = new_config.maximum_memory;
 	config.temporary_directory = new_config.temporary_directory;
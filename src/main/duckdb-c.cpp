@@ -1,3 +1,4 @@
+#include "duckdb/common/arrow.hpp"
 #include "duckdb/common/types/date.hpp"
 #include "duckdb/common/types/time.hpp"
 #include "duckdb/common/types/timestamp.hpp"
@@ -16,6 +17,9 @@ using namespace duckdb;
 
 static duckdb_type ConvertCPPTypeToC(LogicalType type);
 static idx_t GetCTypeSize(duckdb_type type);
+static duckdb_date ConvertDateToC(date_t date);
+static duckdb_time ConvertTimeToC(dtime_t time);
+static duckdb_timestamp ConvertTimestampToC(timestamp_t timestamp);
 namespace duckdb {
 struct DatabaseData {
 	DatabaseData() : database(nullptr) {
@@ -178,11 +182,7 @@ static duckdb_state duckdb_translate_result(MaterializedQueryResult *result, duc
 				auto source = FlatVector::GetData<date_t>(chunk->data[col]);
 				for (idx_t k = 0; k < chunk->size(); k++) {
 					if (!FlatVector::IsNull(chunk->data[col], k)) {
-						int32_t year, month, day;
-						Date::Convert(source[k], year, month, day);
-						target[row].year = year;
-						target[row].month = month;
-						target[row].day = day;
+						target[row] = ConvertDateToC(source[k]);
 					}
 					row++;
 				}
@@ -196,12 +196,7 @@ static duckdb_state duckdb_translate_result(MaterializedQueryResult *result, duc
 				auto source = FlatVector::GetData<dtime_t>(chunk->data[col]);
 				for (idx_t k = 0; k < chunk->size(); k++) {
 					if (!FlatVector::IsNull(chunk->data[col], k)) {
-						int32_t hour, min, sec, msec;
-						Time::Convert(source[k], hour, min, sec, msec);
-						target[row].hour = hour;
-						target[row].min = min;
-						target[row].sec = sec;
-						target[row].msec = msec;
+						target[row] = ConvertTimeToC(source[k]);
 					}
 					row++;
 				}
@@ -215,23 +210,7 @@ static duckdb_state duckdb_translate_result(MaterializedQueryResult *result, duc
 				auto source = FlatVector::GetData<timestamp_t>(chunk->data[col]);
 				for (idx_t k = 0; k < chunk->size(); k++) {
 					if (!FlatVector::IsNull(chunk->data[col], k)) {
-						date_t date;
-						dtime_t time;
-						Timestamp::Convert(source[k], date, time);
-
-						int32_t year, month, day;
-						Date::Convert(date, year, month, day);
-
-						int32_t hour, min, sec, msec;
-						Time::Convert(time, hour, min, sec, msec);
-
-						target[row].date.year = year;
-						target[row].date.month = month;
-						target[row].date.day = day;
-						target[row].time.hour = hour;
-						target[row].time.min = min;
-						target[row].time.sec = sec;
-						target[row].time.msec = msec;
+						target[row] = ConvertTimestampToC(source[k]);
 					}
 					row++;
 				}
@@ -421,6 +400,271 @@ void duckdb_destroy_prepare(duckdb_prepared_statement *prepared_statement) {
 	*prepared_statement = nullptr;
 }
 
+namespace duckdb {
+struct StreamResultWrapper {
+	unique_ptr<QueryResult> result;
+	//! The C types of the columns
+	vector<duckdb_type> types;
+	//! The chunk that was fetched last, the data of the last duckdb_chunk refers to it
+	unique_ptr<DataChunk> chunk;
+	//! The columns of the last duckdb_chunk
+	vector<duckdb_column_data> columns;
+	//! For every column, the null mask of the last duckdb_chunk
+	vector<unique_ptr<bool[]>> nullmasks;
+	//! For every column whose C representation differs from its representation in a DataChunk, the buffer its data is
+	//! converted into
+	vector<unique_ptr<data_t[]>> buffers;
+	//! The error of a fetch that failed after the query succeeded (e.g. because a column type is not supported)
+	string error;
+};
+} // namespace duckdb
+
+static duckdb_state duckdb_translate_stream_result(unique_ptr<QueryResult> result, duckdb_stream_result *out) {
+	if (!out) {
+		return DuckDBError;
+	}
+	auto wrapper = new StreamResultWrapper();
+	wrapper->result = move(result);
+	*out = (duckdb_stream_result)wrapper;
+	if (!wrapper->result->success) {
+		return DuckDBError;
+	}
+	auto column_count = wrapper->result->types.size();
+	wrapper->columns.resize(column_count);
+	wrapper->nullmasks.resize(column_count);
+	wrapper->buffers.resize(column_count);
+	for (idx_t col = 0; col < column_count; col++) {
+		auto type = ConvertCPPTypeToC(wrapper->result->types[col]);
+		wrapper->types.push_back(type);
+		wrapper->nullmasks[col] = unique_ptr<bool[]>(new bool[STANDARD_VECTOR_SIZE]);
+		switch (type) {
+		case DUCKDB_TYPE_DATE:
+		case DUCKDB_TYPE_TIME:
+		case DUCKDB_TYPE_TIMESTAMP:
+			wrapper->buffers[col] = unique_ptr<data_t[]>(new data_t[GetCTypeSize(type) * STANDARD_VECTOR_SIZE]);
+			break;
+		case DUCKDB_TYPE_VARCHAR:
+			wrapper->buffers[col] = unique_ptr<data_t[]>(new data_t[sizeof(duckdb_string) * STANDARD_VECTOR_SIZE]);
+			break;
+		default:
+			break;
+		}
+	}
+	return DuckDBSuccess;
+}
+
+duckdb_state duckdb_query_stream(duckdb_connection connection, const char *query, duckdb_stream_result *out_result) {
+	if (!connection || !query) {
+		return DuckDBError;
+	}
+	Connection *conn = (Connection *)connection;
+	return duckdb_translate_stream_result(conn->SendQuery(query), out_result);
+}
+
+duckdb_state duckdb_execute_prepared_stream(duckdb_prepared_statement prepared_statement,
+                                            duckdb_stream_result *out_result) {
+	auto wrapper = (PreparedStatementWrapper *)prepared_statement;
+	if (!wrapper || !wrapper->statement || !wrapper->statement->success || wrapper->statement->is_invalidated) {
+		return DuckDBError;
+	}
+	return duckdb_translate_stream_result(wrapper->statement->Execute(wrapper->values, true), out_result);
+}
+
+const char *duckdb_stream_error(duckdb_stream_result result) {
+	auto wrapper = (StreamResultWrapper *)result;
+	if (!wrapper) {
+		return NULL;
+	}
+	if (!wrapper->result->success) {
+		return wrapper->result->error.c_str();
+	}
+	return wrapper->error.empty() ? NULL : wrapper->error.c_str();
+}
+
+idx_t duckdb_stream_column_count(duckdb_stream_result result) {
+	auto wrapper = (StreamResultWrapper *)result;
+	if (!wrapper) {
+		return 0;
+	}
+	return wrapper->types.size();
+}
+
+const char *duckdb_stream_column_name(duckdb_stream_result result, idx_t col) {
+	auto wrapper = (StreamResultWrapper *)result;
+	if (!wrapper || col >= wrapper->types.size()) {
+		return NULL;
+	}
+	return wrapper->result->names[col].c_str();
+}
+
+duckdb_type duckdb_stream_column_type(duckdb_stream_result result, idx_t col) {
+	auto wrapper = (StreamResultWrapper *)result;
+	if (!wrapper || col >= wrapper->types.size()) {
+		return DUCKDB_TYPE_INVALID;
+	}
+	return wrapper->types[col];
+}
+
+//! Fetches the next chunk of the result into the wrapper, returns false if the fetch failed
+static bool duckdb_stream_fetch(StreamResultWrapper &wrapper) {
+	wrapper.chunk.reset();
+	if (!wrapper.result->success) {
+		return false;
+	}
+	wrapper.chunk = wrapper.result->Fetch();
+	if (!wrapper.chunk) {
+		// the result has either been exhausted or the fetch failed
+		return wrapper.result->success;
+	}
+	wrapper.chunk->Normalify();
+	return true;
+}
+
+duckdb_state duckdb_stream_fetch_chunk(duckdb_stream_result result, duckdb_chunk *out_chunk) {
+	auto wrapper = (StreamResultWrapper *)result;
+	if (!wrapper || !out_chunk) {
+		return DuckDBError;
+	}
+	out_chunk->column_count = wrapper->types.size();
+	out_chunk->row_count = 0;
+	out_chunk->columns = wrapper->columns.data();
+	if (!duckdb_stream_fetch(*wrapper)) {
+		return DuckDBError;
+	}
+	if (!wrapper->chunk) {
+		return DuckDBSuccess;
+	}
+	auto &chunk = *wrapper->chunk;
+	for (idx_t col = 0; col < chunk.ColumnCount(); col++) {
+		auto &vector = chunk.data[col];
+		auto &nullmask = FlatVector::Nullmask(vector);
+		auto &column = wrapper->columns[col];
+		column.nullmask = wrapper->nullmasks[col].get();
+		for (idx_t k = 0; k < chunk.size(); k++) {
+			column.nullmask[k] = nullmask[k];
+		}
+		switch (wrapper->types[col]) {
+		case DUCKDB_TYPE_BOOLEAN:
+		case DUCKDB_TYPE_TINYINT:
+		case DUCKDB_TYPE_SMALLINT:
+		case DUCKDB_TYPE_INTEGER:
+		case DUCKDB_TYPE_BIGINT:
+		case DUCKDB_TYPE_HUGEINT:
+		case DUCKDB_TYPE_FLOAT:
+		case DUCKDB_TYPE_DOUBLE:
+		case DUCKDB_TYPE_INTERVAL:
+			// the C representation is the same as the representation in the vector: refer to the vector directly
+			column.data = FlatVector::GetData(vector);
+			break;
+		case DUCKDB_TYPE_VARCHAR: {
+			// the strings are not copied, only their pointers and lengths are written
+			auto source = FlatVector::GetData<string_t>(vector);
+			auto target = (duckdb_string *)wrapper->buffers[col].get();
+			for (idx_t k = 0; k < chunk.size(); k++) {
+				if (nullmask[k]) {
+					target[k].data = nullptr;
+					target[k].size = 0;
+				} else {
+					target[k].data = source[k].GetDataUnsafe();
+					target[k].size = source[k].GetSize();
+				}
+			}
+			column.data = target;
+			break;
+		}
+		case DUCKDB_TYPE_DATE: {
+			auto source = FlatVector::GetData<date_t>(vector);
+			auto target = (duckdb_date *)wrapper->buffers[col].get();
+			for (idx_t k = 0; k < chunk.size(); k++) {
+				if (!nullmask[k]) {
+					target[k] = ConvertDateToC(source[k]);
+				}
+			}
+			column.data = target;
+			break;
+		}
+		case DUCKDB_TYPE_TIME: {
+			auto source = FlatVector::GetData<dtime_t>(vector);
+			auto target = (duckdb_time *)wrapper->buffers[col].get();
+			for (idx_t k = 0; k < chunk.size(); k++) {
+				if (!nullmask[k]) {
+					target[k] = ConvertTimeToC(source[k]);
+				}
+			}
+			column.data = target;
+			break;
+		}
+		case DUCKDB_TYPE_TIMESTAMP: {
+			auto source = FlatVector::GetData<timestamp_t>(vector);
+			auto target = (duckdb_timestamp *)wrapper->buffers[col].get();
+			for (idx_t k = 0; k < chunk.size(); k++) {
+				if (!nullmask[k]) {
+					target[k] = ConvertTimestampToC(source[k]);
+				}
+			}
+			column.data = target;
+			break;
+		}
+		default:
+			// unsupported type for C API
+			wrapper->error = "Unsupported type for the C API: " + wrapper->result->types[col].ToString();
+			return DuckDBError;
+		}
+	}
+	out_chunk->row_count = chunk.size();
+	return DuckDBSuccess;
+}
+
+duckdb_state duckdb_stream_arrow_schema(duckdb_stream_result result, ArrowSchema *out_schema) {
+	auto wrapper = (StreamResultWrapper *)result;
+	if (!wrapper || !out_schema || !wrapper->result->success) {
+		return DuckDBError;
+	}
+	try {
+		wrapper->result->ToArrowSchema(out_schema);
+	} catch (...) {
+		return DuckDBError;
+	}
+	return DuckDBSuccess;
+}
+
+duckdb_state duckdb_stream_fetch_arrow_array(duckdb_stream_result result, ArrowArray *out_array) {
+	auto wrapper = (StreamResultWrapper *)result;
+	if (!wrapper || !out_array) {
+		return DuckDBError;
+	}
+	out_array->release = nullptr;
+	if (!duckdb_stream_fetch(*wrapper)) {
+		return DuckDBError;
+	}
+	if (!wrapper->chunk || wrapper->chunk->size() == 0) {
+		// the result has been exhausted: the released array marks the end of the stream
+		return DuckDBSuccess;
+	}
+	try {
+		// the array holds a reference to the buffers of the vectors, so their data is not copied
+		wrapper->chunk->ToArrowArray(out_array);
+	} catch (...) {
+		if (out_array->release) {
+			out_array->release(out_array);
+			out_array->release = nullptr;
+		}
+		return DuckDBError;
+	}
+	return DuckDBSuccess;
+}
+
+void duckdb_destroy_stream_result(duckdb_stream_result *result) {
+	if (!result) {
+		return;
+	}
+	auto wrapper = (StreamResultWrapper *)*result;
+	if (wrapper) {
+		delete wrapper;
+	}
+	*result = nullptr;
+}
+
 duckdb_type ConvertCPPTypeToC(LogicalType sql_type) {
 	switch (sql_type.id()) {
 	case LogicalTypeId::BOOLEAN:
@@ -489,6 +733,40 @@ idx_t GetCTypeSize(duckdb_type type) {
 	}
 }
 
+duckdb_date ConvertDateToC(date_t date) {
+	int32_t year, month, day;
+	Date::Convert(date, year, month, day);
+
+	duckdb_date result;
+	result.year = year;
+	result.month = month;
+	result.day = day;
+	return result;
+}
+
+duckdb_time ConvertTimeToC(dtime_t time) {
+	int32_t hour, min, sec, msec;
+	Time::Convert(time, hour, min, sec, msec);
+
+	duckdb_time result;
+	result.hour = hour;
+	result.min = min;
+	result.sec = sec;
+	result.msec = msec;
+	return result;
+}
+
+duckdb_timestamp ConvertTimestampToC(timestamp_t timestamp) {
+	date_t date;
+	dtime_t time;
+	Timestamp::Convert(timestamp, date, time);
+
+	duckdb_timestamp result;
+	result.date = ConvertDateToC(date);
+	result.time = ConvertTimeToC(time);
+	return result;
+}
+
 template <class T> T UnsafeFetch(duckdb_result *result, idx_t col, idx_t row) {
 	D_ASSERT(row < result->row_count);
 	return ((T *)result->columns[col].data)[row];
@@ -29,6 +29,7 @@ void QueryProfiler::StartQuery(string query, SQLStatement &statement) {
 	root = nullptr;
 	phase_timings.clear();
 	phase_stack.clear();
+	pruned_rows = 0;
 
 	main_query.Start();
 }
@@ -42,6 +43,7 @@ bool QueryProfiler::OperatorRequiresProfiling(PhysicalOperatorType op_type) {
 	case PhysicalOperatorType::TOP_N:
 	case PhysicalOperatorType::AGGREGATE:
 	case PhysicalOperatorType::WINDOW:
+	case PhysicalOperatorType::STREAMING_WINDOW:
 	case PhysicalOperatorType::UNNEST:
 	case PhysicalOperatorType::SIMPLE_AGGREGATE:
 	case PhysicalOperatorType::HASH_GROUP_BY:
@@ -229,6 +231,13 @@ void QueryProfiler::Flush(OperatorProfiler &profiler) {
 	}
 }
 
+void QueryProfiler::AddPrunedRows(idx_t count) {
+	if (!enabled || !running) {
+		return;
+	}
+	pruned_rows += count;
+}
+
 static string DrawPadded(string str, idx_t width) {
 	if (str.size() > width) {
 		return str.substr(0, width);
@@ -293,6 +302,10 @@ void QueryProfiler::ToStream(std::ostream &ss, bool print_optimizer_output) cons
 	ss << "│┌───────────────────────────────────┐│\n";
 	string total_time = "Total Time: " + RenderTiming(main_query.Elapsed());
 	ss << "││" + DrawPadded(total_time, TOTAL_BOX_WIDTH - 4) + "││\n";
+	if (pruned_rows > 0) {
+		string pruned = "Pruned Rows: " + to_string(pruned_rows);
+		ss << "││" + DrawPadded(pruned, TOTAL_BOX_WIDTH - 4) + "││\n";
+	}
 	ss << "│└───────────────────────────────────┘│\n";
 	ss << "└─────────────────────────────────────┘\n";
 	// print phase timings
@@ -367,6 +380,7 @@ string QueryProfiler::ToJSON() const {
 	std::stringstream ss;
 	ss << "{\n";
 	ss << "   \"result\": " + to_string(main_query.Elapsed()) + ",\n";
+	ss << "   \"pruned_rows\": " + to_string(pruned_rows) + ",\n";
 	// print the phase timings
 	ss << "   \"timings\": {\n";
 	const auto &ordered_phase_timings = GetOrderedPhaseTimings();
@@ -1,8 +1,10 @@
 #include "duckdb/optimizer/join_order_optimizer.hpp"
 
+#include "duckdb/common/limits.hpp"
 #include "duckdb/planner/expression/list.hpp"
 #include "duckdb/planner/expression_iterator.hpp"
 #include "duckdb/planner/operator/list.hpp"
+#include "duckdb/storage/statistics/numeric_statistics.hpp"
 
 #include <algorithm>
 
@@ -188,8 +190,163 @@ static void UpdateExclusionSet(JoinRelationSet *node, unordered_set<idx_t> &excl
 	}
 }
 
-//! Create a new JoinTree node by joining together two previous JoinTree nodes
-static unique_ptr<JoinNode> CreateJoinTree(JoinRelationSet *set, NeighborInfo *info, JoinNode *left, JoinNode *right) {
+//! The selectivity of a filter that can not be estimated from the statistics
+static constexpr const double DEFAULT_SELECTIVITY = 0.2;
+
+static idx_t ConvertCardinality(double cardinality) {
+	if (cardinality >= double(NumericLimits<idx_t>::Maximum())) {
+		return NumericLimits<idx_t>::Maximum();
+	}
+	return idx_t(cardinality);
+}
+
+//! Returns the table scan of a relation, or nullptr if the relation is not a (filtered) table scan
+static LogicalGet *GetRelationScan(SingleJoinRelation &relation) {
+	auto op = relation.op;
+	while (op->children.size() == 1 && op->type != LogicalOperatorType::LOGICAL_PROJECTION) {
+		op = op->children[0].get();
+	}
+	return op->type == LogicalOperatorType::LOGICAL_GET ? (LogicalGet *)op : nullptr;
+}
+
+unique_ptr<BaseStatistics> JoinOrderOptimizer::GetColumnStatistics(Expression &expression) {
+	if (expression.type != ExpressionType::BOUND_COLUMN_REF) {
+		return nullptr;
+	}
+	auto &colref = (BoundColumnRefExpression &)expression;
+	auto entry = relation_mapping.find(colref.binding.table_index);
+	if (entry == relation_mapping.end()) {
+		return nullptr;
+	}
+	auto get = GetRelationScan(*relations[entry->second]);
+	if (!get || get->table_index != colref.binding.table_index || !get->function.statistics) {
+		return nullptr;
+	}
+	D_ASSERT(colref.binding.column_index < get->column_ids.size());
+	return get->function.statistics(context, get->bind_data.get(), get->column_ids[colref.binding.column_index]);
+}
+
+//! Estimate the selectivity of the comparison [column] [comparison_type] [constant] from the statistics of the column
+static double EstimateComparisonSelectivity(BaseStatistics &stats, ExpressionType comparison_type,
+                                            const Value &constant) {
+	if (stats.histogram) {
+		// the histogram collected by ANALYZE also describes skewed distributions
+		auto selectivity = stats.histogram->EstimateSelectivity(comparison_type, constant);
+		if (selectivity >= 0) {
+			return selectivity;
+		}
+	}
+	// the min and max of the column: we assume the values are spread uniformly in between them
+	double min, max, value;
+	bool has_range = false;
+	if (TypeIsNumeric(stats.type.InternalType()) && stats.type == constant.type()) {
+		auto &nstats = (NumericStatistics &)stats;
+		has_range = Histogram::TryGetNumericValue(nstats.min, min) && Histogram::TryGetNumericValue(nstats.max, max) &&
+		            Histogram::TryGetNumericValue(constant, value) && min <= max;
+	}
+	auto distinct_count = stats.GetDistinctCount();
+	bool has_distinct_count = distinct_count != INVALID_INDEX && distinct_count > 0;
+	switch (comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+		if (has_range && (value < min || value > max)) {
+			return 0;
+		}
+		return has_distinct_count ? 1.0 / distinct_count : DEFAULT_SELECTIVITY;
+	case ExpressionType::COMPARE_NOTEQUAL:
+		return has_distinct_count ? 1.0 - 1.0 / distinct_count : 1.0 - DEFAULT_SELECTIVITY;
+	case ExpressionType::COMPARE_LESSTHAN:
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+		if (!has_range) {
+			return DEFAULT_SELECTIVITY;
+		}
+		bool is_smaller = comparison_type == ExpressionType::COMPARE_LESSTHAN ||
+		                  comparison_type == ExpressionType::COMPARE_LESSTHANOREQUALTO;
+		if (max == min) {
+			// all values are the same
+			bool inclusive = comparison_type == ExpressionType::COMPARE_LESSTHANOREQUALTO ||
+			                 comparison_type == ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+			if (value == min) {
+				return inclusive ? 1 : 0;
+			}
+			return (is_smaller ? value > min : value < min) ? 1 : 0;
+		}
+		// the fraction of the values that is smaller than the constant
+		double smaller = MinValue<double>(MaxValue<double>((value - min) / (max - min), 0), 1);
+		return is_smaller ? smaller : 1 - smaller;
+	}
+	default:
+		return DEFAULT_SELECTIVITY;
+	}
+}
+
+void JoinOrderOptimizer::EstimateFilter(Expression &filter, FilterInfo &info) {
+	if (info.set->count == 0) {
+		// constant filter
+		return;
+	}
+	if (filter.GetExpressionClass() != ExpressionClass::BOUND_COMPARISON) {
+		info.selectivity = DEFAULT_SELECTIVITY;
+		return;
+	}
+	auto &comparison = (BoundComparisonExpression &)filter;
+	if (info.set->count > 1) {
+		// join condition: the selectivity of an equality join follows from the distinct values of both sides
+		if (comparison.type == ExpressionType::COMPARE_EQUAL && info.left_set && info.right_set) {
+			auto left_stats = GetColumnStatistics(*comparison.left);
+			auto right_stats = GetColumnStatistics(*comparison.right);
+			if (left_stats && right_stats) {
+				info.left_distinct_count = left_stats->GetDistinctCount();
+				info.right_distinct_count = right_stats->GetDistinctCount();
+			}
+		}
+		return;
+	}
+	// filter on a single relation: we can estimate comparisons between a column and a constant
+	auto column = comparison.left.get();
+	auto constant = comparison.right.get();
+	auto comparison_type = comparison.type;
+	if (column->GetExpressionClass() == ExpressionClass::BOUND_CONSTANT) {
+		std::swap(column, constant);
+		comparison_type = FlipComparisionExpression(comparison_type);
+	}
+	info.selectivity = DEFAULT_SELECTIVITY;
+	if (constant->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return;
+	}
+	auto stats = GetColumnStatistics(*column);
+	if (stats) {
+		auto &value = ((BoundConstantExpression &)*constant).value;
+		info.selectivity = EstimateComparisonSelectivity(*stats, comparison_type, value);
+	}
+}
+
+idx_t JoinOrderOptimizer::EstimateRelationCardinality(idx_t relation_index) {
+	auto &relation = *relations[relation_index];
+	double cardinality = relation.op->EstimateCardinality(context);
+	// apply the selectivity of the filters that were pushed into the table scan
+	auto get = GetRelationScan(relation);
+	if (get) {
+		for (auto &filter : get->tableFilters) {
+			auto stats = get->function.statistics
+			                 ? get->function.statistics(context, get->bind_data.get(), filter.column_index)
+			                 : nullptr;
+			cardinality *= stats ? EstimateComparisonSelectivity(*stats, filter.comparison_type, filter.constant)
+			                     : DEFAULT_SELECTIVITY;
+		}
+	}
+	// apply the selectivity of the filters on the relation that were extracted from the plan
+	for (auto &info : filter_infos) {
+		if (info->set->count == 1 && info->set->relations[0] == relation_index) {
+			cardinality *= info->selectivity;
+		}
+	}
+	return ConvertCardinality(MaxValue<double>(cardinality, 1));
+}
+
+unique_ptr<JoinNode> JoinOrderOptimizer::CreateJoinTree(JoinRelationSet *set, NeighborInfo *info, JoinNode *left,
+                                                        JoinNode *right) {
 	// for the hash join we want the right side (build side) to have the smallest cardinality
 	// also just a heuristic but for now...
 	// FIXME: we should probably actually benchmark that as well
@@ -197,20 +354,40 @@ static unique_ptr<JoinNode> CreateJoinTree(JoinRelationSet *set, NeighborInfo *i
 	if (left->cardinality < right->cardinality) {
 		return CreateJoinTree(set, info, right, left);
 	}
-	// the expected cardinality is the max of the child cardinalities
-	// FIXME: we should obviously use better cardinality estimation here
-	// but for now we just assume foreign key joins only
-	idx_t expected_cardinality;
-	if (info->filters.size() == 0) {
-		// cross product
-		expected_cardinality = left->cardinality * right->cardinality;
-	} else {
-		// normal join, expect foreign key join
-		expected_cardinality = MaxValue(left->cardinality, right->cardinality);
+	double left_cardinality = left->cardinality;
+	double right_cardinality = right->cardinality;
+	// without conditions the join is a cross product
+	double expected_cardinality = left_cardinality * right_cardinality;
+	if (info->filters.size() > 0) {
+		// an equality condition matches a tuple with 1 / (the distinct values of the side with the most distinct
+		// values) of the tuples of the other side. We use the most selective condition of the join.
+		double selectivity = 1;
+		bool has_estimate = false;
+		for (auto &filter : info->filters) {
+			if (filter->left_distinct_count == INVALID_INDEX || filter->right_distinct_count == INVALID_INDEX) {
+				continue;
+			}
+			bool invert = !JoinRelationSet::IsSubset(left->set, filter->left_set);
+			idx_t left_count = invert ? filter->right_distinct_count : filter->left_distinct_count;
+			idx_t right_count = invert ? filter->left_distinct_count : filter->right_distinct_count;
+			// a side can not have more distinct values than tuples
+			double left_distinct = MinValue<double>(left_count, left_cardinality);
+			double right_distinct = MinValue<double>(right_count, right_cardinality);
+			double distinct_count = MaxValue<double>(MaxValue<double>(left_distinct, right_distinct), 1);
+			selectivity = MinValue<double>(selectivity, 1.0 / distinct_count);
+			has_estimate = true;
+		}
+		if (has_estimate) {
+			expected_cardinality = MaxValue<double>(expected_cardinality * selectivity, 1);
+		} else {
+			// no statistics on the join columns: expect a foreign key join
+			expected_cardinality = MaxValue<double>(left_cardinality, right_cardinality);
+		}
 	}
 	// cost is expected_cardinality plus the cost of the previous plans
-	idx_t cost = expected_cardinality;
-	return make_unique<JoinNode>(set, info, left, right, expected_cardinality, cost);
+	double cost = expected_cardinality + double(left->cost) + double(right->cost);
+	return make_unique<JoinNode>(set, info, left, right, ConvertCardinality(expected_cardinality),
+	                             ConvertCardinality(cost));
 }
 
 JoinNode *JoinOrderOptimizer::EmitPair(JoinRelationSet *left, JoinRelationSet *right, NeighborInfo *info) {
@@ -655,7 +832,8 @@ unique_ptr<LogicalOperator> JoinOrderOptimizer::RewritePlan(unique_ptr<LogicalOp
 // the join ordering is pretty much a straight implementation of the paper "Dynamic Programming Strikes Back" by Guido
 // Moerkotte and Thomas Neumannn, see that paper for additional info/documentation bonus slides:
 // https://db.in.tum.de/teaching/ws1415/queryopt/chapter3.pdf?lang=de
-// FIXME: incorporate cardinality estimation into the plans, possibly by pushing samples?
+// the cardinalities of the relations and joins are estimated from the statistics of the base tables: the min/max of
+// the columns estimate the selectivity of filters, the distinct counts estimate the selectivity of equality joins
 unique_ptr<LogicalOperator> JoinOrderOptimizer::Optimize(unique_ptr<LogicalOperator> plan) {
 	D_ASSERT(filters.size() == 0 &&
 	         relations.size() == 0); // assert that the JoinOrderOptimizer has not been used before
@@ -749,14 +927,17 @@ unique_ptr<LogicalOperator> JoinOrderOptimizer::Optimize(unique_ptr<LogicalOpera
 			}
 		}
 	}
+	// estimate the selectivity of the filters from the statistics of the base tables
+	for (auto &info : filter_infos) {
+		EstimateFilter(*filters[info->filter_index], *info);
+	}
 	// now use dynamic programming to figure out the optimal join order
 	// First we initialize each of the single-node plans with themselves and with their cardinalities these are the leaf
 	// nodes of the join tree NOTE: we can just use pointers to JoinRelationSet* here because the GetJoinRelation
 	// function ensures that a unique combination of relations will have a unique JoinRelationSet object.
 	for (idx_t i = 0; i < relations.size(); i++) {
-		auto &rel = *relations[i];
 		auto node = set_manager.GetJoinRelation(i);
-		plans[node] = make_unique<JoinNode>(node, rel.op->EstimateCardinality(context));
+		plans[node] = make_unique<JoinNode>(node, EstimateRelationCardinality(i));
 	}
 	// now we perform the actual dynamic programming to compute the final result
 	SolveJoinOrder();
@@ -36,6 +36,13 @@ void StatisticsPropagator::SetStatisticsNotNull(ColumnBinding binding) {
 
 void StatisticsPropagator::UpdateFilterStatistics(BaseStatistics &stats, ExpressionType comparison_type,
                                                   Value constant) {
+	if (stats.histogram && node_stats && node_stats->has_estimated_cardinality) {
+		// the histogram collected by ANALYZE estimates how many of the rows pass the filter
+		auto selectivity = stats.histogram->EstimateSelectivity(comparison_type, constant);
+		if (selectivity >= 0) {
+			node_stats->estimated_cardinality = idx_t(node_stats->estimated_cardinality * selectivity);
+		}
+	}
 	// any comparison filter removes all null values
 	stats.has_null = false;
 	if (!stats.type.IsNumeric()) {
@@ -17,7 +17,7 @@ using namespace std;
 
 namespace duckdb {
 
-Executor::Executor(ClientContext &context) : context(context) {
+Executor::Executor(ClientContext &context) : context(context), has_recursive_pipelines(false) {
 }
 
 Executor::~Executor() {
@@ -31,7 +31,7 @@ void Executor::Initialize(unique_ptr<PhysicalOperator> plan) {
 
 	context.profiler.Initialize(physical_plan.get());
 	auto &scheduler = TaskScheduler::GetScheduler(context);
-	this->producer = scheduler.CreateProducer();
+	this->producer = scheduler.CreateProducer(context.task_priority);
 
 	BuildPipelines(physical_plan.get(), nullptr);
 
@@ -54,6 +54,10 @@ void Executor::Initialize(unique_ptr<PhysicalOperator> plan) {
 	}
 
 	pipelines.clear();
+	if (!has_recursive_pipelines) {
+		// unregister the producer: the query no longer takes part in the round-robin over all producers
+		producer.reset();
+	}
 	if (exceptions.size() > 0) {
 		// an exception has occurred executing one of the pipelines
 		throw Exception(exceptions[0]);
@@ -69,6 +73,8 @@ void Executor::Reset() {
 	total_pipelines = 0;
 	exceptions.clear();
 	pipelines.clear();
+	producer.reset();
+	has_recursive_pipelines = false;
 }
 
 void Executor::BuildPipelines(PhysicalOperator *op, Pipeline *parent) {
@@ -187,6 +193,10 @@ void Executor::BuildPipelines(PhysicalOperator *op, Pipeline *parent) {
 			for (idx_t i = 0; i < cte_node.pipelines.size(); i++) {
 				cte_node.pipelines[i]->ClearParents();
 			}
+			if (!cte_node.pipelines.empty()) {
+				// the pipelines of the recursive CTE are scheduled while the result is fetched
+				has_recursive_pipelines = true;
+			}
 
 			recursive_cte = nullptr;
 			return;
@@ -31,6 +31,31 @@ public:
 	}
 };
 
+//! A task that performs part of the Finalize of the sink of a pipeline
+class PipelineFinalizeTask : public Task {
+public:
+	PipelineFinalizeTask(Pipeline *pipeline_, unique_ptr<Task> task_) : pipeline(pipeline_), task(move(task_)) {
+	}
+
+	Pipeline *pipeline;
+	unique_ptr<Task> task;
+
+public:
+	void Execute() override {
+		if (!pipeline->executor.context.interrupted) {
+			try {
+				task->Execute();
+			} catch (std::exception &ex) {
+				pipeline->executor.PushError(ex.what());
+			} catch (...) {
+				pipeline->executor.PushError("Unknown exception in Finalize!");
+			}
+		}
+		task.reset();
+		pipeline->FinishFinalizeTask();
+	}
+};
+
 Pipeline::Pipeline(Executor &executor_, ProducerToken &token_)
     : executor(executor_), token(token_), finished_tasks(0), total_tasks(0), finished_dependencies(0), finished(false),
       recursive_cte(nullptr) {
@@ -88,6 +113,27 @@ void Pipeline::FinishTask() {
 	}
 }
 
+void Pipeline::ScheduleFinalizeTasks(vector<unique_ptr<Task>> tasks) {
+	if (tasks.empty()) {
+		return;
+	}
+	// increment the task count before scheduling any task, so the pipeline cannot be finished before all of the new
+	// tasks have completed
+	total_tasks += tasks.size();
+	auto &scheduler = TaskScheduler::GetScheduler(executor.context);
+	for (auto &task : tasks) {
+		scheduler.ScheduleTask(token, make_unique<PipelineFinalizeTask>(this, move(task)));
+	}
+}
+
+void Pipeline::FinishFinalizeTask() {
+	D_ASSERT(finished_tasks < total_tasks);
+	idx_t current_finished = ++finished_tasks;
+	if (current_finished == total_tasks) {
+		Finish();
+	}
+}
+
 void Pipeline::ScheduleSequentialTask() {
 	auto &scheduler = TaskScheduler::GetScheduler(executor.context);
 	auto task = make_unique<PipelineTask>(this);
@@ -134,8 +180,27 @@ bool Pipeline::ScheduleOperator(PhysicalOperator *op) {
 		return true;
 	}
 	case PhysicalOperatorType::HASH_GROUP_BY: {
-		// FIXME: parallelize scan of GROUP_BY HT
-		return false;
+		// we reached a finalized hash aggregate: scan the (radix-partitioned) hash tables in parallel
+		auto &scheduler = TaskScheduler::GetScheduler(executor.context);
+		auto &aggr = (PhysicalHashAggregate &)*op;
+		idx_t max_threads = aggr.MaxThreads(executor.context);
+		if (max_threads > executor.context.db.NumberOfThreads()) {
+			max_threads = executor.context.db.NumberOfThreads();
+		}
+		if (max_threads <= 1) {
+			// only a single hash table: scan it sequentially
+			return false;
+		}
+		this->parallel_state = aggr.GetParallelState();
+		this->parallel_node = op;
+
+		// launch a task for every thread
+		this->total_tasks = max_threads;
+		for (idx_t i = 0; i < max_threads; i++) {
+			auto task = make_unique<PipelineTask>(this);
+			scheduler.ScheduleTask(*executor.producer, move(task));
+		}
+		return true;
 	}
 	default:
 		// unknown operator: skip parallel task scheduling
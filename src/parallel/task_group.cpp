@@ -0,0 +1,77 @@
+#include "duckdb/parallel/task_group.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+namespace duckdb {
+using namespace std;
+
+class TaskGroupTask : public Task {
+public:
+	TaskGroupTask(TaskGroup &group, std::function<void()> function) : group(group), function(move(function)) {
+	}
+
+	void Execute() override {
+		string error;
+		try {
+			function();
+		} catch (std::exception &ex) {
+			error = ex.what();
+		} catch (...) { // LCOV_EXCL_START
+			error = "Unknown exception in task!";
+		} // LCOV_EXCL_STOP
+		group.FinishTask(error);
+	}
+
+private:
+	TaskGroup &group;
+	std::function<void()> function;
+};
+
+TaskGroup::TaskGroup(TaskScheduler &scheduler)
+    : scheduler(scheduler), producer(scheduler.CreateProducer()), scheduled_tasks(0), finished_tasks(0) {
+}
+
+TaskGroup::~TaskGroup() {
+	// the tasks refer to the group: they have to finish before it is destroyed
+	WaitForTasks();
+}
+
+void TaskGroup::Schedule(std::function<void()> function) {
+	{
+		lock_guard<mutex> guard(lock);
+		scheduled_tasks++;
+	}
+	scheduler.ScheduleTask(*producer, make_unique<TaskGroupTask>(*this, move(function)));
+}
+
+void TaskGroup::FinishTask(const string &task_error) {
+	// the group can be destroyed as soon as the waiting thread sees the last task finish, so it is signaled while the
+	// lock is still held
+	lock_guard<mutex> guard(lock);
+	if (error.empty()) {
+		error = task_error;
+	}
+	finished_tasks++;
+	if (finished_tasks == scheduled_tasks) {
+		tasks_finished.notify_all();
+	}
+}
+
+void TaskGroup::WaitForTasks() {
+	unique_ptr<Task> task;
+	while (scheduler.GetTaskFromProducer(*producer, task)) {
+		task->Execute();
+		task.reset();
+	}
+	unique_lock<mutex> guard(lock);
+	tasks_finished.wait(guard, [&]() { return finished_tasks == scheduled_tasks; });
+}
+
+void TaskGroup::Finish() {
+	WaitForTasks();
+	if (!error.empty()) {
+		throw Exception(error);
+	}
+}
+
+} // namespace duckdb
@@ -4,6 +4,8 @@
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database.hpp"
 
+#include <chrono>
+
 #ifndef DUCKDB_NO_THREADS
 #include "concurrentqueue.h"
 #include "lightweightsemaphore.h"
@@ -24,54 +26,178 @@ struct SchedulerThread {
 #endif
 };
 
+//! A task together with the time at which it was scheduled
+struct ScheduledTask {
+	ScheduledTask() {
+	}
+	ScheduledTask(unique_ptr<Task> task_p) : task(move(task_p)), scheduled(std::chrono::steady_clock::now()) {
+	}
+
+	unique_ptr<Task> task;
+	std::chrono::time_point<std::chrono::steady_clock> scheduled;
+
+	idx_t WaitTime() {
+		auto elapsed = std::chrono::steady_clock::now() - scheduled;
+		return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+	}
+};
+
+//! The weight of a producer in the round-robin over all producers
+static idx_t GetProducerWeight(TaskPriority priority) {
+	switch (priority) {
+	case TaskPriority::LOW:
+		return 1;
+	case TaskPriority::HIGH:
+		return 16;
+	default:
+		return 4;
+	}
+}
+
 #ifndef DUCKDB_NO_THREADS
-typedef moodycamel::ConcurrentQueue<unique_ptr<Task>> concurrent_queue_t;
+typedef moodycamel::ConcurrentQueue<ScheduledTask> concurrent_queue_t;
 typedef moodycamel::LightweightSemaphore lightweight_semaphore_t;
 
+typedef vector<shared_ptr<QueueProducerToken>> producer_list_t;
+
+//! The position of a background thread in the weighted round-robin over all producers
+struct ProducerCursor {
+	ProducerCursor() : version(0), producer_idx(0), remaining(0) {
+	}
+
+	//! The thread's copy of the registered producers, refreshed when the version of the producer list changes
+	shared_ptr<const producer_list_t> producers;
+	idx_t version;
+	//! The index of the producer the thread is currently serving
+	idx_t producer_idx;
+	//! The amount of tasks the thread can still take from this producer before moving on
+	idx_t remaining;
+};
+
+//! Every producer (i.e. every running query) has its own sub-queue in the concurrent queue. The thread of a query only
+//! takes tasks from its own sub-queue, while background threads serve all producers in a weighted round-robin, so a
+//! large query cannot starve a small one and high priority queries get a larger share of the threads.
 struct ConcurrentQueue {
+	ConcurrentQueue() : producers(make_shared<producer_list_t>()), producers_version(1) {
+	}
+
 	concurrent_queue_t q;
 	lightweight_semaphore_t semaphore;
+	//! The registered producers. The list is never modified in place: (un)registering a producer replaces it and bumps
+	//! the version, so the background threads can iterate over their own copy without holding a lock
+	shared_ptr<const producer_list_t> producers;
+	std::atomic<idx_t> producers_version;
+	//! Protects the producers pointer, only taken when producers are (un)registered or a thread refreshes its copy
+	mutex producers_lock;
 
 	void enqueue(ProducerToken &token, unique_ptr<Task> task);
-	bool dequeue_from_producer(ProducerToken &token, unique_ptr<Task> &task);
+	bool dequeue_from_producer(ProducerToken &token, ScheduledTask &task);
+	bool dequeue_round_robin(ProducerCursor &cursor, ScheduledTask &task);
+
+	void register_producer(ProducerToken &token);
+	void unregister_producer(ProducerToken &token);
+	idx_t producer_count();
 };
 
 struct QueueProducerToken {
-	QueueProducerToken(ConcurrentQueue &queue) : queue_token(queue.q) {
+	QueueProducerToken(ConcurrentQueue &queue, idx_t weight) : queue_token(queue.q), weight(weight) {
 	}
 
 	moodycamel::ProducerToken queue_token;
+	//! The amount of tasks a background thread executes from this producer before moving on to the next producer
+	idx_t weight;
 };
 
 void ConcurrentQueue::enqueue(ProducerToken &token, unique_ptr<Task> task) {
+	// the sub-queue of a producer only supports a single enqueuing thread at a time
 	lock_guard<mutex> producer_lock(token.producer_lock);
-	if (q.enqueue(token.token->queue_token, move(task))) {
+	if (q.enqueue(token.token->queue_token, ScheduledTask(move(task)))) {
 		semaphore.signal();
 	} else {
 		throw InternalException("Could not schedule task!");
 	}
 }
 
-bool ConcurrentQueue::dequeue_from_producer(ProducerToken &token, unique_ptr<Task> &task) {
-	lock_guard<mutex> producer_lock(token.producer_lock);
+bool ConcurrentQueue::dequeue_from_producer(ProducerToken &token, ScheduledTask &task) {
+	// any number of threads can dequeue from a sub-queue concurrently with its producer
 	return q.try_dequeue_from_producer(token.token->queue_token, task);
 }
 
+bool ConcurrentQueue::dequeue_round_robin(ProducerCursor &cursor, ScheduledTask &task) {
+	idx_t version = producers_version;
+	if (cursor.version != version) {
+		// producers were (un)registered since we last looked: refresh our copy of the list
+		lock_guard<mutex> lock(producers_lock);
+		cursor.producers = producers;
+		cursor.version = producers_version;
+	}
+	// our copy of the list keeps the tokens of unregistered producers alive while we fetch tasks from them
+	auto &list = *cursor.producers;
+	for (idx_t i = 0; i < list.size(); i++) {
+		auto &producer = *list[cursor.producer_idx % list.size()];
+		if (cursor.remaining == 0) {
+			cursor.remaining = producer.weight;
+		}
+		if (q.try_dequeue_from_producer(producer.queue_token, task)) {
+			if (--cursor.remaining == 0) {
+				// this producer has used up its share: move on to the next one
+				cursor.producer_idx++;
+			}
+			return true;
+		}
+		// no tasks available for this producer: move on to the next one
+		cursor.producer_idx++;
+		cursor.remaining = 0;
+	}
+	return false;
+}
+
+void ConcurrentQueue::register_producer(ProducerToken &token) {
+	lock_guard<mutex> lock(producers_lock);
+	auto new_producers = make_shared<producer_list_t>(*producers);
+	new_producers->push_back(token.token);
+	producers = move(new_producers);
+	producers_version++;
+}
+
+void ConcurrentQueue::unregister_producer(ProducerToken &token) {
+	lock_guard<mutex> lock(producers_lock);
+	auto new_producers = make_shared<producer_list_t>(*producers);
+	for (idx_t i = 0; i < new_producers->size(); i++) {
+		if ((*new_producers)[i] == token.token) {
+			new_producers->erase(new_producers->begin() + i);
+			break;
+		}
+	}
+	producers = move(new_producers);
+	producers_version++;
+}
+
+idx_t ConcurrentQueue::producer_count() {
+	lock_guard<mutex> lock(producers_lock);
+	return producers->size();
+}
+
 #else
 struct ConcurrentQueue {
-	std::queue<std::unique_ptr<Task>> q;
+	std::queue<ScheduledTask> q;
 	mutex qlock;
+	idx_t producers = 0;
 
 	void enqueue(ProducerToken &token, unique_ptr<Task> task);
-	bool dequeue_from_producer(ProducerToken &token, unique_ptr<Task> &task);
+	bool dequeue_from_producer(ProducerToken &token, ScheduledTask &task);
+
+	void register_producer(ProducerToken &token);
+	void unregister_producer(ProducerToken &token);
+	idx_t producer_count();
 };
 
 void ConcurrentQueue::enqueue(ProducerToken &token, unique_ptr<Task> task) {
 	lock_guard<mutex> lock(qlock);
-	q.push(move(task));
+	q.push(ScheduledTask(move(task)));
 }
 
-bool ConcurrentQueue::dequeue_from_producer(ProducerToken &token, unique_ptr<Task> &task) {
+bool ConcurrentQueue::dequeue_from_producer(ProducerToken &token, ScheduledTask &task) {
 	lock_guard<mutex> lock(qlock);
 	if (q.empty()) {
 		return false;
@@ -81,20 +207,39 @@ bool ConcurrentQueue::dequeue_from_producer(ProducerToken &token, unique_ptr<Tas
 	return true;
 }
 
+void ConcurrentQueue::register_producer(ProducerToken &token) {
+	lock_guard<mutex> lock(qlock);
+	producers++;
+}
+
+void ConcurrentQueue::unregister_producer(ProducerToken &token) {
+	lock_guard<mutex> lock(qlock);
+	producers--;
+}
+
+idx_t ConcurrentQueue::producer_count() {
+	lock_guard<mutex> lock(qlock);
+	return producers;
+}
+
 struct QueueProducerToken {
-	QueueProducerToken(ConcurrentQueue &queue) {
+	QueueProducerToken(ConcurrentQueue &queue, idx_t weight) {
 	}
 };
 #endif
 
-ProducerToken::ProducerToken(TaskScheduler &scheduler, unique_ptr<QueueProducerToken> token)
-    : scheduler(scheduler), token(move(token)) {
+ProducerToken::ProducerToken(TaskScheduler &scheduler, shared_ptr<QueueProducerToken> token, TaskPriority priority)
+    : scheduler(scheduler), token(move(token)), priority(priority) {
+	scheduler.queue->register_producer(*this);
 }
 
 ProducerToken::~ProducerToken() {
+	scheduler.queue->unregister_producer(*this);
 }
 
-TaskScheduler::TaskScheduler() : queue(make_unique<ConcurrentQueue>()) {
+TaskScheduler::TaskScheduler()
+    : queue(make_unique<ConcurrentQueue>()), tasks_scheduled(0), tasks_executed(0), total_wait_usecs(0),
+      max_wait_usecs(0) {
 }
 
 TaskScheduler::~TaskScheduler() {
@@ -107,30 +252,57 @@ TaskScheduler &TaskScheduler::GetScheduler(ClientContext &context) {
 	return *context.db.scheduler;
 }
 
-unique_ptr<ProducerToken> TaskScheduler::CreateProducer() {
-	auto token = make_unique<QueueProducerToken>(*queue);
-	return make_unique<ProducerToken>(*this, move(token));
+unique_ptr<ProducerToken> TaskScheduler::CreateProducer(TaskPriority priority) {
+	auto token = make_shared<QueueProducerToken>(*queue, GetProducerWeight(priority));
+	return make_unique<ProducerToken>(*this, move(token), priority);
 }
 
 void TaskScheduler::ScheduleTask(ProducerToken &token, unique_ptr<Task> task) {
 	// Enqueue a task for the given producer token and signal any sleeping threads
 	queue->enqueue(token, move(task));
+	tasks_scheduled++;
 }
 
 bool TaskScheduler::GetTaskFromProducer(ProducerToken &token, unique_ptr<Task> &task) {
-	return queue->dequeue_from_producer(token, task);
+	ScheduledTask scheduled_task;
+	if (!queue->dequeue_from_producer(token, scheduled_task)) {
+		return false;
+	}
+	RecordWait(scheduled_task.WaitTime());
+	task = move(scheduled_task.task);
+	return true;
+}
+
+void TaskScheduler::RecordWait(idx_t wait_usecs) {
+	tasks_executed++;
+	total_wait_usecs += wait_usecs;
+	idx_t current_max = max_wait_usecs;
+	while (wait_usecs > current_max && !max_wait_usecs.compare_exchange_weak(current_max, wait_usecs)) {
+	}
+}
+
+TaskSchedulerStatistics TaskScheduler::GetStatistics() {
+	TaskSchedulerStatistics result;
+	result.tasks_scheduled = tasks_scheduled;
+	result.tasks_executed = tasks_executed;
+	result.total_wait_usecs = total_wait_usecs;
+	result.max_wait_usecs = max_wait_usecs;
+	result.active_producers = queue->producer_count();
+	return result;
 }
 
 void TaskScheduler::ExecuteForever(bool *marker) {
 #ifndef DUCKDB_NO_THREADS
-	unique_ptr<Task> task;
+	ProducerCursor cursor;
+	ScheduledTask scheduled_task;
 	// loop until the marker is set to false
 	while (*marker) {
 		// wait for a signal with a timeout; the timeout allows us to periodically check
 		queue->semaphore.wait(TASK_TIMEOUT_USECS);
-		if (queue->q.try_dequeue(task)) {
-			task->Execute();
-			task.reset();
+		if (queue->dequeue_round_robin(cursor, scheduled_task)) {
+			RecordWait(scheduled_task.WaitTime());
+			scheduled_task.task->Execute();
+			scheduled_task.task.reset();
 		}
 	}
 #else
@@ -1,4 +1,5 @@
 #include "duckdb/parser/statement/vacuum_statement.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
 #include "duckdb/parser/transformer.hpp"
 
 namespace duckdb {
@@ -8,8 +9,21 @@ using namespace duckdb_libpgquery;
 unique_ptr<VacuumStatement> Transformer::TransformVacuum(PGNode *node) {
 	auto stmt = reinterpret_cast<PGVacuumStmt *>(node);
 	D_ASSERT(stmt);
-	(void)stmt;
 	auto result = make_unique<VacuumStatement>();
+	result->info = make_unique<VacuumInfo>();
+	auto &info = *result->info;
+	info.analyze = stmt->options & PG_VACOPT_ANALYZE;
+	if (stmt->relation) {
+		auto ref = TransformRangeVar(stmt->relation);
+		auto &table = (BaseTableRef &)*ref;
+		info.schema = table.schema_name;
+		info.table = table.table_name;
+	}
+	if (stmt->va_cols) {
+		for (auto n = stmt->va_cols->head; n != nullptr; n = n->next) {
+			info.columns.push_back(reinterpret_cast<PGValue *>(n->data.ptr_value)->val.str);
+		}
+	}
 	return result;
 }
 
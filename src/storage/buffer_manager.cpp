@@ -3,9 +3,107 @@
 #include "duckdb/common/exception.hpp"
 #include "concurrentqueue.h"
 
+#include <queue>
+
 namespace duckdb {
 using namespace std;
 
+struct BufferEvictionNode {
+	BufferEvictionNode(std::weak_ptr<BlockHandle> handle_p, idx_t timestamp_p)
+	    : handle(move(handle_p)), timestamp(timestamp_p) {
+		D_ASSERT(!handle.expired());
+	}
+
+	std::weak_ptr<BlockHandle> handle;
+	idx_t timestamp;
+
+	bool CanUnload(BlockHandle &handle) {
+		if (timestamp != handle.eviction_timestamp) {
+			// handle was used in between
+			return false;
+		}
+		return handle.CanUnload();
+	}
+};
+
+typedef moodycamel::ConcurrentQueue<unique_ptr<BufferEvictionNode>> eviction_queue_t;
+
+//! The ids of the blocks that were recently evicted from the recent queue (the "A1out" queue of 2Q). Only the ids are
+//! kept, in the order in which the blocks were evicted, and the oldest ids are dropped once the history is full.
+class EvictionHistory {
+public:
+	//! Adds a block that was evicted, together with the sequential scan that last pinned it
+	void Add(block_id_t block_id, idx_t scan_id, idx_t capacity) {
+		lock_guard<mutex> history_lock(lock);
+		auto sequence = ++sequence_number;
+		entries[block_id] = make_pair(sequence, scan_id);
+		order.push(make_pair(block_id, sequence));
+		while (order.size() > capacity) {
+			// drop the oldest entry, unless the block has been evicted again since
+			auto &oldest = order.front();
+			auto entry = entries.find(oldest.first);
+			if (entry != entries.end() && entry->second.first == oldest.second) {
+				entries.erase(entry);
+			}
+			order.pop();
+		}
+	}
+
+	//! Removes a block that is loaded again from the history. Returns true if the block was in the history and it was
+	//! not evicted by the same sequential scan that loads it again.
+	bool Remove(block_id_t block_id, idx_t scan_id) {
+		lock_guard<mutex> history_lock(lock);
+		auto entry = entries.find(block_id);
+		if (entry == entries.end()) {
+			return false;
+		}
+		bool same_scan = scan_id != 0 && entry->second.second == scan_id;
+		entries.erase(entry);
+		return !same_scan;
+	}
+
+private:
+	mutex lock;
+	//! Maps the block ids in the history to the sequence number of their entry and the scan that last pinned them
+	unordered_map<block_id_t, pair<idx_t, idx_t>> entries;
+	//! The entries of the history in the order in which they were added, including entries that were removed since
+	std::queue<pair<block_id_t, idx_t>> order;
+	idx_t sequence_number = 0;
+};
+
+//! The eviction queues follow the 2Q policy. Blocks that are loaded are placed in the "recent" queue, which is a FIFO
+//! queue: pinning a block again while it is still loaded does not promote it, so a scan that visits a block several
+//! times does not keep it in memory. The ids of blocks that are evicted from the recent queue are remembered in a
+//! bounded history. Only a block that is loaded again while it is in the history, i.e. that is re-referenced after a
+//! while, is placed in the "frequent" queue, which is an LRU queue. The recent queue is evicted first as long as it
+//! holds more than its share of the memory; otherwise the least recently used frequent blocks are evicted, and
+//! frequent blocks that are evicted have to earn their place in the frequent queue again.
+struct EvictionQueue {
+	//! The share of the memory (as a divisor of the limit) that the recent queue can hold before it is evicted first
+	static constexpr idx_t RECENT_MEMORY_DIVISOR = 4;
+	//! The size of the history relative to the amount of blocks that fit in memory (as a divisor)
+	static constexpr idx_t HISTORY_SIZE_DIVISOR = 2;
+
+	//! Blocks that have been loaded, but that have not been re-referenced after being evicted
+	eviction_queue_t recent;
+	//! Blocks that have been re-referenced after being evicted
+	eviction_queue_t frequent;
+	//! The ids of the blocks that were recently evicted from the recent queue
+	EvictionHistory history;
+	//! The amount of memory held by loaded blocks of the recent queue
+	std::atomic<idx_t> recent_memory;
+
+	EvictionQueue() : recent_memory(0) {
+	}
+
+	bool Dequeue(unique_ptr<BufferEvictionNode> &node, idx_t memory_limit) {
+		if (recent_memory > memory_limit / RECENT_MEMORY_DIVISOR) {
+			return recent.try_dequeue(node) || frequent.try_dequeue(node);
+		}
+		return frequent.try_dequeue(node) || recent.try_dequeue(node);
+	}
+};
+
 BlockHandle::BlockHandle(BufferManager &manager_p, block_id_t block_id_p) : manager(manager_p) {
 	block_id = block_id_p;
 	readers = 0;
@@ -14,6 +112,9 @@ BlockHandle::BlockHandle(BufferManager &manager_p, block_id_t block_id_p) : mana
 	state = BlockState::BLOCK_UNLOADED;
 	can_destroy = false;
 	memory_usage = Storage::BLOCK_ALLOC_SIZE;
+	prefetched = false;
+	frequent = false;
+	last_scan_id = 0;
 }
 
 BlockHandle::BlockHandle(BufferManager &manager_p, block_id_t block_id_p, unique_ptr<FileBuffer> buffer_p,
@@ -27,6 +128,10 @@ BlockHandle::BlockHandle(BufferManager &manager_p, block_id_t block_id_p, unique
 	state = BlockState::BLOCK_LOADED;
 	can_destroy = can_destroy_p;
 	memory_usage = alloc_size;
+	prefetched = false;
+	frequent = false;
+	last_scan_id = 0;
+	manager.queue->recent_memory += memory_usage;
 }
 
 BlockHandle::~BlockHandle() {
@@ -35,6 +140,9 @@ BlockHandle::~BlockHandle() {
 		// the block is still loaded in memory: erase it
 		buffer.reset();
 		manager.current_memory -= memory_usage;
+		if (!frequent) {
+			manager.queue->recent_memory -= memory_usage;
+		}
 	}
 	manager.UnregisterBlock(block_id, can_destroy);
 }
@@ -45,22 +153,21 @@ unique_ptr<BufferHandle> BlockHandle::Load(shared_ptr<BlockHandle> &handle) {
 		D_ASSERT(handle->buffer);
 		return make_unique<BufferHandle>(handle->manager, handle, handle->buffer.get());
 	}
-	handle->state = BlockState::BLOCK_LOADED;
 	if (handle->block_id < MAXIMUM_BLOCK) {
-		// FIXME: currently we still require a lock for reading blocks from disk
-		// this is mainly down to the block manager only having a single pointer into the file
-		// this is relatively easy to fix later on
-		lock_guard<mutex> buffer_lock(handle->manager.manager_lock);
+		// the block manager uses positional reads, so no global lock is required here: the block-level lock held by
+		// the caller ensures a block is only loaded once, while different blocks can be loaded concurrently
 		auto block = make_unique<Block>(handle->block_id);
 		handle->manager.manager.Read(*block);
 		handle->buffer = move(block);
 	} else {
 		if (handle->can_destroy) {
+			handle->state = BlockState::BLOCK_LOADED;
 			return nullptr;
 		} else {
 			handle->buffer = handle->manager.ReadTemporaryBuffer(handle->block_id);
 		}
 	}
+	handle->state = BlockState::BLOCK_LOADED;
 	return make_unique<BufferHandle>(handle->manager, handle, handle->buffer.get());
 }
 
@@ -78,6 +185,11 @@ void BlockHandle::Unload() {
 	}
 	buffer.reset();
 	manager.current_memory -= memory_usage;
+	if (!frequent) {
+		manager.queue->recent_memory -= memory_usage;
+	}
+	// the block has to be re-referenced shortly after it is loaded again to remain in the frequent queue
+	frequent = false;
 }
 
 bool BlockHandle::CanUnload() {
@@ -98,33 +210,10 @@ bool BlockHandle::CanUnload() {
 	return true;
 }
 
-struct BufferEvictionNode {
-	BufferEvictionNode(std::weak_ptr<BlockHandle> handle_p, idx_t timestamp_p)
-	    : handle(move(handle_p)), timestamp(timestamp_p) {
-		D_ASSERT(!handle.expired());
-	}
-
-	std::weak_ptr<BlockHandle> handle;
-	idx_t timestamp;
-
-	bool CanUnload(BlockHandle &handle) {
-		if (timestamp != handle.eviction_timestamp) {
-			// handle was used in between
-			return false;
-		}
-		return handle.CanUnload();
-	}
-};
-
-typedef moodycamel::ConcurrentQueue<unique_ptr<BufferEvictionNode>> eviction_queue_t;
-
-struct EvictionQueue {
-	eviction_queue_t q;
-};
-
 BufferManager::BufferManager(FileSystem &fs, BlockManager &manager, string tmp, idx_t maximum_memory)
     : fs(fs), manager(manager), current_memory(0), maximum_memory(maximum_memory), temp_directory(move(tmp)),
-      queue(make_unique<EvictionQueue>()), temporary_id(MAXIMUM_BLOCK) {
+      queue(make_unique<EvictionQueue>()), temporary_id(MAXIMUM_BLOCK), scan_id(0), block_hits(0), block_misses(0),
+      evictions(0), prefetch_requests(0), prefetch_hits(0) {
 	if (!temp_directory.empty()) {
 		fs.CreateDirectory(temp_directory);
 	}
@@ -155,6 +244,17 @@ shared_ptr<BlockHandle> BufferManager::RegisterBlock(block_id_t block_id) {
 	return result;
 }
 
+vector<block_id_t> BufferManager::GetRegisteredBlocks() {
+	lock_guard<mutex> lock(manager_lock);
+	vector<block_id_t> result;
+	for (auto &entry : blocks) {
+		if (!entry.second.expired()) {
+			result.push_back(entry.first);
+		}
+	}
+	return result;
+}
+
 shared_ptr<BlockHandle> BufferManager::RegisterMemory(idx_t alloc_size, bool can_destroy) {
 	// first evict blocks until we have enough memory to store this buffer
 	if (!EvictBlocks(alloc_size, maximum_memory)) {
@@ -175,9 +275,17 @@ unique_ptr<BufferHandle> BufferManager::Allocate(idx_t alloc_size) {
 	return Pin(block);
 }
 
-unique_ptr<BufferHandle> BufferManager::Pin(shared_ptr<BlockHandle> &handle) {
+unique_ptr<BufferHandle> BufferManager::Pin(shared_ptr<BlockHandle> &handle, idx_t scan_id) {
 	// lock the block
 	lock_guard<mutex> lock(handle->lock);
+	handle->last_scan_id = scan_id;
+	if (handle->block_id < MAXIMUM_BLOCK) {
+		if (handle->state == BlockState::BLOCK_LOADED) {
+			block_hits++;
+		} else {
+			block_misses++;
+		}
+	}
 	// check if the block is already loaded
 	if (handle->state == BlockState::BLOCK_LOADED) {
 		// the block is loaded, increment the reader count and return a pointer to the handle
@@ -191,7 +299,54 @@ unique_ptr<BufferHandle> BufferManager::Pin(shared_ptr<BlockHandle> &handle) {
 	// now we can actually load the current block
 	D_ASSERT(handle->readers == 0);
 	handle->readers = 1;
-	return handle->Load(handle);
+	if (handle->prefetched) {
+		// the block was prefetched before it was needed
+		handle->prefetched = false;
+		prefetch_hits++;
+	}
+	unique_ptr<BufferHandle> result;
+	try {
+		result = handle->Load(handle);
+	} catch (...) {
+		// loading failed: release the memory we reserved for the block so it can be pinned again later
+		handle->readers = 0;
+		current_memory -= handle->memory_usage;
+		throw;
+	}
+	// a block that is loaded again shortly after it was evicted is promoted to the frequent queue
+	D_ASSERT(!handle->frequent);
+	handle->frequent = queue->history.Remove(handle->block_id, scan_id);
+	if (!handle->frequent) {
+		queue->recent_memory += handle->memory_usage;
+	}
+	return result;
+}
+
+void BufferManager::Prefetch(shared_ptr<BlockHandle> &handle) {
+	lock_guard<mutex> lock(handle->lock);
+	if (handle->state == BlockState::BLOCK_LOADED || handle->prefetched || handle->block_id >= MAXIMUM_BLOCK) {
+		// the block is already loaded or being prefetched, or it is not an on-disk block
+		return;
+	}
+	handle->prefetched = true;
+	prefetch_requests++;
+	manager.Prefetch(handle->block_id);
+}
+
+idx_t BufferManager::RegisterScan() {
+	return ++scan_id;
+}
+
+BufferManagerStatistics BufferManager::GetStatistics() {
+	BufferManagerStatistics result;
+	result.memory_usage = current_memory;
+	result.memory_limit = maximum_memory;
+	result.block_hits = block_hits;
+	result.block_misses = block_misses;
+	result.evictions = evictions;
+	result.prefetch_requests = prefetch_requests;
+	result.prefetch_hits = prefetch_hits;
+	return result;
 }
 
 void BufferManager::Unpin(shared_ptr<BlockHandle> &handle) {
@@ -200,7 +355,8 @@ void BufferManager::Unpin(shared_ptr<BlockHandle> &handle) {
 	handle->readers--;
 	if (handle->readers == 0) {
 		handle->eviction_timestamp++;
-		queue->q.enqueue(make_unique<BufferEvictionNode>(weak_ptr<BlockHandle>(handle), handle->eviction_timestamp));
+		auto &target = handle->frequent ? queue->frequent : queue->recent;
+		target.enqueue(make_unique<BufferEvictionNode>(weak_ptr<BlockHandle>(handle), handle->eviction_timestamp));
 		// FIXME: do some house-keeping to prevent the queue from being flooded with many old blocks
 	}
 }
@@ -209,8 +365,8 @@ bool BufferManager::EvictBlocks(idx_t extra_memory, idx_t memory_limit) {
 	unique_ptr<BufferEvictionNode> node;
 	current_memory += extra_memory;
 	while (current_memory > memory_limit) {
-		// get a block to unpin from the queue
-		if (!queue->q.try_dequeue(node)) {
+		// get a block to unpin from the queues
+		if (!queue->Dequeue(node, memory_limit)) {
 			current_memory -= extra_memory;
 			return false;
 		}
@@ -231,7 +387,14 @@ bool BufferManager::EvictBlocks(idx_t extra_memory, idx_t memory_limit) {
 		}
 		// hooray, we can unload the block
 		// release the memory and mark the block as unloaded
+		bool recent = !handle->frequent;
 		handle->Unload();
+		evictions++;
+		if (recent && !(handle->block_id >= MAXIMUM_BLOCK && handle->can_destroy)) {
+			// remember the block, so it is promoted if it is loaded again soon
+			idx_t capacity = memory_limit / Storage::BLOCK_ALLOC_SIZE / EvictionQueue::HISTORY_SIZE_DIVISOR;
+			queue->history.Add(handle->block_id, handle->last_scan_id, MaxValue<idx_t>(capacity, 1));
+		}
 	}
 	return true;
 }
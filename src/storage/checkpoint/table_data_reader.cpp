@@ -29,8 +29,15 @@ void TableDataReader::ReadTableData() {
 		auto &column = columns[col];
 		info.data->column_stats[col] = BaseStatistics::Deserialize(reader, column.type);
 	}
+	// load the histograms of the columns
+	for (idx_t col = 0; col < columns.size(); col++) {
+		if (reader.Read<bool>()) {
+			info.data->column_histograms[col] = Histogram::Deserialize(reader, columns[col].type);
+		}
+	}
 
 	// load the data pointers for the table
+	vector<vector<DataPointer>> data_pointers(columns.size());
 	idx_t table_count = 0;
 	for (idx_t col = 0; col < columns.size(); col++) {
 		auto &column = columns[col];
@@ -38,19 +45,9 @@ void TableDataReader::ReadTableData() {
 		idx_t data_pointer_count = reader.Read<idx_t>();
 		for (idx_t data_ptr = 0; data_ptr < data_pointer_count; data_ptr++) {
 			// read the data pointer
-			DataPointer data_pointer;
-			data_pointer.row_start = reader.Read<idx_t>();
-			data_pointer.tuple_count = reader.Read<idx_t>();
-			data_pointer.block_id = reader.Read<block_id_t>();
-			data_pointer.offset = reader.Read<uint32_t>();
-			data_pointer.statistics = BaseStatistics::Deserialize(reader, column.type);
-
+			auto data_pointer = DataPointer::Deserialize(reader, column.type);
 			column_count += data_pointer.tuple_count;
-			// create a persistent segment
-			auto segment = make_unique<PersistentSegment>(manager.buffer_manager, data_pointer.block_id,
-			                                              data_pointer.offset, column.type, data_pointer.row_start,
-			                                              data_pointer.tuple_count, move(data_pointer.statistics));
-			info.data->table_data[col].push_back(move(segment));
+			data_pointers[col].push_back(move(data_pointer));
 		}
 		if (col == 0) {
 			table_count = column_count;
@@ -60,6 +57,30 @@ void TableDataReader::ReadTableData() {
 			}
 		}
 	}
+
+	// load the rows that were deleted from the table
+	idx_t delete_count = reader.Read<idx_t>();
+	for (idx_t i = 0; i < delete_count; i++) {
+		auto start = reader.Read<idx_t>();
+		auto end = reader.Read<idx_t>();
+		info.data->deletes.push_back(std::make_pair(start, end));
+	}
+
+	// create the persistent segments: the values of the rows that were deleted when a block was written are not
+	// stored in the block, so the segments need to know how many of their rows were deleted
+	for (idx_t col = 0; col < columns.size(); col++) {
+		auto &column = columns[col];
+		for (auto &data_pointer : data_pointers[col]) {
+			auto deleted_count =
+			    TableDataWriter::CountDeletedRows(info.data->deletes, data_pointer.row_start,
+			                                      data_pointer.row_start + data_pointer.tuple_count);
+			auto segment = make_unique<PersistentSegment>(
+			    manager.buffer_manager, data_pointer.block_id, data_pointer.offset, column.type,
+			    data_pointer.row_start, data_pointer.tuple_count, move(data_pointer.statistics),
+			    data_pointer.compression, move(data_pointer.overflow_blocks), deleted_count);
+			info.data->table_data[col].push_back(move(segment));
+		}
+	}
 }
 
 } // namespace duckdb
@@ -3,14 +3,17 @@
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/common/types/null_value.hpp"
 
-#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/common/serializer/buffered_serializer.hpp"
 
-#include "duckdb/storage/numeric_segment.hpp"
+#include "duckdb/storage/compressed_segment.hpp"
+#include "duckdb/storage/data_table.hpp"
 #include "duckdb/storage/string_segment.hpp"
 #include "duckdb/storage/table/column_segment.hpp"
+#include "duckdb/transaction/append_info.hpp"
 #include "duckdb/transaction/transaction.hpp"
 
+#include <algorithm>
+
 namespace duckdb {
 using namespace std;
 
@@ -28,6 +31,8 @@ public:
 	block_id_t block_id;
 	//! The offset within the current block
 	idx_t offset;
+	//! The blocks that have been written to
+	vector<block_id_t> blocks;
 
 	static constexpr idx_t STRING_SPACE = Storage::BLOCK_SIZE - sizeof(block_id_t);
 
@@ -38,99 +43,249 @@ private:
 	void AllocateNewBlock(block_id_t new_block_id);
 };
 
-TableDataWriter::TableDataWriter(CheckpointManager &manager, TableCatalogEntry &table)
-    : manager(manager), table(table) {
+TableDataWriter::TableDataWriter(CheckpointManager &manager, DataTable &table)
+    : manager(manager), table(table), transaction(nullptr) {
 }
 
 TableDataWriter::~TableDataWriter() {
 }
 
-void TableDataWriter::WriteTableData(ClientContext &context) {
-	auto &transaction = Transaction::GetTransaction(context);
-	// allocate segments to write the table to
-	segments.resize(table.columns.size());
-	data_pointers.resize(table.columns.size());
-	stats.reserve(table.columns.size());
-	column_stats.reserve(table.columns.size());
-	for (idx_t i = 0; i < table.columns.size(); i++) {
-		auto type_id = table.columns[i].type.InternalType();
-		stats.push_back(make_unique<SegmentStatistics>(table.columns[i].type, GetTypeIdSize(type_id)));
-		column_stats.push_back(BaseStatistics::CreateEmpty(table.columns[i].type));
-		CreateSegment(i);
+//! Returns the first delete range that ends after the specified row
+static vector<std::pair<idx_t, idx_t>>::const_iterator FindDeleteRange(const vector<std::pair<idx_t, idx_t>> &deletes,
+                                                                       idx_t row) {
+	return std::upper_bound(deletes.begin(), deletes.end(), row,
+	                        [](idx_t row, const std::pair<idx_t, idx_t> &range) { return row < range.second; });
+}
+
+idx_t TableDataWriter::CountDeletedRows(const vector<std::pair<idx_t, idx_t>> &deletes, idx_t start, idx_t end) {
+	idx_t count = 0;
+	for (auto entry = FindDeleteRange(deletes, start); entry != deletes.end() && entry->first < end; entry++) {
+		count += MinValue<idx_t>(end, entry->second) - MaxValue<idx_t>(start, entry->first);
+	}
+	return count;
+}
+
+//! Returns the start of the first vector within [start, end) of which every row has been deleted, or end if there is
+//! no such vector
+static idx_t FindDeletedVector(const vector<std::pair<idx_t, idx_t>> &deletes, idx_t start, idx_t end) {
+	for (auto entry = FindDeleteRange(deletes, start); entry != deletes.end() && entry->first < end; entry++) {
+		idx_t vector_start = MaxValue<idx_t>(start, entry->first);
+		vector_start = (vector_start + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE * STANDARD_VECTOR_SIZE;
+		if (vector_start + STANDARD_VECTOR_SIZE <= MinValue<idx_t>(end, entry->second)) {
+			return vector_start;
+		}
+	}
+	return end;
+}
+
+//! Returns whether or not one of the reusable blocks of the segment holds data of the next segment as well
+static bool BlocksExtendPastSegment(ColumnSegment &segment) {
+	for (auto &block : segment.GetCheckpointBlocks()) {
+		auto &pointer = block->pointer;
+		if (!block->modified && pointer.row_start + pointer.tuple_count > segment.start + segment.count) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void TableDataWriter::InitializeTableData(ClientContext &context) {
+	transaction = &Transaction::GetTransaction(context);
+	// no transaction can commit while the checkpoint is written: the segments of the columns do not change until the
+	// checkpoint has finished, so they can be divided into ranges up front. a range never ends in the middle of a
+	// block that can be reused, since the blocks of a range cannot be shared with other ranges
+	for (idx_t col_idx = 0; col_idx < table.types.size(); col_idx++) {
+		auto &column = table.GetColumnData(col_idx);
+		auto segment = (ColumnSegment *)column.data.GetRootSegment();
+		while (segment) {
+			auto range = make_unique<ColumnWriteRange>();
+			range->col_idx = col_idx;
+			range->row_start = segment->start;
+			range->start_segment = segment;
+			range->segment_count = 0;
+			idx_t row_count = 0;
+			while (segment) {
+				range->segment_count++;
+				row_count += segment->count;
+				bool extends_past_segment = BlocksExtendPastSegment(*segment);
+				segment = (ColumnSegment *)segment->next.get();
+				if (row_count >= VECTORS_PER_RANGE * STANDARD_VECTOR_SIZE && !extends_past_segment) {
+					break;
+				}
+			}
+			ranges.push_back(move(range));
+		}
+	}
+	// deleted rows are not removed from the table: instead, the deletes are written alongside the data. this keeps
+	// the row ids of the table equal to the row ids of the in-memory table (which are referenced by the WAL), and
+	// allows every column to be written separately. the values of deleted rows are dropped, however: they are written
+	// as NULL values, and vectors of which every row has been deleted are not written at all
+	deletes = table.GetCommittedDeletes(*transaction);
+}
+
+idx_t TableDataWriter::RangeCount() {
+	return ranges.size();
+}
+
+void TableDataWriter::WriteRange(idx_t range_idx) {
+	auto &range = *ranges[range_idx];
+	// modifications of the segments from this point on invalidate the blocks that their data is written to
+	idx_t range_end = range.start_segment->start;
+	auto segment = range.start_segment;
+	for (idx_t i = 0; i < range.segment_count; i++, segment = (ColumnSegment *)segment->next.get()) {
+		segment->BeginCheckpoint();
+		range_end = segment->start + segment->count;
 	}
 
-	// now start scanning the table and append the data to the uncompressed segments
-	vector<column_t> column_ids;
-	for (auto &column : table.columns) {
-		column_ids.push_back(column.oid);
+	idx_t row = range.start_segment->start;
+	segment = range.start_segment;
+	for (idx_t i = 0; i < range.segment_count; i++, segment = (ColumnSegment *)segment->next.get()) {
+		idx_t segment_end = segment->start + segment->count;
+		auto blocks = segment->GetCheckpointBlocks();
+		while (row < segment_end) {
+			// look for an unmodified block of the previous checkpoint that starts at the current row
+			shared_ptr<CheckpointBlock> existing_block;
+			idx_t write_end = segment_end;
+			for (auto &block : blocks) {
+				auto &pointer = block->pointer;
+				if (block->modified || pointer.row_start + pointer.tuple_count > range_end) {
+					continue;
+				}
+				if (CountDeletedRows(deletes, pointer.row_start, pointer.row_start + pointer.tuple_count) !=
+				    block->deleted_count) {
+					// rows of the block have been deleted since it was written: rewrite it to drop their values
+					continue;
+				}
+				if (pointer.row_start == row) {
+					existing_block = block;
+				} else if (pointer.row_start > row && pointer.row_start < write_end) {
+					write_end = pointer.row_start;
+				}
+			}
+			if (existing_block) {
+				// the data of the block has not been modified: refer to the existing block
+				FlushSegment(range);
+				row += existing_block->pointer.tuple_count;
+				WriteExistingBlock(range, move(existing_block));
+				continue;
+			}
+			// vectors of which every row has been deleted are written without any data
+			idx_t deleted_start = FindDeletedVector(deletes, row, write_end);
+			if (deleted_start == row) {
+				idx_t deleted_end = MinValue<idx_t>(FindDeleteRange(deletes, row)->second, write_end);
+				deleted_end = row + (deleted_end - row) / STANDARD_VECTOR_SIZE * STANDARD_VECTOR_SIZE;
+				WriteDeletedRows(range, row, deleted_end);
+				row = deleted_end;
+				continue;
+			}
+			// the other rows are new or have been modified: append them to the block that is currently being written,
+			// so the data of consecutive segments is packed together
+			WriteRows(range, *segment, row, deleted_start);
+			row = deleted_start;
+		}
 	}
-	// initialize scan structures to prepare for the scan
-	TableScanState state;
-	table.storage->InitializeScan(transaction, state, column_ids);
-	//! get all types of the table and initialize the chunk
-	auto types = table.GetTypes();
+	FlushSegment(range);
+	range.segment.reset();
+	range.stats.reset();
+
+	// hand every segment the blocks that hold its data, so the next checkpoint can reuse them
+	idx_t block_idx = 0;
+	segment = range.start_segment;
+	for (idx_t i = 0; i < range.segment_count; i++, segment = (ColumnSegment *)segment->next.get()) {
+		idx_t segment_end = segment->start + segment->count;
+		while (block_idx < range.blocks.size() &&
+		       range.blocks[block_idx]->pointer.row_start + range.blocks[block_idx]->pointer.tuple_count <=
+		           segment->start) {
+			block_idx++;
+		}
+		vector<shared_ptr<CheckpointBlock>> segment_blocks;
+		for (idx_t k = block_idx; k < range.blocks.size() && range.blocks[k]->pointer.row_start < segment_end; k++) {
+			segment_blocks.push_back(range.blocks[k]);
+		}
+		segment->SetCheckpointBlocks(move(segment_blocks));
+	}
+}
+
+void TableDataWriter::WriteRows(ColumnWriteRange &range, ColumnSegment &segment, idx_t start, idx_t end) {
+	vector<LogicalType> types {table.types[range.col_idx]};
 	DataChunk chunk;
 	chunk.Initialize(types);
 
-	while (true) {
+	ColumnScanState state;
+	segment.InitializeScan(state);
+	for (idx_t vector_index = (start - segment.start) / STANDARD_VECTOR_SIZE;
+	     segment.start + vector_index * STANDARD_VECTOR_SIZE < end; vector_index++) {
+		idx_t vector_start = segment.start + vector_index * STANDARD_VECTOR_SIZE;
 		chunk.Reset();
-		// now scan the table to construct the blocks
-		table.storage->Scan(transaction, chunk, state, column_ids);
-		if (chunk.size() == 0) {
-			break;
-		}
-		// for each column, we append whatever we can fit into the block
-		idx_t chunk_size = chunk.size();
-		for (idx_t i = 0; i < table.columns.size(); i++) {
-			D_ASSERT(chunk.data[i].type == table.columns[i].type);
-			AppendData(transaction, i, chunk.data[i], chunk_size);
+		segment.Scan(*transaction, state, vector_index, chunk.data[0]);
+		idx_t offset = MaxValue<idx_t>(start, vector_start) - vector_start;
+		idx_t count = MinValue<idx_t>(end, vector_start + STANDARD_VECTOR_SIZE) - vector_start - offset;
+		// the values of deleted rows are never read again: store them as NULL values
+		for (auto entry = FindDeleteRange(deletes, vector_start + offset);
+		     entry != deletes.end() && entry->first < vector_start + offset + count; entry++) {
+			idx_t delete_end = MinValue<idx_t>(entry->second, vector_start + offset + count);
+			for (idx_t row = MaxValue<idx_t>(entry->first, vector_start + offset); row < delete_end; row++) {
+				FlatVector::SetNull(chunk.data[0], row - vector_start, true);
+			}
 		}
+		AppendData(range, chunk.data[0], offset, count);
 	}
-	// flush any remaining data and write the data pointers to disk
-	for (idx_t i = 0; i < table.columns.size(); i++) {
-		FlushSegment(transaction, i);
-	}
-	VerifyDataPointers();
-	WriteDataPointers();
 }
 
-void TableDataWriter::CreateSegment(idx_t col_idx) {
-	auto type_id = table.columns[col_idx].type.InternalType();
+//! Strings are stored in dictionary segments, all other types are stored in compressed segments
+static CompressionType GetCompressionType(PhysicalType type) {
+	return type == PhysicalType::VARCHAR ? CompressionType::DICTIONARY : CompressionType::COMPRESSED;
+}
+
+void TableDataWriter::CreateSegment(ColumnWriteRange &range) {
+	auto &type = table.types[range.col_idx];
+	auto type_id = type.InternalType();
 	if (type_id == PhysicalType::VARCHAR) {
 		auto string_segment = make_unique<StringSegment>(manager.buffer_manager, 0);
 		string_segment->overflow_writer = make_unique<WriteOverflowStringsToDisk>(manager);
-		segments[col_idx] = move(string_segment);
+		string_segment->dictionary_offsets = make_unique<unordered_map<string, int32_t>>();
+		range.segment = move(string_segment);
 	} else {
-		segments[col_idx] = make_unique<NumericSegment>(manager.buffer_manager, type_id, 0);
+		range.segment = make_unique<CompressedSegment>(manager.buffer_manager, type_id, 0);
 	}
+	range.stats = make_unique<SegmentStatistics>(type, GetTypeIdSize(type_id));
 }
 
-void TableDataWriter::AppendData(Transaction &transaction, idx_t col_idx, Vector &data, idx_t count) {
-	idx_t offset = 0;
+void TableDataWriter::AppendData(ColumnWriteRange &range, Vector &data, idx_t offset, idx_t count) {
 	while (count > 0) {
-		idx_t appended = segments[col_idx]->Append(*stats[col_idx], data, offset, count);
+		if (!range.segment) {
+			CreateSegment(range);
+		}
+		idx_t appended = range.segment->Append(*range.stats, data, offset, count);
 		if (appended == count) {
 			// appended everything: finished
 			return;
 		}
-		// the segment is full: flush it to disk
-		FlushSegment(transaction, col_idx);
-
-		// now create a new segment and continue appending
-		CreateSegment(col_idx);
+		// the segment is full: flush it to disk and continue appending to a new segment
+		FlushSegment(range);
 		offset += appended;
 		count -= appended;
 	}
 }
 
-void TableDataWriter::FlushSegment(Transaction &transaction, idx_t col_idx) {
-	auto tuple_count = segments[col_idx]->tuple_count;
-	if (tuple_count == 0) {
+//! Returns the row at which the next block of the range starts
+static idx_t GetNextRowStart(ColumnWriteRange &range) {
+	if (range.blocks.empty()) {
+		return range.row_start;
+	}
+	auto &last_pointer = range.blocks.back()->pointer;
+	return last_pointer.row_start + last_pointer.tuple_count;
+}
+
+void TableDataWriter::FlushSegment(ColumnWriteRange &range) {
+	if (!range.segment || range.segment->tuple_count == 0) {
 		return;
 	}
+	auto tuple_count = range.segment->tuple_count;
+	auto type_id = table.types[range.col_idx].InternalType();
 
 	// get the buffer of the segment and pin it
-	auto handle = manager.buffer_manager.Pin(segments[col_idx]->block);
+	auto handle = manager.buffer_manager.Pin(range.segment->block);
 
 	// get a free block id to write to
 	auto block_id = manager.block_manager.GetFreeBlockId();
@@ -139,52 +294,96 @@ void TableDataWriter::FlushSegment(Transaction &transaction, idx_t col_idx) {
 	DataPointer data_pointer;
 	data_pointer.block_id = block_id;
 	data_pointer.offset = 0;
-	data_pointer.row_start = 0;
-	if (data_pointers[col_idx].size() > 0) {
-		auto &last_pointer = data_pointers[col_idx].back();
-		data_pointer.row_start = last_pointer.row_start + last_pointer.tuple_count;
-	}
+	data_pointer.row_start = GetNextRowStart(range);
 	data_pointer.tuple_count = tuple_count;
-	data_pointer.statistics = stats[col_idx]->statistics->Copy();
-	data_pointers[col_idx].push_back(move(data_pointer));
+	data_pointer.compression = GetCompressionType(type_id);
+	data_pointer.statistics = range.stats->statistics->Copy();
+	if (type_id == PhysicalType::VARCHAR) {
+		auto &string_segment = (StringSegment &)*range.segment;
+		data_pointer.overflow_blocks = ((WriteOverflowStringsToDisk &)*string_segment.overflow_writer).blocks;
+	}
+	auto deleted_count = CountDeletedRows(deletes, data_pointer.row_start, data_pointer.row_start + tuple_count);
+	range.blocks.push_back(make_shared<CheckpointBlock>(move(data_pointer), deleted_count));
 	// write the block to disk
 	manager.block_manager.Write(*handle->node, block_id);
 
-	column_stats[col_idx]->Merge(*stats[col_idx]->statistics);
-	stats[col_idx] = make_unique<SegmentStatistics>(table.columns[col_idx].type,
-	                                                GetTypeIdSize(table.columns[col_idx].type.InternalType()));
 	handle.reset();
-	segments[col_idx] = nullptr;
+	range.segment = nullptr;
+	range.stats = nullptr;
+}
+
+void TableDataWriter::WriteDeletedRows(ColumnWriteRange &range, idx_t start, idx_t end) {
+	FlushSegment(range);
+	D_ASSERT(GetNextRowStart(range) == start);
+	// no block is written: the rows only need to exist so the row ids of the rows after them are unchanged
+	DataPointer data_pointer;
+	data_pointer.block_id = INVALID_BLOCK;
+	data_pointer.offset = 0;
+	data_pointer.row_start = start;
+	data_pointer.tuple_count = end - start;
+	data_pointer.compression = CompressionType::EMPTY;
+	data_pointer.statistics = BaseStatistics::CreateEmpty(table.types[range.col_idx]);
+	range.blocks.push_back(make_shared<CheckpointBlock>(move(data_pointer), end - start));
+}
+
+void TableDataWriter::WriteExistingBlock(ColumnWriteRange &range, shared_ptr<CheckpointBlock> block) {
+	D_ASSERT(!range.segment || range.segment->tuple_count == 0);
+	D_ASSERT(GetNextRowStart(range) == block->pointer.row_start);
+	// the block has been written by a previous checkpoint: mark it as used by this checkpoint
+	if (block->pointer.block_id != INVALID_BLOCK) {
+		manager.block_manager.MarkBlockAsUsed(block->pointer.block_id);
+	}
+	for (auto &overflow_block : block->pointer.overflow_blocks) {
+		manager.block_manager.MarkBlockAsUsed(overflow_block);
+	}
+	range.blocks.push_back(move(block));
 }
 
 void TableDataWriter::VerifyDataPointers() {
-	// verify the data pointers
-	idx_t table_count = 0;
-	for (idx_t i = 0; i < data_pointers.size(); i++) {
-		auto &data_pointer_list = data_pointers[i];
-		idx_t column_count = 0;
-		// then write the data pointers themselves
-		for (idx_t k = 0; k < data_pointer_list.size(); k++) {
-			auto &data_pointer = data_pointer_list[k];
-			column_count += data_pointer.tuple_count;
-		}
-		if (segments[i]) {
-			column_count += segments[i]->tuple_count;
-		}
-		if (i == 0) {
-			table_count = column_count;
-		} else {
-			if (table_count != column_count) {
-				throw Exception("Column count mismatch in data write!");
+	// verify that every column has the same amount of rows, and that the data pointers of a column are contiguous
+	vector<idx_t> column_counts(table.types.size(), 0);
+	for (auto &range : ranges) {
+		for (auto &block : range->blocks) {
+			auto &data_pointer = block->pointer;
+			if (data_pointer.row_start != column_counts[range->col_idx]) {
+				throw Exception("Data pointers of a column are not contiguous in data write!");
 			}
+			column_counts[range->col_idx] += data_pointer.tuple_count;
+		}
+	}
+	for (idx_t i = 1; i < column_counts.size(); i++) {
+		if (column_counts[i] != column_counts[0]) {
+			throw Exception("Column count mismatch in data write!");
 		}
 	}
 }
 
 void TableDataWriter::WriteDataPointers() {
+	VerifyDataPointers();
+
+	// gather the data pointers of the ranges per column, and compute the statistics of the columns
+	vector<vector<DataPointer *>> data_pointers(table.types.size());
+	vector<unique_ptr<BaseStatistics>> column_stats;
+	for (idx_t i = 0; i < table.types.size(); i++) {
+		column_stats.push_back(BaseStatistics::CreateEmpty(table.types[i]));
+	}
+	for (auto &range : ranges) {
+		for (auto &block : range->blocks) {
+			column_stats[range->col_idx]->Merge(*block->pointer.statistics);
+			data_pointers[range->col_idx].push_back(&block->pointer);
+		}
+	}
 	for (auto &stats : column_stats) {
 		stats->Serialize(*manager.tabledata_writer);
 	}
+	// write the histograms that were collected by ANALYZE
+	for (idx_t i = 0; i < table.types.size(); i++) {
+		auto histogram = table.GetColumnData(i).GetHistogram();
+		manager.tabledata_writer->Write<bool>(histogram ? true : false);
+		if (histogram) {
+			histogram->Serialize(*manager.tabledata_writer);
+		}
+	}
 
 	for (idx_t i = 0; i < data_pointers.size(); i++) {
 		// get a reference to the data column
@@ -192,14 +391,50 @@ void TableDataWriter::WriteDataPointers() {
 		manager.tabledata_writer->Write<idx_t>(data_pointer_list.size());
 		// then write the data pointers themselves
 		for (idx_t k = 0; k < data_pointer_list.size(); k++) {
-			auto &data_pointer = data_pointer_list[k];
-			manager.tabledata_writer->Write<idx_t>(data_pointer.row_start);
-			manager.tabledata_writer->Write<idx_t>(data_pointer.tuple_count);
-			manager.tabledata_writer->Write<block_id_t>(data_pointer.block_id);
-			manager.tabledata_writer->Write<uint32_t>(data_pointer.offset);
-			data_pointer.statistics->Serialize(*manager.tabledata_writer);
+			data_pointer_list[k]->Serialize(*manager.tabledata_writer);
+		}
+	}
+
+	// finally write the deleted rows
+	manager.tabledata_writer->Write<idx_t>(deletes.size());
+	for (auto &range : deletes) {
+		manager.tabledata_writer->Write<idx_t>(range.first);
+		manager.tabledata_writer->Write<idx_t>(range.second);
+	}
+}
+
+unique_ptr<AppendBlocks> TableDataWriter::WriteAppend(idx_t start_row, idx_t count) {
+	D_ASSERT(ranges.empty());
+	for (idx_t col_idx = 0; col_idx < table.types.size(); col_idx++) {
+		auto range = make_unique<ColumnWriteRange>();
+		range->col_idx = col_idx;
+		range->row_start = start_row;
+		range->start_segment = nullptr;
+		range->segment_count = 0;
+		ranges.push_back(move(range));
+	}
+	// the first chunk of the scan ends at a vector boundary. if the append does not start at a vector boundary, the
+	// first chunk is written to a block of its own: the blocks after it then start at vector boundaries, which allows
+	// the next checkpoint to reuse them
+	bool aligned = start_row % STANDARD_VECTOR_SIZE == 0;
+	table.ScanTableSegment(start_row, count, [&](DataChunk &chunk) {
+		for (idx_t col_idx = 0; col_idx < ranges.size(); col_idx++) {
+			AppendData(*ranges[col_idx], chunk.data[col_idx], 0, chunk.size());
+			if (!aligned) {
+				FlushSegment(*ranges[col_idx]);
+			}
 		}
+		aligned = true;
+	});
+	auto result = make_unique<AppendBlocks>();
+	result->start_row = start_row;
+	result->count = count;
+	for (auto &range : ranges) {
+		FlushSegment(*range);
+		result->columns.push_back(move(range->blocks));
 	}
+	ranges.clear();
+	return result;
 }
 
 WriteOverflowStringsToDisk::WriteOverflowStringsToDisk(CheckpointManager &manager)
@@ -257,6 +492,7 @@ void WriteOverflowStringsToDisk::AllocateNewBlock(block_id_t new_block_id) {
 	}
 	offset = 0;
 	block_id = new_block_id;
+	blocks.push_back(new_block_id);
 }
 
 } // namespace duckdb
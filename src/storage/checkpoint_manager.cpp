@@ -24,6 +24,8 @@
 #include "duckdb/main/connection.hpp"
 #include "duckdb/main/database.hpp"
 
+#include "duckdb/parallel/task_group.hpp"
+
 #include "duckdb/transaction/transaction_manager.hpp"
 
 #include "duckdb/storage/checkpoint/table_data_writer.hpp"
@@ -38,6 +40,9 @@ CheckpointManager::CheckpointManager(StorageManager &manager)
     : block_manager(*manager.block_manager), buffer_manager(*manager.buffer_manager), database(manager.database) {
 }
 
+CheckpointManager::~CheckpointManager() {
+}
+
 void CheckpointManager::CreateCheckpoint() {
 	// assert that the checkpoint manager hasn't been used before
 	D_ASSERT(!metadata_writer);
@@ -58,7 +63,8 @@ void CheckpointManager::CreateCheckpoint() {
 	// we scan the schemas
 	database.catalog->schemas->Scan(*con.context,
 	                                [&](CatalogEntry *entry) { schemas.push_back((SchemaCatalogEntry *)entry); });
-	// write the actual data into the database
+	// first write the data of the tables, then write the metadata of the schemas in order
+	WriteTableData(*con.context, schemas);
 	// write the amount of schemas
 	metadata_writer->Write<uint32_t>(schemas.size());
 	for (auto &schema : schemas) {
@@ -68,10 +74,43 @@ void CheckpointManager::CreateCheckpoint() {
 	metadata_writer->Flush();
 	tabledata_writer->Flush();
 
+	// blocks of the previous checkpoint can still be read by in-memory segments (e.g. the segments of a dropped table
+	// that is still visible to a running transaction): these blocks cannot be reused until they are no longer referred
+	// to, so they are treated as used by this checkpoint
+	for (auto &block_id : buffer_manager.GetRegisteredBlocks()) {
+		block_manager.MarkBlockAsUsed(block_id);
+	}
+
 	// finally write the updated header
 	DatabaseHeader header;
 	header.meta_block = meta_block;
 	block_manager.WriteHeader(header);
+
+	con.Rollback();
+}
+
+void CheckpointManager::WriteTableData(ClientContext &context, vector<SchemaCatalogEntry *> &schemas) {
+	for (auto &schema : schemas) {
+		schema->tables.Scan(context, [&](CatalogEntry *entry) {
+			if (entry->type != CatalogType::TABLE_ENTRY) {
+				return;
+			}
+			auto table = (TableCatalogEntry *)entry;
+			auto writer = make_unique<TableDataWriter>(*this, *table->storage);
+			writer->InitializeTableData(context);
+			table_writers[table] = move(writer);
+		});
+	}
+
+	// write every range of every table in a separate task
+	TaskGroup tasks(TaskScheduler::GetScheduler(context));
+	for (auto &entry : table_writers) {
+		auto writer = entry.second.get();
+		for (idx_t range_idx = 0; range_idx < writer->RangeCount(); range_idx++) {
+			tasks.Schedule([writer, range_idx]() { writer->WriteRange(range_idx); });
+		}
+	}
+	tasks.Finish();
 }
 
 void CheckpointManager::LoadFromStorage() {
@@ -220,9 +259,10 @@ void CheckpointManager::WriteTable(ClientContext &context, TableCatalogEntry &ta
 	metadata_writer->Write<block_id_t>(tabledata_writer->block->id);
 	//! and the offset to where the info starts
 	metadata_writer->Write<uint64_t>(tabledata_writer->offset);
-	// now we need to write the table data
-	TableDataWriter writer(*this, table);
-	writer.WriteTableData(context);
+	// the data of the table has already been written: now write the pointers to it
+	auto entry = table_writers.find(&table);
+	D_ASSERT(entry != table_writers.end());
+	entry->second->WriteDataPointers();
 }
 
 void CheckpointManager::ReadTable(ClientContext &context, MetaBlockReader &reader) {
@@ -106,7 +106,12 @@ void ColumnData::InitializeAppend(ColumnAppendState &state) {
 		AppendTransientSegment(persistent_rows);
 	}
 	auto segment = (ColumnSegment *)data.GetLastSegment();
-	if (segment->segment_type == ColumnSegmentType::PERSISTENT) {
+	if (segment->segment_type == ColumnSegmentType::PERSISTENT &&
+	    ((PersistentSegment *)segment)->block_id == INVALID_BLOCK) {
+		// every row of the last segment has been deleted and no data is stored for it: append a new segment
+		AppendTransientSegment(segment->start + segment->count);
+		state.current = (TransientSegment *)data.GetLastSegment();
+	} else if (segment->segment_type == ColumnSegmentType::PERSISTENT) {
 		// cannot append to persistent segment, convert the last segment into a transient segment
 		auto transient = make_unique<TransientSegment>((PersistentSegment &)*segment);
 		state.current = (TransientSegment *)transient.get();
@@ -169,6 +174,33 @@ void ColumnData::RevertAppend(row_t start_row) {
 	transient.RevertAppend(start_row);
 }
 
+void ColumnData::AddCheckpointBlocks(vector<shared_ptr<CheckpointBlock>> &blocks) {
+	lock_guard<mutex> tree_lock(data.node_lock);
+	for (auto &block : blocks) {
+		auto &pointer = block->pointer;
+		if (pointer.row_start % STANDARD_VECTOR_SIZE != 0 || pointer.tuple_count % STANDARD_VECTOR_SIZE != 0) {
+			// the data pointers of a checkpoint have to start at a vector boundary
+			continue;
+		}
+		// the block can hold the rows of several segments
+		idx_t end = pointer.row_start + pointer.tuple_count;
+		for (idx_t segment_idx = data.GetSegmentIndex(pointer.row_start);
+		     segment_idx < data.nodes.size() && data.nodes[segment_idx].row_start < end; segment_idx++) {
+			((ColumnSegment *)data.nodes[segment_idx].node)->AddCheckpointBlock(block);
+		}
+	}
+}
+
+shared_ptr<Histogram> ColumnData::GetHistogram() {
+	lock_guard<mutex> lock(histogram_lock);
+	return histogram;
+}
+
+void ColumnData::SetHistogram(shared_ptr<Histogram> new_histogram) {
+	lock_guard<mutex> lock(histogram_lock);
+	histogram = move(new_histogram);
+}
+
 void ColumnData::Update(Transaction &transaction, Vector &updates, Vector &row_ids, idx_t count) {
 	// first find the segment that the update belongs to
 	idx_t first_id = FlatVector::GetValue<row_t>(row_ids, 0);
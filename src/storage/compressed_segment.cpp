@@ -0,0 +1,548 @@
+#include "duckdb/storage/compressed_segment.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/storage/table/append_state.hpp"
+#include "duckdb/transaction/update_info.hpp"
+#include "duckdb/transaction/transaction.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/planner/table_filter.hpp"
+
+#include <type_traits>
+
+using namespace std;
+
+namespace duckdb {
+
+//! The size of the header of an encoded vector: the encoding and whether or not the vector has a nullmask
+static constexpr idx_t VECTOR_HEADER_SIZE = 2 * sizeof(uint8_t);
+
+CompressedSegment::CompressedSegment(BufferManager &manager, PhysicalType type, idx_t row_start, block_id_t block_id,
+                                     idx_t count)
+    : NumericSegment(manager, type, row_start, block_id), data_size(0) {
+	if (block_id == INVALID_BLOCK) {
+		// new segment: the values of the vector that is being appended are gathered in an uncompressed segment
+		this->max_vector_count = MAX_VECTOR_COUNT;
+		this->pending = make_unique<NumericSegment>(manager, type, 0);
+	} else {
+		this->max_vector_count = count / STANDARD_VECTOR_SIZE + (count % STANDARD_VECTOR_SIZE == 0 ? 0 : 1);
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Encoding
+//===--------------------------------------------------------------------===//
+template <class T>
+static inline bool BitwiseEquals(const T &left, const T &right) {
+	return memcmp(&left, &right, sizeof(T)) == 0;
+}
+
+//! Frame-of-reference bit-packing of integers: every value is stored as the offset from the minimum value of the
+//! vector, using the amount of bits required to store the largest offset
+template <class T, bool INTEGRAL = std::is_integral<T>::value>
+struct BitPacking {
+	static bool Analyze(T *values, idx_t count, T &min, uint8_t &width) {
+		return false;
+	}
+	static idx_t EncodedSize(idx_t count, uint8_t width) {
+		throw InternalException("Bit-packing is only supported for integers");
+	}
+	static idx_t Encode(T *values, idx_t count, T min, uint8_t width, data_ptr_t target) {
+		throw InternalException("Bit-packing is only supported for integers");
+	}
+	static void Decode(data_ptr_t source, idx_t count, T *result) {
+		throw InternalException("Bit-packing is only supported for integers");
+	}
+};
+
+template <class T>
+struct BitPacking<T, true> {
+	static inline uint64_t GetDelta(T value, T min) {
+		return uint64_t(int64_t(value)) - uint64_t(int64_t(min));
+	}
+
+	static bool Analyze(T *values, idx_t count, T &min, uint8_t &width) {
+		T max = values[0];
+		min = values[0];
+		for (idx_t i = 1; i < count; i++) {
+			if (values[i] < min) {
+				min = values[i];
+			}
+			if (values[i] > max) {
+				max = values[i];
+			}
+		}
+		auto range = GetDelta(max, min);
+		width = 0;
+		while (range > 0) {
+			width++;
+			range >>= 1;
+		}
+		return true;
+	}
+
+	static idx_t WordCount(idx_t count, uint8_t width) {
+		return (count * width + 63) / 64;
+	}
+
+	static idx_t EncodedSize(idx_t count, uint8_t width) {
+		return sizeof(T) + sizeof(uint8_t) + WordCount(count, width) * sizeof(uint64_t);
+	}
+
+	static idx_t Encode(T *values, idx_t count, T min, uint8_t width, data_ptr_t target) {
+		uint64_t words[STANDARD_VECTOR_SIZE];
+		idx_t word_count = WordCount(count, width);
+		memset(words, 0, word_count * sizeof(uint64_t));
+		for (idx_t i = 0; i < count && width > 0; i++) {
+			auto delta = GetDelta(values[i], min);
+			idx_t bit = i * width;
+			idx_t word = bit / 64;
+			idx_t shift = bit % 64;
+			words[word] |= delta << shift;
+			if (shift + width > 64) {
+				words[word + 1] |= delta >> (64 - shift);
+			}
+		}
+		Store<T>(min, target);
+		Store<uint8_t>(width, target + sizeof(T));
+		memcpy(target + sizeof(T) + sizeof(uint8_t), words, word_count * sizeof(uint64_t));
+		return EncodedSize(count, width);
+	}
+
+	static void Decode(data_ptr_t source, idx_t count, T *result) {
+		auto min = Load<T>(source);
+		auto width = Load<uint8_t>(source + sizeof(T));
+		if (width == 0) {
+			for (idx_t i = 0; i < count; i++) {
+				result[i] = min;
+			}
+			return;
+		}
+		uint64_t words[STANDARD_VECTOR_SIZE];
+		memcpy(words, source + sizeof(T) + sizeof(uint8_t), WordCount(count, width) * sizeof(uint64_t));
+		uint64_t mask = width == 64 ? NumericLimits<uint64_t>::Maximum() : (uint64_t(1) << width) - 1;
+		auto base = uint64_t(int64_t(min));
+		for (idx_t i = 0; i < count; i++) {
+			idx_t bit = i * width;
+			idx_t word = bit / 64;
+			idx_t shift = bit % 64;
+			uint64_t delta = words[word] >> shift;
+			if (shift + width > 64) {
+				delta |= words[word + 1] << (64 - shift);
+			}
+			result[i] = T(int64_t(base + (delta & mask)));
+		}
+	}
+};
+
+template <class T>
+static idx_t EncodeVector(data_ptr_t source, nullmask_t &nullmask, idx_t count, data_ptr_t target) {
+	// copy over the values, null values take on the value of the preceding (or first) non-null value so that they do
+	// not break up runs or extend the value range
+	T values[STANDARD_VECTOR_SIZE];
+	memcpy(values, source, count * sizeof(T));
+	bool has_nulls = nullmask.any();
+	if (has_nulls) {
+		T last_value;
+		memset(&last_value, 0, sizeof(T));
+		for (idx_t i = 0; i < count; i++) {
+			if (!nullmask[i]) {
+				last_value = values[i];
+				break;
+			}
+		}
+		for (idx_t i = 0; i < count; i++) {
+			if (nullmask[i]) {
+				values[i] = last_value;
+			} else {
+				last_value = values[i];
+			}
+		}
+	}
+	// figure out the size of the vector for each of the encodings
+	idx_t run_count = 1;
+	for (idx_t i = 1; i < count; i++) {
+		run_count += !BitwiseEquals<T>(values[i - 1], values[i]);
+	}
+	auto encoding = VectorEncoding::UNCOMPRESSED;
+	idx_t encoded_size = count * sizeof(T);
+	if (run_count == 1) {
+		encoding = VectorEncoding::CONSTANT;
+		encoded_size = sizeof(T);
+	} else {
+		idx_t rle_size = sizeof(uint16_t) + run_count * (sizeof(T) + sizeof(uint16_t));
+		if (rle_size < encoded_size) {
+			encoding = VectorEncoding::RLE;
+			encoded_size = rle_size;
+		}
+	}
+	T min;
+	uint8_t width;
+	if (encoding != VectorEncoding::CONSTANT && BitPacking<T>::Analyze(values, count, min, width)) {
+		idx_t bitpacking_size = BitPacking<T>::EncodedSize(count, width);
+		if (bitpacking_size < encoded_size) {
+			encoding = VectorEncoding::BITPACKING;
+		}
+	}
+
+	// write the header of the vector
+	Store<uint8_t>((uint8_t)encoding, target);
+	Store<uint8_t>(has_nulls, target + sizeof(uint8_t));
+	idx_t header_size = VECTOR_HEADER_SIZE;
+	if (has_nulls) {
+		memcpy(target + header_size, &nullmask, sizeof(nullmask_t));
+		header_size += sizeof(nullmask_t);
+	}
+	auto payload = target + header_size;
+	switch (encoding) {
+	case VectorEncoding::CONSTANT:
+		Store<T>(values[0], payload);
+		return header_size + sizeof(T);
+	case VectorEncoding::RLE: {
+		Store<uint16_t>(run_count, payload);
+		auto run_values = payload + sizeof(uint16_t);
+		auto run_lengths = run_values + run_count * sizeof(T);
+		idx_t run_idx = 0;
+		uint16_t run_length = 1;
+		for (idx_t i = 1; i <= count; i++) {
+			if (i == count || !BitwiseEquals<T>(values[i - 1], values[i])) {
+				Store<T>(values[i - 1], run_values + run_idx * sizeof(T));
+				Store<uint16_t>(run_length, run_lengths + run_idx * sizeof(uint16_t));
+				run_idx++;
+				run_length = 1;
+			} else {
+				run_length++;
+			}
+		}
+		D_ASSERT(run_idx == run_count);
+		return header_size + sizeof(uint16_t) + run_count * (sizeof(T) + sizeof(uint16_t));
+	}
+	case VectorEncoding::BITPACKING:
+		return header_size + BitPacking<T>::Encode(values, count, min, width, payload);
+	default:
+		memcpy(payload, values, count * sizeof(T));
+		return header_size + count * sizeof(T);
+	}
+}
+
+template <class T>
+static void DecodeVector(data_ptr_t source, idx_t count, nullmask_t &nullmask, T *result) {
+	auto encoding = (VectorEncoding)Load<uint8_t>(source);
+	auto has_nulls = Load<uint8_t>(source + sizeof(uint8_t));
+	auto payload = source + VECTOR_HEADER_SIZE;
+	if (has_nulls) {
+		memcpy(&nullmask, payload, sizeof(nullmask_t));
+		payload += sizeof(nullmask_t);
+	} else {
+		nullmask.reset();
+	}
+	switch (encoding) {
+	case VectorEncoding::CONSTANT: {
+		auto constant = Load<T>(payload);
+		for (idx_t i = 0; i < count; i++) {
+			result[i] = constant;
+		}
+		break;
+	}
+	case VectorEncoding::RLE: {
+		auto run_count = Load<uint16_t>(payload);
+		auto run_values = payload + sizeof(uint16_t);
+		auto run_lengths = run_values + run_count * sizeof(T);
+		idx_t result_idx = 0;
+		for (idx_t run_idx = 0; run_idx < run_count; run_idx++) {
+			auto value = Load<T>(run_values + run_idx * sizeof(T));
+			auto run_length = Load<uint16_t>(run_lengths + run_idx * sizeof(uint16_t));
+			D_ASSERT(result_idx + run_length <= count);
+			for (idx_t i = 0; i < run_length; i++) {
+				result[result_idx++] = value;
+			}
+		}
+		break;
+	}
+	case VectorEncoding::BITPACKING:
+		BitPacking<T>::Decode(payload, count, result);
+		break;
+	case VectorEncoding::UNCOMPRESSED:
+		memcpy(result, payload, count * sizeof(T));
+		break;
+	default:
+		throw InternalException("Unsupported vector encoding in compressed segment");
+	}
+}
+
+static idx_t EncodeVector(PhysicalType type, data_ptr_t source, nullmask_t &nullmask, idx_t count,
+                          data_ptr_t target) {
+	switch (type) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+		return EncodeVector<int8_t>(source, nullmask, count, target);
+	case PhysicalType::INT16:
+		return EncodeVector<int16_t>(source, nullmask, count, target);
+	case PhysicalType::INT32:
+		return EncodeVector<int32_t>(source, nullmask, count, target);
+	case PhysicalType::INT64:
+		return EncodeVector<int64_t>(source, nullmask, count, target);
+	case PhysicalType::INT128:
+		return EncodeVector<hugeint_t>(source, nullmask, count, target);
+	case PhysicalType::FLOAT:
+		return EncodeVector<float>(source, nullmask, count, target);
+	case PhysicalType::DOUBLE:
+		return EncodeVector<double>(source, nullmask, count, target);
+	case PhysicalType::INTERVAL:
+		return EncodeVector<interval_t>(source, nullmask, count, target);
+	default:
+		throw InvalidTypeException(type, "Unsupported type for compressed segment");
+	}
+}
+
+void CompressedSegment::DecodeVector(data_ptr_t block_data, idx_t vector_index, nullmask_t &nullmask,
+                                     data_ptr_t data) {
+	auto vector_offset = Load<uint32_t>(block_data + Storage::BLOCK_SIZE - (vector_index + 1) * sizeof(uint32_t));
+	auto source = block_data + vector_offset;
+	auto count = GetVectorCount(vector_index);
+	switch (type) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+		duckdb::DecodeVector<int8_t>(source, count, nullmask, (int8_t *)data);
+		break;
+	case PhysicalType::INT16:
+		duckdb::DecodeVector<int16_t>(source, count, nullmask, (int16_t *)data);
+		break;
+	case PhysicalType::INT32:
+		duckdb::DecodeVector<int32_t>(source, count, nullmask, (int32_t *)data);
+		break;
+	case PhysicalType::INT64:
+		duckdb::DecodeVector<int64_t>(source, count, nullmask, (int64_t *)data);
+		break;
+	case PhysicalType::INT128:
+		duckdb::DecodeVector<hugeint_t>(source, count, nullmask, (hugeint_t *)data);
+		break;
+	case PhysicalType::FLOAT:
+		duckdb::DecodeVector<float>(source, count, nullmask, (float *)data);
+		break;
+	case PhysicalType::DOUBLE:
+		duckdb::DecodeVector<double>(source, count, nullmask, (double *)data);
+		break;
+	case PhysicalType::INTERVAL:
+		duckdb::DecodeVector<interval_t>(source, count, nullmask, (interval_t *)data);
+		break;
+	default:
+		throw InvalidTypeException(type, "Unsupported type for compressed segment");
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Scan
+//===--------------------------------------------------------------------===//
+//! Whether or not the pinned block is a compressed on-disk block, or the in-memory buffer of a decompressed segment
+static bool IsCompressed(BufferHandle &handle) {
+	return handle.handle->BlockId() < MAXIMUM_BLOCK;
+}
+
+void CompressedSegment::InitializeScan(ColumnScanState &state) {
+	// pin the primary buffer
+	state.primary_handle = manager.Pin(block, state.scan_id);
+}
+
+void CompressedSegment::FetchBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) {
+	if (!IsCompressed(*state.primary_handle)) {
+		NumericSegment::FetchBaseData(state, vector_index, result);
+		return;
+	}
+	D_ASSERT(vector_index < max_vector_count);
+	D_ASSERT(vector_index * STANDARD_VECTOR_SIZE <= tuple_count);
+
+	// decode the vector directly into the result vector
+	result.vector_type = VectorType::FLAT_VECTOR;
+	DecodeVector(state.primary_handle->node->buffer, vector_index, FlatVector::Nullmask(result),
+	             FlatVector::GetData(result));
+}
+
+void CompressedSegment::FilterFetchBaseData(ColumnScanState &state, Vector &result, SelectionVector &sel,
+                                            idx_t &approved_tuple_count) {
+	if (!IsCompressed(*state.primary_handle)) {
+		NumericSegment::FilterFetchBaseData(state, result, sel, approved_tuple_count);
+		return;
+	}
+	// decode the vector and select the approved tuples from it
+	Vector decoded(result.type);
+	FetchBaseData(state, state.vector_index, decoded);
+	result.Slice(decoded, sel, approved_tuple_count);
+	result.Normalify(approved_tuple_count);
+}
+
+void CompressedSegment::Select(ColumnScanState &state, Vector &result, SelectionVector &sel,
+                               idx_t &approved_tuple_count, vector<TableFilter> &tableFilter) {
+	if (!IsCompressed(*state.primary_handle)) {
+		NumericSegment::Select(state, result, sel, approved_tuple_count, tableFilter);
+		return;
+	}
+	// decode the vector into the result
+	auto block_data = state.primary_handle->node->buffer;
+	FetchBaseData(state, state.vector_index, result);
+	auto &nullmask = FlatVector::Nullmask(result);
+
+	auto vector_offset =
+	    Load<uint32_t>(block_data + Storage::BLOCK_SIZE - (state.vector_index + 1) * sizeof(uint32_t));
+	auto source = block_data + vector_offset;
+	auto encoding = (VectorEncoding)Load<uint8_t>(source);
+	if (encoding != VectorEncoding::CONSTANT && encoding != VectorEncoding::RLE) {
+		// apply the filters to the decoded values
+		for (auto &filter : tableFilter) {
+			filterSelection(sel, result, filter, approved_tuple_count, nullmask);
+		}
+		return;
+	}
+	// the vector consists of runs of equal values: evaluate the filters once per run instead of once per row
+	auto payload = source + VECTOR_HEADER_SIZE + (Load<uint8_t>(source + sizeof(uint8_t)) ? sizeof(nullmask_t) : 0);
+	idx_t run_count = encoding == VectorEncoding::CONSTANT ? 1 : Load<uint16_t>(payload);
+	auto run_values = encoding == VectorEncoding::CONSTANT ? payload : payload + sizeof(uint16_t);
+	Vector runs(result.type);
+	memcpy(FlatVector::GetData(runs), run_values, run_count * type_size);
+	SelectionVector run_sel(STANDARD_VECTOR_SIZE);
+	for (idx_t run_idx = 0; run_idx < run_count; run_idx++) {
+		run_sel.set_index(run_idx, run_idx);
+	}
+	idx_t approved_run_count = run_count;
+	nullmask_t run_nullmask;
+	for (auto &filter : tableFilter) {
+		filterSelection(run_sel, runs, filter, approved_run_count, run_nullmask);
+	}
+	// now select the rows that belong to the approved runs, the selected rows are in ascending order
+	auto run_lengths = run_values + run_count * type_size;
+	SelectionVector new_sel(approved_tuple_count);
+	idx_t result_count = 0;
+	idx_t run_idx = 0;
+	idx_t run_end = encoding == VectorEncoding::CONSTANT ? STANDARD_VECTOR_SIZE : Load<uint16_t>(run_lengths);
+	idx_t approved_idx = 0;
+	for (idx_t i = 0; i < approved_tuple_count; i++) {
+		auto row_idx = sel.get_index(i);
+		while (row_idx >= run_end) {
+			run_idx++;
+			run_end += Load<uint16_t>(run_lengths + run_idx * sizeof(uint16_t));
+		}
+		while (approved_idx < approved_run_count && run_sel.get_index(approved_idx) < run_idx) {
+			approved_idx++;
+		}
+		if (approved_idx < approved_run_count && run_sel.get_index(approved_idx) == run_idx && !nullmask[row_idx]) {
+			new_sel.set_index(result_count++, row_idx);
+		}
+	}
+	sel.Initialize(new_sel);
+	approved_tuple_count = result_count;
+}
+
+//===--------------------------------------------------------------------===//
+// Fetch
+//===--------------------------------------------------------------------===//
+void CompressedSegment::FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id, Vector &result,
+                                 idx_t result_idx) {
+	{
+		auto read_lock = lock.GetSharedLock();
+		auto handle = manager.Pin(block);
+		if (IsCompressed(*handle)) {
+			// decode the vector the row belongs to and fetch the value from it
+			idx_t vector_index = row_id / STANDARD_VECTOR_SIZE;
+			idx_t id_in_vector = row_id - vector_index * STANDARD_VECTOR_SIZE;
+			D_ASSERT(vector_index < max_vector_count);
+
+			nullmask_t nullmask;
+			hugeint_t data[STANDARD_VECTOR_SIZE];
+			DecodeVector(handle->node->buffer, vector_index, nullmask, (data_ptr_t)data);
+
+			FlatVector::SetNull(result, result_idx, nullmask[id_in_vector]);
+			memcpy(FlatVector::GetData(result) + result_idx * type_size, (data_ptr_t)data + id_in_vector * type_size,
+			       type_size);
+			return;
+		}
+	}
+	// the segment has been decompressed
+	NumericSegment::FetchRow(state, transaction, row_id, result, result_idx);
+}
+
+//===--------------------------------------------------------------------===//
+// Append
+//===--------------------------------------------------------------------===//
+idx_t CompressedSegment::Append(SegmentStatistics &stats, Vector &data, idx_t offset, idx_t count) {
+	if (!pending) {
+		// the segment has been decompressed: append to it as an uncompressed segment
+		D_ASSERT(block->BlockId() >= MAXIMUM_BLOCK);
+		return NumericSegment::Append(stats, data, offset, count);
+	}
+	idx_t initial_count = tuple_count;
+	while (count > 0) {
+		idx_t vector_index = tuple_count / STANDARD_VECTOR_SIZE;
+		idx_t pending_count = tuple_count - vector_index * STANDARD_VECTOR_SIZE;
+		if (pending_count == 0) {
+			// we are starting a new vector: only do so if it is guaranteed to fit, even if it cannot be compressed
+			idx_t max_vector_size = VECTOR_HEADER_SIZE + sizeof(nullmask_t) + type_size * STANDARD_VECTOR_SIZE;
+			idx_t offsets_size = (vector_index + 1) * sizeof(uint32_t);
+			if (vector_index == max_vector_count || data_size + max_vector_size + offsets_size > Storage::BLOCK_SIZE) {
+				break;
+			}
+			auto pending_handle = manager.Pin(pending->block);
+			((nullmask_t *)pending_handle->node->buffer)->reset();
+			pending->tuple_count = 0;
+		}
+		idx_t append_count = MinValue<idx_t>(STANDARD_VECTOR_SIZE - pending_count, count);
+		pending->Append(stats, data, offset, append_count);
+		tuple_count += append_count;
+		offset += append_count;
+		count -= append_count;
+
+		// (re-)encode the pending vector, so the block is complete after every append
+		EncodePendingVector();
+	}
+	return tuple_count - initial_count;
+}
+
+void CompressedSegment::EncodePendingVector() {
+	idx_t vector_index = (tuple_count - 1) / STANDARD_VECTOR_SIZE;
+	auto handle = manager.Pin(block);
+	auto pending_handle = manager.Pin(pending->block);
+	auto pending_data = pending_handle->node->buffer;
+
+	auto block_data = handle->node->buffer;
+	auto encoded_size = EncodeVector(type, pending_data + sizeof(nullmask_t), *((nullmask_t *)pending_data),
+	                                 pending->tuple_count, block_data + data_size);
+	Store<uint32_t>(data_size, block_data + Storage::BLOCK_SIZE - (vector_index + 1) * sizeof(uint32_t));
+	if (pending->tuple_count == STANDARD_VECTOR_SIZE) {
+		// the vector is complete: the next vector is written after it
+		data_size += encoded_size;
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// ToTemporary
+//===--------------------------------------------------------------------===//
+void CompressedSegment::ToTemporary() {
+	auto write_lock = lock.GetExclusiveLock();
+
+	if (block->BlockId() >= MAXIMUM_BLOCK) {
+		// conversion has already been performed by a different thread
+		return;
+	}
+	// pin the compressed block
+	auto current = manager.Pin(block);
+
+	// allocate an in-memory buffer that can hold all vectors of the segment in uncompressed form, and that has at least
+	// as much room for appends as an uncompressed segment
+	idx_t vector_count = max_vector_count;
+	max_vector_count = MaxValue<idx_t>(vector_count, Storage::BLOCK_SIZE / vector_size);
+	auto alloc_size =
+	    MaxValue<idx_t>(Storage::BLOCK_ALLOC_SIZE, max_vector_count * vector_size + Storage::BLOCK_HEADER_SIZE);
+	auto new_block = manager.RegisterMemory(alloc_size, false);
+	auto handle = manager.Pin(new_block);
+	// decode all vectors into the new buffer and switch to using it
+	for (idx_t vector_index = 0; vector_index < max_vector_count; vector_index++) {
+		auto target = handle->node->buffer + vector_index * vector_size;
+		if (vector_index < vector_count) {
+			DecodeVector(current->node->buffer, vector_index, *((nullmask_t *)target), target + sizeof(nullmask_t));
+		} else {
+			((nullmask_t *)target)->reset();
+		}
+	}
+	this->block = move(new_block);
+}
+
+} // namespace duckdb
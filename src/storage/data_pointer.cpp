@@ -0,0 +1,47 @@
+#include "duckdb/storage/data_pointer.hpp"
+#include "duckdb/common/serializer.hpp"
+
+namespace duckdb {
+using namespace std;
+
+DataPointer DataPointer::Copy() const {
+	DataPointer result;
+	result.row_start = row_start;
+	result.tuple_count = tuple_count;
+	result.block_id = block_id;
+	result.offset = offset;
+	result.compression = compression;
+	result.overflow_blocks = overflow_blocks;
+	result.statistics = statistics ? statistics->Copy() : nullptr;
+	return result;
+}
+
+void DataPointer::Serialize(Serializer &serializer) const {
+	serializer.Write<idx_t>(row_start);
+	serializer.Write<idx_t>(tuple_count);
+	serializer.Write<block_id_t>(block_id);
+	serializer.Write<uint32_t>(offset);
+	serializer.Write<uint8_t>((uint8_t)compression);
+	serializer.Write<idx_t>(overflow_blocks.size());
+	for (auto &overflow_block : overflow_blocks) {
+		serializer.Write<block_id_t>(overflow_block);
+	}
+	statistics->Serialize(serializer);
+}
+
+DataPointer DataPointer::Deserialize(Deserializer &source, const LogicalType &type) {
+	DataPointer result;
+	result.row_start = source.Read<idx_t>();
+	result.tuple_count = source.Read<idx_t>();
+	result.block_id = source.Read<block_id_t>();
+	result.offset = source.Read<uint32_t>();
+	result.compression = (CompressionType)source.Read<uint8_t>();
+	auto overflow_block_count = source.Read<idx_t>();
+	for (idx_t i = 0; i < overflow_block_count; i++) {
+		result.overflow_blocks.push_back(source.Read<block_id_t>());
+	}
+	result.statistics = BaseStatistics::Deserialize(source, type);
+	return result;
+}
+
+} // namespace duckdb
@@ -10,6 +10,7 @@
 #include "duckdb/transaction/transaction_manager.hpp"
 #include "duckdb/storage/table/transient_segment.hpp"
 #include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/planner/table_filter.hpp"
 #include "duckdb/storage/table/persistent_table_data.hpp"
@@ -34,6 +35,7 @@ DataTable::DataTable(StorageManager &storage, string schema, string table, vecto
 	if (data && data->table_data[0].size() > 0) {
 		for (idx_t i = 0; i < types.size(); i++) {
 			columns[i]->statistics = move(data->column_stats[i]);
+			columns[i]->SetHistogram(move(data->column_histograms[i]));
 		}
 		// first append all the segments to the set of column segments
 		for (idx_t i = 0; i < types.size(); i++) {
@@ -43,12 +45,22 @@ DataTable::DataTable(StorageManager &storage, string schema, string table, vecto
 			}
 		}
 		total_rows = columns[0]->persistent_rows;
+		info->cardinality = total_rows;
 		// create empty morsel info's
 		// in the future, we should lazily load these from the file as well (once we support deleted flags)
 		for (idx_t i = 0; i < total_rows; i += MorselInfo::MORSEL_SIZE) {
 			auto segment = make_unique<MorselInfo>(i, MorselInfo::MORSEL_SIZE);
 			versions->AppendSegment(move(segment));
 		}
+		// restore the rows that were deleted when the checkpoint was written
+		for (auto &range : data->deletes) {
+			for (idx_t row = range.first; row < range.second;) {
+				auto morsel = (MorselInfo *)versions->GetSegment(row);
+				idx_t end = MinValue<idx_t>(range.second, morsel->start + MorselInfo::MORSEL_SIZE);
+				morsel->MarkAsDeleted(row - morsel->start, end - row);
+				row = end;
+			}
+		}
 	} else {
 		// append one (empty) morsel to the table
 		auto segment = make_unique<MorselInfo>(0, MorselInfo::MORSEL_SIZE);
@@ -195,8 +207,10 @@ void DataTable::InitializeScan(TableScanState &state, const vector<column_t> &co
                                TableFilterSet *table_filters) {
 	// initialize a column scan state for each column
 	state.column_scans = unique_ptr<ColumnScanState[]>(new ColumnScanState[column_ids.size()]);
+	auto scan_id = storage.buffer_manager->RegisterScan();
 	for (idx_t i = 0; i < column_ids.size(); i++) {
 		auto column = column_ids[i];
+		state.column_scans[i].scan_id = scan_id;
 		if (column != COLUMN_IDENTIFIER_ROW_ID) {
 			columns[column]->InitializeScan(state.column_scans[i]);
 		} else {
@@ -223,7 +237,8 @@ void DataTable::InitializeScan(Transaction &transaction, TableScanState &state,
 }
 
 void DataTable::InitializeScanWithOffset(TableScanState &state, const vector<column_t> &column_ids,
-                                         TableFilterSet *table_filters, idx_t start_row, idx_t end_row) {
+                                         TableFilterSet *table_filters, idx_t start_row, idx_t end_row,
+                                         idx_t scan_id) {
 	D_ASSERT(start_row % STANDARD_VECTOR_SIZE == 0);
 	D_ASSERT(end_row > start_row);
 	idx_t vector_offset = start_row / STANDARD_VECTOR_SIZE;
@@ -231,6 +246,7 @@ void DataTable::InitializeScanWithOffset(TableScanState &state, const vector<col
 	state.column_scans = unique_ptr<ColumnScanState[]>(new ColumnScanState[column_ids.size()]);
 	for (idx_t i = 0; i < column_ids.size(); i++) {
 		auto column = column_ids[i];
+		state.column_scans[i].scan_id = scan_id;
 		if (column != COLUMN_IDENTIFIER_ROW_ID) {
 			columns[column]->InitializeScanWithOffset(state.column_scans[i], vector_offset);
 		} else {
@@ -241,9 +257,10 @@ void DataTable::InitializeScanWithOffset(TableScanState &state, const vector<col
 	// initialize the chunk scan state
 	state.column_count = column_ids.size();
 	state.current_row = start_row;
-	state.base_row = start_row;
 	state.max_row = end_row;
+	// the scan can start in the middle of a morsel info (e.g. after skipping a segment using its zonemap)
 	state.version_info = (MorselInfo *)versions->GetSegment(state.current_row);
+	state.base_row = state.version_info->start;
 	state.table_filters = table_filters;
 	if (table_filters && table_filters->filters.size() > 0) {
 		state.adaptive_filter = make_unique<AdaptiveFilter>(table_filters);
@@ -263,6 +280,7 @@ idx_t DataTable::MaxThreads(ClientContext &context) {
 void DataTable::InitializeParallelScan(ParallelTableScanState &state) {
 	state.current_row = 0;
 	state.transaction_local_data = false;
+	state.scan_id = storage.buffer_manager->RegisterScan();
 }
 
 bool DataTable::NextParallelScan(ClientContext &context, ParallelTableScanState &state, TableScanState &scan_state,
@@ -273,15 +291,30 @@ bool DataTable::NextParallelScan(ClientContext &context, ParallelTableScanState
 	}
 	idx_t PARALLEL_SCAN_TUPLE_COUNT = STANDARD_VECTOR_SIZE * PARALLEL_SCAN_VECTOR_COUNT;
 
-	if (state.current_row < total_rows) {
-		idx_t next = MinValue(state.current_row + PARALLEL_SCAN_TUPLE_COUNT, total_rows);
+	while (state.current_row < total_rows) {
+		// check the zonemaps before handing out the morsel: segments that contain no matching rows are skipped as a
+		// whole. the skipped rows are reported right away, as the scan might not produce any morsel after them
+		idx_t segment_end;
+		if (!CheckSegmentZonemaps(scan_state.table_filters, column_ids, state.current_row, segment_end)) {
+			context.profiler.AddPrunedRows(segment_end - state.current_row);
+			state.current_row = segment_end;
+			continue;
+		}
+		// the morsel ends at the next segment boundary of the filtered columns and at the end of the version info, so
+		// every morsel is covered by a single zonemap of every filtered column
+		idx_t morsel_end = (state.current_row / MorselInfo::MORSEL_SIZE + 1) * MorselInfo::MORSEL_SIZE;
+		idx_t next = MinValue(MinValue(state.current_row + PARALLEL_SCAN_TUPLE_COUNT, segment_end), morsel_end);
 
 		// scan a morsel from the persistent rows
-		InitializeScanWithOffset(scan_state, column_ids, scan_state.table_filters, state.current_row, next);
+		InitializeScanWithOffset(scan_state, column_ids, scan_state.table_filters, state.current_row, next,
+		                         state.scan_id);
+		// start reading the blocks of the upcoming morsels
+		ReadAhead(context, state, column_ids, state.current_row);
 
 		state.current_row = next;
 		return true;
-	} else if (!state.transaction_local_data) {
+	}
+	if (!state.transaction_local_data) {
 		auto &transaction = Transaction::GetTransaction(context);
 		// create a task for scanning the local data
 		scan_state.current_row = 0;
@@ -296,6 +329,74 @@ bool DataTable::NextParallelScan(ClientContext &context, ParallelTableScanState
 	}
 }
 
+bool DataTable::CheckSegmentZonemaps(TableFilterSet *table_filters, const vector<column_t> &column_ids, idx_t row,
+                                     idx_t &segment_end) {
+	D_ASSERT(row % STANDARD_VECTOR_SIZE == 0);
+	segment_end = total_rows;
+	if (!table_filters) {
+		return true;
+	}
+	idx_t skip_end = 0;
+	for (auto &table_filter : table_filters->filters) {
+		auto column = column_ids[table_filter.first];
+		if (column == COLUMN_IDENTIFIER_ROW_ID) {
+			continue;
+		}
+		auto segment = (ColumnSegment *)columns[column]->data.GetSegment(row);
+		// segments hold whole vectors, except for the last segment of the table
+		idx_t end = segment->start + segment->count;
+		if (end < total_rows) {
+			end = MaxValue<idx_t>(end - end % STANDARD_VECTOR_SIZE, row + STANDARD_VECTOR_SIZE);
+		}
+		end = MinValue<idx_t>(end, total_rows);
+		bool read_segment = true;
+		for (auto &filter : table_filter.second) {
+			if (!segment->stats.CheckZonemap(filter)) {
+				read_segment = false;
+				break;
+			}
+		}
+		if (read_segment) {
+			segment_end = MinValue<idx_t>(segment_end, end);
+		} else {
+			skip_end = MaxValue<idx_t>(skip_end, end);
+		}
+	}
+	if (skip_end > 0) {
+		segment_end = skip_end;
+		return false;
+	}
+	return true;
+}
+
+void DataTable::ReadAhead(ClientContext &context, ParallelTableScanState &state, const vector<column_t> &column_ids,
+                          idx_t row) {
+	idx_t depth = context.read_ahead_depth;
+	if (depth == 0) {
+		return;
+	}
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	state.read_ahead_row.resize(column_ids.size(), 0);
+	for (idx_t i = 0; i < column_ids.size(); i++) {
+		auto column = column_ids[i];
+		if (column == COLUMN_IDENTIFIER_ROW_ID) {
+			continue;
+		}
+		// prefetch the blocks of the next "depth" segments of this column that have not been read ahead yet
+		auto segment = (ColumnSegment *)columns[column]->data.GetSegment(row);
+		for (idx_t segment_idx = 0; segment && segment_idx <= depth; segment_idx++) {
+			if (segment->start >= state.read_ahead_row[i] && segment->segment_type == ColumnSegmentType::PERSISTENT) {
+				auto &persistent = (PersistentSegment &)*segment;
+				if (persistent.block_id != INVALID_BLOCK) {
+					buffer_manager.Prefetch(persistent.data->block);
+				}
+			}
+			state.read_ahead_row[i] = MaxValue<idx_t>(state.read_ahead_row[i], segment->start + segment->count);
+			segment = (ColumnSegment *)segment->next.get();
+		}
+	}
+}
+
 void DataTable::Scan(Transaction &transaction, DataChunk &result, TableScanState &state, vector<column_t> &column_ids) {
 	// scan the persistent segments
 	while (ScanBaseTable(transaction, result, state, column_ids, state.current_row, state.max_row)) {
@@ -331,6 +432,7 @@ bool DataTable::CheckZonemap(TableScanState &state, TableFilterSet *table_filter
 				    ceil((double)(state.column_scans[predicate_constant.column_index].current->count +
 				                  state.column_scans[predicate_constant.column_index].current->start - current_row) /
 				         STANDARD_VECTOR_SIZE);
+				state.pruned_rows += MinValue<idx_t>(vectorsToSkip * STANDARD_VECTOR_SIZE, state.max_row - current_row);
 				for (idx_t i = 0; i < vectorsToSkip; ++i) {
 					state.NextVector();
 					current_row += STANDARD_VECTOR_SIZE;
@@ -357,10 +459,11 @@ bool DataTable::ScanBaseTable(Transaction &transaction, DataChunk &result, Table
 	}
 	// second, scan the version chunk manager to figure out which tuples to load for this transaction
 	SelectionVector valid_sel(STANDARD_VECTOR_SIZE);
-	if (vector_offset >= MorselInfo::MORSEL_VECTOR_COUNT) {
+	// skipping a segment using its zonemap can skip several morsel infos at once
+	while (vector_offset >= MorselInfo::MORSEL_VECTOR_COUNT) {
 		state.version_info = (MorselInfo *)state.version_info->next.get();
 		state.base_row += MorselInfo::MORSEL_SIZE;
-		vector_offset = 0;
+		vector_offset -= MorselInfo::MORSEL_VECTOR_COUNT;
 	}
 	idx_t count = state.version_info->GetSelVector(transaction, vector_offset, valid_sel, max_count);
 	if (count == 0) {
@@ -641,7 +744,8 @@ void DataTable::ScanTableSegment(idx_t row_start, idx_t count, std::function<voi
 	CreateIndexScanState state;
 
 	idx_t row_start_aligned = row_start / STANDARD_VECTOR_SIZE * STANDARD_VECTOR_SIZE;
-	InitializeScanWithOffset(state, column_ids, nullptr, row_start_aligned, row_start + count);
+	InitializeScanWithOffset(state, column_ids, nullptr, row_start_aligned, row_start + count,
+	                         storage.buffer_manager->RegisterScan());
 
 	while (true) {
 		idx_t current_row = state.current_row;
@@ -669,6 +773,13 @@ void DataTable::WriteToLog(WriteAheadLog &log, idx_t row_start, idx_t count) {
 	ScanTableSegment(row_start, count, [&](DataChunk &chunk) { log.WriteInsert(chunk); });
 }
 
+void DataTable::AddCheckpointBlocks(AppendBlocks &blocks) {
+	D_ASSERT(blocks.columns.size() == columns.size());
+	for (idx_t i = 0; i < columns.size(); i++) {
+		columns[i]->AddCheckpointBlocks(blocks.columns[i]);
+	}
+}
+
 void DataTable::CommitAppend(transaction_t commit_id, idx_t row_start, idx_t count) {
 	lock_guard<mutex> lock(append_lock);
 
@@ -725,7 +836,7 @@ void DataTable::RevertAppendInternal(idx_t start_row, idx_t count) {
 		versions->nodes.erase(versions->nodes.begin() + segment_index + 1, versions->nodes.end());
 	}
 	info.next = nullptr;
-	info.RevertAppend(start_row);
+	info.RevertAppend(start_row - info.start);
 }
 
 void DataTable::RevertAppend(idx_t start_row, idx_t count) {
@@ -1054,7 +1165,19 @@ unique_ptr<BaseStatistics> DataTable::GetStatistics(ClientContext &context, colu
 		return nullptr;
 	}
 	// FIXME: potentially merge with transaction local shtuff
-	return columns[column_id]->statistics->Copy();
+	auto stats = columns[column_id]->statistics->Copy();
+	stats->histogram = columns[column_id]->GetHistogram();
+	return stats;
+}
+
+vector<std::pair<idx_t, idx_t>> DataTable::GetCommittedDeletes(Transaction &transaction) {
+	vector<std::pair<idx_t, idx_t>> result;
+	auto morsel = (MorselInfo *)versions->GetRootSegment();
+	while (morsel) {
+		morsel->GetCommittedDeletes(transaction, result);
+		morsel = (MorselInfo *)morsel->next.get();
+	}
+	return result;
 }
 
 } // namespace duckdb
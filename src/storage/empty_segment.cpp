@@ -0,0 +1,66 @@
+#include "duckdb/storage/empty_segment.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/vector.hpp"
+
+namespace duckdb {
+using namespace std;
+
+EmptySegment::EmptySegment(BufferManager &manager, PhysicalType type, idx_t row_start, idx_t count)
+    : UncompressedSegment(manager, type, row_start) {
+	this->vector_size = 0;
+	this->max_vector_count = count / STANDARD_VECTOR_SIZE + (count % STANDARD_VECTOR_SIZE == 0 ? 0 : 1);
+	this->tuple_count = count;
+}
+
+//! The rows of an empty segment have been deleted: they are returned as NULL values
+static void SetNullVector(PhysicalType type, Vector &result, idx_t count) {
+	result.vector_type = VectorType::FLAT_VECTOR;
+	memset(FlatVector::GetData(result), 0, count * GetTypeIdSize(type));
+	FlatVector::Nullmask(result).set();
+}
+
+void EmptySegment::FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id, Vector &result,
+                            idx_t result_idx) {
+	memset(FlatVector::GetData(result) + result_idx * GetTypeIdSize(type), 0, GetTypeIdSize(type));
+	FlatVector::SetNull(result, result_idx, true);
+}
+
+idx_t EmptySegment::Append(SegmentStatistics &stats, Vector &data, idx_t offset, idx_t count) {
+	throw InternalException("Cannot append to an empty segment");
+}
+
+void EmptySegment::RollbackUpdate(UpdateInfo *info) {
+	throw InternalException("Cannot rollback an update of an empty segment");
+}
+
+void EmptySegment::ToTemporary() {
+	throw InternalException("Cannot convert an empty segment into an in-memory segment");
+}
+
+void EmptySegment::Update(ColumnData &data, SegmentStatistics &stats, Transaction &transaction, Vector &update,
+                          row_t *ids, idx_t count, idx_t vector_index, idx_t vector_offset, UpdateInfo *node) {
+	throw InternalException("Cannot update the deleted rows of an empty segment");
+}
+
+void EmptySegment::Select(ColumnScanState &state, Vector &result, SelectionVector &sel, idx_t &approved_tuple_count,
+                          vector<TableFilter> &tableFilter) {
+	// NULL values never pass a filter
+	SetNullVector(type, result, GetVectorCount(state.vector_index));
+	approved_tuple_count = 0;
+}
+
+void EmptySegment::FetchBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) {
+	SetNullVector(type, result, GetVectorCount(vector_index));
+}
+
+void EmptySegment::FilterFetchBaseData(ColumnScanState &state, Vector &result, SelectionVector &sel,
+                                       idx_t &approved_tuple_count) {
+	SetNullVector(type, result, GetVectorCount(state.vector_index));
+}
+
+void EmptySegment::FetchUpdateData(ColumnScanState &state, Transaction &transaction, UpdateInfo *versions,
+                                   Vector &result) {
+	throw InternalException("An empty segment has no updates");
+}
+
+} // namespace duckdb
@@ -6,6 +6,9 @@
 #include "duckdb/storage/uncompressed_segment.hpp"
 #include "duckdb/storage/table/morsel_info.hpp"
 #include "duckdb/transaction/transaction.hpp"
+#include "duckdb/transaction/transaction_manager.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/planner/table_filter.hpp"
 
 namespace duckdb {
@@ -180,7 +183,7 @@ void LocalStorage::Append(DataTable *table, DataChunk &chunk) {
 	storage->collection.Append(chunk);
 	if (storage->active_scans == 0 && storage->collection.Count() >= MorselInfo::MORSEL_SIZE) {
 		// flush to base storage
-		Flush(*table, *storage);
+		table->storage.database.transaction_manager->FlushLocalStorage(transaction, *table);
 	}
 }
 
@@ -356,6 +359,15 @@ void LocalStorage::Flush(DataTable &table, LocalTableStorage &storage) {
 	transaction.PushAppend(&table, append_state.row_start, append_count);
 }
 
+void LocalStorage::Flush(DataTable *table) {
+	auto entry = table_storage.find(table);
+	if (entry == table_storage.end()) {
+		return;
+	}
+	D_ASSERT(entry->second->active_scans == 0);
+	Flush(*table, *entry->second);
+}
+
 void LocalStorage::Commit(LocalStorage::CommitState &commit_state, Transaction &transaction, WriteAheadLog *log,
                           transaction_t commit_id) {
 	// commit local storage, iterate over all entries in the table storage map
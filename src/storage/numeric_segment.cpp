@@ -1,6 +1,7 @@
 #include "duckdb/storage/numeric_segment.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/common/types/vector.hpp"
+#include "duckdb/common/types/hash.hpp"
 #include "duckdb/storage/table/append_state.hpp"
 #include "duckdb/transaction/update_info.hpp"
 #include "duckdb/transaction/transaction.hpp"
@@ -278,7 +279,7 @@ void NumericSegment::Select(ColumnScanState &state, Vector &result, SelectionVec
 //===--------------------------------------------------------------------===//
 void NumericSegment::InitializeScan(ColumnScanState &state) {
 	// pin the primary buffer
-	state.primary_handle = manager.Pin(block);
+	state.primary_handle = manager.Pin(block, state.scan_id);
 }
 
 //===--------------------------------------------------------------------===//
@@ -480,7 +481,7 @@ void NumericSegment::RollbackUpdate(UpdateInfo *info) {
 //===--------------------------------------------------------------------===//
 // Append
 //===--------------------------------------------------------------------===//
-template <class T> static inline void update_numeric_statistics_internal(T new_value, T &min, T &max) {
+template <class T> static inline void update_numeric_min_max_internal(T new_value, T &min, T &max) {
 	if (LessThan::Operation(new_value, min)) {
 		min = new_value;
 	}
@@ -489,44 +490,52 @@ template <class T> static inline void update_numeric_statistics_internal(T new_v
 	}
 }
 
-template <class T> static inline void update_numeric_statistics(SegmentStatistics &stats, T new_value);
+template <class T> static inline void update_numeric_min_max(SegmentStatistics &stats, T new_value);
 
-template <> inline void update_numeric_statistics<int8_t>(SegmentStatistics &stats, int8_t new_value) {
+template <> inline void update_numeric_min_max<int8_t>(SegmentStatistics &stats, int8_t new_value) {
 	auto &nstats = (NumericStatistics &)*stats.statistics;
-	update_numeric_statistics_internal<int8_t>(new_value, nstats.min.value_.tinyint, nstats.max.value_.tinyint);
+	update_numeric_min_max_internal<int8_t>(new_value, nstats.min.value_.tinyint, nstats.max.value_.tinyint);
 }
 
-template <> inline void update_numeric_statistics<int16_t>(SegmentStatistics &stats, int16_t new_value) {
+template <> inline void update_numeric_min_max<int16_t>(SegmentStatistics &stats, int16_t new_value) {
 	auto &nstats = (NumericStatistics &)*stats.statistics;
-	update_numeric_statistics_internal<int16_t>(new_value, nstats.min.value_.smallint, nstats.max.value_.smallint);
+	update_numeric_min_max_internal<int16_t>(new_value, nstats.min.value_.smallint, nstats.max.value_.smallint);
 }
 
-template <> inline void update_numeric_statistics<int32_t>(SegmentStatistics &stats, int32_t new_value) {
+template <> inline void update_numeric_min_max<int32_t>(SegmentStatistics &stats, int32_t new_value) {
 	auto &nstats = (NumericStatistics &)*stats.statistics;
-	update_numeric_statistics_internal<int32_t>(new_value, nstats.min.value_.integer, nstats.max.value_.integer);
+	update_numeric_min_max_internal<int32_t>(new_value, nstats.min.value_.integer, nstats.max.value_.integer);
 }
 
-template <> inline void update_numeric_statistics<int64_t>(SegmentStatistics &stats, int64_t new_value) {
+template <> inline void update_numeric_min_max<int64_t>(SegmentStatistics &stats, int64_t new_value) {
 	auto &nstats = (NumericStatistics &)*stats.statistics;
-	update_numeric_statistics_internal<int64_t>(new_value, nstats.min.value_.bigint, nstats.max.value_.bigint);
+	update_numeric_min_max_internal<int64_t>(new_value, nstats.min.value_.bigint, nstats.max.value_.bigint);
 }
 
-template <> inline void update_numeric_statistics<hugeint_t>(SegmentStatistics &stats, hugeint_t new_value) {
+template <> inline void update_numeric_min_max<hugeint_t>(SegmentStatistics &stats, hugeint_t new_value) {
 	auto &nstats = (NumericStatistics &)*stats.statistics;
-	update_numeric_statistics_internal<hugeint_t>(new_value, nstats.min.value_.hugeint, nstats.max.value_.hugeint);
+	update_numeric_min_max_internal<hugeint_t>(new_value, nstats.min.value_.hugeint, nstats.max.value_.hugeint);
 }
 
-template <> inline void update_numeric_statistics<float>(SegmentStatistics &stats, float new_value) {
+template <> inline void update_numeric_min_max<float>(SegmentStatistics &stats, float new_value) {
 	auto &nstats = (NumericStatistics &)*stats.statistics;
-	update_numeric_statistics_internal<float>(new_value, nstats.min.value_.float_, nstats.max.value_.float_);
+	update_numeric_min_max_internal<float>(new_value, nstats.min.value_.float_, nstats.max.value_.float_);
 }
 
-template <> inline void update_numeric_statistics<double>(SegmentStatistics &stats, double new_value) {
+template <> inline void update_numeric_min_max<double>(SegmentStatistics &stats, double new_value) {
 	auto &nstats = (NumericStatistics &)*stats.statistics;
-	update_numeric_statistics_internal<double>(new_value, nstats.min.value_.double_, nstats.max.value_.double_);
+	update_numeric_min_max_internal<double>(new_value, nstats.min.value_.double_, nstats.max.value_.double_);
 }
 
-template <> void update_numeric_statistics<interval_t>(SegmentStatistics &stats, interval_t new_value) {
+template <> void update_numeric_min_max<interval_t>(SegmentStatistics &stats, interval_t new_value) {
+}
+
+template <class T> static inline void update_numeric_statistics(SegmentStatistics &stats, T new_value) {
+	update_numeric_min_max<T>(stats, new_value);
+	auto &distinct_stats = stats.statistics->distinct_stats;
+	if (distinct_stats) {
+		distinct_stats->Add(Hash<T>(new_value));
+	}
 }
 
 template <class T>
@@ -124,6 +124,9 @@ SingleFileBlockManager::SingleFileBlockManager(FileSystem &fs, string path, bool
 		// we start with h2 as active_header, this way our initial write will be in h1
 		active_header = 1;
 		max_block = 0;
+		meta_block = INVALID_BLOCK;
+		free_list_id = INVALID_BLOCK;
+		iteration_count = h2.iteration;
 	} else {
 		// otherwise, we check the metadata of the file
 		header_buffer.Read(*handle, 0);
@@ -187,10 +190,12 @@ void SingleFileBlockManager::LoadFreeList(BufferManager &manager) {
 }
 
 void SingleFileBlockManager::StartCheckpoint() {
-	used_blocks.clear();
+	lock_guard<mutex> lock(block_lock);
+	used_blocks = pending_blocks;
 }
 
 block_id_t SingleFileBlockManager::GetFreeBlockId() {
+	lock_guard<mutex> lock(block_lock);
 	block_id_t block;
 	if (free_list.size() > 0) {
 		// free list is non empty
@@ -205,6 +210,47 @@ block_id_t SingleFileBlockManager::GetFreeBlockId() {
 	return block;
 }
 
+void SingleFileBlockManager::MarkBlockAsUsed(block_id_t block_id) {
+	lock_guard<mutex> lock(block_lock);
+	D_ASSERT(block_id >= 0 && block_id < max_block);
+	D_ASSERT(std::find(free_list.begin(), free_list.end(), block_id) == free_list.end());
+	used_blocks.insert(block_id);
+}
+
+void SingleFileBlockManager::ReserveBlock(block_id_t block_id) {
+	lock_guard<mutex> lock(block_lock);
+	D_ASSERT(block_id >= 0);
+	// the block was handed out after the last checkpoint was written: it is either in the free list of the checkpoint,
+	// or it lies beyond the blocks of the checkpoint. in the latter case, the blocks in between are free
+	auto entry = std::find(free_list.begin(), free_list.end(), block_id);
+	if (entry != free_list.end()) {
+		free_list.erase(entry);
+	}
+	for (; max_block <= block_id; max_block++) {
+		if (max_block != block_id) {
+			free_list.push_back(max_block);
+		}
+	}
+	used_blocks.insert(block_id);
+}
+
+void SingleFileBlockManager::MarkBlockAsPending(block_id_t block_id) {
+	lock_guard<mutex> lock(block_lock);
+	D_ASSERT(block_id >= 0 && block_id < max_block);
+	pending_blocks.insert(block_id);
+	used_blocks.insert(block_id);
+}
+
+void SingleFileBlockManager::ReleasePendingBlock(block_id_t block_id, bool free) {
+	lock_guard<mutex> lock(block_lock);
+	if (pending_blocks.erase(block_id) == 0 || !free) {
+		// once its transaction has committed, the block is used by the next checkpoint only if it still holds data
+		return;
+	}
+	used_blocks.erase(block_id);
+	free_list.push_back(block_id);
+}
+
 block_id_t SingleFileBlockManager::GetMetaBlock() {
 	return meta_block;
 }
@@ -215,38 +261,60 @@ unique_ptr<Block> SingleFileBlockManager::CreateBlock() {
 
 void SingleFileBlockManager::Read(Block &block) {
 	D_ASSERT(block.id >= 0);
-	D_ASSERT(std::find(free_list.begin(), free_list.end(), block.id) == free_list.end());
+#ifdef DEBUG
+	{
+		lock_guard<mutex> lock(block_lock);
+		D_ASSERT(std::find(free_list.begin(), free_list.end(), block.id) == free_list.end());
+	}
+#endif
 	block.Read(*handle, BLOCK_START + block.id * Storage::BLOCK_ALLOC_SIZE);
 }
 
+void SingleFileBlockManager::Prefetch(block_id_t block_id) {
+	D_ASSERT(block_id >= 0);
+	if (use_direct_io) {
+		// direct IO bypasses the page cache: prefetching into it is of no use
+		return;
+	}
+	handle->Prefetch(Storage::BLOCK_ALLOC_SIZE, BLOCK_START + block_id * Storage::BLOCK_ALLOC_SIZE);
+}
+
 void SingleFileBlockManager::Write(FileBuffer &buffer, block_id_t block_id) {
 	D_ASSERT(block_id >= 0);
 	buffer.Write(*handle, BLOCK_START + block_id * Storage::BLOCK_ALLOC_SIZE);
 }
 
+void SingleFileBlockManager::Sync() {
+	if (!use_direct_io) {
+		handle->Sync();
+	}
+}
+
 void SingleFileBlockManager::WriteHeader(DatabaseHeader header) {
 	// set the iteration count
 	header.iteration = ++iteration_count;
-	header.block_count = max_block;
-	// now handle the free list
-	free_list.clear();
+	// now handle the free list: every block that is not used by this checkpoint is free
+	vector<block_id_t> new_free_list;
 	for (block_id_t i = 0; i < max_block; i++) {
 		if (used_blocks.find(i) == used_blocks.end()) {
-			free_list.push_back(i);
+			new_free_list.push_back(i);
 		}
 	}
-	if (free_list.size() > 0) {
+	if (new_free_list.size() > 0) {
 		// there are blocks in the free list
-		// write them to the file
+		// write them to the file. the blocks that hold the free list itself are taken from the end of the free list
+		// before it is written, so they are not marked as free
+		idx_t list_size = sizeof(uint64_t) + new_free_list.size() * sizeof(block_id_t);
+		idx_t block_capacity = Storage::BLOCK_SIZE - sizeof(block_id_t);
+		idx_t reserved_count = MinValue<idx_t>((list_size + block_capacity - 1) / block_capacity, new_free_list.size());
+		free_list.assign(new_free_list.end() - reserved_count, new_free_list.end());
+		new_free_list.resize(new_free_list.size() - reserved_count);
+
 		MetaBlockWriter writer(*this);
-		auto entry = std::find(free_list.begin(), free_list.end(), writer.block->id);
-		if (entry != free_list.end()) {
-			free_list.erase(entry);
-		}
 		header.free_list = writer.block->id;
 
-		writer.Write<uint64_t>(free_list.size());
-		for (auto &block_id : free_list) {
+		writer.Write<uint64_t>(new_free_list.size());
+		for (auto &block_id : new_free_list) {
 			writer.Write<block_id_t>(block_id);
 		}
 		writer.Flush();
@@ -254,6 +322,7 @@ void SingleFileBlockManager::WriteHeader(DatabaseHeader header) {
 		// no blocks in the free list
 		header.free_list = INVALID_BLOCK;
 	}
+	header.block_count = max_block;
 	if (!use_direct_io) {
 		// if we are not using Direct IO we need to fsync BEFORE we write the header to ensure that all the previous
 		// blocks are written as well
@@ -270,12 +339,11 @@ void SingleFileBlockManager::WriteHeader(DatabaseHeader header) {
 	//! Ensure the header write ends up on disk
 	handle->Sync();
 
-	// the free list is now equal to the blocks that were used by the previous iteration
-	free_list.clear();
-	for (auto &block_id : used_blocks) {
-		free_list.push_back(block_id);
-	}
-	used_blocks.clear();
+	meta_block = header.meta_block;
+	free_list_id = header.free_list;
+	// the blocks that are not used by the checkpoint that was just written can now be reused by the next checkpoint
+	free_list = move(new_free_list);
+	used_blocks = pending_blocks;
 }
 
 } // namespace duckdb
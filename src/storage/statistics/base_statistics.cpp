@@ -9,15 +9,31 @@ namespace duckdb {
 
 unique_ptr<BaseStatistics> BaseStatistics::Copy() {
 	auto statistics = make_unique<BaseStatistics>(type);
-	statistics->has_null = has_null;
+	CopyBase(*statistics);
 	return statistics;
 }
 
+void BaseStatistics::CopyBase(BaseStatistics &other) {
+	other.has_null = has_null;
+	other.distinct_stats = distinct_stats ? distinct_stats->Copy() : nullptr;
+}
+
 void BaseStatistics::Merge(const BaseStatistics &other) {
 	has_null = has_null || other.has_null;
+	if (!other.distinct_stats) {
+		// the distinct values of the other side are unknown: so are the distinct values of the union
+		distinct_stats.reset();
+	} else if (distinct_stats) {
+		distinct_stats->Merge(*other.distinct_stats);
+	}
+}
+
+idx_t BaseStatistics::GetDistinctCount() {
+	return distinct_stats ? distinct_stats->Count() : INVALID_INDEX;
 }
 
 unique_ptr<BaseStatistics> BaseStatistics::CreateEmpty(LogicalType type) {
+	unique_ptr<BaseStatistics> result;
 	switch (type.InternalType()) {
 	case PhysicalType::BOOL:
 	case PhysicalType::INT8:
@@ -27,22 +43,35 @@ unique_ptr<BaseStatistics> BaseStatistics::CreateEmpty(LogicalType type) {
 	case PhysicalType::INT128:
 	case PhysicalType::FLOAT:
 	case PhysicalType::DOUBLE:
-		return make_unique<NumericStatistics>(type);
+		result = make_unique<NumericStatistics>(type);
+		break;
 	case PhysicalType::VARCHAR:
-		return make_unique<StringStatistics>(type);
+		result = make_unique<StringStatistics>(type);
+		break;
 	case PhysicalType::INTERVAL:
-		return make_unique<BaseStatistics>(type);
+		result = make_unique<BaseStatistics>(type);
+		break;
 	default:
 		return nullptr;
 	}
+	result->distinct_stats = make_unique<HyperLogLog>();
+	return result;
 }
 
 void BaseStatistics::Serialize(Serializer &serializer) {
 	serializer.Write<bool>(has_null);
+	serializer.Write<bool>(distinct_stats ? true : false);
+	if (distinct_stats) {
+		distinct_stats->Serialize(serializer);
+	}
 }
 
 unique_ptr<BaseStatistics> BaseStatistics::Deserialize(Deserializer &source, LogicalType type) {
 	auto has_null = source.Read<bool>();
+	unique_ptr<HyperLogLog> distinct_stats;
+	if (source.Read<bool>()) {
+		distinct_stats = HyperLogLog::Deserialize(source);
+	}
 	unique_ptr<BaseStatistics> result;
 	switch (type.InternalType()) {
 	case PhysicalType::BOOL:
@@ -65,6 +94,7 @@ unique_ptr<BaseStatistics> BaseStatistics::Deserialize(Deserializer &source, Log
 		throw InternalException("Unimplemented type for statistics deserialization");
 	}
 	result->has_null = has_null;
+	result->distinct_stats = move(distinct_stats);
 	return result;
 }
 
@@ -0,0 +1,265 @@
+#include "duckdb/storage/statistics/histogram.hpp"
+#include "duckdb/common/serializer.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hugeint.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+using namespace std;
+
+Histogram::Histogram(LogicalType type)
+    : type(move(type)), null_fraction(0), bucket_fraction(0), bucket_distinct_count(0) {
+}
+
+bool Histogram::IsSupported(const LogicalType &type) {
+	switch (type.InternalType()) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+	case PhysicalType::INT16:
+	case PhysicalType::INT32:
+	case PhysicalType::INT64:
+	case PhysicalType::INT128:
+	case PhysicalType::FLOAT:
+	case PhysicalType::DOUBLE:
+	case PhysicalType::INTERVAL:
+	case PhysicalType::VARCHAR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+unique_ptr<Histogram> Histogram::Build(LogicalType type, vector<Value> &sample) {
+	if (sample.empty()) {
+		return nullptr;
+	}
+	auto result = make_unique<Histogram>(move(type));
+	double total_count = sample.size();
+
+	// sort the non-NULL values, so equal values are adjacent
+	vector<Value> values;
+	for (auto &value : sample) {
+		if (!value.is_null) {
+			values.push_back(move(value));
+		}
+	}
+	result->null_fraction = (total_count - values.size()) / total_count;
+	if (values.empty()) {
+		return result;
+	}
+	sort(values.begin(), values.end());
+
+	// find the runs of equal values as [start, count] pairs
+	vector<pair<idx_t, idx_t>> runs;
+	for (idx_t i = 0; i < values.size(); i++) {
+		if (i == 0 || values[i] != values[i - 1]) {
+			runs.push_back(make_pair(i, 0));
+		}
+		runs.back().second++;
+	}
+
+	// a value is common if it occurs noticeably more often than the average value of the sample
+	double average_count = double(values.size()) / runs.size();
+	vector<idx_t> common_runs;
+	for (idx_t run_idx = 0; run_idx < runs.size(); run_idx++) {
+		auto count = runs[run_idx].second;
+		if (count > 1 && count > 1.25 * average_count) {
+			common_runs.push_back(run_idx);
+		}
+	}
+	sort(common_runs.begin(), common_runs.end(),
+	     [&](const idx_t &a, const idx_t &b) { return runs[a].second > runs[b].second; });
+	if (common_runs.size() > MAX_COMMON_VALUES) {
+		common_runs.resize(MAX_COMMON_VALUES);
+	}
+	vector<bool> is_common(runs.size(), false);
+	for (auto &run_idx : common_runs) {
+		is_common[run_idx] = true;
+		result->common_values.push_back(values[runs[run_idx].first]);
+		result->common_frequencies.push_back(runs[run_idx].second / total_count);
+	}
+
+	// the other values are divided over the buckets of the equi-depth histogram
+	vector<Value> remaining;
+	for (idx_t run_idx = 0; run_idx < runs.size(); run_idx++) {
+		if (is_common[run_idx]) {
+			continue;
+		}
+		result->bucket_distinct_count++;
+		for (idx_t i = 0; i < runs[run_idx].second; i++) {
+			remaining.push_back(values[runs[run_idx].first + i]);
+		}
+	}
+	result->bucket_fraction = remaining.size() / total_count;
+	if (!remaining.empty()) {
+		idx_t bucket_count = MinValue<idx_t>(MAX_BUCKETS, remaining.size());
+		for (idx_t i = 0; i <= bucket_count; i++) {
+			result->bounds.push_back(remaining[i * (remaining.size() - 1) / bucket_count]);
+		}
+	}
+	return result;
+}
+
+bool Histogram::TryGetNumericValue(const Value &value, double &result) {
+	if (value.is_null) {
+		return false;
+	}
+	switch (value.type().InternalType()) {
+	case PhysicalType::INT8:
+		result = value.value_.tinyint;
+		return true;
+	case PhysicalType::INT16:
+		result = value.value_.smallint;
+		return true;
+	case PhysicalType::INT32:
+		result = value.value_.integer;
+		return true;
+	case PhysicalType::INT64:
+		result = value.value_.bigint;
+		return true;
+	case PhysicalType::INT128:
+		result = Hugeint::Cast<double>(value.value_.hugeint);
+		return true;
+	case PhysicalType::FLOAT:
+		result = value.value_.float_;
+		return true;
+	case PhysicalType::DOUBLE:
+		result = value.value_.double_;
+		return true;
+	default:
+		return false;
+	}
+}
+
+double Histogram::BucketFractionSmallerThan(const Value &constant) const {
+	if (bounds.empty() || constant <= bounds[0]) {
+		return 0;
+	}
+	idx_t bucket_count = bounds.size() - 1;
+	// find the bucket that the constant falls in
+	idx_t bucket_idx = 0;
+	while (bucket_idx < bucket_count && constant >= bounds[bucket_idx + 1]) {
+		bucket_idx++;
+	}
+	if (bucket_idx == bucket_count) {
+		return 1;
+	}
+	// assume the values are spread uniformly within the bucket; constants that cannot be interpolated (e.g. strings)
+	// are assumed to be in the middle of the bucket
+	double fraction_in_bucket = 0.5;
+	double lower, upper, value;
+	if (TryGetNumericValue(bounds[bucket_idx], lower) && TryGetNumericValue(bounds[bucket_idx + 1], upper) &&
+	    TryGetNumericValue(constant, value) && upper > lower) {
+		fraction_in_bucket = (value - lower) / (upper - lower);
+	}
+	return (bucket_idx + fraction_in_bucket) / bucket_count;
+}
+
+double Histogram::EstimateSelectivity(ExpressionType comparison_type, const Value &constant) const {
+	if (constant.type() != type) {
+		return -1;
+	}
+	if (constant.is_null) {
+		// a comparison with NULL never holds
+		return 0;
+	}
+	switch (comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+		for (idx_t i = 0; i < common_values.size(); i++) {
+			if (common_values[i] == constant) {
+				return common_frequencies[i];
+			}
+		}
+		if (bounds.empty() || constant < bounds.front() || constant > bounds.back()) {
+			return 0;
+		}
+		// the other values in the buckets are assumed to occur equally often
+		return bucket_fraction / MaxValue<idx_t>(bucket_distinct_count, 1);
+	case ExpressionType::COMPARE_NOTEQUAL:
+		return MaxValue<double>(1 - null_fraction - EstimateSelectivity(ExpressionType::COMPARE_EQUAL, constant), 0);
+	case ExpressionType::COMPARE_LESSTHAN:
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+	case ExpressionType::COMPARE_GREATERTHAN:
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+		bool is_smaller = comparison_type == ExpressionType::COMPARE_LESSTHAN ||
+		                  comparison_type == ExpressionType::COMPARE_LESSTHANOREQUALTO;
+		double result = 0;
+		for (idx_t i = 0; i < common_values.size(); i++) {
+			auto &value = common_values[i];
+			bool matches;
+			switch (comparison_type) {
+			case ExpressionType::COMPARE_LESSTHAN:
+				matches = value < constant;
+				break;
+			case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+				matches = value <= constant;
+				break;
+			case ExpressionType::COMPARE_GREATERTHAN:
+				matches = value > constant;
+				break;
+			default:
+				matches = value >= constant;
+				break;
+			}
+			if (matches) {
+				result += common_frequencies[i];
+			}
+		}
+		if (!bounds.empty()) {
+			double smaller = BucketFractionSmallerThan(constant);
+			result += bucket_fraction * (is_smaller ? smaller : 1 - smaller);
+		}
+		return MinValue<double>(result, 1);
+	}
+	default:
+		return -1;
+	}
+}
+
+void Histogram::Serialize(Serializer &serializer) {
+	serializer.Write<double>(null_fraction);
+	serializer.Write<idx_t>(common_values.size());
+	for (idx_t i = 0; i < common_values.size(); i++) {
+		common_values[i].Serialize(serializer);
+		serializer.Write<double>(common_frequencies[i]);
+	}
+	serializer.Write<idx_t>(bounds.size());
+	for (auto &bound : bounds) {
+		bound.Serialize(serializer);
+	}
+	serializer.Write<double>(bucket_fraction);
+	serializer.Write<idx_t>(bucket_distinct_count);
+}
+
+unique_ptr<Histogram> Histogram::Deserialize(Deserializer &source, LogicalType type) {
+	auto result = make_unique<Histogram>(move(type));
+	result->null_fraction = source.Read<double>();
+	auto common_count = source.Read<idx_t>();
+	for (idx_t i = 0; i < common_count; i++) {
+		result->common_values.push_back(Value::Deserialize(source));
+		result->common_frequencies.push_back(source.Read<double>());
+	}
+	auto bound_count = source.Read<idx_t>();
+	for (idx_t i = 0; i < bound_count; i++) {
+		result->bounds.push_back(Value::Deserialize(source));
+	}
+	result->bucket_fraction = source.Read<double>();
+	result->bucket_distinct_count = source.Read<idx_t>();
+	return result;
+}
+
+string Histogram::ToString() const {
+	string common;
+	for (idx_t i = 0; i < common_values.size(); i++) {
+		common += (i > 0 ? ", " : "") + common_values[i].ToString() + ": " + to_string(common_frequencies[i]);
+	}
+	string buckets;
+	for (idx_t i = 0; i < bounds.size(); i++) {
+		buckets += (i > 0 ? ", " : "") + bounds[i].ToString();
+	}
+	return StringUtil::Format("Histogram<%s> [Null Fraction: %f, Common Values: [%s], Bounds: [%s]]", type.ToString(),
+	                          null_fraction, common, buckets);
+}
+
+} // namespace duckdb
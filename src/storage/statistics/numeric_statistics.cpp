@@ -14,8 +14,8 @@ NumericStatistics::NumericStatistics(LogicalType type_p, Value min_p, Value max_
 }
 
 void NumericStatistics::Merge(const BaseStatistics &other_p) {
+	BaseStatistics::Merge(other_p);
 	auto &other = (const NumericStatistics &)other_p;
-	has_null = has_null || other.has_null;
 	if (other.min < min) {
 		min = other.min;
 	}
@@ -43,7 +43,7 @@ bool NumericStatistics::CheckZonemap(ExpressionType comparison_type, Value const
 
 unique_ptr<BaseStatistics> NumericStatistics::Copy() {
 	auto stats = make_unique<NumericStatistics>(type, min, max);
-	stats->has_null = has_null;
+	CopyBase(*stats);
 	return move(stats);
 }
 
@@ -22,8 +22,8 @@ unique_ptr<BaseStatistics> StringStatistics::Copy() {
 	memcpy(stats->max, max, MAX_STRING_MINMAX_SIZE);
 	stats->has_unicode = has_unicode;
 	stats->max_string_length = max_string_length;
-	stats->max_string_length = max_string_length;
-	stats->has_null = has_null;
+	stats->has_overflow_strings = has_overflow_strings;
+	CopyBase(*stats);
 	return move(stats);
 }
 
@@ -91,6 +91,7 @@ void StringStatistics::Update(const string_t &value) {
 }
 
 void StringStatistics::Merge(const BaseStatistics &other_) {
+	BaseStatistics::Merge(other_);
 	auto &other = (const StringStatistics &)other_;
 	if (string_value_comparison(other.min, MAX_STRING_MINMAX_SIZE, min) < 0) {
 		memcpy(min, other.min, MAX_STRING_MINMAX_SIZE);
@@ -98,7 +99,6 @@ void StringStatistics::Merge(const BaseStatistics &other_) {
 	if (string_value_comparison(other.max, MAX_STRING_MINMAX_SIZE, max) > 0) {
 		memcpy(max, other.max, MAX_STRING_MINMAX_SIZE);
 	}
-	has_null = has_null || other.has_null;
 	has_unicode = has_unicode || other.has_unicode;
 	max_string_length = MaxValue<uint32_t>(max_string_length, other.max_string_length);
 	has_overflow_strings = has_overflow_strings || other.has_overflow_strings;
@@ -3,6 +3,6 @@
 namespace duckdb {
 using namespace std;
 
-const uint64_t VERSION_NUMBER = 7;
+const uint64_t VERSION_NUMBER = 11;
 
 } // namespace duckdb
@@ -67,32 +67,25 @@ void StorageManager::Initialize() {
 	}
 }
 
-void StorageManager::Checkpoint(string wal_path) {
-	auto &fs = database.GetFileSystem();
-	if (!fs.FileExists(wal_path)) {
-		// no WAL to checkpoint
-		return;
-	}
-	if (read_only) {
-		// cannot checkpoint in read-only system
+bool StorageManager::WALIsLarge(string &wal_path) {
+	BufferedFileReader reader(database.GetFileSystem(), wal_path.c_str());
+	return reader.FileSize() > database.config.checkpoint_wal_size;
+}
+
+bool StorageManager::CheckpointIsRequired() {
+	return wal.initialized && idx_t(wal.GetWALSize()) > database.config.checkpoint_wal_size;
+}
+
+void StorageManager::CreateCheckpoint() {
+	if (!wal.initialized) {
+		// in-memory or read-only database: nothing to checkpoint
 		return;
 	}
-	// check the size of the WAL
-	{
-		BufferedFileReader reader(fs, wal_path.c_str());
-		if (reader.FileSize() <= database.config.checkpoint_wal_size) {
-			// WAL is too small
-			return;
-		}
-	}
-
-	// checkpoint the database
-	// FIXME: we do this now by creating a new database and forcing a checkpoint in that database
-	// then reloading the file again
-	// this should be fixed and turned into an incremental checkpoint
-	DBConfig config;
-	config.checkpoint_only = true;
-	DuckDB db(path, &config);
+	CheckpointManager checkpointer(*this);
+	checkpointer.CreateCheckpoint();
+	// all committed changes are now stored in the database file: the WAL can be emptied
+	wal.Truncate(0);
+	wal.Flush();
 }
 
 void StorageManager::LoadDatabase() {
@@ -114,9 +107,6 @@ void StorageManager::LoadDatabase() {
 		buffer_manager = make_unique<BufferManager>(fs, *block_manager, database.config.temporary_directory,
 		                                            database.config.maximum_memory);
 	} else {
-		if (!database.config.checkpoint_only) {
-			Checkpoint(wal_path);
-		}
 		// initialize the block manager while loading the current db file
 		auto sf = make_unique<SingleFileBlockManager>(fs, path, read_only, false, database.config.use_direct_io);
 		buffer_manager =
@@ -131,8 +121,7 @@ void StorageManager::LoadDatabase() {
 		if (fs.FileExists(wal_path)) {
 			// replay the WAL
 			WriteAheadLog::Replay(database, wal_path);
-			if (database.config.checkpoint_only) {
-				D_ASSERT(!read_only);
+			if (!read_only && WALIsLarge(wal_path)) {
 				// checkpoint the database
 				checkpointer.CreateCheckpoint();
 				// remove the WAL
@@ -141,7 +130,7 @@ void StorageManager::LoadDatabase() {
 		}
 	}
 	// initialize the WAL file
-	if (!database.config.checkpoint_only && !read_only) {
+	if (!read_only) {
 		wal.Initialize(wal_path);
 	}
 }
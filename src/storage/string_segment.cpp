@@ -1,4 +1,5 @@
 #include "duckdb/storage/string_segment.hpp"
+#include "duckdb/common/types/hash.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/storage/numeric_segment.hpp"
 #include "duckdb/transaction/update_info.hpp"
@@ -18,6 +19,7 @@ StringSegment::StringSegment(BufferManager &manager, idx_t row_start, block_id_t
 	// the vector_size is given in the size of the dictionary offsets
 	this->vector_size = STANDARD_VECTOR_SIZE * sizeof(int32_t) + sizeof(nullmask_t);
 	this->string_updates = nullptr;
+	this->shared_dictionary = false;
 
 	if (block_id == INVALID_BLOCK) {
 		// start off with an empty string segment: allocate space for it
@@ -74,7 +76,8 @@ void StringSegment::ExpandStringSegment(data_ptr_t baseptr) {
 //===--------------------------------------------------------------------===//
 void StringSegment::InitializeScan(ColumnScanState &state) {
 	// pin the primary buffer
-	state.primary_handle = manager.Pin(block);
+	state.primary_handle = manager.Pin(block, state.scan_id);
+	state.dictionary_filter_results.clear();
 }
 
 //===--------------------------------------------------------------------===//
@@ -111,6 +114,11 @@ void StringSegment::Select(ColumnScanState &state, Vector &result, SelectionVect
 	auto base_data = (int32_t *)(base + sizeof(nullmask_t));
 	auto base_nullmask = (nullmask_t *)base;
 
+	if (shared_dictionary && !(string_updates && string_updates[vector_index])) {
+		// the dictionary is shared between the rows of the segment: evaluate the filters per dictionary entry
+		SelectDictionary(state, result, baseptr, base_data, sel, approved_tuple_count, tableFilter, *base_nullmask);
+		return;
+	}
 	if (tableFilter.size() == 1) {
 		switch (tableFilter[0].comparison_type) {
 		case ExpressionType::COMPARE_EQUAL: {
@@ -171,6 +179,61 @@ void StringSegment::Select(ColumnScanState &state, Vector &result, SelectionVect
 	}
 }
 
+static bool StringPassesFilter(string_t value, TableFilter &filter) {
+	string_t constant(filter.constant.str_value);
+	switch (filter.comparison_type) {
+	case ExpressionType::COMPARE_EQUAL:
+		return Equals::Operation(value, constant);
+	case ExpressionType::COMPARE_LESSTHAN:
+		return LessThan::Operation(value, constant);
+	case ExpressionType::COMPARE_GREATERTHAN:
+		return GreaterThan::Operation(value, constant);
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		return LessThanEquals::Operation(value, constant);
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		return GreaterThanEquals::Operation(value, constant);
+	default:
+		throw NotImplementedException("Unknown comparison type for filter pushed down to table!");
+	}
+}
+
+void StringSegment::SelectDictionary(ColumnScanState &state, Vector &result, data_ptr_t baseptr,
+                                     int32_t *dict_offset, SelectionVector &sel, idx_t &approved_tuple_count,
+                                     vector<TableFilter> &tableFilter, nullmask_t &source_nullmask) {
+	result.vector_type = VectorType::FLAT_VECTOR;
+	auto result_data = FlatVector::GetData<string_t>(result);
+	auto &filter_results = state.dictionary_filter_results;
+	SelectionVector new_sel(approved_tuple_count);
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < approved_tuple_count; i++) {
+		idx_t src_idx = sel.get_index(i);
+		if (source_nullmask[src_idx]) {
+			continue;
+		}
+		auto offset = dict_offset[src_idx];
+		auto entry = filter_results.find(offset);
+		if (entry == filter_results.end()) {
+			// first time we encounter this dictionary entry: evaluate the filters on it
+			auto value = FetchStringFromDict(result, baseptr, offset);
+			bool passes = true;
+			for (auto &filter : tableFilter) {
+				if (!StringPassesFilter(value, filter)) {
+					passes = false;
+					break;
+				}
+			}
+			entry = filter_results.insert(make_pair(offset, passes)).first;
+		}
+		if (entry->second) {
+			// only fetch the strings of the rows that pass the filter
+			result_data[src_idx] = FetchStringFromDict(result, baseptr, offset);
+			new_sel.set_index(result_count++, src_idx);
+		}
+	}
+	sel.Initialize(new_sel);
+	approved_tuple_count = result_count;
+}
+
 //===--------------------------------------------------------------------===//
 // Fetch base data
 //===--------------------------------------------------------------------===//
@@ -451,6 +514,13 @@ idx_t StringSegment::Append(SegmentStatistics &stats, Vector &data, idx_t offset
 	return tuple_count - initial_count;
 }
 
+void StringSegment::RevertAppend(idx_t start_tuple) {
+	UncompressedSegment::RevertAppend(start_tuple);
+	// the strings of the removed tuples remain in the dictionary: drop the vectors that no longer hold any tuples, so
+	// that appends have to check for remaining space again before they use another vector
+	max_vector_count = MaxValue<idx_t>((tuple_count + (STANDARD_VECTOR_SIZE - 1)) / STANDARD_VECTOR_SIZE, 1);
+}
+
 idx_t StringSegment::RemainingSpace(BufferHandle &handle) {
 	idx_t used_space = GetDictionaryOffset(handle) + max_vector_count * vector_size;
 	D_ASSERT(Storage::BLOCK_SIZE >= used_space);
@@ -460,6 +530,9 @@ idx_t StringSegment::RemainingSpace(BufferHandle &handle) {
 static inline void update_string_stats(SegmentStatistics &stats, const string_t &new_value) {
 	auto &sstats = (StringStatistics &)*stats.statistics;
 	sstats.Update(new_value);
+	if (sstats.distinct_stats) {
+		sstats.distinct_stats->Add(Hash<string_t>(new_value));
+	}
 }
 
 void StringSegment::AppendData(BufferHandle &handle, SegmentStatistics &stats, data_ptr_t target, data_ptr_t end,
@@ -489,6 +562,16 @@ void StringSegment::AppendData(BufferHandle &handle, SegmentStatistics &stats, d
 
 			update_string_stats(stats, sdata[source_idx]);
 
+			if (dictionary_offsets) {
+				// check if the string is already stored in the dictionary
+				auto entry = dictionary_offsets->find(sdata[source_idx].GetString());
+				if (entry != dictionary_offsets->end()) {
+					result_data[target_idx] = entry->second;
+					remaining_strings--;
+					continue;
+				}
+			}
+
 			// determine whether or not the string needs to be stored in an overflow block
 			// we never place small strings in the overflow blocks: the pointer would take more space than the
 			// string itself we always place big strings (>= STRING_BLOCK_LIMIT) in the overflow blocks we also have
@@ -521,6 +604,9 @@ void StringSegment::AppendData(BufferHandle &handle, SegmentStatistics &stats, d
 			D_ASSERT(dictionary_offset <= Storage::BLOCK_SIZE);
 			result_data[target_idx] = dictionary_offset;
 			SetDictionaryOffset(handle, dictionary_offset);
+			if (dictionary_offsets) {
+				dictionary_offsets->insert(make_pair(sdata[source_idx].GetString(), (int32_t)dictionary_offset));
+			}
 		}
 		remaining_strings--;
 	}
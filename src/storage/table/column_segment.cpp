@@ -17,4 +17,49 @@ ColumnSegment::ColumnSegment(LogicalType type, ColumnSegmentType segment_type, i
       stats(type, type_size, move(statistics)) {
 }
 
+vector<shared_ptr<CheckpointBlock>> ColumnSegment::GetCheckpointBlocks() {
+	lock_guard<mutex> guard(checkpoint_lock);
+	return checkpoint_blocks;
+}
+
+void ColumnSegment::BeginCheckpoint() {
+	lock_guard<mutex> guard(checkpoint_lock);
+	modified = false;
+}
+
+void ColumnSegment::SetCheckpointBlocks(vector<shared_ptr<CheckpointBlock>> blocks) {
+	// an update that is still in the version chains might not have been committed yet: once it commits, the written
+	// data no longer matches the data of the segment
+	bool has_updates = HasUpdates();
+	lock_guard<mutex> guard(checkpoint_lock);
+	if (modified || has_updates) {
+		// the blocks might hold the data of other segments as well: none of them can refer to the blocks anymore
+		for (auto &block : blocks) {
+			block->modified = true;
+		}
+		return;
+	}
+	checkpoint_blocks = move(blocks);
+}
+
+void ColumnSegment::AddCheckpointBlock(shared_ptr<CheckpointBlock> block) {
+	// the block might have been written before rows of the segment were updated
+	bool has_updates = HasUpdates();
+	lock_guard<mutex> guard(checkpoint_lock);
+	if (has_updates) {
+		block->modified = true;
+		return;
+	}
+	checkpoint_blocks.push_back(move(block));
+}
+
+void ColumnSegment::MarkAsModified() {
+	lock_guard<mutex> guard(checkpoint_lock);
+	modified = true;
+	for (auto &block : checkpoint_blocks) {
+		block->modified = true;
+	}
+	checkpoint_blocks.clear();
+}
+
 } // namespace duckdb
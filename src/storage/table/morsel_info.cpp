@@ -105,6 +105,59 @@ void MorselInfo::RevertAppend(idx_t morsel_start) {
 	}
 }
 
+void MorselInfo::GetCommittedDeletes(Transaction &transaction, vector<std::pair<idx_t, idx_t>> &result) {
+	lock_guard<mutex> lock(morsel_lock);
+	if (!root) {
+		return;
+	}
+	SelectionVector sel_vector(STANDARD_VECTOR_SIZE);
+	for (idx_t vector_idx = 0; vector_idx < MorselInfo::MORSEL_VECTOR_COUNT; vector_idx++) {
+		auto info = root->info[vector_idx].get();
+		if (!info || vector_idx * STANDARD_VECTOR_SIZE >= count) {
+			continue;
+		}
+		// rows that are deleted by transactions that have not committed are visible to the transaction. rows that
+		// were inserted by transactions that rolled back are not: they are left behind as gaps in the table
+		idx_t max_count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, count - vector_idx * STANDARD_VECTOR_SIZE);
+		idx_t visible_count = info->GetSelVector(transaction, sel_vector, max_count);
+		if (visible_count == max_count) {
+			continue;
+		}
+		idx_t sel_idx = 0;
+		for (idx_t i = 0; i < max_count; i++) {
+			if (sel_idx < visible_count && sel_vector.get_index(sel_idx) == i) {
+				sel_idx++;
+				continue;
+			}
+			idx_t row = start + vector_idx * STANDARD_VECTOR_SIZE + i;
+			if (!result.empty() && result.back().second == row) {
+				result.back().second++;
+			} else {
+				result.push_back(std::make_pair(row, row + 1));
+			}
+		}
+	}
+}
+
+void MorselInfo::MarkAsDeleted(idx_t morsel_start, idx_t count) {
+	lock_guard<mutex> lock(morsel_lock);
+	if (!root) {
+		root = make_unique<VersionNode>();
+	}
+	for (idx_t row = morsel_start; row < morsel_start + count; row++) {
+		idx_t vector_idx = row / STANDARD_VECTOR_SIZE;
+		if (!root->info[vector_idx]) {
+			auto vector_start = this->start + vector_idx * STANDARD_VECTOR_SIZE;
+			root->info[vector_idx] = make_unique<ChunkVectorInfo>(vector_start, *this);
+		}
+		D_ASSERT(root->info[vector_idx]->type == ChunkInfoType::VECTOR_INFO);
+		auto &info = (ChunkVectorInfo &)*root->info[vector_idx];
+		// a delete id of 0 is visible to every transaction
+		info.deleted[row - vector_idx * STANDARD_VECTOR_SIZE] = 0;
+		info.any_deleted = true;
+	}
+}
+
 class VersionDeleteState {
 public:
 	VersionDeleteState(MorselInfo &info, Transaction &transaction, DataTable *table, idx_t base_row)
@@ -6,6 +6,8 @@
 #include "duckdb/storage/checkpoint/table_data_writer.hpp"
 #include "duckdb/storage/meta_block_reader.hpp"
 
+#include "duckdb/storage/compressed_segment.hpp"
+#include "duckdb/storage/empty_segment.hpp"
 #include "duckdb/storage/numeric_segment.hpp"
 #include "duckdb/storage/string_segment.hpp"
 
@@ -13,17 +15,42 @@ namespace duckdb {
 using namespace std;
 
 PersistentSegment::PersistentSegment(BufferManager &manager, block_id_t id, idx_t offset, LogicalType type, idx_t start,
-                                     idx_t count, unique_ptr<BaseStatistics> statistics)
+                                     idx_t count, unique_ptr<BaseStatistics> statistics, CompressionType compression,
+                                     vector<block_id_t> overflow_blocks, idx_t deleted_count)
     : ColumnSegment(type, ColumnSegmentType::PERSISTENT, start, count, move(statistics)), manager(manager),
       block_id(id), offset(offset) {
 	D_ASSERT(offset == 0);
-	if (type.InternalType() == PhysicalType::VARCHAR) {
-		data = make_unique<StringSegment>(manager, start, id);
+	if (compression == CompressionType::EMPTY) {
+		D_ASSERT(id == INVALID_BLOCK && deleted_count == count);
+		data = make_unique<EmptySegment>(manager, type.InternalType(), start, count);
+	} else if (type.InternalType() == PhysicalType::VARCHAR) {
+		auto string_segment = make_unique<StringSegment>(manager, start, id);
+		string_segment->shared_dictionary = compression == CompressionType::DICTIONARY;
+		for (auto &overflow_block : overflow_blocks) {
+			string_segment->persistent_overflow_blocks.push_back(manager.RegisterBlock(overflow_block));
+		}
+		data = move(string_segment);
 		data->max_vector_count = count / STANDARD_VECTOR_SIZE + (count % STANDARD_VECTOR_SIZE == 0 ? 0 : 1);
+	} else if (compression == CompressionType::COMPRESSED) {
+		data = make_unique<CompressedSegment>(manager, type.InternalType(), start, id, count);
 	} else {
 		data = make_unique<NumericSegment>(manager, type.InternalType(), start, id);
 	}
 	data->tuple_count = count;
+
+	// the segment holds the data of its block: until it is modified, a checkpoint can refer to the block as-is
+	DataPointer pointer;
+	pointer.row_start = start;
+	pointer.tuple_count = count;
+	pointer.block_id = id;
+	pointer.offset = offset;
+	pointer.compression = compression;
+	pointer.overflow_blocks = move(overflow_blocks);
+	pointer.statistics = stats.statistics->Copy();
+	vector<shared_ptr<CheckpointBlock>> blocks;
+	blocks.push_back(make_shared<CheckpointBlock>(move(pointer), deleted_count));
+	BeginCheckpoint();
+	SetCheckpointBlocks(move(blocks));
 }
 
 void PersistentSegment::InitializeScan(ColumnScanState &state) {
@@ -60,12 +87,17 @@ void PersistentSegment::FetchRow(ColumnFetchState &state, Transaction &transacti
 void PersistentSegment::Update(ColumnData &column_data, Transaction &transaction, Vector &updates, row_t *ids,
                                idx_t count) {
 	// update of persistent segment: check if the table has been updated before
-	if (block_id == data->block->BlockId()) {
+	if (block_id != INVALID_BLOCK && block_id == data->block->BlockId()) {
 		// data has not been updated before! convert the segment from one that refers to an on-disk block to one that
 		// refers to a in-memory buffer
 		data->ToTemporary();
 	}
 	data->Update(column_data, stats, transaction, updates, ids, count, this->start);
+	MarkAsModified();
+}
+
+bool PersistentSegment::HasUpdates() {
+	return data->HasUpdates();
 }
 
 } // namespace duckdb
@@ -6,6 +6,7 @@ namespace duckdb {
 
 PersistentTableData::PersistentTableData(idx_t column_count) {
 	column_stats.resize(column_count);
+	column_histograms.resize(column_count);
 	table_data.resize(column_count);
 }
 
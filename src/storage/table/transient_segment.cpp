@@ -64,6 +64,11 @@ void TransientSegment::FetchRow(ColumnFetchState &state, Transaction &transactio
 void TransientSegment::Update(ColumnData &column_data, Transaction &transaction, Vector &updates, row_t *ids,
                               idx_t count) {
 	data->Update(column_data, stats, transaction, updates, ids, count, this->start);
+	MarkAsModified();
+}
+
+bool TransientSegment::HasUpdates() {
+	return data->HasUpdates();
 }
 
 void TransientSegment::InitializeAppend(ColumnAppendState &state) {
@@ -73,12 +78,14 @@ void TransientSegment::InitializeAppend(ColumnAppendState &state) {
 idx_t TransientSegment::Append(ColumnAppendState &state, Vector &append_data, idx_t offset, idx_t count) {
 	idx_t appended = data->Append(stats, append_data, offset, count);
 	this->count += appended;
+	MarkAsModified();
 	return appended;
 }
 
 void TransientSegment::RevertAppend(idx_t start_row) {
-	data->tuple_count = start_row - this->start;
+	data->RevertAppend(start_row - this->start);
 	this->count = start_row - this->start;
+	MarkAsModified();
 }
 
 } // namespace duckdb
@@ -39,7 +39,7 @@ static void CheckForConflicts(UpdateInfo *info, Transaction &transaction, row_t
 	if (info->version_number == transaction.transaction_id) {
 		// this UpdateInfo belongs to the current transaction, set it in the node
 		node = info;
-	} else if (info->version_number > transaction.start_time) {
+	} else if (info->version_number >= transaction.start_time) {
 		// potential conflict, check that tuple ids do not conflict
 		// as both ids and info->tuples are sorted, this is similar to a merge join
 		idx_t i = 0, j = 0;
@@ -252,6 +252,14 @@ void UncompressedSegment::filterSelection(SelectionVector &sel, Vector &result,
 		                             nullmask);
 		break;
 	}
+	case PhysicalType::INT128: {
+		auto result_flat = FlatVector::GetData<hugeint_t>(result);
+		auto predicate_vector = Vector(Value::HUGEINT(filter.constant.value_.hugeint));
+		auto predicate = FlatVector::GetData<hugeint_t>(predicate_vector);
+		filterSelectionType<hugeint_t>(result_flat, predicate, sel, approved_tuple_count, filter.comparison_type,
+		                               nullmask);
+		break;
+	}
 	case PhysicalType::FLOAT: {
 		auto result_flat = FlatVector::GetData<float>(result);
 		auto predicate_vector = Vector(filter.constant.value_.float_);
@@ -360,6 +368,37 @@ void UncompressedSegment::CleanupUpdate(UpdateInfo *info) {
 	}
 }
 
+bool UncompressedSegment::HasUpdates() {
+	auto read_lock = lock.GetSharedLock();
+	if (!versions) {
+		return false;
+	}
+	for (idx_t i = 0; i < max_vector_count; i++) {
+		if (versions[i]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//===--------------------------------------------------------------------===//
+// Revert Append
+//===--------------------------------------------------------------------===//
+void UncompressedSegment::RevertAppend(idx_t start_tuple) {
+	D_ASSERT(start_tuple <= tuple_count);
+	if (start_tuple == tuple_count) {
+		return;
+	}
+	// appends only set the bits of NULL values in the nullmask: clear the bits of the removed tuples, so the tuples
+	// that are appended in their place start with a clean nullmask
+	auto handle = manager.Pin(block);
+	for (idx_t tuple_idx = start_tuple; tuple_idx < tuple_count; tuple_idx++) {
+		auto &nullmask = *((nullmask_t *)(handle->node->buffer + (tuple_idx / STANDARD_VECTOR_SIZE) * vector_size));
+		nullmask[tuple_idx % STANDARD_VECTOR_SIZE] = false;
+	}
+	tuple_count = start_tuple;
+}
+
 //===--------------------------------------------------------------------===//
 // ToTemporary
 //===--------------------------------------------------------------------===//
@@ -6,6 +6,7 @@
 #include "duckdb/catalog/catalog_entry/view_catalog_entry.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/database.hpp"
+#include "duckdb/parallel/task_group.hpp"
 #include "duckdb/parser/parsed_data/alter_table_info.hpp"
 #include "duckdb/parser/parsed_data/drop_info.hpp"
 #include "duckdb/parser/parsed_data/create_schema_info.hpp"
@@ -15,23 +16,77 @@
 #include "duckdb/planner/parsed_data/bound_create_table_info.hpp"
 #include "duckdb/common/printer.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table/persistent_segment.hpp"
 
 using namespace std;
 
 namespace duckdb {
+
+//! An insert, delete or update of the WAL
+struct ReplayDataEntry {
+	WALType type;
+	TableCatalogEntry *table;
+	//! The updated column (for updates)
+	column_t column_index = 0;
+	unique_ptr<DataChunk> chunk;
+	//! The blocks that hold the inserted rows of every column (for inserts of rows that were written to blocks)
+	vector<vector<DataPointer>> data_pointers;
+	//! The amount of rows of the entry
+	idx_t row_count = 0;
+};
+
+//! The data entries of a single WAL transaction for a single table
+struct ReplayTableTransaction {
+	bool has_inserts = false;
+	//! Whether or not the transaction deletes or updates rows
+	bool has_changes = false;
+	vector<ReplayDataEntry> entries;
+};
+
+//! The data entries of a single table of a batch of WAL transactions, in WAL order
+struct ReplayTableData {
+	TableCatalogEntry *table;
+	vector<ReplayTableTransaction> transactions;
+};
+
+//! The data of the WAL is replayed in batches of transactions. Within a batch, the data of every table is replayed
+//! by a separate task, and consecutive transactions that only insert into a table are replayed as a single large
+//! append. Catalog changes are replayed on the main thread in WAL order, after the data of the preceding batch, and
+//! transactions that change several tables are replayed on their own in a single context.
 class ReplayState {
 public:
 	ReplayState(DuckDB &db, ClientContext &context, Deserializer &source)
-	    : db(db), context(context), source(source), current_table(nullptr) {
+	    : db(db), context(context), source(source), current_table(nullptr), replay_directly(false),
+	      batch_row_count(0) {
 	}
 
 	DuckDB &db;
 	ClientContext &context;
 	Deserializer &source;
 	TableCatalogEntry *current_table;
+	//! The data entries of the current WAL transaction
+	vector<ReplayDataEntry> transaction_entries;
+	//! Whether or not the data entries of the current WAL transaction are replayed directly in the main context
+	//! (i.e. whether the transaction changes the catalog)
+	bool replay_directly;
+	//! The data of the current batch of transactions, grouped by table
+	vector<unique_ptr<ReplayTableData>> batch;
+	unordered_map<TableCatalogEntry *, idx_t> batch_tables;
+	//! The amount of rows in the current batch
+	idx_t batch_row_count;
+
+	//! The amount of rows after which a batch of transactions is replayed
+	static constexpr idx_t BATCH_ROW_COUNT = 1048576;
 
 public:
 	void ReplayEntry(WALType entry_type);
+	//! Finish the current WAL transaction: its entries are added to the current batch
+	void FinishTransaction();
+	//! Replay the data of the current batch of transactions
+	void ReplayBatch();
 
 private:
 	void ReplayCreateTable();
@@ -53,10 +108,152 @@ private:
 
 	void ReplayUseTable();
 	void ReplayInsert();
+	void ReplayInsertBlocks();
 	void ReplayDelete();
 	void ReplayUpdate();
+
+	void AddDataEntry(ReplayDataEntry entry);
+	void BeginDirectReplay();
 };
 
+//! Appends the rows that a transaction wrote to blocks before it committed to the table
+static void ReplayInsertBlocksInContext(ClientContext &context, ReplayDataEntry &entry) {
+	auto &table = *entry.table;
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	vector<vector<unique_ptr<PersistentSegment>>> segments(table.columns.size());
+	for (idx_t col = 0; col < table.columns.size(); col++) {
+		for (auto &pointer : entry.data_pointers[col]) {
+			segments[col].push_back(make_unique<PersistentSegment>(
+			    buffer_manager, pointer.block_id, pointer.offset, table.columns[col].type, pointer.row_start,
+			    pointer.tuple_count, pointer.statistics->Copy(), pointer.compression, pointer.overflow_blocks));
+		}
+	}
+	auto types = table.GetTypes();
+	DataChunk chunk;
+	chunk.Initialize(types);
+	vector<ColumnScanState> states(table.columns.size());
+	vector<idx_t> segment_indexes(table.columns.size(), 0);
+	idx_t row = entry.data_pointers[0][0].row_start;
+	idx_t end = row + entry.row_count;
+	while (row < end) {
+		chunk.Reset();
+		// the blocks of every column start at the same vector boundaries, so the next vector of every column holds
+		// the same rows
+		idx_t count = STANDARD_VECTOR_SIZE;
+		for (idx_t col = 0; col < table.columns.size(); col++) {
+			auto &column_segments = segments[col];
+			auto &segment_idx = segment_indexes[col];
+			while (segment_idx < column_segments.size() &&
+			       row >= column_segments[segment_idx]->start + column_segments[segment_idx]->count) {
+				segment_idx++;
+			}
+			if (segment_idx == column_segments.size() || row < column_segments[segment_idx]->start ||
+			    (row - column_segments[segment_idx]->start) % STANDARD_VECTOR_SIZE != 0) {
+				throw Exception("Corrupt WAL: the blocks of an insert are not aligned");
+			}
+			auto &segment = *column_segments[segment_idx];
+			idx_t vector_index = (row - segment.start) / STANDARD_VECTOR_SIZE;
+			count = MinValue<idx_t>(count, segment.start + segment.count - row);
+			segment.Fetch(states[col], vector_index, chunk.data[col]);
+		}
+		chunk.SetCardinality(count);
+		table.storage->Append(table, context, chunk);
+		row += count;
+	}
+}
+
+//! Replays a single data entry in the given context
+static void ReplayDataEntryInContext(ClientContext &context, ReplayDataEntry &entry) {
+	auto &table = *entry.table;
+	if (entry.type == WALType::INSERT_BLOCKS) {
+		ReplayInsertBlocksInContext(context, entry);
+		return;
+	}
+	auto &chunk = *entry.chunk;
+	switch (entry.type) {
+	case WALType::INSERT_TUPLE:
+		table.storage->Append(table, context, chunk);
+		break;
+	case WALType::DELETE_TUPLE: {
+		D_ASSERT(chunk.ColumnCount() == 1 && chunk.data[0].type == LOGICAL_ROW_TYPE);
+		row_t row_ids[1];
+		Vector row_identifiers(LOGICAL_ROW_TYPE, (data_ptr_t)row_ids);
+
+		auto source_ids = FlatVector::GetData<row_t>(chunk.data[0]);
+		// delete the tuples from the table
+		for (idx_t i = 0; i < chunk.size(); i++) {
+			row_ids[0] = source_ids[i];
+			table.storage->Delete(table, context, row_identifiers, 1);
+		}
+		break;
+	}
+	case WALType::UPDATE_TUPLE: {
+		vector<column_t> column_ids {entry.column_index};
+		// remove the row id vector from the chunk
+		auto row_ids = move(chunk.data.back());
+		chunk.data.pop_back();
+
+		table.storage->Update(table, context, row_ids, column_ids, chunk);
+		break;
+	}
+	default:
+		throw Exception("Invalid WAL data entry type!");
+	}
+}
+
+//! Replays the data of a single table of a batch in its own context, in WAL order
+static void ReplayTableDataInContext(DuckDB &db, ReplayTableData &data) {
+	ClientContext context(db);
+	context.transaction.SetAutoCommit(false);
+	context.transaction.BeginTransaction();
+	try {
+		bool has_inserts = false, has_changes = false;
+		for (auto &transaction : data.transactions) {
+			// transactions that only insert rows are replayed together, as are transactions that only delete or update
+			// rows. deletes and updates refer to rows by their row id, so the inserts before them have to be
+			// committed first
+			bool only_inserts = !transaction.has_changes && !has_changes;
+			bool only_changes = !transaction.has_inserts && !has_inserts;
+			if ((has_inserts || has_changes) && !only_inserts && !only_changes) {
+				context.transaction.Commit();
+				context.transaction.SetAutoCommit(false);
+				context.transaction.BeginTransaction();
+				has_inserts = false;
+				has_changes = false;
+			}
+			has_inserts = has_inserts || transaction.has_inserts;
+			has_changes = has_changes || transaction.has_changes;
+			for (auto &entry : transaction.entries) {
+				ReplayDataEntryInContext(context, entry);
+			}
+		}
+		context.transaction.Commit();
+	} catch (...) {
+		if (context.transaction.HasActiveTransaction()) {
+			context.transaction.Rollback();
+		}
+		throw;
+	}
+}
+
+//! Replays the data entries of a single WAL transaction in its own context, as a single transaction
+static void ReplayTransactionInContext(DuckDB &db, vector<ReplayDataEntry> &entries) {
+	ClientContext context(db);
+	context.transaction.SetAutoCommit(false);
+	context.transaction.BeginTransaction();
+	try {
+		for (auto &entry : entries) {
+			ReplayDataEntryInContext(context, entry);
+		}
+		context.transaction.Commit();
+	} catch (...) {
+		if (context.transaction.HasActiveTransaction()) {
+			context.transaction.Rollback();
+		}
+		throw;
+	}
+}
+
 void WriteAheadLog::Replay(DuckDB &database, string &path) {
 	BufferedFileReader reader(database.GetFileSystem(), path.c_str());
 
@@ -83,11 +280,15 @@ void WriteAheadLog::Replay(DuckDB &database, string &path) {
 				// flush: commit the current transaction
 				context.transaction.Commit();
 				context.transaction.SetAutoCommit(false);
+				state.FinishTransaction();
 				// check if the file is exhausted
 				if (reader.Finished()) {
 					// we finished reading the file: break
 					break;
 				}
+				if (state.batch_row_count >= ReplayState::BATCH_ROW_COUNT) {
+					state.ReplayBatch();
+				}
 				// otherwise we keep on reading
 				context.transaction.BeginTransaction();
 			} else {
@@ -99,14 +300,148 @@ void WriteAheadLog::Replay(DuckDB &database, string &path) {
 		// FIXME: this report a proper warning in the connection
 		Printer::Print(StringUtil::Format("Exception in WAL playback: %s\n", ex.what()));
 		// exception thrown in WAL replay: rollback
-		context.transaction.Rollback();
+		if (context.transaction.HasActiveTransaction()) {
+			context.transaction.Rollback();
+		}
+	}
+	// replay the data of the transactions that were read completely
+	try {
+		state.ReplayBatch();
+	} catch (std::exception &ex) {
+		Printer::Print(StringUtil::Format("Exception in WAL playback: %s\n", ex.what()));
 	}
 }
 
+void ReplayState::FinishTransaction() {
+	replay_directly = false;
+	if (transaction_entries.empty()) {
+		return;
+	}
+	for (auto &entry : transaction_entries) {
+		if (entry.table == transaction_entries[0].table) {
+			continue;
+		}
+		// the transaction changes several tables: it is replayed after the preceding transactions in a single context,
+		// so it is either applied entirely or not at all
+		ReplayBatch();
+		auto entries = move(transaction_entries);
+		transaction_entries.clear();
+		ReplayTransactionInContext(db, entries);
+		return;
+	}
+	// group the entries of the transaction by table
+	unordered_map<TableCatalogEntry *, ReplayTableTransaction *> transactions;
+	for (auto &entry : transaction_entries) {
+		auto table_entry = transactions.find(entry.table);
+		ReplayTableTransaction *transaction;
+		if (table_entry == transactions.end()) {
+			auto batch_entry = batch_tables.find(entry.table);
+			idx_t table_idx;
+			if (batch_entry == batch_tables.end()) {
+				auto data = make_unique<ReplayTableData>();
+				data->table = entry.table;
+				table_idx = batch.size();
+				batch_tables[entry.table] = table_idx;
+				batch.push_back(move(data));
+			} else {
+				table_idx = batch_entry->second;
+			}
+			batch[table_idx]->transactions.push_back(ReplayTableTransaction());
+			transaction = &batch[table_idx]->transactions.back();
+			transactions[entry.table] = transaction;
+		} else {
+			transaction = table_entry->second;
+		}
+		if (entry.type == WALType::INSERT_TUPLE || entry.type == WALType::INSERT_BLOCKS) {
+			transaction->has_inserts = true;
+		} else {
+			transaction->has_changes = true;
+		}
+		batch_row_count += entry.row_count;
+		transaction->entries.push_back(move(entry));
+	}
+	transaction_entries.clear();
+}
+
+void ReplayState::ReplayBatch() {
+	auto tables = move(batch);
+	batch.clear();
+	batch_tables.clear();
+	batch_row_count = 0;
+	if (tables.empty()) {
+		return;
+	}
+	// rows that are deleted from an index are only removed from it once no transaction can see them anymore, so the
+	// tables of a batch are only replayed in parallel if no rows are deleted from a table with indexes: otherwise
+	// re-inserting a deleted key could fail
+	auto &scheduler = TaskScheduler::GetScheduler(context);
+	bool parallel = tables.size() > 1 && scheduler.NumberOfThreads() > 1;
+	for (auto &data : tables) {
+		if (data->table->storage->info->indexes.empty()) {
+			continue;
+		}
+		for (auto &transaction : data->transactions) {
+			if (transaction.has_changes) {
+				parallel = false;
+			}
+		}
+	}
+	if (!parallel) {
+		for (auto &data : tables) {
+			ReplayTableDataInContext(db, *data);
+		}
+		return;
+	}
+	TaskGroup tasks(scheduler);
+	for (auto &data : tables) {
+		auto table_data = data.get();
+		tasks.Schedule([this, table_data]() { ReplayTableDataInContext(db, *table_data); });
+	}
+	tasks.Finish();
+}
+
+void ReplayState::AddDataEntry(ReplayDataEntry entry) {
+	if (replay_directly) {
+		ReplayDataEntryInContext(context, entry);
+	} else {
+		transaction_entries.push_back(move(entry));
+	}
+}
+
+void ReplayState::BeginDirectReplay() {
+	if (replay_directly) {
+		return;
+	}
+	// the transaction changes the catalog: the data of the preceding transactions is replayed first, after which the
+	// transaction is replayed in the main context. the main context has only looked up tables so far, so its
+	// transaction is restarted to not keep the deletes of the batch from being cleaned up
+	context.transaction.Commit();
+	context.transaction.SetAutoCommit(false);
+	ReplayBatch();
+	context.transaction.BeginTransaction();
+	replay_directly = true;
+	for (auto &entry : transaction_entries) {
+		ReplayDataEntryInContext(context, entry);
+	}
+	transaction_entries.clear();
+}
+
 //===--------------------------------------------------------------------===//
 // Replay Entries
 //===--------------------------------------------------------------------===//
 void ReplayState::ReplayEntry(WALType entry_type) {
+	switch (entry_type) {
+	case WALType::SEQUENCE_VALUE:
+	case WALType::USE_TABLE:
+	case WALType::INSERT_TUPLE:
+	case WALType::INSERT_BLOCKS:
+	case WALType::DELETE_TUPLE:
+	case WALType::UPDATE_TUPLE:
+		break;
+	default:
+		BeginDirectReplay();
+		break;
+	}
 	switch (entry_type) {
 	case WALType::CREATE_TABLE:
 		ReplayCreateTable();
@@ -150,6 +485,9 @@ void ReplayState::ReplayEntry(WALType entry_type) {
 	case WALType::INSERT_TUPLE:
 		ReplayInsert();
 		break;
+	case WALType::INSERT_BLOCKS:
+		ReplayInsertBlocks();
+		break;
 	case WALType::DELETE_TUPLE:
 		ReplayDelete();
 		break;
@@ -288,53 +626,81 @@ void ReplayState::ReplayInsert() {
 	if (!current_table) {
 		throw Exception("Corrupt WAL: insert without table");
 	}
-	DataChunk chunk;
-	chunk.Deserialize(source);
+	ReplayDataEntry entry;
+	entry.type = WALType::INSERT_TUPLE;
+	entry.table = current_table;
+	entry.chunk = make_unique<DataChunk>();
+	entry.chunk->Deserialize(source);
+	entry.row_count = entry.chunk->size();
+
+	AddDataEntry(move(entry));
+}
 
-	// append to the current table
-	current_table->storage->Append(*current_table, context, chunk);
+void ReplayState::ReplayInsertBlocks() {
+	if (!current_table) {
+		throw Exception("Corrupt WAL: insert without table");
+	}
+	ReplayDataEntry entry;
+	entry.type = WALType::INSERT_BLOCKS;
+	entry.table = current_table;
+	auto column_count = source.Read<idx_t>();
+	if (column_count != current_table->columns.size()) {
+		throw Exception("Corrupt WAL: column count of insert does not match the table");
+	}
+	auto &block_manager = *db.storage->block_manager;
+	for (idx_t col = 0; col < column_count; col++) {
+		vector<DataPointer> column_pointers;
+		idx_t column_rows = 0;
+		auto pointer_count = source.Read<idx_t>();
+		for (idx_t i = 0; i < pointer_count; i++) {
+			auto pointer = DataPointer::Deserialize(source, current_table->columns[col].type);
+			// the blocks were written after the last checkpoint: they cannot be handed out again
+			block_manager.ReserveBlock(pointer.block_id);
+			for (auto &overflow_block : pointer.overflow_blocks) {
+				block_manager.ReserveBlock(overflow_block);
+			}
+			column_rows += pointer.tuple_count;
+			column_pointers.push_back(move(pointer));
+		}
+		if (pointer_count == 0 || (col > 0 && column_rows != entry.row_count)) {
+			throw Exception("Corrupt WAL: column length mismatch in insert");
+		}
+		entry.row_count = column_rows;
+		entry.data_pointers.push_back(move(column_pointers));
+	}
+	AddDataEntry(move(entry));
 }
 
 void ReplayState::ReplayDelete() {
 	if (!current_table) {
 		throw Exception("Corrupt WAL: delete without table");
 	}
-	DataChunk chunk;
-	chunk.Deserialize(source);
-
-	D_ASSERT(chunk.ColumnCount() == 1 && chunk.data[0].type == LOGICAL_ROW_TYPE);
-	row_t row_ids[1];
-	Vector row_identifiers(LOGICAL_ROW_TYPE, (data_ptr_t)row_ids);
-
-	auto source_ids = FlatVector::GetData<row_t>(chunk.data[0]);
-	// delete the tuples from the current table
-	for (idx_t i = 0; i < chunk.size(); i++) {
-		row_ids[0] = source_ids[i];
-		current_table->storage->Delete(*current_table, context, row_identifiers, 1);
-	}
+	ReplayDataEntry entry;
+	entry.type = WALType::DELETE_TUPLE;
+	entry.table = current_table;
+	entry.chunk = make_unique<DataChunk>();
+	entry.chunk->Deserialize(source);
+	entry.row_count = entry.chunk->size();
+
+	AddDataEntry(move(entry));
 }
 
 void ReplayState::ReplayUpdate() {
 	if (!current_table) {
 		throw Exception("Corrupt WAL: update without table");
 	}
-
-	idx_t column_index = source.Read<column_t>();
-
-	DataChunk chunk;
-	chunk.Deserialize(source);
-
-	vector<column_t> column_ids{column_index};
-	if (column_index >= current_table->columns.size()) {
+	ReplayDataEntry entry;
+	entry.type = WALType::UPDATE_TUPLE;
+	entry.table = current_table;
+	entry.column_index = source.Read<column_t>();
+	entry.chunk = make_unique<DataChunk>();
+	entry.chunk->Deserialize(source);
+	entry.row_count = entry.chunk->size();
+
+	if (entry.column_index >= current_table->columns.size()) {
 		throw Exception("Corrupt WAL: column index for update out of bounds");
 	}
-
-	// remove the row id vector from the chunk
-	auto row_ids = move(chunk.data.back());
-	chunk.data.pop_back();
-
-	// now perform the update
-	current_table->storage->Update(*current_table, context, row_ids, column_ids, chunk);
+	AddDataEntry(move(entry));
 }
 
 } // namespace duckdb
@@ -4,15 +4,21 @@
 #include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/catalog/catalog_entry/view_catalog_entry.hpp"
+#include "duckdb/common/thread.hpp"
 #include "duckdb/main/database.hpp"
 #include "duckdb/parser/parsed_data/alter_table_info.hpp"
+#include "duckdb/storage/data_pointer.hpp"
+#include "duckdb/transaction/append_info.hpp"
 
+#include <chrono>
 #include <cstring>
 
 namespace duckdb {
 using namespace std;
 
-WriteAheadLog::WriteAheadLog(DuckDB &database) : initialized(false), database(database) {
+WriteAheadLog::WriteAheadLog(DuckDB &database)
+    : initialized(false), database(database), written_sequence(0), sync_in_progress(false), synced_sequence(0),
+      sync_count(0) {
 }
 
 void WriteAheadLog::Initialize(string &path) {
@@ -132,6 +138,18 @@ void WriteAheadLog::WriteInsert(DataChunk &chunk) {
 	chunk.Serialize(*writer);
 }
 
+void WriteAheadLog::WriteInsertBlocks(AppendBlocks &blocks) {
+	D_ASSERT(blocks.count > 0);
+	writer->Write<WALType>(WALType::INSERT_BLOCKS);
+	writer->Write<idx_t>(blocks.columns.size());
+	for (auto &column_blocks : blocks.columns) {
+		writer->Write<idx_t>(column_blocks.size());
+		for (auto &block : column_blocks) {
+			block->pointer.Serialize(*writer);
+		}
+	}
+}
+
 void WriteAheadLog::WriteDelete(DataChunk &chunk) {
 	D_ASSERT(chunk.size() > 0);
 	D_ASSERT(chunk.ColumnCount() == 1 && chunk.data[0].type == LOGICAL_ROW_TYPE);
@@ -168,4 +186,59 @@ void WriteAheadLog::Flush() {
 	writer->Sync();
 }
 
+//===--------------------------------------------------------------------===//
+// Group Commit
+//===--------------------------------------------------------------------===//
+idx_t WriteAheadLog::WriteCommit() {
+	// write an empty entry
+	writer->Write<WALType>(WALType::WAL_FLUSH);
+	// write the buffered entries to the file, but do not sync it yet. the commit is only assigned a sequence number
+	// after the write has completed: a sync that starts after this point includes the commit
+	writer->Flush();
+	return ++written_sequence;
+}
+
+void WriteAheadLog::SyncCommit(idx_t commit_sequence, idx_t commit_delay) {
+	unique_lock<mutex> lock(sync_lock);
+	while (synced_sequence < commit_sequence) {
+		if (!sync_error.empty()) {
+			throw IOException("A previous sync of the WAL failed: %s", sync_error);
+		}
+		if (sync_in_progress) {
+			// another committer is syncing the WAL: wait for it to finish, its sync might include this commit
+			sync_finished.wait(lock);
+			continue;
+		}
+		// no sync is in progress: this committer syncs the WAL for every commit that has been written so far
+		sync_in_progress = true;
+		lock.unlock();
+		idx_t sync_sequence;
+		try {
+			if (commit_delay > 0) {
+				// wait for other commits to be written, so they can be included in this sync
+				std::this_thread::sleep_for(std::chrono::microseconds(commit_delay));
+			}
+			sync_sequence = written_sequence;
+			writer->handle->Sync();
+			sync_count++;
+		} catch (std::exception &ex) {
+			lock.lock();
+			sync_error = ex.what();
+			sync_in_progress = false;
+			sync_finished.notify_all();
+			throw;
+		} catch (...) { // LCOV_EXCL_START
+			lock.lock();
+			sync_error = "Unknown exception in WAL sync!";
+			sync_in_progress = false;
+			sync_finished.notify_all();
+			throw;
+		} // LCOV_EXCL_STOP
+		lock.lock();
+		sync_in_progress = false;
+		synced_sequence = MaxValue<idx_t>(synced_sequence, sync_sequence);
+		sync_finished.notify_all();
+	}
+}
+
 } // namespace duckdb
@@ -3,6 +3,7 @@
 #include "duckdb/transaction/delete_info.hpp"
 #include "duckdb/transaction/update_info.hpp"
 
+#include "duckdb/storage/data_pointer.hpp"
 #include "duckdb/storage/data_table.hpp"
 #include "duckdb/storage/write_ahead_log.hpp"
 #include "duckdb/storage/uncompressed_segment.hpp"
@@ -173,11 +174,24 @@ template <bool HAS_LOG> void CommitState::CommitEntry(UndoFlags type, data_ptr_t
 	case UndoFlags::INSERT_TUPLE: {
 		// append:
 		auto info = (AppendInfo *)data;
+		// consecutive appends that were written to blocks before the commit share the blocks: these are handled as
+		// part of the first append
+		bool first_append = info->blocks && info->blocks->start_row == info->start_row;
 		if (HAS_LOG && !info->table->info->IsTemporary()) {
-			info->table->WriteToLog(*log, info->start_row, info->count);
+			if (!info->blocks) {
+				info->table->WriteToLog(*log, info->start_row, info->count);
+			} else if (first_append) {
+				// the rows have already been written to blocks: only write references to the blocks to the WAL
+				SwitchTable(info->table->info.get(), UndoFlags::INSERT_TUPLE);
+				log->WriteInsertBlocks(*info->blocks);
+			}
 		}
 		// mark the tuples as committed
 		info->table->CommitAppend(commit_id, info->start_row, info->count);
+		if (first_append) {
+			// hand the blocks to the segments of the table, so the next checkpoint can reuse them
+			info->table->AddCheckpointBlocks(*info->blocks);
+		}
 		break;
 	}
 	case UndoFlags::DELETE_TUPLE: {
@@ -219,6 +233,14 @@ void CommitState::RevertCommit(UndoFlags type, data_ptr_t data) {
 	}
 	case UndoFlags::INSERT_TUPLE: {
 		auto info = (AppendInfo *)data;
+		if (info->blocks) {
+			// the blocks no longer hold the committed data of the table
+			for (auto &column_blocks : info->blocks->columns) {
+				for (auto &block : column_blocks) {
+					block->modified = true;
+				}
+			}
+		}
 		// revert this append
 		info->table->RevertAppend(info->start_row, info->count);
 		break;
@@ -3,14 +3,19 @@
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/unordered_set.hpp"
 #include "duckdb/parser/column_definition.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/checkpoint/table_data_writer.hpp"
 #include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/storage/write_ahead_log.hpp"
 
 #include "duckdb/transaction/append_info.hpp"
 #include "duckdb/transaction/delete_info.hpp"
 #include "duckdb/transaction/update_info.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 namespace duckdb {
@@ -54,6 +59,16 @@ void Transaction::PushAppend(DataTable *table, idx_t start_row, idx_t row_count)
 	append_info->table = table;
 	append_info->start_row = start_row;
 	append_info->count = row_count;
+	append_info->blocks = nullptr;
+	if (!table->info->IsTemporary()) {
+		optimistic_appends.push_back(append_info);
+		idx_t row_size = 0;
+		for (auto &type : table->types) {
+			row_size += GetTypeIdSize(type.InternalType());
+		}
+		optimistic_append_size += row_count * row_size;
+		unwritten_append_size += row_count * row_size;
+	}
 }
 
 UpdateInfo *Transaction::CreateUpdateInfo(idx_t type_size, idx_t entries) {
@@ -67,6 +82,86 @@ UpdateInfo *Transaction::CreateUpdateInfo(idx_t type_size, idx_t entries) {
 	return update_info;
 }
 
+void Transaction::WriteOptimisticAppends(StorageManager &storage_manager) {
+	// the remaining transaction-local rows of the tables are written to the blocks as well, instead of to the WAL
+	unordered_set<DataTable *> tables;
+	for (auto &info : optimistic_appends) {
+		tables.insert(info->table);
+	}
+	for (auto &table : tables) {
+		storage.Flush(table);
+	}
+	WriteAppendBlocks(storage_manager);
+	// the blocks have to be on disk before the WAL refers to them
+	storage_manager.block_manager->Sync();
+}
+
+void Transaction::WriteAppendBlocks(StorageManager &storage_manager) {
+	// consecutive appends to the same table that have not been written yet are written to the same blocks
+	vector<AppendInfo *> appends;
+	for (auto &info : optimistic_appends) {
+		if (!info->blocks) {
+			appends.push_back(info);
+		}
+	}
+	std::stable_sort(appends.begin(), appends.end(), [](AppendInfo *a, AppendInfo *b) {
+		return a->table != b->table ? a->table < b->table : a->start_row < b->start_row;
+	});
+	CheckpointManager manager(storage_manager);
+	for (idx_t i = 0; i < appends.size();) {
+		auto first = appends[i];
+		idx_t count = first->count;
+		idx_t end = i + 1;
+		for (; end < appends.size(); end++) {
+			if (appends[end]->table != first->table || appends[end]->start_row != first->start_row + count) {
+				break;
+			}
+			count += appends[end]->count;
+		}
+		TableDataWriter writer(manager, *first->table);
+		auto blocks = writer.WriteAppend(first->start_row, count);
+		// checkpoints that run before the transaction has finished must not free the blocks
+		for (auto &column_blocks : blocks->columns) {
+			for (auto &block : column_blocks) {
+				if (block->pointer.block_id != INVALID_BLOCK) {
+					storage_manager.block_manager->MarkBlockAsPending(block->pointer.block_id);
+				}
+				for (auto &overflow_block : block->pointer.overflow_blocks) {
+					storage_manager.block_manager->MarkBlockAsPending(overflow_block);
+				}
+			}
+		}
+		for (; i < end; i++) {
+			appends[i]->blocks = blocks.get();
+		}
+		append_blocks.push_back(move(blocks));
+	}
+	unwritten_append_size = 0;
+}
+
+void Transaction::ReleaseAppendBlocks(BlockManager &block_manager, bool free) {
+	for (auto &blocks : append_blocks) {
+		for (auto &column_blocks : blocks->columns) {
+			for (auto &block : column_blocks) {
+				if (block->pointer.block_id != INVALID_BLOCK) {
+					block_manager.ReleasePendingBlock(block->pointer.block_id, free);
+				}
+				for (auto &overflow_block : block->pointer.overflow_blocks) {
+					block_manager.ReleasePendingBlock(overflow_block, free);
+				}
+			}
+		}
+	}
+}
+
+void Transaction::PushHistogram(shared_ptr<DataTable> table, column_t column, shared_ptr<Histogram> histogram) {
+	PendingHistogram pending;
+	pending.table = move(table);
+	pending.column = column;
+	pending.histogram = move(histogram);
+	histograms.push_back(move(pending));
+}
+
 string Transaction::Commit(WriteAheadLog *log, transaction_t commit_id) noexcept {
 	this->commit_id = commit_id;
 
@@ -86,11 +181,16 @@ string Transaction::Commit(WriteAheadLog *log, transaction_t commit_id) noexcept
 			for (auto &entry : sequence_usage) {
 				log->WriteSequenceValue(entry.first, entry.second);
 			}
-			// flush the WAL
+			// write the commit to the WAL: the WAL is synced to disk after the transaction lock has been released
 			if (changes_made) {
-				log->Flush();
+				wal_sequence = log->WriteCommit();
 			}
 		}
+		// the commit succeeded: install the histograms collected by the transaction
+		for (auto &pending : histograms) {
+			pending.table->GetColumnData(pending.column).SetHistogram(move(pending.histogram));
+		}
+		histograms.clear();
 		return string();
 	} catch (std::exception &ex) {
 		undo_buffer.RevertCommit(iterator_state, transaction_id);
@@ -3,12 +3,17 @@
 #include "duckdb/catalog/catalog_set.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/helper.hpp"
+#include "duckdb/common/printer.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types/timestamp.hpp"
 #include "duckdb/catalog/catalog.hpp"
 #include "duckdb/catalog/dependency_manager.hpp"
+#include "duckdb/main/database.hpp"
 #include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/transaction/transaction.hpp"
 
+#include <algorithm>
+
 namespace duckdb {
 using namespace std;
 
@@ -39,6 +44,11 @@ Transaction *TransactionManager::StartTransaction() {
 	// obtain the start time and transaction ID of this transaction
 	transaction_t start_time = current_start_timestamp++;
 	transaction_t transaction_id = current_transaction_id++;
+	if (!unsynced_commits.empty()) {
+		// start the transaction before any commit that has not been synced to the WAL yet, so it cannot see changes
+		// that might not be durable
+		start_time = unsynced_commits.front();
+	}
 	timestamp_t start_timestamp = Timestamp::GetCurrentTimestamp();
 
 	// create the actual transaction
@@ -51,52 +61,168 @@ Transaction *TransactionManager::StartTransaction() {
 }
 
 string TransactionManager::CommitTransaction(Transaction *transaction) {
-	// obtain the transaction lock during this function
-	lock_guard<mutex> lock(transaction_lock);
+	string error;
+	// the transaction is cleaned up while committing
+	bool requires_checkpoint = transaction->requires_checkpoint;
+	{
+		// obtain a shared checkpoint lock during the commit: commits wait for a running checkpoint to finish
+		auto checkpoint_guard = checkpoint_lock.GetSharedLock();
+		auto log = storage.GetWriteAheadLog();
+		if (log && transaction->optimistic_append_size > storage.database.config.checkpoint_wal_size) {
+			// the transaction appended too many rows to write them to the WAL: write them to new blocks instead, so
+			// the commit only has to write references to the blocks to the WAL. this happens before the transaction
+			// lock is obtained, so other transactions can commit in the meantime. the shared checkpoint lock keeps a
+			// checkpoint from freeing the blocks before the WAL refers to them
+			try {
+				transaction->WriteOptimisticAppends(storage);
+			} catch (std::exception &ex) {
+				error = string("Failed to write the appended rows to the database file: ") + ex.what();
+			}
+		}
+		idx_t wal_sequence;
+		transaction_t commit_id;
+		{
+			// obtain the transaction lock while committing
+			lock_guard<mutex> lock(transaction_lock);
 
-	// obtain a commit id for the transaction
-	transaction_t commit_id = current_start_timestamp++;
-	// commit the UndoBuffer of the transaction
-	string error = transaction->Commit(storage.GetWriteAheadLog(), commit_id);
-	if (!error.empty()) {
-		// commit unsuccessful: rollback the transaction instead
-		transaction->commit_id = 0;
-		transaction->Rollback();
-	}
+			if (error.empty() && !sync_error.empty()) {
+				error = "Cannot commit: a previous sync of the WAL failed, the database has to be restarted: " +
+				        sync_error;
+			}
+			if (error.empty()) {
+				// obtain a commit id for the transaction
+				transaction_t commit_id = current_start_timestamp++;
+				// commit the UndoBuffer of the transaction
+				error = transaction->Commit(log, commit_id);
+			}
+			if (!error.empty()) {
+				// commit unsuccessful: rollback the transaction instead
+				transaction->commit_id = 0;
+				transaction->Rollback();
+			}
+			// the blocks that the appends were written to are now owned by the table, or free again
+			transaction->ReleaseAppendBlocks(*storage.block_manager, !error.empty());
+			wal_sequence = transaction->wal_sequence;
+			commit_id = transaction->commit_id;
+			if (error.empty() && wal_sequence > 0) {
+				// the commit is not visible to new transactions until its WAL entries have been synced
+				unsynced_commits.push_back(commit_id);
+			}
 
-	// commit successful: remove the transaction id from the list of active transactions
-	// potentially resulting in garbage collection
-	RemoveTransaction(transaction);
+			// commit successful: remove the transaction id from the list of active transactions
+			// potentially resulting in garbage collection
+			RemoveTransaction(transaction);
+		}
+		if (error.empty() && wal_sequence > 0) {
+			// the commit has been written to the WAL: wait until it has been synced to disk. this happens outside of
+			// the transaction lock, so the commits of other transactions can be written in the meantime and share the
+			// sync
+			string sync_failure;
+			try {
+				log->SyncCommit(wal_sequence, storage.database.config.commit_delay);
+			} catch (std::exception &ex) {
+				sync_failure = ex.what();
+			}
+			lock_guard<mutex> lock(transaction_lock);
+			if (!sync_failure.empty()) {
+				// the commit might not be durable: it remains invisible, and no other transaction can commit anymore
+				if (sync_error.empty()) {
+					sync_error = sync_failure;
+				}
+				error = "Failed to sync the WAL, the changes of the transaction might not be durable: " + sync_failure;
+			} else {
+				// the WAL has been synced up to and including this commit, which makes it (and any earlier commit)
+				// visible to transactions that start from now on
+				auto synced_end = std::upper_bound(unsynced_commits.begin(), unsynced_commits.end(), commit_id);
+				unsynced_commits.erase(unsynced_commits.begin(), synced_end);
+				// the versions that the synced commits overwrote might not be needed anymore
+				GarbageCollect();
+			}
+		}
+	}
+	if (error.empty() && (requires_checkpoint || storage.CheckpointIsRequired())) {
+		// the WAL has grown too large, or the transaction made changes that are only persisted by a checkpoint:
+		// checkpoint the database
+		try {
+			Checkpoint(requires_checkpoint);
+		} catch (std::exception &ex) {
+			// the transaction has been committed to the WAL, so the commit itself succeeded: report the failure as a
+			// warning, the checkpoint is retried after the next commit
+			Printer::Print(StringUtil::Format("Failed to checkpoint the database after a commit: %s\n", ex.what()));
+		}
+	}
 	return error;
 }
 
+void TransactionManager::Checkpoint(bool force) {
+	auto checkpoint_guard = checkpoint_lock.GetExclusiveLock();
+	// another commit might have written a checkpoint while waiting for the lock
+	if (!force && !storage.CheckpointIsRequired()) {
+		return;
+	}
+	if (HasOptimisticAppends()) {
+		// the checkpoint writes every row of the tables: it cannot be written while they contain rows of transactions
+		// that might still commit, those rows would be written both to the checkpoint and to the WAL. the checkpoint
+		// is retried after the next commit
+		if (force) {
+			throw TransactionException("Cannot checkpoint: there are active transactions that have appended rows");
+		}
+		return;
+	}
+	storage.CreateCheckpoint();
+}
+
+bool TransactionManager::HasOptimisticAppends() {
+	lock_guard<mutex> lock(transaction_lock);
+	for (auto &transaction : active_transactions) {
+		if (transaction->optimistic_append_size > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void TransactionManager::RollbackTransaction(Transaction *transaction) {
+	// the blocks that the appends of the transaction were written to are freed, which cannot happen during a checkpoint
+	unique_ptr<StorageLockKey> checkpoint_guard;
+	if (transaction->HasAppendBlocks()) {
+		checkpoint_guard = checkpoint_lock.GetSharedLock();
+	}
 	// obtain the transaction lock during this function
 	lock_guard<mutex> lock(transaction_lock);
 
 	// rollback the transaction
 	transaction->Rollback();
+	transaction->ReleaseAppendBlocks(*storage.block_manager, true);
 
 	// remove the transaction id from the list of active transactions
 	// potentially resulting in garbage collection
 	RemoveTransaction(transaction);
 }
 
+void TransactionManager::FlushLocalStorage(Transaction &transaction, DataTable &table) {
+	// the shared checkpoint lock keeps a checkpoint from running while the rows are appended to the table and the
+	// blocks are handed out
+	auto checkpoint_guard = checkpoint_lock.GetSharedLock();
+	transaction.storage.Flush(&table);
+	auto log = storage.GetWriteAheadLog();
+	if (log && transaction.optimistic_append_size > storage.database.config.checkpoint_wal_size &&
+	    transaction.unwritten_append_size >= Transaction::APPEND_WRITE_SIZE) {
+		// the transaction has appended too many rows to write them to the WAL: write them to blocks while they are
+		// loaded, so the commit only has to write the remaining rows. the rows are written in large batches, so only
+		// the last block of every column of a batch is not filled up
+		transaction.WriteAppendBlocks(storage);
+	}
+}
+
 void TransactionManager::RemoveTransaction(Transaction *transaction) noexcept {
 	// remove the transaction from the list of active transactions
 	idx_t t_index = active_transactions.size();
-	// check for the lowest and highest start time in the list of transactions
-	transaction_t lowest_start_time = TRANSACTION_ID_START;
-	transaction_t lowest_active_query = MAXIMUM_QUERY_ID;
 	for (idx_t i = 0; i < active_transactions.size(); i++) {
 		if (active_transactions[i].get() == transaction) {
 			t_index = i;
-		} else {
-			lowest_start_time = MinValue(lowest_start_time, active_transactions[i]->start_time);
-			lowest_active_query = MinValue(lowest_active_query, active_transactions[i]->active_query);
 		}
 	}
-	transaction_t lowest_stored_query = lowest_start_time;
 	D_ASSERT(t_index != active_transactions.size());
 	auto current_transaction = move(active_transactions[t_index]);
 	if (transaction->commit_id != 0) {
@@ -111,6 +237,23 @@ void TransactionManager::RemoveTransaction(Transaction *transaction) noexcept {
 	}
 	// remove the transaction from the set of currently active transactions
 	active_transactions.erase(active_transactions.begin() + t_index);
+	GarbageCollect();
+}
+
+void TransactionManager::GarbageCollect() noexcept {
+	// check for the lowest and highest start time in the list of transactions
+	transaction_t lowest_start_time = TRANSACTION_ID_START;
+	transaction_t lowest_active_query = MAXIMUM_QUERY_ID;
+	for (auto &active : active_transactions) {
+		lowest_start_time = MinValue(lowest_start_time, active->start_time);
+		lowest_active_query = MinValue(lowest_active_query, active->active_query);
+	}
+	if (!unsynced_commits.empty()) {
+		// new transactions start before the first commit that has not been synced yet: the versions that were
+		// overwritten by that commit and any later commit have to be kept for them
+		lowest_start_time = MinValue(lowest_start_time, unsynced_commits.front());
+	}
+	transaction_t lowest_stored_query = lowest_start_time;
 	// traverse the recently_committed transactions to see if we can remove any
 	idx_t i = 0;
 	for (; i < recently_committed_transactions.size(); i++) {
@@ -181,8 +324,9 @@ void TransactionManager::AddCatalogSet(ClientContext &context, unique_ptr<Catalo
 	Catalog::GetCatalog(context).dependency_manager->ClearDependencies(*catalog_set);
 
 	lock_guard<mutex> lock(transaction_lock);
-	if (active_transactions.size() > 0) {
-		// if there are active transactions we wait with deleting the objects
+	if (active_transactions.size() > 0 || !unsynced_commits.empty()) {
+		// if there are active transactions (or transactions that start before an unsynced commit can still be
+		// started) we wait with deleting the objects
 		StoredCatalogSet set;
 		set.stored_set = move(catalog_set);
 		set.highest_active_query = current_start_timestamp;
@@ -1,6 +1,7 @@
 #include "catch.hpp"
 #include "duckdb.h"
 #include "test_helpers.hpp"
+#include "duckdb/common/arrow.hpp"
 #include "duckdb/common/exception.hpp"
 
 using namespace duckdb;
@@ -445,3 +446,117 @@ TEST_CASE("Test prepared statements in C API", "[capi][.]") {
 	duckdb_destroy_result(&res);
 	duckdb_destroy_prepare(&stmt);
 }
+
+TEST_CASE("Test streaming results in C API", "[capi]") {
+	CAPITester tester;
+	duckdb_stream_result result = nullptr;
+	duckdb_chunk chunk;
+
+	// open the database in in-memory mode
+	REQUIRE(tester.OpenDatabase(nullptr));
+
+	REQUIRE_NO_FAIL(tester.Query("CREATE TABLE test AS SELECT range AS i, CASE WHEN range % 3 = 0 THEN NULL "
+	                             "ELSE 'this is string ' || range::VARCHAR END AS s, "
+	                             "DATE '1992-01-01' + (range % 10)::INTEGER AS d FROM range(0, 10000)"));
+
+	// fetch the result chunk by chunk
+	REQUIRE(duckdb_query_stream(tester.connection, "SELECT i, s, d FROM test ORDER BY i", &result) == DuckDBSuccess);
+	REQUIRE(duckdb_stream_error(result) == nullptr);
+	REQUIRE(duckdb_stream_column_count(result) == 3);
+	REQUIRE(string(duckdb_stream_column_name(result, 1)) == "s");
+	REQUIRE(duckdb_stream_column_name(result, 3) == nullptr);
+	REQUIRE(duckdb_stream_column_type(result, 0) == DUCKDB_TYPE_BIGINT);
+	REQUIRE(duckdb_stream_column_type(result, 1) == DUCKDB_TYPE_VARCHAR);
+	REQUIRE(duckdb_stream_column_type(result, 2) == DUCKDB_TYPE_DATE);
+
+	idx_t row_count = 0, chunk_count = 0, null_count = 0;
+	int64_t sum = 0;
+	while (true) {
+		REQUIRE(duckdb_stream_fetch_chunk(result, &chunk) == DuckDBSuccess);
+		if (chunk.row_count == 0) {
+			break;
+		}
+		REQUIRE(chunk.column_count == 3);
+		auto integers = (int64_t *)chunk.columns[0].data;
+		auto strings = (duckdb_string *)chunk.columns[1].data;
+		auto dates = (duckdb_date *)chunk.columns[2].data;
+		for (idx_t k = 0; k < chunk.row_count; k++) {
+			auto i = integers[k];
+			REQUIRE(i == int64_t(row_count + k));
+			sum += i;
+			if (chunk.columns[1].nullmask[k]) {
+				REQUIRE(i % 3 == 0);
+				null_count++;
+			} else {
+				REQUIRE(string(strings[k].data, strings[k].size) == "this is string " + to_string(i));
+			}
+			REQUIRE(!chunk.columns[2].nullmask[k]);
+			REQUIRE(dates[k].year == 1992);
+			REQUIRE(dates[k].day == 1 + i % 10);
+		}
+		row_count += chunk.row_count;
+		chunk_count++;
+	}
+	REQUIRE(row_count == 10000);
+	REQUIRE(chunk_count > 1);
+	REQUIRE(sum == 49995000);
+	REQUIRE(null_count == 3334);
+	// fetching after the end keeps returning empty chunks
+	REQUIRE(duckdb_stream_fetch_chunk(result, &chunk) == DuckDBSuccess);
+	REQUIRE(chunk.row_count == 0);
+	duckdb_destroy_stream_result(&result);
+	REQUIRE(result == nullptr);
+
+	// a result that is not fully fetched is closed when it is destroyed
+	REQUIRE(duckdb_query_stream(tester.connection, "SELECT * FROM test", &result) == DuckDBSuccess);
+	REQUIRE(duckdb_stream_fetch_chunk(result, &chunk) == DuckDBSuccess);
+	REQUIRE(chunk.row_count > 0);
+	duckdb_destroy_stream_result(&result);
+	REQUIRE_NO_FAIL(tester.Query("SELECT COUNT(*) FROM test"));
+
+	// errors
+	REQUIRE(duckdb_query_stream(tester.connection, "SELECT * FROM nonexisting", &result) == DuckDBError);
+	REQUIRE(duckdb_stream_error(result) != nullptr);
+	REQUIRE(duckdb_stream_fetch_chunk(result, &chunk) == DuckDBError);
+	duckdb_destroy_stream_result(&result);
+	// a fetch of a column type that is not supported by the C API fails with an error
+	REQUIRE(duckdb_query_stream(tester.connection, "SELECT LIST_VALUE(1, 2) AS l", &result) == DuckDBSuccess);
+	REQUIRE(duckdb_stream_error(result) == nullptr);
+	REQUIRE(duckdb_stream_fetch_chunk(result, &chunk) == DuckDBError);
+	REQUIRE(duckdb_stream_error(result) != nullptr);
+	duckdb_destroy_stream_result(&result);
+
+	// prepared statements
+	duckdb_prepared_statement stmt = nullptr;
+	REQUIRE(duckdb_prepare(tester.connection, "SELECT i FROM test WHERE i < $1 ORDER BY i", &stmt) == DuckDBSuccess);
+	REQUIRE(duckdb_bind_int64(stmt, 1, 10) == DuckDBSuccess);
+	REQUIRE(duckdb_execute_prepared_stream(stmt, &result) == DuckDBSuccess);
+	REQUIRE(duckdb_stream_fetch_chunk(result, &chunk) == DuckDBSuccess);
+	REQUIRE(chunk.row_count == 10);
+	REQUIRE(((int64_t *)chunk.columns[0].data)[9] == 9);
+	duckdb_destroy_stream_result(&result);
+	duckdb_destroy_prepare(&stmt);
+
+	// the result as Arrow arrays
+	REQUIRE(duckdb_query_stream(tester.connection, "SELECT i, s FROM test", &result) == DuckDBSuccess);
+	ArrowSchema schema;
+	REQUIRE(duckdb_stream_arrow_schema(result, &schema) == DuckDBSuccess);
+	REQUIRE(schema.n_children == 2);
+	REQUIRE(string(schema.children[0]->format) == "l");
+	REQUIRE(string(schema.children[1]->format) == "u");
+	schema.release(&schema);
+	row_count = 0;
+	while (true) {
+		ArrowArray array;
+		REQUIRE(duckdb_stream_fetch_arrow_array(result, &array) == DuckDBSuccess);
+		if (!array.release) {
+			break;
+		}
+		REQUIRE(array.n_children == 2);
+		REQUIRE(array.children[0]->length == array.length);
+		row_count += array.length;
+		array.release(&array);
+	}
+	REQUIRE(row_count == 10000);
+	duckdb_destroy_stream_result(&result);
+}
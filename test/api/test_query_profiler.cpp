@@ -23,3 +23,39 @@ TEST_CASE("Test query profiler", "[api]") {
 	output = con.GetProfilingInformation(ProfilerPrintFormat::JSON);
 	REQUIRE(output.size() > 0);
 }
+
+TEST_CASE("Test query profiler reports rows pruned by zonemaps", "[api]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+	string output;
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers AS SELECT i FROM range(0, 1000000, 1) t1(i)"));
+	// the values in between the two halves of the table are not in any segment
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE gaps AS SELECT CASE WHEN i < 500000 THEN i ELSE i + 1000000 END AS i FROM "
+	                          "range(0, 1000000, 1) t1(i)"));
+
+	con.EnableProfiling();
+	for (idx_t threads = 1; threads <= 4; threads += 3) {
+		REQUIRE_NO_FAIL(con.Query("PRAGMA threads=" + to_string(threads)));
+
+		result = con.Query("SELECT COUNT(*), SUM(i) FROM integers WHERE i >= 999000");
+		REQUIRE(CHECK_COLUMN(result, 0, {1000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {999499500}));
+
+		output = con.GetProfilingInformation(ProfilerPrintFormat::JSON);
+		REQUIRE(output.find("\"pruned_rows\": 0,") == string::npos);
+		REQUIRE(output.find("\"pruned_rows\"") != string::npos);
+
+		// every segment that the scan does not prune produces no rows either
+		result = con.Query("SELECT COUNT(*) FROM gaps WHERE i BETWEEN 600000 AND 700000");
+		REQUIRE(CHECK_COLUMN(result, 0, {0}));
+		output = con.GetProfilingInformation(ProfilerPrintFormat::JSON);
+		REQUIRE(output.find("\"pruned_rows\": 0,") == string::npos);
+	}
+	// a filter that cannot be answered from the zonemaps does not prune anything
+	result = con.Query("SELECT COUNT(*) FROM integers WHERE i % 2 = 0");
+	REQUIRE(CHECK_COLUMN(result, 0, {500000}));
+	output = con.GetProfilingInformation(ProfilerPrintFormat::JSON);
+	REQUIRE(output.find("\"pruned_rows\": 0,") != string::npos);
+}
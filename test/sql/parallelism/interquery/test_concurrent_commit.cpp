@@ -0,0 +1,112 @@
+#include "catch.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/write_ahead_log.hpp"
+#include "test_helpers.hpp"
+
+#include <thread>
+
+using namespace duckdb;
+using namespace std;
+
+static constexpr int CONCURRENT_COMMIT_THREAD_COUNT = 10;
+static constexpr int CONCURRENT_COMMIT_INSERT_COUNT = 50;
+
+static void insert_committed_elements(DuckDB *db, bool *correct, int threadnr) {
+	correct[threadnr] = true;
+	Connection con(*db);
+	for (int i = 0; i < CONCURRENT_COMMIT_INSERT_COUNT; i++) {
+		// every insert is committed separately
+		auto result = con.Query("INSERT INTO integers VALUES (" + to_string(threadnr) + ")");
+		if (!result->success) {
+			correct[threadnr] = false;
+		}
+	}
+}
+
+static void test_concurrent_commit(string checkpoint_threshold, bool check_syncs) {
+	auto storage_database = TestCreatePath("concurrent_commit");
+	auto config = GetTestConfig();
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("PRAGMA wal_autocheckpoint='" + checkpoint_threshold + "'"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA commit_delay=100"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+
+		bool correct[CONCURRENT_COMMIT_THREAD_COUNT];
+		thread threads[CONCURRENT_COMMIT_THREAD_COUNT];
+		for (int i = 0; i < CONCURRENT_COMMIT_THREAD_COUNT; i++) {
+			threads[i] = thread(insert_committed_elements, &db, correct, i);
+		}
+		for (int i = 0; i < CONCURRENT_COMMIT_THREAD_COUNT; i++) {
+			threads[i].join();
+			REQUIRE(correct[i]);
+		}
+		if (check_syncs) {
+			// the commits have shared their WAL syncs
+			auto log = StorageManager::GetStorageManager(*con.context).GetWriteAheadLog();
+			REQUIRE(log);
+			REQUIRE(log->GetSyncCount() > 0);
+			REQUIRE(log->GetSyncCount() < CONCURRENT_COMMIT_THREAD_COUNT * CONCURRENT_COMMIT_INSERT_COUNT);
+		}
+	}
+	// every commit has been synced to the WAL (or written to a checkpoint): all rows are there after a restart
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		auto result = con.Query("SELECT COUNT(*), COUNT(DISTINCT i), SUM(i) FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {CONCURRENT_COMMIT_THREAD_COUNT * CONCURRENT_COMMIT_INSERT_COUNT}));
+		REQUIRE(CHECK_COLUMN(result, 1, {CONCURRENT_COMMIT_THREAD_COUNT}));
+		REQUIRE(CHECK_COLUMN(result, 2, {45 * CONCURRENT_COMMIT_INSERT_COUNT}));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Concurrent commits share WAL syncs", "[interquery]") {
+	test_concurrent_commit("1GB", true);
+}
+
+TEST_CASE("Concurrent commits with checkpoints", "[interquery]") {
+	test_concurrent_commit("0b", false);
+}
+
+static void update_with_delayed_sync(DuckDB *db, bool *success) {
+	Connection con(*db);
+	auto result = con.Query("UPDATE integers SET i = 2 WHERE i = 1");
+	*success = result->success;
+}
+
+TEST_CASE("Transactions that start while a commit is synced do not see the commit", "[interquery]") {
+	auto storage_database = TestCreatePath("concurrent_commit");
+	auto config = GetTestConfig();
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("PRAGMA wal_autocheckpoint='1GB'"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers(i INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers VALUES (1)"));
+		// the sync of the next commit takes at least a second
+		REQUIRE_NO_FAIL(con.Query("PRAGMA commit_delay=1000000"));
+
+		bool success = false;
+		thread update_thread(update_with_delayed_sync, &db, &success);
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+		// the update has not been synced yet: a transaction that starts now reads the old value, and conflicts with
+		// the update
+		Connection reader(db);
+		REQUIRE_NO_FAIL(reader.Query("BEGIN TRANSACTION"));
+		auto result = reader.Query("SELECT i FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {1}));
+		REQUIRE_FAIL(reader.Query("UPDATE integers SET i = 3"));
+		REQUIRE_NO_FAIL(reader.Query("ROLLBACK"));
+
+		update_thread.join();
+		REQUIRE(success);
+		result = reader.Query("SELECT i FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {2}));
+	}
+	DeleteDatabase(storage_database);
+}
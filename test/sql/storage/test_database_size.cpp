@@ -71,3 +71,221 @@ TEST_CASE("Test that database size does not grow after many checkpoints", "[stor
 	REQUIRE(new_size <= size * 3);
 	DeleteDatabase(storage_database);
 }
+
+static int64_t GetDatabaseSize(FileSystem &fs, string &path) {
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+	return fs.GetFileSize(*handle);
+}
+
+TEST_CASE("Test that checkpoints pack the compressed data of in-memory segments", "[storage]") {
+	FileSystem fs;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("compressed_size_test");
+	// the uncompressed size of the two BIGINT columns
+	constexpr int64_t UNCOMPRESSED_SIZE = 2 * 1000000 * sizeof(int64_t);
+
+	// the table is checkpointed right after it has been created
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers AS SELECT i AS a, i * 2 AS b FROM range(0, 1000000) t(i)"));
+	}
+	auto size = GetDatabaseSize(fs, storage_database);
+	REQUIRE(size < UNCOMPRESSED_SIZE / 2);
+
+	// the table is checkpointed after replaying the WAL
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database);
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers AS SELECT i AS a, i * 2 AS b FROM range(0, 1000000) t(i)"));
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT SUM(a), SUM(b) FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::HUGEINT(499999500000)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::HUGEINT(999999000000)}));
+	}
+	REQUIRE(GetDatabaseSize(fs, storage_database) < UNCOMPRESSED_SIZE / 2);
+
+	// updating a few rows only rewrites the blocks that hold them
+	// the updates also match the rows with a = 0 that were inserted by the previous iterations
+	for (idx_t i = 0; i < 3; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("UPDATE integers SET b = b + 1 WHERE a % 100000 = 0"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i, i * 2 FROM range(0, 1000) t(i)"));
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(b) FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {1003000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::HUGEINT(999999000000 + 33 + 3 * 999000)}));
+	}
+	REQUIRE(GetDatabaseSize(fs, storage_database) < UNCOMPRESSED_SIZE / 2);
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test that checkpoints drop the data of deleted rows", "[storage]") {
+	FileSystem fs;
+	auto config = GetTestConfig();
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("deleted_size_test");
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE strings AS SELECT i AS a, 'thisisalongstring' || i AS s FROM range(0, "
+		                          "1000000) t(i)"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE integers AS SELECT i FROM range(0, 100000) t(i)"));
+	}
+	auto size = GetDatabaseSize(fs, storage_database);
+	{
+		// delete most rows, and every other row of the remaining rows
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM strings WHERE a < 900000 OR a % 2 = 0"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM integers"));
+	}
+	for (idx_t i = 0; i < 2; i++) {
+		// the deleted rows stay deleted after a restart, and new rows can be appended after them
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(a), MIN(s), MAX(LENGTH(s)) FROM strings WHERE a < 1000000");
+		REQUIRE(CHECK_COLUMN(result, 0, {50000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::HUGEINT(47500000000)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {"thisisalongstring900001"}));
+		REQUIRE(CHECK_COLUMN(result, 3, {23}));
+		result = con.Query("SELECT COUNT(*), SUM(i) FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(i * 10)}));
+		REQUIRE(CHECK_COLUMN(result, 1, {i == 0 ? Value() : Value::HUGEINT(45)}));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO integers SELECT i FROM range(0, 10) t(i)"));
+		// the space of the deleted rows can be used by new rows
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO strings SELECT i, 'thisisalongstring' || i FROM range(1000000, "
+		                          "1400000) t(i)"));
+	}
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*) FROM strings");
+		REQUIRE(CHECK_COLUMN(result, 0, {850000}));
+		result = con.Query("SELECT COUNT(*), SUM(i) FROM integers");
+		REQUIRE(CHECK_COLUMN(result, 0, {20}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::HUGEINT(90)}));
+	}
+	// the new rows are written to the blocks that held the deleted rows
+	REQUIRE(GetDatabaseSize(fs, storage_database) < size * 3 / 2);
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test that large appends are written to the database file before they commit", "[storage]") {
+	FileSystem fs;
+	auto config = GetTestConfig();
+	// a checkpoint is only written once the WAL exceeds 1MB
+	config->checkpoint_wal_size = 1 << 20;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("bulk_append_test");
+	auto wal_path = storage_database + ".wal";
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db), con2(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE bulk(i INTEGER, s VARCHAR)"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE small(i INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(
+		    con.Query("INSERT INTO bulk SELECT i, 'thisisalongstring' || i::VARCHAR FROM range(0, 1000000) t(i)"));
+		// other transactions can commit while the append is pending
+		REQUIRE_NO_FAIL(con2.Query("INSERT INTO small VALUES (1)"));
+		REQUIRE_NO_FAIL(con.Query("COMMIT"));
+		REQUIRE_NO_FAIL(con2.Query("INSERT INTO small VALUES (2)"));
+		// the WAL only refers to the blocks that the rows were written to, it does not trigger a checkpoint
+		REQUIRE(GetDatabaseSize(fs, wal_path) < 1 << 20);
+		auto size = GetDatabaseSize(fs, storage_database);
+		REQUIRE(size > 20000000);
+
+		// the next checkpoint reuses the blocks
+		REQUIRE_NO_FAIL(con.Query("PRAGMA force_checkpoint"));
+		REQUIRE(GetDatabaseSize(fs, storage_database) < size * 11 / 10);
+		result = con.Query("SELECT COUNT(*), SUM(i), SUM(LENGTH(s)) FROM bulk");
+		REQUIRE(CHECK_COLUMN(result, 0, {1000000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::HUGEINT(499999500000)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {Value::HUGEINT(22888890)}));
+
+		// append to the end of the table, which does not start at a vector boundary
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO bulk VALUES (-1, 'small')"));
+		REQUIRE_NO_FAIL(
+		    con.Query("INSERT INTO bulk SELECT i, 'thisisalongstring' || i::VARCHAR FROM range(0, 1000000) t(i)"));
+	}
+	// the rows are read from the blocks when the WAL is replayed
+	for (idx_t i = 0; i < 2; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(i), SUM(LENGTH(s)) FROM bulk");
+		REQUIRE(CHECK_COLUMN(result, 0, {2000001}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::HUGEINT(999998999999)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {Value::HUGEINT(45777785)}));
+		result = con.Query("SELECT SUM(i) FROM small");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::HUGEINT(3)}));
+	}
+	DeleteDatabase(storage_database);
+}
+
+TEST_CASE("Test that large appends are written to the database file while they are loaded", "[storage]") {
+	FileSystem fs;
+	auto config = GetTestConfig();
+	config->checkpoint_wal_size = 1 << 20;
+	unique_ptr<QueryResult> result;
+	auto storage_database = TestCreatePath("bulk_load_test");
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db), con2(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE bulk(i INTEGER, s VARCHAR)"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE small(i INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("PRAGMA force_checkpoint"));
+		auto initial_size = GetDatabaseSize(fs, storage_database);
+
+		// the rows are written to blocks before the transaction commits
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(
+		    con.Query("INSERT INTO bulk SELECT i, 'thisisalongstring' || i::VARCHAR FROM range(0, 1000000) t(i)"));
+		auto loaded_size = GetDatabaseSize(fs, storage_database);
+		REQUIRE(loaded_size > initial_size + 15000000);
+		// a rollback frees the blocks again
+		REQUIRE_NO_FAIL(con.Query("ROLLBACK"));
+
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(
+		    con.Query("INSERT INTO bulk SELECT i, 'thisisalongstring' || i::VARCHAR FROM range(0, 1000000) t(i)"));
+		REQUIRE(GetDatabaseSize(fs, storage_database) < loaded_size * 11 / 10);
+		// other transactions can commit while the append is pending, but no checkpoint can be written
+		REQUIRE_NO_FAIL(con2.Query("INSERT INTO small VALUES (1)"));
+		REQUIRE_FAIL(con2.Query("PRAGMA force_checkpoint"));
+		REQUIRE_NO_FAIL(con2.Query("INSERT INTO small SELECT * FROM range(0, 100000)"));
+		// rows that are updated after they were written to blocks
+		REQUIRE_NO_FAIL(con.Query("UPDATE bulk SET i = -i WHERE i < 10"));
+		REQUIRE_NO_FAIL(con.Query("COMMIT"));
+	}
+	for (idx_t i = 0; i < 3; i++) {
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		result = con.Query("SELECT COUNT(*), SUM(i), SUM(LENGTH(s)) FROM bulk");
+		REQUIRE(CHECK_COLUMN(result, 0, {1000000}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::HUGEINT(499999500000 - 90)}));
+		REQUIRE(CHECK_COLUMN(result, 2, {Value::HUGEINT(22888890)}));
+		result = con.Query("SELECT COUNT(*), SUM(i) FROM small");
+		REQUIRE(CHECK_COLUMN(result, 0, {100001}));
+		REQUIRE(CHECK_COLUMN(result, 1, {Value::HUGEINT(4999950001)}));
+		// the checkpoint does not reuse the blocks of the updated rows
+		REQUIRE_NO_FAIL(con.Query("PRAGMA force_checkpoint"));
+	}
+	DeleteDatabase(storage_database);
+}
@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "test_helpers.hpp"
+
+using namespace duckdb;
+using namespace std;
+
+TEST_CASE("Test replaying the WAL on multiple threads", "[storage]") {
+	auto storage_database = TestCreatePath("wal_replay_test");
+	auto config = GetTestConfig();
+	// the WAL is never checkpointed, so every restart replays all of it
+	config->checkpoint_wal_size = (idx_t)1 << 40;
+	config->maximum_threads = 4;
+
+	vector<string> queries {"SELECT COUNT(*), SUM(i), SUM(j) FROM a",
+	                        "SELECT k, v FROM b ORDER BY k",
+	                        "SELECT s, t FROM c ORDER BY s, t",
+	                        "SELECT * FROM d ORDER BY x"};
+	vector<string> expected;
+
+	DeleteDatabase(storage_database);
+	{
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE a(i INTEGER, j INTEGER)"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE b(k INTEGER PRIMARY KEY, v VARCHAR)"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE c(s VARCHAR)"));
+		REQUIRE_NO_FAIL(con.Query("CREATE SEQUENCE seq"));
+		// many small transactions interleaved over the tables
+		for (idx_t i = 0; i < 100; i++) {
+			auto value = to_string(i);
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO a VALUES (" + value + ", " + value + ")"));
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO b VALUES (" + value + ", 'v" + value + "')"));
+			REQUIRE_NO_FAIL(con.Query("INSERT INTO c VALUES ('s" + value + "')"));
+			if (i % 25 == 0) {
+				REQUIRE_NO_FAIL(con.Query("SELECT nextval('seq')"));
+			}
+		}
+		// the catalog change ends the batch of transactions before it: its inserts are replayed in parallel
+		REQUIRE_NO_FAIL(con.Query("CREATE VIEW v AS SELECT 42"));
+		// deletes and updates of the rows inserted by the preceding transactions
+		REQUIRE_NO_FAIL(con.Query("UPDATE a SET j = j + 1000 WHERE i % 10 = 0"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM a WHERE i % 7 = 0"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO a SELECT range, range FROM range(1000, 5000)"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE a SET i = i + 1 WHERE i >= 4990"));
+		// deleted keys are inserted again by later transactions
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM b WHERE k < 10"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO b VALUES (100, 'new')"));
+		REQUIRE_NO_FAIL(con.Query("COMMIT"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO b VALUES (5, 'reinserted')"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM b WHERE k = 20"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO b VALUES (20, 'again')"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE b SET v = 'updated' WHERE k = 20"));
+		// a transaction that changes several tables
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO a VALUES (-1, -1)"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM b WHERE k = 30"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO b VALUES (200, 'moved')"));
+		REQUIRE_NO_FAIL(con.Query("UPDATE c SET s = 'multi' WHERE s = 's4'"));
+		REQUIRE_NO_FAIL(con.Query("COMMIT"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO a VALUES (-2, -2)"));
+		// catalog changes in between the data
+		REQUIRE_NO_FAIL(con.Query("ALTER TABLE c ADD COLUMN t INTEGER DEFAULT 1"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO c VALUES ('after', 2)"));
+		REQUIRE_NO_FAIL(con.Query("BEGIN TRANSACTION"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO c VALUES ('before_create', 3)"));
+		REQUIRE_NO_FAIL(con.Query("CREATE TABLE d AS SELECT 42 AS x"));
+		REQUIRE_NO_FAIL(con.Query("DELETE FROM c WHERE s = 's3'"));
+		REQUIRE_NO_FAIL(con.Query("COMMIT"));
+		REQUIRE_NO_FAIL(con.Query("INSERT INTO d VALUES (43)"));
+
+		for (auto &query : queries) {
+			auto result = con.Query(query);
+			REQUIRE(result->success);
+			expected.push_back(result->ToString());
+		}
+		auto result = con.Query("SELECT nextval('seq')");
+		REQUIRE(CHECK_COLUMN(result, 0, {5}));
+	}
+	// replay the WAL on multiple threads and on a single thread
+	int64_t sequence_value = 6;
+	for (idx_t threads : {4, 1}) {
+		config->maximum_threads = threads;
+		DuckDB db(storage_database, config.get());
+		Connection con(db);
+		for (idx_t i = 0; i < queries.size(); i++) {
+			auto result = con.Query(queries[i]);
+			REQUIRE(result->ToString() == expected[i]);
+		}
+		auto result = con.Query("SELECT nextval('seq')");
+		REQUIRE(CHECK_COLUMN(result, 0, {Value::BIGINT(sequence_value++)}));
+	}
+	DeleteDatabase(storage_database);
+}